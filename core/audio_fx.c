@@ -0,0 +1,358 @@
+/**
+ * @file audio_fx.c
+ * @brief 人声监听效果链实现（定点）
+ *
+ * 定点约定：采样 Q15（1.0 = 32768），内部以 int32 保存并限制在 ±2^19（+24 dB 余量）；
+ * 增益系数 Q12（最大 8.0 = +18 dB），其余系数 Q15。延迟线存 int16（写入前饱和）。
+ */
+
+#include "audio_fx.h"
+#include <math.h>
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define AUDIO_FX_NEON 1
+#endif
+
+#define FX_COMBS 4
+#define FX_ALLPASSES 2
+#define FX_SUBBLOCK 16
+#define FX_HEADROOM ((1 << 19) - 1)
+#define FX_RELEASE_MS 80
+
+/* Freeverb 原始延迟（44.1 kHz 下的采样数），按实际采样率缩放 */
+static const uint32_t comb_tuning[FX_COMBS] = {1116, 1188, 1277, 1356};
+static const uint32_t allpass_tuning[FX_ALLPASSES] = {556, 441};
+
+typedef struct {
+    int16_t *buf;
+    uint32_t len;
+    uint32_t pos;
+    int32_t filt;     /* 阻尼低通状态 */
+} fx_delay_t;
+
+struct audio_fx {
+    uint32_t rate;
+    uint32_t max_block;
+
+    /* 参数发布（seqlock）：seq 为奇数表示正在写 */
+    atomic_uint seq;
+    atomic_flag writer;
+    audio_fx_params_t pending;
+    unsigned applied_seq;
+    audio_fx_params_t params;       /* 处理线程当前生效的参数 */
+
+    int32_t gain_q12;               /* 当前增益（块内线性过渡到 target） */
+    int32_t gain_target_q12;
+
+    bool echo_on;
+    uint32_t echo_delay;
+    int32_t echo_fb_q15;
+    int32_t echo_mix_q15;
+    fx_delay_t echo;
+
+    bool reverb_on;
+    int32_t room_q15;
+    int32_t damp_q15;
+    int32_t wet_q15;
+    fx_delay_t comb[FX_COMBS];
+    fx_delay_t allpass[FX_ALLPASSES];
+
+    int32_t limit;                  /* 门限（Q15 采样值） */
+    int32_t env;                    /* 峰值包络 */
+    int32_t release_q15;            /* 每个子块的包络保留系数 */
+    int32_t lim_gain_q12;
+    atomic_int min_gain_q12;        /* 统计：最小限幅增益 */
+
+    int32_t *work;                  /* max_block 个 int32 */
+    int16_t *storage;               /* 所有延迟线共用的一块内存 */
+};
+
+static inline int16_t sat16(int32_t v) {
+    return (int16_t)(v > 32767 ? 32767 : (v < -32768 ? -32768 : v));
+}
+
+static inline int32_t clamp_headroom(int32_t v) {
+    return v > FX_HEADROOM ? FX_HEADROOM : (v < -FX_HEADROOM ? -FX_HEADROOM : v);
+}
+
+static inline float clampf(float v, float lo, float hi) {
+    return v < lo ? lo : (v > hi ? hi : v);
+}
+
+static int32_t to_q15(float v) {
+    return (int32_t)lrintf(v * 32768.0f);
+}
+
+void audio_fx_default_params(audio_fx_params_t *params) {
+    memset(params, 0, sizeof(*params));
+    params->gain_db = 0.0f;
+    params->echo_ms = 250;
+    params->echo_feedback = 0.35f;
+    params->echo_mix = 0.3f;
+    params->reverb_room = 0.6f;
+    params->reverb_damp = 0.4f;
+    params->reverb_mix = 0.25f;
+    params->limiter_db = -1.0f;
+}
+
+audio_fx_t *audio_fx_create(uint32_t sample_rate, uint32_t max_block) {
+    if (sample_rate < 8000 || max_block == 0) return NULL;
+    audio_fx_t *fx = (audio_fx_t *)calloc(1, sizeof(audio_fx_t));
+    if (!fx) return NULL;
+    fx->rate = sample_rate;
+    fx->max_block = max_block;
+
+    /* 延迟线长度：回声最长 AUDIO_FX_MAX_ECHO_MS，混响按采样率缩放 Freeverb 长度 */
+    size_t total = 0;
+    fx->echo.len = (uint32_t)((uint64_t)sample_rate * AUDIO_FX_MAX_ECHO_MS / 1000U) + 1;
+    total += fx->echo.len;
+    for (int i = 0; i < FX_COMBS; ++i) {
+        fx->comb[i].len = (uint32_t)((uint64_t)comb_tuning[i] * sample_rate / 44100U);
+        total += fx->comb[i].len;
+    }
+    for (int i = 0; i < FX_ALLPASSES; ++i) {
+        fx->allpass[i].len = (uint32_t)((uint64_t)allpass_tuning[i] * sample_rate / 44100U);
+        total += fx->allpass[i].len;
+    }
+    fx->storage = (int16_t *)calloc(total, sizeof(int16_t));
+    fx->work = (int32_t *)calloc(max_block, sizeof(int32_t));
+    if (!fx->storage || !fx->work) {
+        audio_fx_destroy(fx);
+        return NULL;
+    }
+    int16_t *p = fx->storage;
+    fx->echo.buf = p;
+    p += fx->echo.len;
+    for (int i = 0; i < FX_COMBS; ++i) {
+        fx->comb[i].buf = p;
+        p += fx->comb[i].len;
+    }
+    for (int i = 0; i < FX_ALLPASSES; ++i) {
+        fx->allpass[i].buf = p;
+        p += fx->allpass[i].len;
+    }
+
+    float sub_ms = (float)FX_SUBBLOCK * 1000.0f / (float)sample_rate;
+    fx->release_q15 = to_q15(expf(-sub_ms / (float)FX_RELEASE_MS));
+
+    atomic_init(&fx->seq, 0);
+    atomic_flag_clear(&fx->writer);
+    atomic_init(&fx->min_gain_q12, 4096);
+
+    audio_fx_params_t defaults;
+    audio_fx_default_params(&defaults);
+    audio_fx_set_params(fx, &defaults);
+    fx->applied_seq = ~0U;
+    audio_fx_reset(fx);
+    return fx;
+}
+
+void audio_fx_destroy(audio_fx_t *fx) {
+    if (!fx) return;
+    free(fx->storage);
+    free(fx->work);
+    free(fx);
+}
+
+void audio_fx_set_params(audio_fx_t *fx, const audio_fx_params_t *params) {
+    if (!fx || !params) return;
+    while (atomic_flag_test_and_set_explicit(&fx->writer, memory_order_acquire)) {
+        /* 写者之间互斥，临界区只有一次拷贝 */
+    }
+    unsigned s = atomic_load_explicit(&fx->seq, memory_order_relaxed);
+    atomic_store_explicit(&fx->seq, s + 1, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    fx->pending = *params;
+    atomic_store_explicit(&fx->seq, s + 2, memory_order_release);
+    atomic_flag_clear_explicit(&fx->writer, memory_order_release);
+}
+
+/* seqlock 读：成功返回 true（拷贝期间没有写者） */
+static bool read_pending(audio_fx_t *fx, audio_fx_params_t *out, unsigned *seq_out) {
+    unsigned s1 = atomic_load_explicit(&fx->seq, memory_order_acquire);
+    if (s1 & 1U) return false;
+    *out = fx->pending;
+    atomic_thread_fence(memory_order_acquire);
+    unsigned s2 = atomic_load_explicit(&fx->seq, memory_order_relaxed);
+    *seq_out = s1;
+    return s1 == s2;
+}
+
+void audio_fx_get_params(audio_fx_t *fx, audio_fx_params_t *out) {
+    unsigned seq;
+    while (!read_pending(fx, out, &seq)) {
+    }
+}
+
+/* 把浮点参数换算成定点系数（处理线程，块开头） */
+static void apply_params(audio_fx_t *fx, const audio_fx_params_t *p) {
+    fx->params = *p;
+    float gain = powf(10.0f, clampf(p->gain_db, -30.0f, 18.0f) / 20.0f);
+    fx->gain_target_q12 = (int32_t)lrintf(gain * 4096.0f);
+
+    fx->echo_on = p->echo_enabled;
+    uint32_t echo_ms = p->echo_ms < 20 ? 20 : (p->echo_ms > AUDIO_FX_MAX_ECHO_MS ? AUDIO_FX_MAX_ECHO_MS : p->echo_ms);
+    fx->echo_delay = (uint32_t)((uint64_t)fx->rate * echo_ms / 1000U);
+    if (fx->echo_delay >= fx->echo.len) fx->echo_delay = fx->echo.len - 1;
+    fx->echo_fb_q15 = to_q15(clampf(p->echo_feedback, 0.0f, 0.9f));
+    fx->echo_mix_q15 = to_q15(clampf(p->echo_mix, 0.0f, 1.0f));
+
+    /* Freeverb 映射：反馈 0.7 + 0.28 × room，阻尼 0.4 × damp */
+    fx->reverb_on = p->reverb_enabled;
+    fx->room_q15 = to_q15(0.7f + 0.28f * clampf(p->reverb_room, 0.0f, 1.0f));
+    fx->damp_q15 = to_q15(0.4f * clampf(p->reverb_damp, 0.0f, 1.0f));
+    fx->wet_q15 = to_q15(clampf(p->reverb_mix, 0.0f, 1.0f));
+
+    float limit = powf(10.0f, clampf(p->limiter_db, -12.0f, 0.0f) / 20.0f);
+    fx->limit = (int32_t)lrintf(limit * 32767.0f);
+}
+
+void audio_fx_reset(audio_fx_t *fx) {
+    if (!fx) return;
+    size_t total = fx->echo.len;
+    for (int i = 0; i < FX_COMBS; ++i) total += fx->comb[i].len;
+    for (int i = 0; i < FX_ALLPASSES; ++i) total += fx->allpass[i].len;
+    memset(fx->storage, 0, total * sizeof(int16_t));
+    fx->echo.pos = 0;
+    for (int i = 0; i < FX_COMBS; ++i) fx->comb[i].pos = fx->comb[i].filt = 0;
+    for (int i = 0; i < FX_ALLPASSES; ++i) fx->allpass[i].pos = 0;
+    fx->env = 0;
+    fx->lim_gain_q12 = 4096;
+    fx->gain_q12 = fx->gain_target_q12;
+}
+
+float audio_fx_take_gain_reduction_db(audio_fx_t *fx) {
+    int32_t g = atomic_exchange_explicit(&fx->min_gain_q12, 4096, memory_order_relaxed);
+    if (g >= 4096 || g <= 0) return 0.0f;
+    return -20.0f * log10f((float)g / 4096.0f);
+}
+
+/* 输入增益：int16 → int32，增益变化时块内线性过渡避免拉链噪声 */
+static void stage_gain(audio_fx_t *fx, const int16_t *in, int32_t *x, uint32_t n) {
+    int32_t g = fx->gain_q12;
+    int32_t target = fx->gain_target_q12;
+    if (g == target) {
+        uint32_t i = 0;
+#ifdef AUDIO_FX_NEON
+        int16x4_t gv = vdup_n_s16((int16_t)(g > 32767 ? 32767 : g));
+        for (; i + 4 <= n; i += 4) {
+            int32x4_t v = vmull_s16(vld1_s16(in + i), gv);
+            vst1q_s32(x + i, vshrq_n_s32(v, 12));
+        }
+#endif
+        for (; i < n; ++i) x[i] = (in[i] * g) >> 12;
+        return;
+    }
+    int32_t step = (target - g) / (int32_t)n;
+    for (uint32_t i = 0; i < n; ++i) {
+        x[i] = (in[i] * g) >> 12;
+        g += step;
+    }
+    fx->gain_q12 = target;
+}
+
+/* 回声：y = x + mix · d[n - D]，d[n] = x + fb · d[n - D] */
+static void stage_echo(audio_fx_t *fx, int32_t *x, uint32_t n) {
+    fx_delay_t *e = &fx->echo;
+    const int32_t fb = fx->echo_fb_q15;
+    const int32_t mix = fx->echo_mix_q15;
+    uint32_t rd = e->pos >= fx->echo_delay ? e->pos - fx->echo_delay : e->pos + e->len - fx->echo_delay;
+    for (uint32_t i = 0; i < n; ++i) {
+        int32_t d = e->buf[rd];
+        int32_t in = x[i];
+        e->buf[e->pos] = sat16(in + ((d * fb) >> 15));
+        x[i] = clamp_headroom(in + ((d * mix) >> 15));
+        if (++e->pos == e->len) e->pos = 0;
+        if (++rd == e->len) rd = 0;
+    }
+}
+
+/* 混响：输入 ×1/16 进 4 路并联梳状（带阻尼低通），再串联 2 路全通，按 wet 混回 */
+static void stage_reverb(audio_fx_t *fx, int32_t *x, uint32_t n) {
+    const int32_t room = fx->room_q15;
+    const int32_t damp = fx->damp_q15;
+    const int32_t damp_inv = 32768 - damp;
+    const int32_t wet = fx->wet_q15;
+    for (uint32_t i = 0; i < n; ++i) {
+        int32_t in = x[i] >> 4;
+        int32_t acc = 0;
+        for (int c = 0; c < FX_COMBS; ++c) {
+            fx_delay_t *d = &fx->comb[c];
+            int32_t out = d->buf[d->pos];
+            d->filt = (out * damp_inv + d->filt * damp) >> 15;
+            d->buf[d->pos] = sat16(in + ((d->filt * room) >> 15));
+            if (++d->pos == d->len) d->pos = 0;
+            acc += out;
+        }
+        for (int a = 0; a < FX_ALLPASSES; ++a) {
+            fx_delay_t *d = &fx->allpass[a];
+            int32_t bufout = d->buf[d->pos];
+            d->buf[d->pos] = sat16(acc + (bufout >> 1));
+            acc = bufout - acc;
+            if (++d->pos == d->len) d->pos = 0;
+        }
+        /* acc 可达 ±2^18，先右移 2 位再乘 wet，避免 32 位溢出；整体 ×2 补偿输入的 1/16 */
+        x[i] = clamp_headroom(x[i] + (((acc >> 2) * wet) >> 12));
+    }
+}
+
+/* 输出级：乘限幅增益（Q12）并饱和到 16 位 */
+static void stage_output(const int32_t *x, int16_t *out, uint32_t n, int32_t g) {
+    uint32_t i = 0;
+#ifdef AUDIO_FX_NEON
+    int32x4_t gv = vdupq_n_s32(g);
+    for (; i + 4 <= n; i += 4) {
+        int32x4_t v = vmulq_s32(vld1q_s32(x + i), gv);
+        vst1_s16(out + i, vqshrn_n_s32(v, 12));
+    }
+#endif
+    for (; i < n; ++i) out[i] = sat16((x[i] * g) >> 12);
+}
+
+/* 限幅：每个子块取峰值更新包络（瞬时起控、指数释放），增益 = 门限 / 包络 */
+static void stage_limit(audio_fx_t *fx, const int32_t *x, int16_t *out, uint32_t n) {
+    int32_t min_gain = 4096;
+    for (uint32_t off = 0; off < n; off += FX_SUBBLOCK) {
+        uint32_t len = n - off < FX_SUBBLOCK ? n - off : FX_SUBBLOCK;
+        int32_t peak = 0;
+        for (uint32_t i = 0; i < len; ++i) {
+            int32_t a = x[off + i] < 0 ? -x[off + i] : x[off + i];
+            if (a > peak) peak = a;
+        }
+        if (peak >= fx->env) {
+            fx->env = peak;
+        } else {
+            fx->env = peak + (int32_t)(((int64_t)(fx->env - peak) * fx->release_q15) >> 15);
+        }
+        int32_t g = fx->env > fx->limit ? (int32_t)(((int64_t)fx->limit << 12) / fx->env) : 4096;
+        fx->lim_gain_q12 = g;
+        if (g < min_gain) min_gain = g;
+        stage_output(x + off, out + off, len, g);
+    }
+    int32_t prev = atomic_load_explicit(&fx->min_gain_q12, memory_order_relaxed);
+    if (min_gain < prev) atomic_store_explicit(&fx->min_gain_q12, min_gain, memory_order_relaxed);
+}
+
+void audio_fx_process(audio_fx_t *fx, const int16_t *in, int16_t *out, uint32_t frames) {
+    audio_fx_params_t p;
+    unsigned seq;
+    if (atomic_load_explicit(&fx->seq, memory_order_relaxed) != fx->applied_seq && read_pending(fx, &p, &seq)) {
+        apply_params(fx, &p);
+        fx->applied_seq = seq;
+    }
+
+    while (frames > 0) {
+        uint32_t n = frames < fx->max_block ? frames : fx->max_block;
+        stage_gain(fx, in, fx->work, n);
+        if (fx->echo_on) stage_echo(fx, fx->work, n);
+        if (fx->reverb_on) stage_reverb(fx, fx->work, n);
+        stage_limit(fx, fx->work, out, n);
+        in += n;
+        out += n;
+        frames -= n;
+    }
+}
@@ -0,0 +1,66 @@
+/**
+ * @file audio_fx.h
+ * @brief 人声监听效果链：增益 → 回声 → 混响 → 限幅，全程定点
+ *
+ * - 单声道 S16 输入输出，内部 32 位累加（Q15，带 +24 dB 余量），最终饱和到 16 位
+ * - 回声：单抽头反馈延迟线；混响：Freeverb 结构的精简版（4 梳状 + 2 全通）
+ * - 限幅：每 16 个采样一个子块，峰值瞬时起控、指数释放，残余过冲由最终饱和截断
+ * - 参数更新无锁：任意线程调用 audio_fx_set_params 发布（seqlock），
+ *   处理线程在每个块开头取最新参数，读取不阻塞、不分配内存
+ * - 增益 / 限幅输出级在 ARM 上用 NEON，其它平台为可自动向量化的标量循环
+ *
+ * 调用线程：audio_fx_process / audio_fx_reset 只能由一个线程（音频线程）调用
+ */
+
+#ifndef KTVLV_CORE_AUDIO_FX_H
+#define KTVLV_CORE_AUDIO_FX_H
+
+#include <stdbool.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define AUDIO_FX_MAX_ECHO_MS 1000
+
+typedef struct audio_fx audio_fx_t;
+
+typedef struct {
+    float gain_db;            /* 输入增益，-30..+18 dB */
+    bool echo_enabled;
+    uint32_t echo_ms;         /* 回声延迟，20..AUDIO_FX_MAX_ECHO_MS */
+    float echo_feedback;      /* 0..0.9 */
+    float echo_mix;           /* 0..1 */
+    bool reverb_enabled;
+    float reverb_room;        /* 0..1，房间大小（梳状滤波反馈） */
+    float reverb_damp;        /* 0..1，高频阻尼 */
+    float reverb_mix;         /* 0..1 */
+    float limiter_db;         /* 限幅门限 dBFS，-12..0 */
+} audio_fx_params_t;
+
+/* 默认参数：0 dB，回声/混响关闭，-1 dBFS 限幅 */
+void audio_fx_default_params(audio_fx_params_t *params);
+
+/* 按采样率与最大块长预分配全部缓冲；失败返回 NULL */
+audio_fx_t *audio_fx_create(uint32_t sample_rate, uint32_t max_block);
+void audio_fx_destroy(audio_fx_t *fx);
+
+/* 发布新参数（任意线程，多个写者之间自动互斥；不影响正在处理的块） */
+void audio_fx_set_params(audio_fx_t *fx, const audio_fx_params_t *params);
+void audio_fx_get_params(audio_fx_t *fx, audio_fx_params_t *out);
+
+/* 处理 frames 个单声道采样，in 与 out 可以相同；frames 超过 max_block 时分块处理 */
+void audio_fx_process(audio_fx_t *fx, const int16_t *in, int16_t *out, uint32_t frames);
+
+/* 清空延迟线与包络（切歌、重新开始监听时调用） */
+void audio_fx_reset(audio_fx_t *fx);
+
+/* 上次读取以来的最大限幅量（dB，≥ 0），读取后清零 */
+float audio_fx_take_gain_reduction_db(audio_fx_t *fx);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // KTVLV_CORE_AUDIO_FX_H
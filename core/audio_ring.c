@@ -0,0 +1,163 @@
+/**
+ * @file audio_ring.c
+ * @brief 录音 PCM 环形缓冲实现
+ *
+ * 写者先发布 claimed（即将覆盖到的位置）再拷贝数据，最后发布 committed；
+ * 读者按 committed 拷贝，拷贝后再看 claimed，被覆盖的部分丢弃。
+ * 帧序号为 64 位，不会回绕，读写位置直接相减即可。
+ */
+
+#include "audio_ring.h"
+#include <stdatomic.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct audio_ring {
+    _Atomic uint64_t claimed;     /* 写者即将写到的位置（写前发布） */
+    _Atomic uint64_t committed;   /* 已完整写入的位置 */
+    uint32_t capacity;            /* 帧数，2 的幂 */
+    uint32_t mask;
+    uint32_t frame_bytes;
+    uint8_t* data;
+};
+
+static uint32_t round_up_pow2(uint32_t v) {
+    uint32_t p = 1;
+    while (p < v && p < (1U << 30)) p <<= 1;
+    return p;
+}
+
+audio_ring_t* audio_ring_create(uint32_t capacity_frames, uint32_t frame_bytes) {
+    if (capacity_frames == 0 || frame_bytes == 0) return NULL;
+    audio_ring_t* ring = (audio_ring_t*)calloc(1, sizeof(audio_ring_t));
+    if (!ring) return NULL;
+    ring->capacity = round_up_pow2(capacity_frames);
+    ring->mask = ring->capacity - 1;
+    ring->frame_bytes = frame_bytes;
+    ring->data = (uint8_t*)calloc(ring->capacity, frame_bytes);
+    if (!ring->data) {
+        free(ring);
+        return NULL;
+    }
+    atomic_init(&ring->claimed, 0);
+    atomic_init(&ring->committed, 0);
+    return ring;
+}
+
+void audio_ring_destroy(audio_ring_t* ring) {
+    if (!ring) return;
+    free(ring->data);
+    free(ring);
+}
+
+uint32_t audio_ring_capacity(const audio_ring_t* ring) {
+    return ring->capacity;
+}
+
+uint32_t audio_ring_frame_bytes(const audio_ring_t* ring) {
+    return ring->frame_bytes;
+}
+
+uint64_t audio_ring_written(const audio_ring_t* ring) {
+    return atomic_load_explicit(&((audio_ring_t*)ring)->committed, memory_order_acquire);
+}
+
+/* 把 frames 帧从环形位置 pos 开始拷出/拷入（最多分两段） */
+static void copy_out(const audio_ring_t* ring, uint64_t pos, uint8_t* dst, uint32_t frames) {
+    uint32_t start = (uint32_t)(pos & ring->mask);
+    uint32_t first = ring->capacity - start;
+    if (first > frames) first = frames;
+    memcpy(dst, ring->data + (size_t)start * ring->frame_bytes, (size_t)first * ring->frame_bytes);
+    if (frames > first) {
+        memcpy(dst + (size_t)first * ring->frame_bytes, ring->data, (size_t)(frames - first) * ring->frame_bytes);
+    }
+}
+
+static void copy_in(audio_ring_t* ring, uint64_t pos, const uint8_t* src, uint32_t frames) {
+    uint32_t start = (uint32_t)(pos & ring->mask);
+    uint32_t first = ring->capacity - start;
+    if (first > frames) first = frames;
+    memcpy(ring->data + (size_t)start * ring->frame_bytes, src, (size_t)first * ring->frame_bytes);
+    if (frames > first) {
+        memcpy(ring->data, src + (size_t)first * ring->frame_bytes, (size_t)(frames - first) * ring->frame_bytes);
+    }
+}
+
+void audio_ring_write(audio_ring_t* ring, const void* data, uint32_t frames) {
+    if (!ring || !data || frames == 0) return;
+    const uint8_t* src = (const uint8_t*)data;
+    uint64_t pos = atomic_load_explicit(&ring->committed, memory_order_relaxed);
+    uint64_t end = pos + frames;
+
+    /* 一次写入超过容量：只有最后 capacity 帧会留下 */
+    if (frames > ring->capacity) {
+        src += (size_t)(frames - ring->capacity) * ring->frame_bytes;
+        pos = end - ring->capacity;
+        frames = ring->capacity;
+    }
+
+    atomic_store_explicit(&ring->claimed, end, memory_order_relaxed);
+    atomic_thread_fence(memory_order_release);
+    copy_in(ring, pos, src, frames);
+    atomic_store_explicit(&ring->committed, end, memory_order_release);
+}
+
+void audio_ring_reader_init(audio_ring_reader_t* reader, audio_ring_t* ring) {
+    reader->ring = ring;
+    reader->pos = audio_ring_written(ring);
+    reader->overruns = 0;
+    reader->lost_frames = 0;
+}
+
+uint32_t audio_ring_available(const audio_ring_reader_t* reader) {
+    uint64_t w = audio_ring_written(reader->ring);
+    uint64_t avail = w - reader->pos;
+    return avail > reader->ring->capacity ? reader->ring->capacity : (uint32_t)avail;
+}
+
+uint32_t audio_ring_fill_permille(const audio_ring_reader_t* reader) {
+    return (uint32_t)((uint64_t)audio_ring_available(reader) * 1000U / reader->ring->capacity);
+}
+
+uint32_t audio_ring_read(audio_ring_reader_t* reader, void* dst, uint32_t max_frames) {
+    audio_ring_t* ring = reader->ring;
+    uint64_t w = atomic_load_explicit(&ring->committed, memory_order_acquire);
+    uint64_t oldest = w > ring->capacity ? w - ring->capacity : 0;
+    if (reader->pos < oldest) {
+        reader->lost_frames += oldest - reader->pos;
+        reader->overruns++;
+        reader->pos = oldest;
+    }
+
+    uint64_t avail = w - reader->pos;
+    uint32_t n = avail < max_frames ? (uint32_t)avail : max_frames;
+    if (n == 0) return 0;
+    copy_out(ring, reader->pos, (uint8_t*)dst, n);
+
+    /* 拷贝期间写者可能已覆盖开头的部分：claimed - capacity 之前的帧不可信 */
+    atomic_thread_fence(memory_order_acquire);
+    uint64_t claimed = atomic_load_explicit(&ring->claimed, memory_order_relaxed);
+    uint64_t valid_from = claimed > ring->capacity ? claimed - ring->capacity : 0;
+    if (valid_from > reader->pos) {
+        uint64_t bad = valid_from - reader->pos;
+        reader->overruns++;
+        if (bad >= n) {
+            reader->lost_frames += bad;
+            reader->pos = valid_from;
+            return 0;
+        }
+        uint32_t good = n - (uint32_t)bad;
+        memmove(dst, (uint8_t*)dst + (size_t)bad * ring->frame_bytes, (size_t)good * ring->frame_bytes);
+        reader->lost_frames += bad;
+        reader->pos += n;
+        return good;
+    }
+
+    reader->pos += n;
+    return n;
+}
+
+void audio_ring_reader_skip(audio_ring_reader_t* reader, uint32_t keep_frames) {
+    uint64_t w = audio_ring_written(reader->ring);
+    if (w - reader->pos > keep_frames) reader->pos = w - keep_frames;
+}
@@ -0,0 +1,70 @@
+/**
+ * @file audio_ring.h
+ * @brief 录音 PCM 环形缓冲：单写者、多读者，全程无锁
+ *
+ * - 写者（录音线程）从不阻塞也不等待读者：缓冲满时覆盖最旧的数据
+ * - 每个读者（音高分析、混音监听等）持有自己的读位置，按各自节奏读取；
+ *   读者落后超过容量时记一次溢出并跳到仍有效的最旧数据，不影响写者和其他读者
+ * - 写入位置以 64 位帧计数发布，读者拷贝后按 seqlock 方式校验数据未被覆盖
+ *
+ * 调用线程：audio_ring_write 只能由一个线程调用；每个 audio_ring_reader_t 只能由一个线程使用
+ */
+
+#ifndef KTVLV_CORE_AUDIO_RING_H
+#define KTVLV_CORE_AUDIO_RING_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct audio_ring audio_ring_t;
+
+typedef struct {
+    audio_ring_t* ring;
+    uint64_t pos;             /* 下一个要读的帧序号 */
+    uint32_t overruns;        /* 落后被覆盖的次数 */
+    uint64_t lost_frames;     /* 因落后丢失的帧数 */
+} audio_ring_reader_t;
+
+/*
+ * 创建缓冲：容量向上取整到 2 的幂帧，frame_bytes 为一帧（所有声道）的字节数。
+ * 失败返回 NULL。
+ */
+audio_ring_t* audio_ring_create(uint32_t capacity_frames, uint32_t frame_bytes);
+void audio_ring_destroy(audio_ring_t* ring);
+
+uint32_t audio_ring_capacity(const audio_ring_t* ring);
+uint32_t audio_ring_frame_bytes(const audio_ring_t* ring);
+
+/* 已写入的总帧数（单调递增） */
+uint64_t audio_ring_written(const audio_ring_t* ring);
+
+/* 写入 frames 帧；超过容量时只保留最后 capacity 帧 */
+void audio_ring_write(audio_ring_t* ring, const void* data, uint32_t frames);
+
+/* 读者从当前写入位置开始读（不读历史数据） */
+void audio_ring_reader_init(audio_ring_reader_t* reader, audio_ring_t* ring);
+
+/* 可读帧数（已按容量截断） */
+uint32_t audio_ring_available(const audio_ring_reader_t* reader);
+
+/* 填充率（可读帧数 / 容量，千分比），用于观察读者是否跟得上 */
+uint32_t audio_ring_fill_permille(const audio_ring_reader_t* reader);
+
+/*
+ * 最多读取 max_frames 帧到 dst，返回实际读取的帧数。
+ * 读者落后或拷贝期间被覆盖时，丢弃无效部分并计入 overruns/lost_frames。
+ */
+uint32_t audio_ring_read(audio_ring_reader_t* reader, void* dst, uint32_t max_frames);
+
+/* 跳过积压数据，只保留最近 keep_frames 帧（对实时性敏感的读者在卡顿后调用） */
+void audio_ring_reader_skip(audio_ring_reader_t* reader, uint32_t keep_frames);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // KTVLV_CORE_AUDIO_RING_H
@@ -0,0 +1,390 @@
+/**
+ * @file lv_mem_pool.c
+ * @brief LVGL 专用 TLSF 内存池实现
+ *
+ * 块布局：[块头 | 负载]，块头记录物理前驱、负载大小、标签和状态；
+ * 空闲块在负载区存放空闲链表指针。内存区末尾放一个大小为 0 的已用哨兵块，
+ * 物理遍历和向后合并都不需要越界判断。
+ */
+
+#include "lv_mem_pool.h"
+#include <stdbool.h>
+#include <string.h>
+#include <syslog.h>
+
+#define ALIGN_SIZE_LOG2 3
+#define ALIGN_SIZE (1U << ALIGN_SIZE_LOG2)
+#define ALIGN_UP(x) (((x) + (ALIGN_SIZE - 1)) & ~(size_t)(ALIGN_SIZE - 1))
+
+/* 二级索引：每个 2^n 区间再分 16 档 */
+#define SL_INDEX_COUNT_LOG2 4
+#define SL_INDEX_COUNT (1U << SL_INDEX_COUNT_LOG2)
+#define FL_INDEX_SHIFT (SL_INDEX_COUNT_LOG2 + ALIGN_SIZE_LOG2)
+#define FL_INDEX_MAX 27 /* 最大块 128MB，远大于内存池 */
+#define FL_INDEX_COUNT (FL_INDEX_MAX - FL_INDEX_SHIFT + 1)
+#define SMALL_BLOCK_SIZE (1U << FL_INDEX_SHIFT)
+
+#define BLOCK_FREE 0x1U
+
+#if KTV_LV_POOL_GUARD
+#define GUARD_MAGIC 0x4B54564CU /* "KTVL" */
+#define CANARY_SIZE 8U
+static const uint8_t kCanary[CANARY_SIZE] = {0xDE, 0xAD, 0xBE, 0xEF, 0xFE, 0xED, 0xFA, 0xCE};
+#else
+#define CANARY_SIZE 0U
+#endif
+
+typedef struct block_hdr {
+    struct block_hdr* prev_phys;
+    uint32_t size; /* 负载字节数（ALIGN_SIZE 的倍数） */
+    uint16_t tag;
+    uint16_t flags;
+#if KTV_LV_POOL_GUARD
+    uint32_t magic;
+    uint32_t seq;
+    uint32_t req; /* 申请的字节数，金丝雀紧随其后 */
+    uint32_t reserved;
+#endif
+    /* 以下两项只在空闲块中有效（与负载区重叠） */
+    struct block_hdr* next_free;
+    struct block_hdr* prev_free;
+} block_hdr;
+
+#define HDR_SIZE ALIGN_UP(offsetof(block_hdr, next_free))
+#define BLOCK_MIN_PAYLOAD ALIGN_UP(sizeof(block_hdr) - HDR_SIZE)
+
+typedef struct {
+    bool inited;
+    uint8_t* start;
+    size_t total;
+    uint32_t fl_bitmap;
+    uint32_t sl_bitmap[FL_INDEX_COUNT];
+    block_hdr* blocks[FL_INDEX_COUNT][SL_INDEX_COUNT];
+
+    size_t used;
+    size_t high_water;
+    uint32_t alloc_count;
+    uint32_t free_count;
+    uint32_t fail_count;
+    uint16_t tag;
+    size_t tag_bytes[KTV_LV_POOL_MAX_TAGS];
+    uint32_t seq;
+} pool_t;
+
+static union {
+    uint64_t align;
+    uint8_t bytes[KTV_LV_POOL_SIZE];
+} s_arena;
+
+static pool_t s_pool;
+
+/* ---------- 位运算 ---------- */
+
+static int ffs_u32(uint32_t x) { return x ? __builtin_ctz(x) : -1; }
+static int fls_size(size_t x) {
+    int bit = -1;
+    while (x) {
+        x >>= 1;
+        ++bit;
+    }
+    return bit;
+}
+
+/* ---------- 块操作 ---------- */
+
+static inline uint8_t* block_payload(block_hdr* b) { return (uint8_t*)b + HDR_SIZE; }
+static inline block_hdr* block_from_payload(void* p) { return (block_hdr*)((uint8_t*)p - HDR_SIZE); }
+static inline block_hdr* block_next(block_hdr* b) { return (block_hdr*)(block_payload(b) + b->size); }
+static inline bool block_is_free(const block_hdr* b) { return (b->flags & BLOCK_FREE) != 0; }
+static inline size_t block_footprint(const block_hdr* b) { return HDR_SIZE + b->size; }
+
+static void mapping_insert(size_t size, int* fli, int* sli) {
+    if (size < SMALL_BLOCK_SIZE) {
+        *fli = 0;
+        *sli = (int)(size / (SMALL_BLOCK_SIZE / SL_INDEX_COUNT));
+    } else {
+        int fl = fls_size(size);
+        *sli = (int)((size >> (fl - SL_INDEX_COUNT_LOG2)) ^ SL_INDEX_COUNT);
+        *fli = fl - (FL_INDEX_SHIFT - 1);
+    }
+}
+
+/* 查找时向上取整到下一档，保证档内任意块都足够大 */
+static void mapping_search(size_t size, int* fli, int* sli) {
+    if (size >= SMALL_BLOCK_SIZE) {
+        size += ((size_t)1 << (fls_size(size) - SL_INDEX_COUNT_LOG2)) - 1;
+    }
+    mapping_insert(size, fli, sli);
+}
+
+static void remove_free(block_hdr* b) {
+    int fl, sl;
+    mapping_insert(b->size, &fl, &sl);
+    if (b->prev_free) b->prev_free->next_free = b->next_free;
+    if (b->next_free) b->next_free->prev_free = b->prev_free;
+    if (s_pool.blocks[fl][sl] == b) {
+        s_pool.blocks[fl][sl] = b->next_free;
+        if (!b->next_free) {
+            s_pool.sl_bitmap[fl] &= ~(1U << sl);
+            if (!s_pool.sl_bitmap[fl]) s_pool.fl_bitmap &= ~(1U << fl);
+        }
+    }
+    b->next_free = b->prev_free = NULL;
+}
+
+static void insert_free(block_hdr* b) {
+    int fl, sl;
+    mapping_insert(b->size, &fl, &sl);
+    b->flags |= BLOCK_FREE;
+    b->prev_free = NULL;
+    b->next_free = s_pool.blocks[fl][sl];
+    if (b->next_free) b->next_free->prev_free = b;
+    s_pool.blocks[fl][sl] = b;
+    s_pool.fl_bitmap |= 1U << fl;
+    s_pool.sl_bitmap[fl] |= 1U << sl;
+}
+
+static block_hdr* find_free(size_t size) {
+    int fl, sl;
+    mapping_search(size, &fl, &sl);
+    if (fl >= FL_INDEX_COUNT) return NULL;
+
+    uint32_t sl_map = s_pool.sl_bitmap[fl] & (~0U << sl);
+    if (!sl_map) {
+        uint32_t fl_map = fl + 1 < 32 ? s_pool.fl_bitmap & (~0U << (fl + 1)) : 0;
+        if (!fl_map) return NULL;
+        fl = ffs_u32(fl_map);
+        sl_map = s_pool.sl_bitmap[fl];
+    }
+    sl = ffs_u32(sl_map);
+    return s_pool.blocks[fl][sl];
+}
+
+/* 已用块 b 尾部多出的空间切成新的空闲块（与后继空闲块合并） */
+static void split_tail(block_hdr* b, size_t size) {
+    if (b->size < size + HDR_SIZE + BLOCK_MIN_PAYLOAD) return;
+
+    block_hdr* next = block_next(b);
+    block_hdr* rest = (block_hdr*)(block_payload(b) + size);
+    rest->prev_phys = b;
+    rest->size = (uint32_t)(b->size - size - HDR_SIZE);
+    rest->tag = 0;
+    rest->flags = 0;
+    b->size = (uint32_t)size;
+    next->prev_phys = rest;
+
+    if (block_is_free(next)) {
+        remove_free(next);
+        rest->size += (uint32_t)block_footprint(next);
+        block_next(next)->prev_phys = rest;
+    }
+    insert_free(rest);
+}
+
+static void pool_init(void) {
+    s_pool.inited = true;
+    s_pool.start = s_arena.bytes;
+    s_pool.total = sizeof(s_arena.bytes) & ~(size_t)(ALIGN_SIZE - 1);
+
+    /* 一个覆盖全部空间的空闲块 + 末尾 0 大小的已用哨兵（哨兵按完整结构体预留） */
+    block_hdr* first = (block_hdr*)s_pool.start;
+    first->prev_phys = NULL;
+    first->size = (uint32_t)(s_pool.total - HDR_SIZE - ALIGN_UP(sizeof(block_hdr)));
+    first->tag = 0;
+    first->flags = 0;
+
+    block_hdr* sentinel = block_next(first);
+    sentinel->prev_phys = first;
+    sentinel->size = 0;
+    sentinel->tag = 0;
+    sentinel->flags = 0;
+
+    insert_free(first);
+}
+
+static size_t adjust_size(size_t size) {
+    size_t adjusted = ALIGN_UP(size + CANARY_SIZE);
+    return adjusted < BLOCK_MIN_PAYLOAD ? BLOCK_MIN_PAYLOAD : adjusted;
+}
+
+static void account_alloc(block_hdr* b, size_t req) {
+    b->tag = s_pool.tag;
+    s_pool.used += block_footprint(b);
+    if (s_pool.used > s_pool.high_water) s_pool.high_water = s_pool.used;
+    s_pool.tag_bytes[b->tag] += block_footprint(b);
+#if KTV_LV_POOL_GUARD
+    b->magic = GUARD_MAGIC;
+    b->seq = ++s_pool.seq;
+    b->req = (uint32_t)req;
+    memcpy(block_payload(b) + req, kCanary, CANARY_SIZE);
+#else
+    (void)req;
+#endif
+}
+
+static void account_free(block_hdr* b) {
+    s_pool.used -= block_footprint(b);
+    s_pool.tag_bytes[b->tag] -= block_footprint(b);
+}
+
+#if KTV_LV_POOL_GUARD
+static bool guard_check(block_hdr* b, const char* op) {
+    if (b->magic != GUARD_MAGIC || block_is_free(b)) {
+        syslog(LOG_ERR, "[ktv][mem][guard] op=%s ptr=%p reason=bad_header", op, (void*)block_payload(b));
+        return false;
+    }
+    if (memcmp(block_payload(b) + b->req, kCanary, CANARY_SIZE) != 0) {
+        syslog(LOG_ERR, "[ktv][mem][guard] op=%s ptr=%p size=%u seq=%u tag=%u reason=overflow", op,
+               (void*)block_payload(b), (unsigned)b->req, (unsigned)b->seq, (unsigned)b->tag);
+    }
+    return true;
+}
+#endif
+
+/* ---------- 对外接口 ---------- */
+
+void* ktv_lv_pool_alloc(size_t size) {
+    if (!s_pool.inited) pool_init();
+
+    size_t adjusted = adjust_size(size);
+    block_hdr* b = adjusted <= UINT32_MAX ? find_free(adjusted) : NULL;
+    if (!b) {
+        ++s_pool.fail_count;
+        syslog(LOG_ERR, "[ktv][mem][pool] action=alloc size=%zu used=%zu total=%zu reason=exhausted", size,
+               s_pool.used, s_pool.total);
+        return NULL;
+    }
+    remove_free(b);
+    b->flags &= ~BLOCK_FREE;
+    split_tail(b, adjusted);
+    account_alloc(b, size);
+    ++s_pool.alloc_count;
+    return block_payload(b);
+}
+
+void ktv_lv_pool_free(void* ptr) {
+    if (!ptr) return;
+    block_hdr* b = block_from_payload(ptr);
+#if KTV_LV_POOL_GUARD
+    if (!guard_check(b, "free")) return;
+    b->magic = 0;
+#endif
+    account_free(b);
+    ++s_pool.free_count;
+
+    /* 与物理前驱、后继空闲块合并 */
+    block_hdr* prev = b->prev_phys;
+    if (prev && block_is_free(prev)) {
+        remove_free(prev);
+        prev->size += (uint32_t)block_footprint(b);
+        block_next(prev)->prev_phys = prev;
+        b = prev;
+    }
+    block_hdr* next = block_next(b);
+    if (block_is_free(next)) {
+        remove_free(next);
+        b->size += (uint32_t)block_footprint(next);
+        block_next(b)->prev_phys = b;
+    }
+    insert_free(b);
+}
+
+void* ktv_lv_pool_realloc(void* ptr, size_t size) {
+    if (!ptr) return ktv_lv_pool_alloc(size);
+    if (size == 0) {
+        ktv_lv_pool_free(ptr);
+        return NULL;
+    }
+
+    block_hdr* b = block_from_payload(ptr);
+#if KTV_LV_POOL_GUARD
+    if (!guard_check(b, "realloc")) return NULL;
+    const size_t old_req = b->req;
+#else
+    const size_t old_req = b->size;
+#endif
+    size_t adjusted = adjust_size(size);
+    block_hdr* next = block_next(b);
+
+    if (adjusted <= b->size ||
+        (block_is_free(next) && adjusted <= (size_t)b->size + block_footprint(next))) {
+        /* 原地扩展/收缩：吸收后继空闲块，再把多余部分切回去 */
+        account_free(b);
+        if (adjusted > b->size) {
+            remove_free(next);
+            b->size += (uint32_t)block_footprint(next);
+            block_next(b)->prev_phys = b;
+        }
+        split_tail(b, adjusted);
+        uint16_t tag = s_pool.tag;
+        s_pool.tag = b->tag; /* 原地调整不改变记账标签 */
+        account_alloc(b, size);
+        s_pool.tag = tag;
+        return ptr;
+    }
+
+    void* fresh = ktv_lv_pool_alloc(size);
+    if (!fresh) return NULL;
+    memcpy(fresh, ptr, old_req < size ? old_req : size);
+    ktv_lv_pool_free(ptr);
+    return fresh;
+}
+
+void ktv_lv_pool_get_stats(ktv_lv_pool_stats_t* out) {
+    if (!out) return;
+    if (!s_pool.inited) pool_init();
+    memset(out, 0, sizeof(*out));
+    out->total = s_pool.total;
+    out->used = s_pool.used;
+    out->high_water = s_pool.high_water;
+    out->alloc_count = s_pool.alloc_count;
+    out->free_count = s_pool.free_count;
+    out->fail_count = s_pool.fail_count;
+
+    for (block_hdr* b = (block_hdr*)s_pool.start; b->size; b = block_next(b)) {
+        if (block_is_free(b)) {
+            ++out->free_blocks;
+            out->free_bytes += b->size;
+            if (b->size > out->largest_free) out->largest_free = b->size;
+        } else {
+            ++out->used_blocks;
+        }
+    }
+    out->frag_pct = out->free_bytes ? (uint8_t)(100 - out->largest_free * 100 / out->free_bytes) : 0;
+}
+
+uint16_t ktv_lv_pool_set_tag(uint16_t tag) {
+    uint16_t prev = s_pool.tag;
+    s_pool.tag = tag < KTV_LV_POOL_MAX_TAGS ? tag : 0;
+    return prev;
+}
+
+size_t ktv_lv_pool_tag_bytes(uint16_t tag) {
+    return tag < KTV_LV_POOL_MAX_TAGS ? s_pool.tag_bytes[tag] : 0;
+}
+
+uint32_t ktv_lv_pool_checkpoint(void) {
+    return s_pool.seq;
+}
+
+uint32_t ktv_lv_pool_report_leaks(uint32_t since, uint32_t max_log) {
+#if KTV_LV_POOL_GUARD
+    if (!s_pool.inited) return 0;
+    uint32_t live = 0;
+    for (block_hdr* b = (block_hdr*)s_pool.start; b->size; b = block_next(b)) {
+        if (block_is_free(b)) continue;
+        guard_check(b, "scan");
+        if (b->seq <= since) continue;
+        if (live < max_log) {
+            syslog(LOG_WARNING, "[ktv][mem][leak] ptr=%p size=%u seq=%u tag=%u", (void*)block_payload(b),
+                   (unsigned)b->req, (unsigned)b->seq, (unsigned)b->tag);
+        }
+        ++live;
+    }
+    return live;
+#else
+    (void)since;
+    (void)max_log;
+    return 0;
+#endif
+}
@@ -0,0 +1,77 @@
+/**
+ * @file lv_mem_pool.h
+ * @brief LVGL 专用内存池（TLSF），通过 lv_conf.h 的 LV_MEM_CUSTOM_* 接入
+ *
+ * - 固定大小的静态内存区，与 C++ 侧 new/malloc 的堆隔离，页面反复重建不会碎片化系统堆
+ * - TLSF（两级位图 + 分级空闲链表）：分配/释放 O(1)，相邻空闲块立即合并
+ * - 统计：已用/峰值/最大空闲块/碎片率，分配按标签（页面）记账
+ * - KTV_LV_POOL_GUARD=1 时每块带魔数、尾部金丝雀和分配序号，用于长稳测试查泄漏/越界
+ *
+ * 调用线程：与 LVGL 相同，只能在 UI 线程调用（内部不加锁）
+ */
+
+#ifndef KTVLV_CORE_LV_MEM_POOL_H
+#define KTVLV_CORE_LV_MEM_POOL_H
+
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/* 内存池大小（字节），可在编译选项中覆盖 */
+#ifndef KTV_LV_POOL_SIZE
+#define KTV_LV_POOL_SIZE (4U * 1024U * 1024U)
+#endif
+
+/* 守护模式：默认关闭（每块额外 16 字节头 + 8 字节金丝雀） */
+#ifndef KTV_LV_POOL_GUARD
+#define KTV_LV_POOL_GUARD 0
+#endif
+
+/* 记账标签数：0 为全局，其余由调用方分配（PageManager 按页面使用） */
+#define KTV_LV_POOL_MAX_TAGS 16
+
+typedef struct {
+    size_t total;           /* 内存池总字节数 */
+    size_t used;            /* 已分配（含块头） */
+    size_t high_water;      /* 历史峰值 */
+    size_t free_bytes;      /* 空闲字节 */
+    size_t largest_free;    /* 最大空闲块 */
+    uint32_t used_blocks;
+    uint32_t free_blocks;
+    uint8_t frag_pct;       /* 100 - 最大空闲块 / 空闲总量 */
+    uint32_t alloc_count;   /* 累计分配次数 */
+    uint32_t free_count;    /* 累计释放次数 */
+    uint32_t fail_count;    /* 分配失败次数（池耗尽） */
+} ktv_lv_pool_stats_t;
+
+/* LV_MEM_CUSTOM_ALLOC / FREE / REALLOC */
+void* ktv_lv_pool_alloc(size_t size);
+void ktv_lv_pool_free(void* ptr);
+void* ktv_lv_pool_realloc(void* ptr, size_t size);
+
+/* 统计（遍历整个内存池，适合低频调用） */
+void ktv_lv_pool_get_stats(ktv_lv_pool_stats_t* out);
+
+/* 设置之后分配所记的标签，返回之前的标签；超出范围记到 0 */
+uint16_t ktv_lv_pool_set_tag(uint16_t tag);
+
+/* 标签下当前存活的字节数（含块头） */
+size_t ktv_lv_pool_tag_bytes(uint16_t tag);
+
+/* 守护模式：返回当前分配序号，作为泄漏检查的起点 */
+uint32_t ktv_lv_pool_checkpoint(void);
+
+/*
+ * 守护模式：输出序号大于 since 且仍未释放的块（最多 max_log 条 syslog），
+ * 并校验所有已分配块的金丝雀；返回存活块数。未开启守护模式时返回 0。
+ */
+uint32_t ktv_lv_pool_report_leaks(uint32_t since, uint32_t max_log);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // KTVLV_CORE_LV_MEM_POOL_H
@@ -8,7 +8,12 @@
 
 // ✅ Step1修复：强制使用 32bit 颜色深度，确保与 SDL ARGB8888 匹配
 #define LV_COLOR_DEPTH 32
-#define LV_MEM_CUSTOM 0
+// LVGL 使用独立的 TLSF 内存池（core/lv_mem_pool.c），与 C++ 堆隔离，带峰值/碎片/按页面统计
+#define LV_MEM_CUSTOM 1
+#define LV_MEM_CUSTOM_INCLUDE "lv_mem_pool.h"
+#define LV_MEM_CUSTOM_ALLOC   ktv_lv_pool_alloc
+#define LV_MEM_CUSTOM_FREE    ktv_lv_pool_free
+#define LV_MEM_CUSTOM_REALLOC ktv_lv_pool_realloc
 #define LV_USE_LOG 1
 
 // ✅ 关键修复：禁用所有 GPU/SDL 渲染器，确保使用自定义 flush_cb
@@ -17,6 +22,15 @@
 #define LV_USE_SDL_RENDER 0
 #define LV_USE_PERF_MONITOR 0
 
+/* 字号：StyleRegistry::font() 按缩放后的设计字号选择最接近的一档 */
+#define LV_FONT_MONTSERRAT_12 1
+#define LV_FONT_MONTSERRAT_14 1
+#define LV_FONT_MONTSERRAT_16 1
+#define LV_FONT_MONTSERRAT_20 1
+#define LV_FONT_MONTSERRAT_24 1
+#define LV_FONT_MONTSERRAT_28 1
+#define LV_FONT_MONTSERRAT_32 1
+
 // ✅ 确保使用软件渲染路径
 #define LV_COLOR_16_SWAP 0
 
@@ -1,69 +1,223 @@
 /**
  * @file audio_alsa.c
  * @brief F133 Linux 平台音频驱动实现（ALSA）
- * 
+ *
  * 功能：
  * - 系统音效播放（可选，当前为 stub）
- * - 录音功能（未来：语音点歌、唱歌打分）
- * 
+ * - 录音功能（唱歌打分、人声监听等）
+ * - 人声监听：录音 → 回声/混响/限幅 → 播放
+ *
+ * 录音数据流：
+ * - 录音线程（SCHED_FIFO）以较小的周期 mmap 读取（snd_pcm_mmap_begin/commit），
+ *   直接写入无锁环形缓冲（core/audio_ring.h），不调用任何用户代码
+ * - 消费者（音高分析、混音等）各自挂读者按自己的节奏读取，慢消费者只会丢自己的数据，
+ *   不会造成硬件 overrun
+ * - start_record 传入的回调由单独的分发线程调用（同样是环形缓冲的一个读者）
+ * - 人声监听（可选）：监听线程也是一个读者，经 core/audio_fx 效果链写到播放设备，
+ *   以小周期 + 两周期播放缓冲把往返延迟压在 10 ms 量级
+ *
  * 注意：
  * - 播放器音频由 TPlayer 直接处理，不经过此接口
  * - 如果不需要系统音效，play_sound 保持为 stub
- * - 录音功能需要 ALSA 库（libasound2）
+ * - 录音功能需要 ALSA 库（libasound2），编译时定义 KTV_USE_ALSA_RECORD
  */
 
+#define _GNU_SOURCE   /* pthread_setname_np */
+
 #include "drivers/audio_driver.h"
+#include "platform/f133_linux/audio_alsa.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
+#include <stdatomic.h>
 #include <pthread.h>
+#include <sched.h>
+#include <time.h>
+#include <unistd.h>
+
+#define CAPTURE_THREAD_PRIORITY 20   // 高于输入读取线程
+#define CAPTURE_WAIT_TIMEOUT_MS 100  // snd_pcm_wait 超时，保证停止时能及时退出
+
+static char capture_device[64] = "hw:0,0";
+static uint32_t capture_period_frames = 128;
+static uint32_t capture_periods = 4;
+static uint32_t capture_ring_ms = 500;
+
+static char monitor_device[64] = "hw:0,0";
+static bool monitor_enabled = false;
+static uint32_t monitor_period_frames = 64;
+static uint32_t monitor_periods = 2;
+static uint32_t monitor_channels = 2;
+static uint32_t monitor_target_ms = 20;
+
+static atomic_bool is_recording = false;
+static atomic_bool stop_requested = false;   // 回调返回 false 时请求停止
+
+static struct {
+    atomic_uint xruns;
+    atomic_uint suspends;
+    atomic_uint wakeups;
+    atomic_ullong frames;
+    atomic_uint hw_fill_max;
+    atomic_uint callback_fill;
+    atomic_uint callback_overruns;
+} capture_stats;
 
 #ifdef KTV_USE_ALSA_RECORD
 #include <alsa/asoundlib.h>
 
 // 录音相关状态
 static snd_pcm_t *capture_handle = NULL;
-static bool is_recording = false;
+static audio_ring_t *capture_ring = NULL;
 static audio_record_callback_t record_callback = NULL;
 static void* record_user_data = NULL;
 static pthread_t record_thread = 0;
+static pthread_t dispatch_thread = 0;
 static int record_sample_rate = 16000;
 static int record_channels = 1;
 static snd_pcm_format_t record_format = SND_PCM_FORMAT_S16_LE;
+static bool capture_mmap = true;
+static snd_pcm_uframes_t capture_period_size = 0;
+static snd_pcm_uframes_t capture_buffer_size = 0;
+
+// xrun / 挂起恢复：失败返回负的错误码
+static int capture_recover(int err) {
+    if (err == -EPIPE) {
+        atomic_fetch_add(&capture_stats.xruns, 1);
+        err = snd_pcm_prepare(capture_handle);
+        if (err == 0) err = snd_pcm_start(capture_handle);
+        return err;
+    }
+    if (err == -ESTRPIPE) {
+        atomic_fetch_add(&capture_stats.suspends, 1);
+        while ((err = snd_pcm_resume(capture_handle)) == -EAGAIN) usleep(10000);
+        if (err < 0) {
+            err = snd_pcm_prepare(capture_handle);
+            if (err == 0) err = snd_pcm_start(capture_handle);
+        }
+        return err;
+    }
+    return err;
+}
+
+static void note_hw_fill(snd_pcm_sframes_t avail) {
+    if (capture_buffer_size == 0) return;
+    uint32_t fill = (uint32_t)((uint64_t)avail * 1000U / capture_buffer_size);
+    if (fill > atomic_load_explicit(&capture_stats.hw_fill_max, memory_order_relaxed)) {
+        atomic_store_explicit(&capture_stats.hw_fill_max, fill, memory_order_relaxed);
+    }
+}
 
-// 录音线程函数
+// mmap 读取一批：直接从 DMA 缓冲拷进环形缓冲，没有中间缓冲
+static int capture_mmap_chunk(snd_pcm_uframes_t avail) {
+    while (avail > 0) {
+        const snd_pcm_channel_area_t *areas;
+        snd_pcm_uframes_t offset;
+        snd_pcm_uframes_t frames = avail;
+        int err = snd_pcm_mmap_begin(capture_handle, &areas, &offset, &frames);
+        if (err < 0) return err;
+        // 交错格式：所有声道从 areas[0] 开始，step 为一帧的位数
+        const uint8_t *src = (const uint8_t *)areas[0].addr + (areas[0].first + offset * areas[0].step) / 8;
+        audio_ring_write(capture_ring, src, (uint32_t)frames);
+        snd_pcm_sframes_t committed = snd_pcm_mmap_commit(capture_handle, offset, frames);
+        if (committed < 0) return (int)committed;
+        if ((snd_pcm_uframes_t)committed != frames) return -EPIPE;
+        atomic_fetch_add_explicit(&capture_stats.frames, (unsigned long long)frames, memory_order_relaxed);
+        avail -= frames;
+    }
+    return 0;
+}
+
+// 驱动不支持 mmap 时的退化路径
+static int capture_read_chunk(void *buffer, snd_pcm_uframes_t avail) {
+    while (avail > 0) {
+        snd_pcm_uframes_t frames = avail < capture_period_size ? avail : capture_period_size;
+        snd_pcm_sframes_t n = snd_pcm_readi(capture_handle, buffer, frames);
+        if (n < 0) return (int)n;
+        audio_ring_write(capture_ring, buffer, (uint32_t)n);
+        atomic_fetch_add_explicit(&capture_stats.frames, (unsigned long long)n, memory_order_relaxed);
+        avail -= (snd_pcm_uframes_t)n;
+    }
+    return 0;
+}
+
+// 录音线程函数：只搬运数据，不调用用户代码
 static void* record_thread_func(void* arg) {
-    snd_pcm_uframes_t frames = 1024;
-    size_t frame_size = snd_pcm_format_physical_width(record_format) / 8 * record_channels;
-    char *buffer = malloc(frames * frame_size);
-    
-    if (!buffer) {
-        fprintf(stderr, "[ALSA] Failed to allocate record buffer\n");
-        return NULL;
+    (void)arg;
+    void *buffer = NULL;
+    if (!capture_mmap) {
+        buffer = malloc(capture_period_size * audio_ring_frame_bytes(capture_ring));
+        if (!buffer) {
+            fprintf(stderr, "[ALSA] Failed to allocate record buffer\n");
+            return NULL;
+        }
     }
-    
-    while (is_recording) {
-        snd_pcm_sframes_t read_frames = snd_pcm_readi(capture_handle, buffer, frames);
-        if (read_frames < 0) {
-            // 处理错误（如 underrun）
-            if (read_frames == -EPIPE) {
-                snd_pcm_prepare(capture_handle);
-            } else {
-                fprintf(stderr, "[ALSA] Read error: %s\n", snd_strerror(read_frames));
+
+    int err = snd_pcm_start(capture_handle);
+    if (err < 0) fprintf(stderr, "[ALSA] snd_pcm_start failed: %s\n", snd_strerror(err));
+
+    while (atomic_load(&is_recording) && !atomic_load(&stop_requested)) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(capture_handle);
+        if (avail < 0) {
+            err = capture_recover((int)avail);
+            if (err < 0) {
+                fprintf(stderr, "[ALSA] Capture recover failed: %s\n", snd_strerror(err));
                 break;
             }
-        } else if (read_frames > 0) {
-            // 调用回调函数处理录音数据
-            if (record_callback) {
-                size_t data_size = read_frames * frame_size;
-                if (!record_callback(buffer, data_size, record_user_data)) {
-                    // 回调返回 false，停止录音
-                    break;
-                }
+            continue;
+        }
+        if ((snd_pcm_uframes_t)avail < capture_period_size) {
+            err = snd_pcm_wait(capture_handle, CAPTURE_WAIT_TIMEOUT_MS);
+            if (err < 0 && (err = capture_recover(err)) < 0) {
+                fprintf(stderr, "[ALSA] Capture wait failed: %s\n", snd_strerror(err));
+                break;
             }
+            continue;
         }
+
+        atomic_fetch_add_explicit(&capture_stats.wakeups, 1, memory_order_relaxed);
+        note_hw_fill(avail);
+        err = capture_mmap ? capture_mmap_chunk((snd_pcm_uframes_t)avail)
+                           : capture_read_chunk(buffer, (snd_pcm_uframes_t)avail);
+        if (err < 0 && (err = capture_recover(err)) < 0) {
+            fprintf(stderr, "[ALSA] Capture error: %s\n", snd_strerror(err));
+            break;
+        }
+    }
+
+    snd_pcm_drop(capture_handle);
+    free(buffer);
+    return NULL;
+}
+
+// 回调分发线程：环形缓冲的一个普通读者，回调慢只会让自己丢数据
+static void* dispatch_thread_func(void* arg) {
+    (void)arg;
+    uint32_t frame_bytes = audio_ring_frame_bytes(capture_ring);
+    uint32_t chunk = (uint32_t)capture_period_size;
+    void *buffer = malloc((size_t)chunk * frame_bytes);
+    if (!buffer) {
+        fprintf(stderr, "[ALSA] Failed to allocate dispatch buffer\n");
+        return NULL;
     }
-    
+    useconds_t idle_us = (useconds_t)((uint64_t)chunk * 1000000ULL / (uint32_t)record_sample_rate / 2);
+
+    audio_ring_reader_t reader;
+    audio_ring_reader_init(&reader, capture_ring);
+    while (atomic_load(&is_recording) && !atomic_load(&stop_requested)) {
+        atomic_store_explicit(&capture_stats.callback_fill, audio_ring_fill_permille(&reader), memory_order_relaxed);
+        uint32_t n = audio_ring_read(&reader, buffer, chunk);
+        atomic_store_explicit(&capture_stats.callback_overruns, reader.overruns, memory_order_relaxed);
+        if (n == 0) {
+            usleep(idle_us);
+            continue;
+        }
+        if (!record_callback(buffer, (size_t)n * frame_bytes, record_user_data)) {
+            // 回调返回 false，停止录音（资源在 stop_record 中释放）
+            atomic_store(&stop_requested, true);
+        }
+    }
+
     free(buffer);
     return NULL;
 }
@@ -82,104 +236,170 @@ static bool audio_alsa_play_sound(uint32_t sound_id) {
 }
 
 #ifdef KTV_USE_ALSA_RECORD
+static void close_capture(void) {
+    if (capture_handle) {
+        snd_pcm_close(capture_handle);
+        capture_handle = NULL;
+    }
+    audio_ring_destroy(capture_ring);
+    capture_ring = NULL;
+}
+
 static bool audio_alsa_start_record(int sample_rate, int channels, int format,
                                     audio_record_callback_t callback, void* user_data) {
-    if (is_recording) {
+    if (atomic_load(&is_recording)) {
         fprintf(stderr, "[ALSA] Already recording\n");
         return false;
     }
-    
-    // 打开录音设备（默认使用 hw:0,0，可根据实际调整）
-    int err = snd_pcm_open(&capture_handle, "hw:0,0", SND_PCM_STREAM_CAPTURE, 0);
+
+    // 打开录音设备（设备名由 alsa_capture_configure 设置，默认 hw:0,0）
+    int err = snd_pcm_open(&capture_handle, capture_device, SND_PCM_STREAM_CAPTURE, 0);
     if (err < 0) {
-        fprintf(stderr, "[ALSA] Failed to open capture device: %s\n", snd_strerror(err));
+        fprintf(stderr, "[ALSA] Failed to open capture device %s: %s\n", capture_device, snd_strerror(err));
         return false;
     }
-    
+
     // 设置硬件参数
     snd_pcm_hw_params_t *hw_params;
     snd_pcm_hw_params_alloca(&hw_params);
     snd_pcm_hw_params_any(capture_handle, hw_params);
-    snd_pcm_hw_params_set_access(capture_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
-    
+
+    // 优先 mmap，驱动不支持时退化为 readi
+    capture_mmap = snd_pcm_hw_params_set_access(capture_handle, hw_params, SND_PCM_ACCESS_MMAP_INTERLEAVED) == 0;
+    if (!capture_mmap) {
+        fprintf(stderr, "[ALSA] mmap capture not supported, falling back to readi\n");
+        snd_pcm_hw_params_set_access(capture_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    }
+
     // 设置格式
     record_format = (format == 0) ? SND_PCM_FORMAT_S16_LE : SND_PCM_FORMAT_S32_LE;
     snd_pcm_hw_params_set_format(capture_handle, hw_params, record_format);
-    
+
     // 设置采样率
     unsigned int rate = sample_rate;
     snd_pcm_hw_params_set_rate_near(capture_handle, hw_params, &rate, 0);
     record_sample_rate = rate;
-    
+
     // 设置声道数
     snd_pcm_hw_params_set_channels(capture_handle, hw_params, channels);
     record_channels = channels;
-    
+
+    // 周期：小周期降低延迟，周期数保证调度抖动时不溢出
+    snd_pcm_uframes_t period = capture_period_frames;
+    unsigned int periods = capture_periods;
+    snd_pcm_hw_params_set_period_size_near(capture_handle, hw_params, &period, 0);
+    snd_pcm_hw_params_set_periods_near(capture_handle, hw_params, &periods, 0);
+
     // 应用参数
     err = snd_pcm_hw_params(capture_handle, hw_params);
     if (err < 0) {
         fprintf(stderr, "[ALSA] Failed to set hw params: %s\n", snd_strerror(err));
-        snd_pcm_close(capture_handle);
-        capture_handle = NULL;
+        close_capture();
+        return false;
+    }
+    snd_pcm_hw_params_get_period_size(hw_params, &capture_period_size, 0);
+    snd_pcm_hw_params_get_buffer_size(hw_params, &capture_buffer_size);
+
+    // 软件参数：满一个周期唤醒；由录音线程显式 snd_pcm_start
+    snd_pcm_sw_params_t *sw_params;
+    snd_pcm_sw_params_alloca(&sw_params);
+    snd_pcm_sw_params_current(capture_handle, sw_params);
+    snd_pcm_sw_params_set_avail_min(capture_handle, sw_params, capture_period_size);
+    snd_pcm_sw_params_set_start_threshold(capture_handle, sw_params, capture_buffer_size);
+    err = snd_pcm_sw_params(capture_handle, sw_params);
+    if (err < 0) {
+        fprintf(stderr, "[ALSA] Failed to set sw params: %s\n", snd_strerror(err));
+        close_capture();
         return false;
     }
-    
+
     // 准备录音
     err = snd_pcm_prepare(capture_handle);
     if (err < 0) {
         fprintf(stderr, "[ALSA] Failed to prepare: %s\n", snd_strerror(err));
-        snd_pcm_close(capture_handle);
-        capture_handle = NULL;
+        close_capture();
+        return false;
+    }
+
+    uint32_t frame_bytes = (uint32_t)(snd_pcm_format_physical_width(record_format) / 8 * record_channels);
+    uint32_t ring_frames = (uint32_t)((uint64_t)record_sample_rate * capture_ring_ms / 1000U);
+    if (ring_frames < capture_buffer_size * 2) ring_frames = (uint32_t)capture_buffer_size * 2;
+    capture_ring = audio_ring_create(ring_frames, frame_bytes);
+    if (!capture_ring) {
+        fprintf(stderr, "[ALSA] Failed to allocate capture ring\n");
+        close_capture();
         return false;
     }
-    
+
     // 保存回调函数
     record_callback = callback;
     record_user_data = user_data;
-    is_recording = true;
-    
+    atomic_store(&stop_requested, false);
+    atomic_store(&is_recording, true);
+
     // 启动录音线程
     if (pthread_create(&record_thread, NULL, record_thread_func, NULL) != 0) {
         fprintf(stderr, "[ALSA] Failed to create record thread\n");
-        snd_pcm_close(capture_handle);
-        capture_handle = NULL;
-        is_recording = false;
+        record_thread = 0;
+        atomic_store(&is_recording, false);
+        close_capture();
         return false;
     }
-    
-    fprintf(stderr, "[ALSA] Recording started: %dHz, %dch, format=%d\n",
-            record_sample_rate, record_channels, format);
+    struct sched_param sp;
+    sp.sched_priority = CAPTURE_THREAD_PRIORITY;
+    if (pthread_setschedparam(record_thread, SCHED_FIFO, &sp) != 0) {
+        fprintf(stderr, "[ALSA] Warning: SCHED_FIFO unavailable for record thread\n");
+    }
+    pthread_setname_np(record_thread, "ktv_capture");
+
+    if (record_callback && pthread_create(&dispatch_thread, NULL, dispatch_thread_func, NULL) != 0) {
+        fprintf(stderr, "[ALSA] Warning: failed to create dispatch thread, callback disabled\n");
+        dispatch_thread = 0;
+    }
+
+    fprintf(stderr, "[ALSA] Recording started: %dHz, %dch, format=%d, %s, period=%lu buffer=%lu ring=%u\n",
+            record_sample_rate, record_channels, format, capture_mmap ? "mmap" : "readi",
+            (unsigned long)capture_period_size, (unsigned long)capture_buffer_size,
+            audio_ring_capacity(capture_ring));
+    if (monitor_enabled) alsa_monitor_start();
     return true;
 }
 
 static bool audio_alsa_stop_record(void) {
-    if (!is_recording) {
+    if (!atomic_load(&is_recording)) {
         return false;
     }
-    
-    is_recording = false;
-    
-    // 等待录音线程结束
+
+    // 监听线程读环形缓冲，必须先于环形缓冲销毁停止
+    alsa_monitor_stop();
+    atomic_store(&is_recording, false);
+
+    // 等待录音线程和分发线程结束
     if (record_thread) {
         pthread_join(record_thread, NULL);
         record_thread = 0;
     }
-    
-    // 关闭设备
-    if (capture_handle) {
-        snd_pcm_close(capture_handle);
-        capture_handle = NULL;
+    if (dispatch_thread) {
+        pthread_join(dispatch_thread, NULL);
+        dispatch_thread = 0;
     }
-    
+
+    // 关闭设备、释放环形缓冲
+    close_capture();
+
     record_callback = NULL;
     record_user_data = NULL;
-    
-    fprintf(stderr, "[ALSA] Recording stopped\n");
+
+    fprintf(stderr, "[ALSA] Recording stopped (xruns=%u)\n", atomic_load(&capture_stats.xruns));
     return true;
 }
 
 static bool audio_alsa_is_recording(void) {
-    return is_recording;
+    return atomic_load(&is_recording) && !atomic_load(&stop_requested);
+}
+
+audio_ring_t *alsa_capture_ring(void) {
+    return atomic_load(&is_recording) ? capture_ring : NULL;
 }
 #else
 // 未启用录音功能时的 stub 实现
@@ -198,11 +418,456 @@ static bool audio_alsa_stop_record(void) {
 static bool audio_alsa_is_recording(void) {
     return false;
 }
+
+audio_ring_t *alsa_capture_ring(void) {
+    return NULL;
+}
 #endif
 
+// ------------------------------------------------------------------
+// 人声监听：录音环形缓冲的一个读者 → 效果链 → 播放设备
+//
+// 监听线程以播放设备为时钟：每当播放缓冲空出一个周期，就从环形缓冲取一个周期的数据。
+// 录音周期与监听周期可以不同，开头先攒够一个录音周期作为抖动余量，之后积压超过
+// 目标延迟就丢弃旧数据追上（宁可丢一点也不让延迟累积）。
+// ------------------------------------------------------------------
+
+#define MONITOR_THREAD_PRIORITY 20   // 与录音线程同级
+#define MONITOR_MEASURE_TIMEOUT_US 1000000
+#define MONITOR_PULSE_FRAMES 16
+#define MONITOR_PULSE_LEVEL 28000
+#define MONITOR_DETECT_LEVEL 12000
+
+enum { MEASURE_IDLE = 0, MEASURE_REQUESTED, MEASURE_WAITING };
+
+// 只保护启停与效果链指针的生命周期，监听线程从不获取
+static pthread_mutex_t monitor_lock = PTHREAD_MUTEX_INITIALIZER;
+static audio_fx_params_t monitor_fx_params;
+static bool monitor_fx_params_set = false;
+static atomic_bool monitor_running = false;
+
+static struct {
+    atomic_uint underruns;
+    atomic_uint starved;
+    atomic_ullong dropped_frames;
+    atomic_uint latency_est_us;
+    atomic_uint latency_est_max_us;
+    atomic_int latency_measured_us;
+    atomic_uint dsp_load_pct;
+} monitor_stats = {.latency_measured_us = -1};
+
+#ifdef KTV_USE_ALSA_RECORD
+static snd_pcm_t *playback_handle = NULL;
+static pthread_t monitor_thread = 0;
+static audio_fx_t *monitor_fx = NULL;
+static snd_pcm_uframes_t monitor_period_size = 0;
+static snd_pcm_uframes_t monitor_buffer_size = 0;
+static atomic_int monitor_measure = MEASURE_IDLE;
+
+static uint64_t monotonic_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static int playback_recover(int err) {
+    if (err == -EPIPE) {
+        atomic_fetch_add(&monitor_stats.underruns, 1);
+        return snd_pcm_prepare(playback_handle);
+    }
+    if (err == -ESTRPIPE) {
+        while ((err = snd_pcm_resume(playback_handle)) == -EAGAIN) usleep(10000);
+        if (err < 0) err = snd_pcm_prepare(playback_handle);
+        return err;
+    }
+    return err;
+}
+
+// 录音格式（S16/S32、任意声道）→ 单声道 S16
+static void capture_to_mono(const void *src, int16_t *dst, uint32_t frames) {
+    const int ch = record_channels;
+    if (record_format == SND_PCM_FORMAT_S16_LE) {
+        const int16_t *p = (const int16_t *)src;
+        for (uint32_t i = 0; i < frames; ++i, p += ch) {
+            int32_t acc = 0;
+            for (int c = 0; c < ch; ++c) acc += p[c];
+            dst[i] = (int16_t)(acc / ch);
+        }
+    } else {
+        const int32_t *p = (const int32_t *)src;
+        for (uint32_t i = 0; i < frames; ++i, p += ch) {
+            int32_t acc = 0;
+            for (int c = 0; c < ch; ++c) acc += p[c] >> 16;
+            dst[i] = (int16_t)(acc / ch);
+        }
+    }
+}
+
+// 回环实测：在录音数据中找脉冲，换算成从写入播放缓冲到被录到的时间
+static void measure_detect(const int16_t *mono, uint32_t frames, uint32_t backlog, uint64_t inject_us) {
+    uint64_t now = monotonic_us();
+    for (uint32_t i = 0; i < frames; ++i) {
+        if (mono[i] > MONITOR_DETECT_LEVEL || mono[i] < -MONITOR_DETECT_LEVEL) {
+            // 第 i 帧之后的数据（本块剩余 + 环形缓冲积压）都比它晚到
+            uint64_t later_us = (uint64_t)(frames - i + backlog) * 1000000ULL / (uint32_t)record_sample_rate;
+            uint64_t elapsed = now - inject_us;
+            int32_t us = elapsed > later_us ? (int32_t)(elapsed - later_us) : 0;
+            atomic_store(&monitor_stats.latency_measured_us, us);
+            atomic_store(&monitor_measure, MEASURE_IDLE);
+            fprintf(stderr, "[ALSA] Monitor round-trip latency measured: %.2f ms\n", us / 1000.0);
+            return;
+        }
+    }
+    if (now - inject_us > MONITOR_MEASURE_TIMEOUT_US) {
+        atomic_store(&monitor_stats.latency_measured_us, -1);
+        atomic_store(&monitor_measure, MEASURE_IDLE);
+        fprintf(stderr, "[ALSA] Monitor latency measurement timed out (no loopback path?)\n");
+    }
+}
+
+static void* monitor_thread_func(void* arg) {
+    (void)arg;
+    const uint32_t period = (uint32_t)monitor_period_size;
+    const uint32_t out_ch = monitor_channels;
+    const uint32_t reserve = (uint32_t)capture_period_size;   // 抖动余量：一个录音周期
+    uint32_t keep = (uint32_t)((uint64_t)record_sample_rate * monitor_target_ms / 1000U);
+    if (keep < reserve + period) keep = reserve + period;
+
+    uint8_t *raw = malloc((size_t)period * audio_ring_frame_bytes(capture_ring));
+    int16_t *mono = malloc((size_t)period * sizeof(int16_t));
+    int16_t *out = malloc((size_t)period * out_ch * sizeof(int16_t));
+    if (!raw || !mono || !out) {
+        fprintf(stderr, "[ALSA] Failed to allocate monitor buffers\n");
+        free(raw);
+        free(mono);
+        free(out);
+        return NULL;
+    }
+
+    audio_ring_reader_t reader;
+    audio_ring_reader_init(&reader, capture_ring);
+    bool primed = false;
+    uint64_t inject_us = 0;
+    uint64_t busy_us = 0, span_us = 0;
+    const uint64_t period_us = (uint64_t)period * 1000000ULL / (uint32_t)record_sample_rate;
+
+    // 先写一个周期的静音，达到 start_threshold 后播放开始计时
+    memset(out, 0, (size_t)period * out_ch * sizeof(int16_t));
+    snd_pcm_writei(playback_handle, out, period);
+
+    while (atomic_load(&monitor_running)) {
+        snd_pcm_sframes_t avail = snd_pcm_avail_update(playback_handle);
+        if (avail < 0) {
+            int err = playback_recover((int)avail);
+            if (err < 0) {
+                fprintf(stderr, "[ALSA] Monitor recover failed: %s\n", snd_strerror(err));
+                break;
+            }
+            primed = false;
+            continue;
+        }
+        if ((snd_pcm_uframes_t)avail < period) {
+            int err = snd_pcm_wait(playback_handle, CAPTURE_WAIT_TIMEOUT_MS);
+            if (err < 0 && (err = playback_recover(err)) < 0) {
+                fprintf(stderr, "[ALSA] Monitor wait failed: %s\n", snd_strerror(err));
+                break;
+            }
+            continue;
+        }
+
+        uint32_t backlog = audio_ring_available(&reader);
+        if (!primed && backlog >= reserve) primed = true;
+        if (primed && backlog > keep) {
+            audio_ring_reader_skip(&reader, reserve);
+            atomic_fetch_add_explicit(&monitor_stats.dropped_frames, backlog - reserve, memory_order_relaxed);
+            backlog = reserve;
+        }
+
+        uint32_t got = primed ? audio_ring_read(&reader, raw, period) : 0;
+        if (primed && got < period) {
+            atomic_fetch_add_explicit(&monitor_stats.starved, 1, memory_order_relaxed);
+            primed = false;   // 重新攒够余量再继续
+        }
+        capture_to_mono(raw, mono, got);
+        memset(mono + got, 0, (size_t)(period - got) * sizeof(int16_t));
+
+        int measure = atomic_load(&monitor_measure);
+        if (measure == MEASURE_WAITING) measure_detect(mono, got, audio_ring_available(&reader), inject_us);
+
+        uint64_t t0 = monotonic_us();
+        audio_fx_process(monitor_fx, mono, mono, period);
+        busy_us += monotonic_us() - t0;
+        span_us += period_us;
+        if (span_us >= 1000000ULL) {
+            atomic_store_explicit(&monitor_stats.dsp_load_pct, (uint32_t)(busy_us * 100 / span_us),
+                                  memory_order_relaxed);
+            busy_us = span_us = 0;
+        }
+
+        // 测量期间静音，避免监听声音经回环再次被检测到
+        if (measure != MEASURE_IDLE) memset(mono, 0, (size_t)period * sizeof(int16_t));
+        if (measure == MEASURE_REQUESTED) {
+            for (uint32_t i = 0; i < MONITOR_PULSE_FRAMES && i < period; ++i) mono[i] = MONITOR_PULSE_LEVEL;
+        }
+
+        for (uint32_t i = 0; i < period; ++i) {
+            for (uint32_t c = 0; c < out_ch; ++c) out[i * out_ch + c] = mono[i];
+        }
+
+        snd_pcm_sframes_t delay = 0;
+        if (snd_pcm_delay(playback_handle, &delay) < 0 || delay < 0) delay = 0;
+        snd_pcm_sframes_t n = snd_pcm_writei(playback_handle, out, period);
+        if (n < 0) {
+            int err = playback_recover((int)n);
+            if (err < 0) {
+                fprintf(stderr, "[ALSA] Monitor write failed: %s\n", snd_strerror(err));
+                break;
+            }
+            continue;
+        }
+        if (measure == MEASURE_REQUESTED) {
+            inject_us = monotonic_us();
+            atomic_store(&monitor_measure, MEASURE_WAITING);
+        }
+
+        // 估算：录音周期 + 读取前的积压 + 写入前播放缓冲中的数据
+        uint64_t est_frames = (uint64_t)capture_period_size + backlog + (uint64_t)delay;
+        uint32_t est_us = (uint32_t)(est_frames * 1000000ULL / (uint32_t)record_sample_rate);
+        atomic_store_explicit(&monitor_stats.latency_est_us, est_us, memory_order_relaxed);
+        if (est_us > atomic_load_explicit(&monitor_stats.latency_est_max_us, memory_order_relaxed)) {
+            atomic_store_explicit(&monitor_stats.latency_est_max_us, est_us, memory_order_relaxed);
+        }
+    }
+
+    snd_pcm_drop(playback_handle);
+    free(raw);
+    free(mono);
+    free(out);
+    return NULL;
+}
+
+static void close_playback(void) {
+    if (playback_handle) {
+        snd_pcm_close(playback_handle);
+        playback_handle = NULL;
+    }
+    audio_fx_destroy(monitor_fx);
+    monitor_fx = NULL;
+}
+
+static bool monitor_start_locked(void) {
+    if (atomic_load(&monitor_running)) return true;
+    if (!atomic_load(&is_recording) || !capture_ring) {
+        fprintf(stderr, "[ALSA] Monitor requires an active recording\n");
+        return false;
+    }
+
+    int err = snd_pcm_open(&playback_handle, monitor_device, SND_PCM_STREAM_PLAYBACK, 0);
+    if (err < 0) {
+        fprintf(stderr, "[ALSA] Failed to open playback device %s: %s\n", monitor_device, snd_strerror(err));
+        playback_handle = NULL;
+        return false;
+    }
+
+    snd_pcm_hw_params_t *hw_params;
+    snd_pcm_hw_params_alloca(&hw_params);
+    snd_pcm_hw_params_any(playback_handle, hw_params);
+    snd_pcm_hw_params_set_access(playback_handle, hw_params, SND_PCM_ACCESS_RW_INTERLEAVED);
+    snd_pcm_hw_params_set_format(playback_handle, hw_params, SND_PCM_FORMAT_S16_LE);
+    snd_pcm_hw_params_set_channels(playback_handle, hw_params, monitor_channels);
+    unsigned int rate = (unsigned int)record_sample_rate;
+    snd_pcm_hw_params_set_rate_near(playback_handle, hw_params, &rate, 0);
+    snd_pcm_uframes_t period = monitor_period_frames;
+    unsigned int periods = monitor_periods;
+    snd_pcm_hw_params_set_period_size_near(playback_handle, hw_params, &period, 0);
+    snd_pcm_hw_params_set_periods_near(playback_handle, hw_params, &periods, 0);
+    err = snd_pcm_hw_params(playback_handle, hw_params);
+    if (err < 0 || rate != (unsigned int)record_sample_rate) {
+        // 不做重采样：播放与录音必须同一采样率
+        fprintf(stderr, "[ALSA] Failed to set monitor hw params (rate %u vs %d): %s\n", rate, record_sample_rate,
+                err < 0 ? snd_strerror(err) : "rate mismatch");
+        close_playback();
+        return false;
+    }
+    snd_pcm_hw_params_get_period_size(hw_params, &monitor_period_size, 0);
+    snd_pcm_hw_params_get_buffer_size(hw_params, &monitor_buffer_size);
+
+    // 写满一个周期即开始播放，空出一个周期就唤醒
+    snd_pcm_sw_params_t *sw_params;
+    snd_pcm_sw_params_alloca(&sw_params);
+    snd_pcm_sw_params_current(playback_handle, sw_params);
+    snd_pcm_sw_params_set_avail_min(playback_handle, sw_params, monitor_period_size);
+    snd_pcm_sw_params_set_start_threshold(playback_handle, sw_params, monitor_period_size);
+    err = snd_pcm_sw_params(playback_handle, sw_params);
+    if (err == 0) err = snd_pcm_prepare(playback_handle);
+    if (err < 0) {
+        fprintf(stderr, "[ALSA] Failed to prepare monitor playback: %s\n", snd_strerror(err));
+        close_playback();
+        return false;
+    }
+
+    monitor_fx = audio_fx_create((uint32_t)record_sample_rate, (uint32_t)monitor_period_size);
+    if (!monitor_fx) {
+        fprintf(stderr, "[ALSA] Failed to allocate monitor effects\n");
+        close_playback();
+        return false;
+    }
+    if (monitor_fx_params_set) audio_fx_set_params(monitor_fx, &monitor_fx_params);
+
+    atomic_store(&monitor_measure, MEASURE_IDLE);
+    atomic_store(&monitor_stats.latency_est_max_us, 0);
+    atomic_store(&monitor_running, true);
+    if (pthread_create(&monitor_thread, NULL, monitor_thread_func, NULL) != 0) {
+        fprintf(stderr, "[ALSA] Failed to create monitor thread\n");
+        monitor_thread = 0;
+        atomic_store(&monitor_running, false);
+        close_playback();
+        return false;
+    }
+    struct sched_param sp;
+    sp.sched_priority = MONITOR_THREAD_PRIORITY;
+    if (pthread_setschedparam(monitor_thread, SCHED_FIFO, &sp) != 0) {
+        fprintf(stderr, "[ALSA] Warning: SCHED_FIFO unavailable for monitor thread\n");
+    }
+    pthread_setname_np(monitor_thread, "ktv_monitor");
+
+    fprintf(stderr, "[ALSA] Monitor started: %s, %dHz, %uch, period=%lu buffer=%lu target=%ums\n", monitor_device,
+            record_sample_rate, monitor_channels, (unsigned long)monitor_period_size,
+            (unsigned long)monitor_buffer_size, monitor_target_ms);
+    return true;
+}
+
+static void monitor_stop_locked(void) {
+    if (!atomic_load(&monitor_running)) return;
+    atomic_store(&monitor_running, false);
+    if (monitor_thread) {
+        pthread_join(monitor_thread, NULL);
+        monitor_thread = 0;
+    }
+    close_playback();
+    fprintf(stderr, "[ALSA] Monitor stopped (underruns=%u starved=%u)\n", atomic_load(&monitor_stats.underruns),
+            atomic_load(&monitor_stats.starved));
+}
+
+bool alsa_monitor_start(void) {
+    pthread_mutex_lock(&monitor_lock);
+    bool ok = monitor_start_locked();
+    pthread_mutex_unlock(&monitor_lock);
+    return ok;
+}
+
+void alsa_monitor_stop(void) {
+    pthread_mutex_lock(&monitor_lock);
+    monitor_stop_locked();
+    pthread_mutex_unlock(&monitor_lock);
+}
+
+bool alsa_monitor_measure_latency(void) {
+    if (!atomic_load(&monitor_running)) return false;
+    int expected = MEASURE_IDLE;
+    if (!atomic_compare_exchange_strong(&monitor_measure, &expected, MEASURE_REQUESTED)) return false;
+    // 清掉上一次的结果：-1 一直保持到本次测出或超时
+    atomic_store(&monitor_stats.latency_measured_us, -1);
+    return true;
+}
+#else
+// 未启用录音功能时监听同样不可用
+bool alsa_monitor_start(void) {
+    fprintf(stderr, "[ALSA] Monitor not enabled (compile with KTV_USE_ALSA_RECORD)\n");
+    return false;
+}
+
+void alsa_monitor_stop(void) {
+}
+
+bool alsa_monitor_measure_latency(void) {
+    return false;
+}
+#endif
+
+bool alsa_monitor_is_active(void) {
+    return atomic_load(&monitor_running);
+}
+
+void alsa_monitor_configure(const alsa_monitor_config_t *cfg) {
+    if (!cfg) return;
+    monitor_enabled = cfg->enabled;
+    if (cfg->device && cfg->device[0]) snprintf(monitor_device, sizeof(monitor_device), "%s", cfg->device);
+    if (cfg->period_frames > 0) monitor_period_frames = cfg->period_frames;
+    if (cfg->periods >= 2) monitor_periods = cfg->periods;
+    if (cfg->channels > 0) monitor_channels = cfg->channels;
+    if (cfg->target_latency_ms > 0) monitor_target_ms = cfg->target_latency_ms;
+}
+
+void alsa_monitor_set_fx(const audio_fx_params_t *params) {
+    if (!params) return;
+    pthread_mutex_lock(&monitor_lock);
+    monitor_fx_params = *params;
+    monitor_fx_params_set = true;
+#ifdef KTV_USE_ALSA_RECORD
+    // 监听线程只在块开头无锁读取，这里的锁只防止与启停并发
+    if (monitor_fx) audio_fx_set_params(monitor_fx, params);
+#endif
+    pthread_mutex_unlock(&monitor_lock);
+}
+
+void alsa_monitor_get_stats(alsa_monitor_stats_t *out) {
+    if (!out) return;
+    memset(out, 0, sizeof(*out));
+    pthread_mutex_lock(&monitor_lock);
+    out->active = atomic_load(&monitor_running);
+#ifdef KTV_USE_ALSA_RECORD
+    if (out->active) {
+        out->rate = (uint32_t)record_sample_rate;
+        out->period_frames = (uint32_t)monitor_period_size;
+        out->buffer_frames = (uint32_t)monitor_buffer_size;
+        out->gain_reduction_db = audio_fx_take_gain_reduction_db(monitor_fx);
+    }
+#endif
+    pthread_mutex_unlock(&monitor_lock);
+    out->underruns = atomic_load_explicit(&monitor_stats.underruns, memory_order_relaxed);
+    out->starved = atomic_load_explicit(&monitor_stats.starved, memory_order_relaxed);
+    out->dropped_frames = atomic_load_explicit(&monitor_stats.dropped_frames, memory_order_relaxed);
+    out->latency_est_us = atomic_load_explicit(&monitor_stats.latency_est_us, memory_order_relaxed);
+    out->latency_est_max_us = atomic_exchange_explicit(&monitor_stats.latency_est_max_us, 0, memory_order_relaxed);
+    out->latency_measured_us = atomic_load_explicit(&monitor_stats.latency_measured_us, memory_order_relaxed);
+    out->dsp_load_pct = atomic_load_explicit(&monitor_stats.dsp_load_pct, memory_order_relaxed);
+}
+
+void alsa_capture_configure(const alsa_capture_config_t *cfg) {
+    if (!cfg) return;
+    if (cfg->device && cfg->device[0]) snprintf(capture_device, sizeof(capture_device), "%s", cfg->device);
+    if (cfg->period_frames > 0) capture_period_frames = cfg->period_frames;
+    if (cfg->periods >= 2) capture_periods = cfg->periods;
+    if (cfg->ring_ms > 0) capture_ring_ms = cfg->ring_ms;
+}
+
+void alsa_capture_get_stats(alsa_capture_stats_t *out) {
+    if (out) {
+        memset(out, 0, sizeof(*out));
+#ifdef KTV_USE_ALSA_RECORD
+        out->active = atomic_load(&is_recording);
+        out->mmap = capture_mmap;
+        out->rate = (uint32_t)record_sample_rate;
+        out->channels = (uint32_t)record_channels;
+        out->period_frames = (uint32_t)capture_period_size;
+        out->buffer_frames = (uint32_t)capture_buffer_size;
+        out->ring_frames = capture_ring ? audio_ring_capacity(capture_ring) : 0;
+#endif
+        out->xruns = atomic_load_explicit(&capture_stats.xruns, memory_order_relaxed);
+        out->suspends = atomic_load_explicit(&capture_stats.suspends, memory_order_relaxed);
+        out->wakeups = atomic_load_explicit(&capture_stats.wakeups, memory_order_relaxed);
+        out->frames = atomic_load_explicit(&capture_stats.frames, memory_order_relaxed);
+        out->hw_fill_max = atomic_load_explicit(&capture_stats.hw_fill_max, memory_order_relaxed);
+        out->callback_fill = atomic_load_explicit(&capture_stats.callback_fill, memory_order_relaxed);
+        out->callback_overruns = atomic_load_explicit(&capture_stats.callback_overruns, memory_order_relaxed);
+    }
+    atomic_store_explicit(&capture_stats.hw_fill_max, 0, memory_order_relaxed);
+}
+
 static void audio_alsa_deinit(void) {
     // 如果正在录音，先停止
-    if (is_recording) {
+    if (atomic_load(&is_recording)) {
         audio_alsa_stop_record();
     }
     fprintf(stderr, "[ALSA] Audio driver deinitialized\n");
@@ -217,5 +882,3 @@ audio_iface_t AUDIO = {
     .is_recording = audio_alsa_is_recording,
     .deinit = audio_alsa_deinit
 };
-
-
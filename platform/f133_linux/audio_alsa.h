@@ -0,0 +1,119 @@
+/**
+ * @file audio_alsa.h
+ * @brief F133 Linux ALSA 录音辅助函数（环形缓冲、参数、统计）与人声监听
+ */
+
+#ifndef KTVLV_PLATFORM_F133_LINUX_AUDIO_ALSA_H
+#define KTVLV_PLATFORM_F133_LINUX_AUDIO_ALSA_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "core/audio_ring.h"
+#include "core/audio_fx.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    const char *device;       /* PCM 设备名，如 "hw:0,0"（内部会拷贝） */
+    uint32_t period_frames;   /* 周期大小（帧），越小延迟越低、唤醒越频繁 */
+    uint32_t periods;         /* 硬件缓冲的周期数 */
+    uint32_t ring_ms;         /* 软件环形缓冲时长，决定读者最多可以落后多久 */
+} alsa_capture_config_t;
+
+typedef struct {
+    bool active;
+    bool mmap;                /* false 表示驱动不支持 mmap，退化为 snd_pcm_readi */
+    uint32_t rate;
+    uint32_t channels;
+    uint32_t period_frames;   /* 实际协商到的值 */
+    uint32_t buffer_frames;
+    uint32_t ring_frames;
+    uint32_t xruns;           /* 硬件缓冲溢出（-EPIPE）次数 */
+    uint32_t suspends;        /* 系统挂起恢复（-ESTRPIPE）次数 */
+    uint32_t wakeups;         /* 录音线程处理周期数 */
+    uint64_t frames;          /* 累计写入环形缓冲的帧数 */
+    uint32_t hw_fill_max;     /* 唤醒时硬件缓冲的最大填充率（千分比，读取后清零） */
+    uint32_t callback_fill;   /* 回调读者当前的环形缓冲填充率（千分比） */
+    uint32_t callback_overruns; /* 回调读者因落后丢数据的次数 */
+} alsa_capture_stats_t;
+
+typedef struct {
+    bool enabled;             /* start_record 成功后自动开启监听 */
+    const char *device;       /* 播放设备名（内部会拷贝）；"null" 可在无声卡环境跑通整条链路 */
+    uint32_t period_frames;   /* 监听周期（帧），越小延迟越低 */
+    uint32_t periods;         /* 播放缓冲的周期数，2–3 */
+    uint32_t channels;        /* 输出声道数，人声单声道复制到各声道 */
+    uint32_t target_latency_ms; /* 往返延迟目标：积压超出时丢弃旧数据追上 */
+} alsa_monitor_config_t;
+
+typedef struct {
+    bool active;
+    uint32_t rate;
+    uint32_t period_frames;   /* 实际协商到的值 */
+    uint32_t buffer_frames;
+    uint32_t underruns;       /* 播放欠载（-EPIPE）次数 */
+    uint32_t starved;         /* 录音数据不足、补静音的周期数 */
+    uint64_t dropped_frames;  /* 为满足延迟目标丢弃的录音帧 */
+    uint32_t latency_est_us;  /* 估算往返延迟：录音周期 + 环形缓冲积压 + 播放缓冲 */
+    uint32_t latency_est_max_us; /* 读取后清零 */
+    int32_t latency_measured_us; /* 最近一次回环实测，-1 表示未测或超时 */
+    uint32_t dsp_load_pct;    /* 效果链耗时 / 周期时长 */
+    float gain_reduction_db;  /* 最大限幅量（读取后清零） */
+} alsa_monitor_stats_t;
+
+/**
+ * @brief 设置录音参数，下一次 AUDIO.start_record 生效
+ */
+void alsa_capture_configure(const alsa_capture_config_t *cfg);
+
+/**
+ * @brief 录音环形缓冲（start_record 成功后有效，stop_record 时销毁）
+ *
+ * 消费者用 audio_ring_reader_init 挂一个自己的读者，按自己的节奏读取；
+ * 必须在 stop_record 之前停止读取。未录音时返回 NULL
+ */
+audio_ring_t *alsa_capture_ring(void);
+
+/**
+ * @brief 读取录音统计（hw_fill_max 读取后清零）
+ */
+void alsa_capture_get_stats(alsa_capture_stats_t *out);
+
+/**
+ * @brief 设置监听参数，下一次 alsa_monitor_start 生效
+ */
+void alsa_monitor_configure(const alsa_monitor_config_t *cfg);
+
+/**
+ * @brief 开启人声监听：录音环形缓冲 → 效果链 → 播放设备
+ *
+ * 需要正在录音（采样率与录音一致，格式为 S16）；stop_record 会先自动关闭监听
+ */
+bool alsa_monitor_start(void);
+void alsa_monitor_stop(void);
+bool alsa_monitor_is_active(void);
+
+/**
+ * @brief 更新效果参数（任意线程，无锁发布，下一个周期生效）；未监听时保存到下次开启
+ */
+void alsa_monitor_set_fx(const audio_fx_params_t *params);
+
+/**
+ * @brief 请求一次回环延迟实测：输出一个脉冲并在录音中检测，结果写入 latency_measured_us
+ *
+ * 需要输出能回到输入（snd-aloop 回环、或扬声器对着麦克风）；测量期间监听静音约一秒
+ */
+bool alsa_monitor_measure_latency(void);
+
+/**
+ * @brief 读取监听统计（latency_est_max_us / gain_reduction_db 读取后清零）
+ */
+void alsa_monitor_get_stats(alsa_monitor_stats_t *out);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // KTVLV_PLATFORM_F133_LINUX_AUDIO_ALSA_H
@@ -1,50 +1,295 @@
 /**
  * @file input_evdev.c
  * @brief F133 Linux 平台输入驱动实现（evdev）
- * 
+ *
  * 支持：
- * - 触摸屏：/dev/input/eventX（触摸事件）
- * - 遥控器：/dev/input/eventX（按键事件）
- * 
- * 注意：此文件为框架模板，需要根据实际 F133 输入设备配置调整
+ * - 触摸屏：单点 ABS_X/ABS_Y 与多点 ABS_MT_* slot 协议
+ * - 遥控器/键盘：按键事件
+ *
+ * 设备发现：扫描 /dev/input/event*，按能力（EVIOCGBIT）区分触摸屏与按键设备，
+ * 并用 inotify 监听 /dev/input，热插拔的遥控器接收器、USB 键盘无需重启即可使用。
+ *
+ * 事件流：独立读取线程 epoll 等待所有设备 → 按 SYN_REPORT 成帧后带内核时间戳写入
+ * 单生产者/单消费者无锁队列 → eventfd 唤醒主循环（evdev_wait）→ LVGL read_cb 逐条取出
+ * （continue_reading）。UI 线程卡顿只会推迟按键的处理，不会推迟读取或丢失按键。
+ * 方向键的长按连发由读取线程按配置生成（内核 value=2 的重复事件忽略）。
  */
 
+#define _GNU_SOURCE   /* pthread_setname_np */
+
 #include "drivers/input_driver.h"
+#include "platform/f133_linux/input_evdev.h"
 #include <stdio.h>
 #include <stdbool.h>
+#include <stdint.h>
+#include <stdatomic.h>
+#include <dirent.h>
+#include <errno.h>
 #include <fcntl.h>
+#include <poll.h>
+#include <pthread.h>
+#include <sched.h>
 #include <unistd.h>
 #include <linux/input.h>
 #include <string.h>
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/inotify.h>
+#include <sys/ioctl.h>
+#include <time.h>
+
+#define EVDEV_INPUT_DIR "/dev/input"
+#define EVDEV_MAX_DEVICES 8      // 同时打开的设备数
+#define EVDEV_QUEUE_SIZE 64      // 每类事件的无锁队列长度（2 的幂）
+#define EVDEV_MT_SLOTS 10        // 跟踪的触点数
+#define EVDEV_DELIVERED_SIZE 8   // 已交给 LVGL、等待性能统计取走的按键
+#define EVDEV_READER_PRIORITY 10 // 读取线程 SCHED_FIFO 优先级（失败则保持普通调度）
+
+// epoll 标签：设备用数组下标，其余为特殊 fd
+#define TAG_INOTIFY 0xFFFF0001u
+#define TAG_STOP    0xFFFF0002u
+
+#define CAP_TOUCH 0x1
+#define CAP_KEYS  0x2
+
+#define BITS_PER_LONG (sizeof(unsigned long) * 8)
+#define NLONGS(x) (((x) + BITS_PER_LONG - 1) / BITS_PER_LONG)
+
+typedef struct {
+    uint64_t ts_us;      // 内核时间戳（CLOCK_MONOTONIC）；连发为计划触发时刻
+    uint32_t key;        // LVGL 键值
+    uint16_t code;       // Linux 键码
+    bool pressed;
+    bool repeat;         // 驱动生成的连发
+} key_event_t;
 
-// 输入设备路径（根据实际 F133 配置调整）
-#define TOUCH_DEVICE "/dev/input/event0"  // 触摸屏
-#define KEYPAD_DEVICE "/dev/input/event1"  // 遥控器/键盘
+typedef struct {
+    uint64_t ts_us;
+    int32_t x;
+    int32_t y;
+    bool pressed;
+} touch_event_t;
 
-static int touch_fd = -1;
-static int keypad_fd = -1;
+typedef struct {
+    int32_t tracking_id;   // -1 表示该 slot 无触点
+    int32_t x;
+    int32_t y;
+} mt_slot_t;
+
+// 一个已打开的 evdev 设备及其触摸解析状态（只在读取线程访问）
+typedef struct {
+    int fd;                  // -1 表示空位
+    int caps;
+    char node[32];           // eventN
+    char name[64];
+    mt_slot_t slots[EVDEV_MT_SLOTS];
+    int cur_slot;
+    int primary;             // 作为 LVGL 单指针上报的触点
+    bool mt;                 // 设备使用 MT 协议
+    bool syncing;            // SYN_DROPPED 后丢弃到下一个 SYN_REPORT，再用 ioctl 重新读取状态
+    int32_t legacy_x;
+    int32_t legacy_y;
+    bool legacy_pressed;
+} evdev_device_t;
+
+// 单生产者（读取线程）/单消费者（UI 线程）队列下标，自由递增，取模定位
+typedef struct {
+    atomic_uint head;
+    atomic_uint tail;
+} spsc_index_t;
+
+static lv_indev_drv_t pointer_drv;   // LVGL 保存驱动指针，必须是静态存储
+static lv_indev_drv_t keypad_drv;
 static lv_indev_t* pointer_indev = NULL;
 static lv_indev_t* keypad_indev = NULL;
 
-// 输入状态
-static int32_t touch_x = 0;
-static int32_t touch_y = 0;
-static bool touch_pressed = false;
-static uint32_t keypad_key = 0;
-static bool keypad_pressed = false;
+// 无锁队列
+static key_event_t key_queue[EVDEV_QUEUE_SIZE];
+static spsc_index_t key_index;
+static touch_event_t touch_queue[EVDEV_QUEUE_SIZE];
+static spsc_index_t touch_index;
+
+// LVGL 最近一次看到的状态（队列为空时重复上报）
+static key_event_t key_last;
+static touch_event_t touch_last;
+
+// 已交给 LVGL 的真实按键（供 evdev_take_key_press，只在 UI 线程访问）
+static key_event_t delivered[EVDEV_DELIVERED_SIZE];
+static uint32_t delivered_head = 0, delivered_tail = 0;
+
+// 读取线程与唤醒
+static int epoll_fd = -1;
+static int inotify_fd = -1;
+static int stop_fd = -1;
+static int wake_fd = -1;            // 有新事件时由读取线程写入，主循环 evdev_wait 等待
+static pthread_t reader_thread;
+static atomic_bool reader_running = false;
+static bool reader_started = false;
+
+// 以下状态只在读取线程访问（线程未启动时由主循环轮询访问）
+static evdev_device_t devices[EVDEV_MAX_DEVICES];
+static touch_event_t touch_queued;   // 最近入队的状态，用于去重
+static int touch_source = -1;        // 最近一帧触摸来自的设备
+static key_event_t key_overflow;     // 队列满时暂存的松开事件，避免按键卡在按下
+static bool key_overflow_pending = false;
+static touch_event_t touch_overflow; // 队列满时合并的最新触摸状态
+static bool touch_overflow_pending = false;
+static bool wake_needed = false;
+static int key_down_device = -1;     // 当前按下的按键来自的设备（拔出时补松开）
+static key_event_t key_down;
+static uint32_t held_key = 0;        // 正在连发的按键
+static uint16_t held_code = 0;
+static uint64_t next_repeat_us = 0;
+
+// 长按连发配置（UI 线程写，读取线程读）
+static atomic_uint repeat_delay_ms = 400;
+static atomic_uint repeat_interval_ms = 80;
+
+static struct {
+    atomic_uint key_events;
+    atomic_uint touch_events;
+    atomic_uint repeats;
+    atomic_uint coalesced;
+    atomic_uint dropped;
+    atomic_uint syn_dropped;
+    atomic_uint max_queue_us;
+    atomic_uint devices;
+    atomic_uint hotplugs;
+} stats;
+
+#define STAT_INC(field) atomic_fetch_add_explicit(&stats.field, 1, memory_order_relaxed)
+
+static uint64_t now_us(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000ULL + (uint64_t)ts.tv_nsec / 1000ULL;
+}
+
+static uint64_t event_us(const struct input_event* ev) {
+    return (uint64_t)ev->time.tv_sec * 1000000ULL + (uint64_t)ev->time.tv_usec;
+}
+
+static void note_queue_wait(uint64_t ts_us) {
+    uint64_t now = now_us();
+    if (now <= ts_us) return;
+    uint32_t wait = (uint32_t)(now - ts_us);
+    if (wait > atomic_load_explicit(&stats.max_queue_us, memory_order_relaxed)) {
+        atomic_store_explicit(&stats.max_queue_us, wait, memory_order_relaxed);
+    }
+}
+
+// ---- 无锁队列 ----
+
+static bool key_try_push(const key_event_t* e) {
+    unsigned tail = atomic_load_explicit(&key_index.tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&key_index.head, memory_order_acquire);
+    if (tail - head >= EVDEV_QUEUE_SIZE) return false;
+    key_queue[tail % EVDEV_QUEUE_SIZE] = *e;
+    atomic_store_explicit(&key_index.tail, tail + 1, memory_order_release);
+    wake_needed = true;
+    return true;
+}
+
+static bool key_try_pop(key_event_t* out) {
+    unsigned head = atomic_load_explicit(&key_index.head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&key_index.tail, memory_order_acquire);
+    if (head == tail) return false;
+    *out = key_queue[head % EVDEV_QUEUE_SIZE];
+    atomic_store_explicit(&key_index.head, head + 1, memory_order_release);
+    return true;
+}
+
+static bool touch_try_push(const touch_event_t* e) {
+    unsigned tail = atomic_load_explicit(&touch_index.tail, memory_order_relaxed);
+    unsigned head = atomic_load_explicit(&touch_index.head, memory_order_acquire);
+    if (tail - head >= EVDEV_QUEUE_SIZE) return false;
+    touch_queue[tail % EVDEV_QUEUE_SIZE] = *e;
+    atomic_store_explicit(&touch_index.tail, tail + 1, memory_order_release);
+    wake_needed = true;
+    return true;
+}
+
+static bool touch_try_pop(touch_event_t* out) {
+    unsigned head = atomic_load_explicit(&touch_index.head, memory_order_relaxed);
+    unsigned tail = atomic_load_explicit(&touch_index.tail, memory_order_acquire);
+    if (head == tail) return false;
+    *out = touch_queue[head % EVDEV_QUEUE_SIZE];
+    atomic_store_explicit(&touch_index.head, head + 1, memory_order_release);
+    return true;
+}
+
+static bool queue_empty(spsc_index_t* idx) {
+    return atomic_load_explicit(&idx->head, memory_order_relaxed) ==
+           atomic_load_explicit(&idx->tail, memory_order_acquire);
+}
+
+// 队列满时暂存的事件：每轮读取先尝试补入，保证顺序
+static void flush_overflow(void) {
+    if (key_overflow_pending && key_try_push(&key_overflow)) key_overflow_pending = false;
+    if (touch_overflow_pending && touch_try_push(&touch_overflow)) touch_overflow_pending = false;
+}
+
+static void key_push(const key_event_t* e) {
+    flush_overflow();
+    if (!key_overflow_pending && key_try_push(e)) {
+        STAT_INC(key_events);
+        return;
+    }
+    // 队列满：按下/连发直接丢弃，松开暂存（否则 LVGL 认为按键一直按住）
+    if (!e->pressed) {
+        if (key_overflow_pending) STAT_INC(dropped);
+        key_overflow = *e;
+        key_overflow_pending = true;
+    } else {
+        STAT_INC(dropped);
+    }
+}
+
+static void touch_push(const touch_event_t* e) {
+    flush_overflow();
+    if (!touch_overflow_pending && touch_try_push(e)) {
+        STAT_INC(touch_events);
+        return;
+    }
+    // 队列满：连续移动合并为最新状态，按下/抬起被覆盖时计为丢弃
+    if (touch_overflow_pending) {
+        if (touch_overflow.pressed == e->pressed) STAT_INC(coalesced);
+        else STAT_INC(dropped);
+    }
+    touch_overflow = *e;
+    touch_overflow_pending = true;
+}
+
+// ---- LVGL 回调（UI 线程）----
 
-// LVGL 输入读取回调
+// 每次取一条，队列非空时要求 LVGL 继续读取
 static void evdev_touch_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
     (void)indev_drv;
-    data->point.x = touch_x;
-    data->point.y = touch_y;
-    data->state = touch_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    if (touch_try_pop(&touch_last)) note_queue_wait(touch_last.ts_us);
+    data->point.x = touch_last.x;
+    data->point.y = touch_last.y;
+    data->state = touch_last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = !queue_empty(&touch_index);
 }
 
 static void evdev_keypad_read(lv_indev_drv_t* indev_drv, lv_indev_data_t* data) {
     (void)indev_drv;
-    data->key = keypad_pressed ? keypad_key : 0;
-    data->state = keypad_pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    if (key_try_pop(&key_last)) {
+        note_queue_wait(key_last.ts_us);
+        if (key_last.pressed && !key_last.repeat) {
+            if (delivered_tail - delivered_head >= EVDEV_DELIVERED_SIZE) delivered_head++;
+            delivered[delivered_tail++ % EVDEV_DELIVERED_SIZE] = key_last;
+        }
+    }
+    data->key = key_last.key;
+    data->state = key_last.pressed ? LV_INDEV_STATE_PRESSED : LV_INDEV_STATE_RELEASED;
+    data->continue_reading = !queue_empty(&key_index);
+}
+
+// ---- 事件解析（读取线程）----
+
+static bool test_bit(const unsigned long* bits, unsigned int bit) {
+    return (bits[bit / BITS_PER_LONG] >> (bit % BITS_PER_LONG)) & 1UL;
 }
 
 // 按键码映射（Linux input event -> LVGL key）
@@ -61,104 +306,511 @@ static uint32_t map_linux_key_to_lvgl(uint16_t linux_key) {
     }
 }
 
-static int input_evdev_init(void) {
-    fprintf(stderr, "[EVDEV] Initializing input devices...\n");
-    
-    // 打开触摸屏设备（非阻塞）
-    touch_fd = open(TOUCH_DEVICE, O_RDONLY | O_NONBLOCK);
-    if (touch_fd < 0) {
-        fprintf(stderr, "[EVDEV] Warning: Failed to open touch device %s\n", TOUCH_DEVICE);
+// 只有方向键和退格连发，确认/返回长按保持原义
+static bool key_repeats(uint32_t key) {
+    return key == LV_KEY_UP || key == LV_KEY_DOWN || key == LV_KEY_LEFT ||
+           key == LV_KEY_RIGHT || key == LV_KEY_BACKSPACE;
+}
+
+// 一帧触摸数据结束：取主触点入队（状态无变化时不入队）
+static void touch_frame_done(int index, uint64_t ts_us) {
+    evdev_device_t* d = &devices[index];
+    touch_event_t e;
+    e.ts_us = ts_us;
+    if (d->mt) {
+        if (d->primary < 0 || d->slots[d->primary].tracking_id < 0) {
+            d->primary = -1;
+            for (int i = 0; i < EVDEV_MT_SLOTS; i++) {
+                if (d->slots[i].tracking_id >= 0) {
+                    d->primary = i;
+                    break;
+                }
+            }
+        }
+        e.pressed = d->primary >= 0;
+        // 抬起时保留最后坐标，LVGL 需要在释放点上判定点击
+        e.x = e.pressed ? d->slots[d->primary].x : touch_queued.x;
+        e.y = e.pressed ? d->slots[d->primary].y : touch_queued.y;
     } else {
-        fprintf(stderr, "[EVDEV] Touch device opened: %s\n", TOUCH_DEVICE);
+        e.pressed = d->legacy_pressed;
+        e.x = d->legacy_x;
+        e.y = d->legacy_y;
     }
-    
-    // 打开遥控器/键盘设备（非阻塞）
-    keypad_fd = open(KEYPAD_DEVICE, O_RDONLY | O_NONBLOCK);
-    if (keypad_fd < 0) {
-        fprintf(stderr, "[EVDEV] Warning: Failed to open keypad device %s\n", KEYPAD_DEVICE);
+    // 其他触摸设备按住时忽略本设备的抬起，避免打断拖动
+    if (!e.pressed && touch_source != index && touch_queued.pressed) return;
+    if (e.pressed == touch_queued.pressed && e.x == touch_queued.x && e.y == touch_queued.y) return;
+    touch_queued = e;
+    touch_source = index;
+    touch_push(&e);
+}
+
+// SYN_DROPPED 已由 read_device 处理，这里只看完整的帧
+static void handle_touch_event(int index, const struct input_event* ev) {
+    evdev_device_t* d = &devices[index];
+    if (ev->type == EV_SYN) {
+        if (ev->code == SYN_REPORT) touch_frame_done(index, event_us(ev));
+        return;
+    }
+
+    if (ev->type == EV_ABS) {
+        mt_slot_t* slot = &d->slots[d->cur_slot];
+        switch (ev->code) {
+            case ABS_X: d->legacy_x = ev->value; break;
+            case ABS_Y: d->legacy_y = ev->value; break;
+            case ABS_MT_SLOT:
+                d->cur_slot = (ev->value >= 0 && ev->value < EVDEV_MT_SLOTS) ? ev->value : EVDEV_MT_SLOTS - 1;
+                d->mt = true;
+                break;
+            case ABS_MT_TRACKING_ID:
+                slot->tracking_id = ev->value;
+                d->mt = true;
+                break;
+            case ABS_MT_POSITION_X: slot->x = ev->value; d->mt = true; break;
+            case ABS_MT_POSITION_Y: slot->y = ev->value; d->mt = true; break;
+            default: break;
+        }
+    } else if (ev->type == EV_KEY && ev->code == BTN_TOUCH) {
+        d->legacy_pressed = (ev->value != 0);
+    }
+}
+
+static void handle_key_event(int index, const struct input_event* ev) {
+    if (ev->type != EV_KEY || ev->value == 2) return;   // value=2 为内核重复，连发由驱动生成
+    uint32_t key = map_linux_key_to_lvgl(ev->code);
+    if (key == 0) return;
+
+    key_event_t e;
+    e.ts_us = event_us(ev);
+    e.key = key;
+    e.code = ev->code;
+    e.pressed = ev->value == 1;
+    e.repeat = false;
+    key_push(&e);
+
+    if (e.pressed) {
+        key_down = e;
+        key_down_device = index;
+        uint32_t interval = atomic_load_explicit(&repeat_interval_ms, memory_order_relaxed);
+        uint32_t delay = atomic_load_explicit(&repeat_delay_ms, memory_order_relaxed);
+        held_key = key_repeats(key) && interval > 0 ? key : 0;
+        held_code = ev->code;
+        next_repeat_us = e.ts_us + (uint64_t)delay * 1000ULL;
     } else {
-        fprintf(stderr, "[EVDEV] Keypad device opened: %s\n", KEYPAD_DEVICE);
+        if (key == key_down.key) key_down_device = -1;
+        if (key == held_key) held_key = 0;
     }
-    
+}
+
+// SYN_DROPPED 后重新读取按键状态：按下的键已松开（松开事件被内核丢弃）则补发松开并停止连发
+static void resync_keys(int index, uint64_t ts_us) {
+    if (key_down_device != index) return;
+    unsigned long key_bits[NLONGS(KEY_MAX + 1)];
+    memset(key_bits, 0, sizeof(key_bits));
+    if (ioctl(devices[index].fd, EVIOCGKEY(sizeof(key_bits)), key_bits) < 0) return;
+    if (test_bit(key_bits, key_down.code)) return;
+
+    key_event_t e = key_down;
+    e.ts_us = ts_us;
+    e.pressed = false;
+    e.repeat = false;
+    key_push(&e);
+    key_down_device = -1;
+    if (held_code == key_down.code) held_key = 0;
+}
+
+// SYN_DROPPED 后重新读取触摸状态：MT 设备整组读取各 slot，单点设备读取坐标与 BTN_TOUCH
+static void resync_touch(int index, uint64_t ts_us) {
+    evdev_device_t* d = &devices[index];
+    struct {
+        uint32_t code;
+        int32_t values[EVDEV_MT_SLOTS];
+    } mt;
+    static const uint32_t mt_codes[] = {ABS_MT_TRACKING_ID, ABS_MT_POSITION_X, ABS_MT_POSITION_Y};
+    bool mt_ok = true;
+    for (size_t c = 0; c < sizeof(mt_codes) / sizeof(mt_codes[0]) && mt_ok; c++) {
+        mt.code = mt_codes[c];
+        // 设备 slot 数少于 EVDEV_MT_SLOTS 时内核只填前面几个，其余视为无触点
+        for (int i = 0; i < EVDEV_MT_SLOTS; i++) mt.values[i] = mt_codes[c] == ABS_MT_TRACKING_ID ? -1 : 0;
+        mt_ok = ioctl(d->fd, EVIOCGMTSLOTS(sizeof(mt)), &mt) >= 0;
+        for (int i = 0; mt_ok && i < EVDEV_MT_SLOTS; i++) {
+            if (mt_codes[c] == ABS_MT_TRACKING_ID) d->slots[i].tracking_id = mt.values[i];
+            else if (mt_codes[c] == ABS_MT_POSITION_X) d->slots[i].x = mt.values[i];
+            else d->slots[i].y = mt.values[i];
+        }
+    }
+    if (mt_ok) {
+        struct input_absinfo slot;
+        if (ioctl(d->fd, EVIOCGABS(ABS_MT_SLOT), &slot) == 0) {
+            d->cur_slot = (slot.value >= 0 && slot.value < EVDEV_MT_SLOTS) ? slot.value : EVDEV_MT_SLOTS - 1;
+        }
+        d->mt = true;
+    } else {
+        struct input_absinfo abs;
+        if (ioctl(d->fd, EVIOCGABS(ABS_X), &abs) == 0) d->legacy_x = abs.value;
+        if (ioctl(d->fd, EVIOCGABS(ABS_Y), &abs) == 0) d->legacy_y = abs.value;
+        unsigned long key_bits[NLONGS(KEY_MAX + 1)];
+        memset(key_bits, 0, sizeof(key_bits));
+        if (ioctl(d->fd, EVIOCGKEY(sizeof(key_bits)), key_bits) >= 0) d->legacy_pressed = test_bit(key_bits, BTN_TOUCH);
+    }
+    touch_frame_done(index, ts_us);
+}
+
+// 长按连发：到期时插入一对 松开+按下；读取线程被抢占后不补发积压的次数
+static void generate_repeats(uint64_t now) {
+    uint32_t interval_ms = atomic_load_explicit(&repeat_interval_ms, memory_order_relaxed);
+    if (held_key == 0 || interval_ms == 0 || now < next_repeat_us) return;
+    key_event_t e;
+    e.ts_us = next_repeat_us;
+    e.key = held_key;
+    e.code = held_code;
+    e.repeat = true;
+    e.pressed = false;
+    key_push(&e);
+    e.pressed = true;
+    key_push(&e);
+    STAT_INC(repeats);
+
+    uint64_t interval = (uint64_t)interval_ms * 1000ULL;
+    next_repeat_us += interval;
+    if (next_repeat_us <= now) next_repeat_us = now + interval;
+}
+
+// ---- 设备管理（读取线程）----
+
+// 按能力分类：有绝对坐标的是触摸屏，有方向键/确认键的是遥控器或键盘
+static int probe_caps(int fd) {
+    unsigned long ev_bits[NLONGS(EV_MAX + 1)];
+    unsigned long key_bits[NLONGS(KEY_MAX + 1)];
+    unsigned long abs_bits[NLONGS(ABS_MAX + 1)];
+    memset(ev_bits, 0, sizeof(ev_bits));
+    memset(key_bits, 0, sizeof(key_bits));
+    memset(abs_bits, 0, sizeof(abs_bits));
+
+    if (ioctl(fd, EVIOCGBIT(0, sizeof(ev_bits)), ev_bits) < 0) return 0;
+    if (test_bit(ev_bits, EV_KEY)) ioctl(fd, EVIOCGBIT(EV_KEY, sizeof(key_bits)), key_bits);
+    if (test_bit(ev_bits, EV_ABS)) ioctl(fd, EVIOCGBIT(EV_ABS, sizeof(abs_bits)), abs_bits);
+
+    int caps = 0;
+    if (test_bit(abs_bits, ABS_MT_POSITION_X) ||
+        (test_bit(abs_bits, ABS_X) && test_bit(key_bits, BTN_TOUCH))) {
+        caps |= CAP_TOUCH;
+    }
+    static const uint16_t nav_keys[] = {KEY_UP, KEY_DOWN, KEY_LEFT, KEY_RIGHT, KEY_ENTER};
+    for (size_t i = 0; i < sizeof(nav_keys) / sizeof(nav_keys[0]); i++) {
+        if (test_bit(key_bits, nav_keys[i])) {
+            caps |= CAP_KEYS;
+            break;
+        }
+    }
+    return caps;
+}
+
+static int find_device(const char* node) {
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        if (devices[i].fd >= 0 && strcmp(devices[i].node, node) == 0) return i;
+    }
+    return -1;
+}
+
+// 打开并登记一个 eventN 节点；不相关的设备（传感器、电源键等）直接关闭
+static void device_add(const char* node) {
+    if (strncmp(node, "event", 5) != 0 || find_device(node) >= 0) return;
+
+    int index = -1;
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        if (devices[i].fd < 0) {
+            index = i;
+            break;
+        }
+    }
+    if (index < 0) {
+        fprintf(stderr, "[EVDEV] Warning: device table full, ignoring %s\n", node);
+        return;
+    }
+
+    char path[64];
+    snprintf(path, sizeof(path), EVDEV_INPUT_DIR "/%s", node);
+    int fd = open(path, O_RDONLY | O_NONBLOCK | O_CLOEXEC);
+    if (fd < 0) return;   // 热插拔时节点可能还没有权限，等 IN_ATTRIB 再试
+
+    int caps = probe_caps(fd);
+    if (caps == 0) {
+        close(fd);
+        return;
+    }
+
+    // 事件时间戳改用 CLOCK_MONOTONIC，便于与帧时间直接相减
+    int clk = CLOCK_MONOTONIC;
+    if (ioctl(fd, EVIOCSCLOCKID, &clk) < 0) {
+        fprintf(stderr, "[EVDEV] Warning: EVIOCSCLOCKID failed on %s, latency stats unavailable\n", path);
+    }
+
+    evdev_device_t* d = &devices[index];
+    memset(d, 0, sizeof(*d));
+    d->fd = fd;
+    d->caps = caps;
+    d->primary = -1;
+    snprintf(d->node, sizeof(d->node), "%s", node);
+    if (ioctl(fd, EVIOCGNAME(sizeof(d->name)), d->name) < 0) snprintf(d->name, sizeof(d->name), "unknown");
+    for (int i = 0; i < EVDEV_MT_SLOTS; i++) d->slots[i].tracking_id = -1;
+
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u32 = (uint32_t)index;
+    if (epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev) < 0) {
+        fprintf(stderr, "[EVDEV] Warning: epoll_ctl failed on %s: %s\n", path, strerror(errno));
+        close(fd);
+        d->fd = -1;
+        return;
+    }
+
+    atomic_fetch_add_explicit(&stats.devices, 1, memory_order_relaxed);
+    fprintf(stderr, "[EVDEV] Device opened: %s \"%s\"%s%s\n", path, d->name,
+            (caps & CAP_TOUCH) ? " touch" : "", (caps & CAP_KEYS) ? " keys" : "");
+}
+
+// 设备拔出：补发松开，避免 LVGL 停留在按下状态
+static void device_remove(int index) {
+    evdev_device_t* d = &devices[index];
+    if (d->fd < 0) return;
+    epoll_ctl(epoll_fd, EPOLL_CTL_DEL, d->fd, NULL);
+    close(d->fd);
+    d->fd = -1;
+    atomic_fetch_sub_explicit(&stats.devices, 1, memory_order_relaxed);
+    fprintf(stderr, "[EVDEV] Device removed: %s/%s \"%s\"\n", EVDEV_INPUT_DIR, d->node, d->name);
+
+    uint64_t now = now_us();
+    if (key_down_device == index) {
+        key_event_t e = key_down;
+        e.ts_us = now;
+        e.pressed = false;
+        e.repeat = false;
+        key_push(&e);
+        key_down_device = -1;
+        held_key = 0;
+    }
+    if (touch_source == index && touch_queued.pressed) {
+        touch_event_t e = touch_queued;
+        e.ts_us = now;
+        e.pressed = false;
+        touch_queued = e;
+        touch_push(&e);
+    }
+    if (touch_source == index) touch_source = -1;
+}
+
+static void scan_devices(void) {
+    DIR* dir = opendir(EVDEV_INPUT_DIR);
+    if (!dir) {
+        fprintf(stderr, "[EVDEV] Warning: cannot open %s: %s\n", EVDEV_INPUT_DIR, strerror(errno));
+        return;
+    }
+    struct dirent* ent;
+    while ((ent = readdir(dir)) != NULL) device_add(ent->d_name);
+    closedir(dir);
+}
+
+static void handle_inotify(void) {
+    char buf[1024] __attribute__((aligned(__alignof__(struct inotify_event))));
+    ssize_t n;
+    while ((n = read(inotify_fd, buf, sizeof(buf))) > 0) {
+        for (char* p = buf; p < buf + n;) {
+            const struct inotify_event* ie = (const struct inotify_event*)p;
+            // 拔出由设备 fd 的 EPOLLHUP/ENODEV 处理，这里只关心新增和权限变化
+            if (ie->len > 0 && (ie->mask & (IN_CREATE | IN_ATTRIB))) {
+                unsigned before = atomic_load_explicit(&stats.devices, memory_order_relaxed);
+                device_add(ie->name);
+                if (atomic_load_explicit(&stats.devices, memory_order_relaxed) > before) STAT_INC(hotplugs);
+            }
+            p += sizeof(struct inotify_event) + ie->len;
+        }
+    }
+}
+
+static void read_device(int index) {
+    evdev_device_t* d = &devices[index];
+    struct input_event evs[32];
+    ssize_t n;
+    while ((n = read(d->fd, evs, sizeof(evs))) >= (ssize_t)sizeof(evs[0])) {
+        for (size_t i = 0; i < (size_t)n / sizeof(evs[0]); i++) {
+            const struct input_event* ev = &evs[i];
+            if (ev->type == EV_SYN && ev->code == SYN_DROPPED) {
+                // 内核缓冲溢出：丢弃到下一个 SYN_REPORT（含），之后按 ioctl 读到的真实状态补齐
+                d->syncing = true;
+                STAT_INC(syn_dropped);
+                continue;
+            }
+            if (d->syncing) {
+                if (ev->type != EV_SYN || ev->code != SYN_REPORT) continue;
+                d->syncing = false;
+                if (d->caps & CAP_KEYS) resync_keys(index, event_us(ev));
+                if (d->caps & CAP_TOUCH) resync_touch(index, event_us(ev));
+                continue;
+            }
+            if (d->caps & CAP_TOUCH) handle_touch_event(index, ev);
+            if (d->caps & CAP_KEYS) handle_key_event(index, ev);
+        }
+    }
+    if (n < 0 && errno == ENODEV) device_remove(index);
+}
+
+// 等待超时：有连发待触发或队列满暂存时不能无限等待
+static int reader_timeout_ms(void) {
+    int timeout = -1;
+    if (key_overflow_pending || touch_overflow_pending) timeout = 5;
+    if (held_key != 0 && atomic_load_explicit(&repeat_interval_ms, memory_order_relaxed) > 0) {
+        uint64_t now = now_us();
+        int until = now >= next_repeat_us ? 0 : (int)((next_repeat_us - now + 999) / 1000);
+        if (timeout < 0 || until < timeout) timeout = until;
+    }
+    return timeout;
+}
+
+// 一轮读取：等待设备/热插拔事件，解析入队后用 eventfd 唤醒主循环
+static void reader_poll(int timeout_ms) {
+    struct epoll_event events[EVDEV_MAX_DEVICES + 2];
+    int n = epoll_wait(epoll_fd, events, (int)(sizeof(events) / sizeof(events[0])), timeout_ms);
+    flush_overflow();
+    for (int i = 0; i < n; i++) {
+        uint32_t tag = events[i].data.u32;
+        if (tag == TAG_STOP) continue;
+        if (tag == TAG_INOTIFY) {
+            handle_inotify();
+        } else if (tag < EVDEV_MAX_DEVICES) {
+            if (events[i].events & EPOLLIN) read_device((int)tag);
+            if (events[i].events & (EPOLLHUP | EPOLLERR)) device_remove((int)tag);
+        }
+    }
+    generate_repeats(now_us());
+
+    if (wake_needed && wake_fd >= 0) {
+        uint64_t one = 1;
+        ssize_t w = write(wake_fd, &one, sizeof(one));
+        (void)w;   // 计数器饱和（EAGAIN）时主循环本来就会被唤醒
+        wake_needed = false;
+    }
+}
+
+static void* reader_thread_func(void* arg) {
+    (void)arg;
+    while (atomic_load(&reader_running)) reader_poll(reader_timeout_ms());
+    return NULL;
+}
+
+static int watch_fd(int fd, uint32_t tag) {
+    struct epoll_event ev;
+    ev.events = EPOLLIN;
+    ev.data.u32 = tag;
+    return epoll_ctl(epoll_fd, EPOLL_CTL_ADD, fd, &ev);
+}
+
+static int input_evdev_init(void) {
+    fprintf(stderr, "[EVDEV] Initializing input devices...\n");
+
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) devices[i].fd = -1;
+
+    epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    stop_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    if (epoll_fd < 0 || wake_fd < 0 || stop_fd < 0) {
+        fprintf(stderr, "[EVDEV] Failed to create epoll/eventfd: %s\n", strerror(errno));
+        return 0;
+    }
+    watch_fd(stop_fd, TAG_STOP);
+
+    // 先建监听再扫描，避免两者之间插入的设备被漏掉（重复的由 find_device 去重）
+    inotify_fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (inotify_fd < 0 || inotify_add_watch(inotify_fd, EVDEV_INPUT_DIR, IN_CREATE | IN_ATTRIB) < 0 ||
+        watch_fd(inotify_fd, TAG_INOTIFY) < 0) {
+        fprintf(stderr, "[EVDEV] Warning: inotify on %s unavailable, hotplug disabled\n", EVDEV_INPUT_DIR);
+        if (inotify_fd >= 0) close(inotify_fd);
+        inotify_fd = -1;
+    }
+    scan_devices();
+    if (atomic_load(&stats.devices) == 0) {
+        fprintf(stderr, "[EVDEV] Warning: no input device found, waiting for hotplug\n");
+    }
+
+    atomic_store(&reader_running, true);
+    if (pthread_create(&reader_thread, NULL, reader_thread_func, NULL) != 0) {
+        atomic_store(&reader_running, false);
+        fprintf(stderr, "[EVDEV] Warning: failed to create reader thread, falling back to main loop polling\n");
+        return 1;
+    }
+    reader_started = true;
+
+    // 单核 F133 上 UI 线程可能长时间占满 CPU，读取线程用低优先级实时调度保证及时读取
+    struct sched_param sp;
+    sp.sched_priority = EVDEV_READER_PRIORITY;
+    if (pthread_setschedparam(reader_thread, SCHED_FIFO, &sp) != 0) {
+        fprintf(stderr, "[EVDEV] Warning: SCHED_FIFO unavailable for reader thread\n");
+    }
+    pthread_setname_np(reader_thread, "ktv_input");
     return 1;
 }
 
 static lv_indev_t* input_evdev_register_device(input_device_type_t type) {
-    lv_indev_drv_t indev_drv;
-    lv_indev_drv_init(&indev_drv);
-    
     if (type == INPUT_TYPE_POINTER) {
-        indev_drv.type = LV_INDEV_TYPE_POINTER;
-        indev_drv.read_cb = evdev_touch_read;
-        pointer_indev = lv_indev_drv_register(&indev_drv);
+        lv_indev_drv_init(&pointer_drv);
+        pointer_drv.type = LV_INDEV_TYPE_POINTER;
+        pointer_drv.read_cb = evdev_touch_read;
+        pointer_indev = lv_indev_drv_register(&pointer_drv);
         fprintf(stderr, "[EVDEV] Pointer device registered\n");
         return pointer_indev;
     } else if (type == INPUT_TYPE_KEYPAD) {
-        indev_drv.type = LV_INDEV_TYPE_KEYPAD;
-        indev_drv.read_cb = evdev_keypad_read;
-        keypad_indev = lv_indev_drv_register(&indev_drv);
+        lv_indev_drv_init(&keypad_drv);
+        keypad_drv.type = LV_INDEV_TYPE_KEYPAD;
+        keypad_drv.read_cb = evdev_keypad_read;
+        // 连发由驱动生成，关闭 LVGL 自带的长按重复，避免叠加
+        keypad_drv.long_press_repeat_time = UINT16_MAX;
+        keypad_indev = lv_indev_drv_register(&keypad_drv);
         fprintf(stderr, "[EVDEV] Keypad device registered\n");
         return keypad_indev;
     }
-    
+
     return NULL;
 }
 
 static bool input_evdev_process_event(void *event_data) {
-    // 注意：evdev 事件在主循环中通过 read() 读取
+    // 注意：evdev 事件由读取线程处理
     // 此函数可以用于处理其他类型的事件
     (void)event_data;
     return false;
 }
 
-// 从 evdev 设备读取事件（在主循环中调用）
-static void evdev_read_events(void) {
-    struct input_event ev;
-    ssize_t n;
-    
-    // 读取触摸屏事件
-    if (touch_fd >= 0) {
-        while ((n = read(touch_fd, &ev, sizeof(ev))) == sizeof(ev)) {
-            if (ev.type == EV_ABS) {
-                if (ev.code == ABS_X) {
-                    touch_x = ev.value;
-                } else if (ev.code == ABS_Y) {
-                    touch_y = ev.value;
-                }
-            } else if (ev.type == EV_KEY && ev.code == BTN_TOUCH) {
-                touch_pressed = (ev.value != 0);
-            }
-        }
+static void input_evdev_deinit(void) {
+    if (reader_started) {
+        atomic_store(&reader_running, false);
+        uint64_t one = 1;
+        ssize_t w = write(stop_fd, &one, sizeof(one));
+        (void)w;
+        pthread_join(reader_thread, NULL);
+        reader_started = false;
     }
-    
-    // 读取遥控器/键盘事件
-    if (keypad_fd >= 0) {
-        while ((n = read(keypad_fd, &ev, sizeof(ev))) == sizeof(ev)) {
-            if (ev.type == EV_KEY) {
-                if (ev.value == 1) {  // 按下
-                    keypad_key = map_linux_key_to_lvgl(ev.code);
-                    keypad_pressed = true;
-                } else if (ev.value == 0) {  // 释放
-                    if (map_linux_key_to_lvgl(ev.code) == keypad_key) {
-                        keypad_pressed = false;
-                    }
-                }
-            }
+    for (int i = 0; i < EVDEV_MAX_DEVICES; i++) {
+        if (devices[i].fd >= 0) {
+            close(devices[i].fd);
+            devices[i].fd = -1;
         }
     }
-}
-
-static void input_evdev_deinit(void) {
-    if (touch_fd >= 0) {
-        close(touch_fd);
-        touch_fd = -1;
-    }
-    if (keypad_fd >= 0) {
-        close(keypad_fd);
-        keypad_fd = -1;
+    int* fds[] = {&inotify_fd, &epoll_fd, &stop_fd, &wake_fd};
+    for (size_t i = 0; i < sizeof(fds) / sizeof(fds[0]); i++) {
+        if (*fds[i] >= 0) {
+            close(*fds[i]);
+            *fds[i] = -1;
+        }
     }
+    atomic_store(&stats.devices, 0);
     pointer_indev = NULL;
     keypad_indev = NULL;
+    held_key = 0;
+    key_down_device = -1;
+    touch_source = -1;
+    key_overflow_pending = touch_overflow_pending = false;
+    atomic_store(&key_index.head, 0);
+    atomic_store(&key_index.tail, 0);
+    atomic_store(&touch_index.head, 0);
+    atomic_store(&touch_index.tail, 0);
     fprintf(stderr, "[EVDEV] Input driver deinitialized\n");
 }
 
@@ -170,9 +822,59 @@ input_iface_t INPUT = {
     .deinit = input_evdev_deinit
 };
 
-// 导出 evdev 事件读取函数（供主循环调用）
-// 注意：此函数需要在头文件中声明
+// 读取线程未能启动时退化为主循环轮询
 void evdev_read_events_exported(void) {
-    evdev_read_events();
+    if (!reader_started && epoll_fd >= 0) reader_poll(0);
+}
+
+// 让 LVGL 在本次 lv_timer_handler 中立即读取输入，而不是等到读取定时器周期
+static void indev_read_now(lv_indev_t* indev) {
+    if (indev && indev->driver && indev->driver->read_timer) lv_timer_ready(indev->driver->read_timer);
+}
+
+bool evdev_wait(uint32_t timeout_ms) {
+    if (wake_fd < 0) {
+        usleep(timeout_ms * 1000);
+        return false;
+    }
+    struct pollfd pfd;
+    pfd.fd = wake_fd;
+    pfd.events = POLLIN;
+    pfd.revents = 0;
+    if (poll(&pfd, 1, (int)timeout_ms) <= 0) return false;
+
+    uint64_t count;
+    ssize_t r = read(wake_fd, &count, sizeof(count));
+    (void)r;
+    if (!queue_empty(&key_index)) indev_read_now(keypad_indev);
+    if (!queue_empty(&touch_index)) indev_read_now(pointer_indev);
+    return true;
 }
 
+bool evdev_take_key_press(uint16_t *code, uint64_t *ts_us) {
+    if (delivered_head == delivered_tail) return false;
+    const key_event_t* e = &delivered[delivered_head++ % EVDEV_DELIVERED_SIZE];
+    if (code) *code = e->code;
+    if (ts_us) *ts_us = e->ts_us;
+    return true;
+}
+
+void evdev_set_autorepeat(uint32_t delay_ms, uint32_t interval_ms) {
+    atomic_store_explicit(&repeat_delay_ms, delay_ms, memory_order_relaxed);
+    atomic_store_explicit(&repeat_interval_ms, interval_ms, memory_order_relaxed);
+}
+
+void evdev_get_stats(evdev_stats_t *out) {
+    if (out) {
+        out->key_events = atomic_load_explicit(&stats.key_events, memory_order_relaxed);
+        out->touch_events = atomic_load_explicit(&stats.touch_events, memory_order_relaxed);
+        out->repeats = atomic_load_explicit(&stats.repeats, memory_order_relaxed);
+        out->coalesced = atomic_load_explicit(&stats.coalesced, memory_order_relaxed);
+        out->dropped = atomic_load_explicit(&stats.dropped, memory_order_relaxed);
+        out->syn_dropped = atomic_load_explicit(&stats.syn_dropped, memory_order_relaxed);
+        out->max_queue_us = atomic_load_explicit(&stats.max_queue_us, memory_order_relaxed);
+        out->devices = atomic_load_explicit(&stats.devices, memory_order_relaxed);
+        out->hotplugs = atomic_load_explicit(&stats.hotplugs, memory_order_relaxed);
+    }
+    atomic_store_explicit(&stats.max_queue_us, 0, memory_order_relaxed);
+}
@@ -6,17 +6,58 @@
 #ifndef KTVLV_PLATFORM_F133_LINUX_INPUT_EVDEV_H
 #define KTVLV_PLATFORM_F133_LINUX_INPUT_EVDEV_H
 
+#include <stdbool.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C" {
 #endif
 
 /**
  * @brief 从 evdev 设备读取事件（在主循环中调用）
- * 
- * 注意：此函数需要在主循环中定期调用，以更新输入状态
+ *
+ * 正常情况下由独立读取线程读取，此函数为空操作；读取线程创建失败时退化为在此轮询
  */
 void evdev_read_events_exported(void);
 
+/**
+ * @brief 主循环空闲等待：最多等待 timeout_ms，有新输入事件时立即返回
+ *
+ * 返回前让 LVGL 输入设备在下一次 lv_timer_handler 中立即读取（不等读取定时器周期）
+ * @return true 被输入事件唤醒
+ */
+bool evdev_wait(uint32_t timeout_ms);
+
+typedef struct {
+    uint32_t key_events;     /* 入队的按键事件（含连发） */
+    uint32_t touch_events;   /* 入队的触摸帧 */
+    uint32_t repeats;        /* 生成的连发次数 */
+    uint32_t coalesced;      /* 队列满时合并的触摸移动 */
+    uint32_t dropped;        /* 队列满时丢弃的事件 */
+    uint32_t syn_dropped;    /* 内核 SYN_DROPPED 次数 */
+    uint32_t max_queue_us;   /* 内核时间戳 → LVGL 读取的最大排队时间（读取后清零） */
+    uint32_t devices;        /* 当前打开的输入设备数 */
+    uint32_t hotplugs;       /* 启动后热插拔接入的设备数 */
+} evdev_stats_t;
+
+/**
+ * @brief 取出一个已被 LVGL 读取的按键按下（Linux 键码 + 内核时间戳，CLOCK_MONOTONIC 微秒）
+ *
+ * 用于输入延迟统计和调试组合键；不含驱动生成的连发。最多缓存 8 个，需循环调用取完
+ * @return true 取到一个事件
+ */
+bool evdev_take_key_press(uint16_t *code, uint64_t *ts_us);
+
+/**
+ * @brief 设置方向键长按连发：按住 delay_ms 后每 interval_ms 触发一次（interval_ms=0 关闭）
+ */
+void evdev_set_autorepeat(uint32_t delay_ms, uint32_t interval_ms);
+
+/**
+ * @brief 读取驱动统计（max_queue_us 读取后清零）
+ */
+void evdev_get_stats(evdev_stats_t *out);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,103 @@
+/**
+ * @file display_mem.c
+ * @brief 无头显示驱动实现（内存帧缓冲）
+ *
+ * flush 的像素转换与 display_fbdev.c 相同（ARGB8888），只是目标换成 malloc 的缓冲区，
+ * 这样基准测得的刷新开销与真机的 CPU 拷贝部分一致（不含 framebuffer 总线写入）。
+ */
+
+#define _POSIX_C_SOURCE 200809L   /* clock_gettime */
+
+#include "platform/headless/display_mem.h"
+#include <lvgl.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+
+static int32_t mem_width = LV_HOR_RES_MAX;
+static int32_t mem_height = LV_VER_RES_MAX;
+static uint32_t *mem_fb = NULL;
+static display_mem_stats_t mem_stats;
+
+static uint64_t now_ns(void) {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return (uint64_t)ts.tv_sec * 1000000000ULL + (uint64_t)ts.tv_nsec;
+}
+
+void display_mem_set_resolution(int32_t width, int32_t height) {
+    if (mem_fb) return;   /* 初始化之后不允许修改 */
+    if (width > 0) mem_width = width;
+    if (height > 0) mem_height = height;
+}
+
+void display_mem_take_stats(display_mem_stats_t *out) {
+    if (out) *out = mem_stats;
+    memset(&mem_stats, 0, sizeof(mem_stats));
+}
+
+const uint32_t *display_mem_framebuffer(void) {
+    return mem_fb;
+}
+
+static int display_mem_init(void) {
+    if (mem_fb) return 1;
+    mem_fb = (uint32_t *)calloc((size_t)mem_width * (size_t)mem_height, sizeof(uint32_t));
+    if (!mem_fb) {
+        fprintf(stderr, "[MEMDISP] Failed to allocate %dx%d framebuffer\n", (int)mem_width, (int)mem_height);
+        return 0;
+    }
+    memset(&mem_stats, 0, sizeof(mem_stats));
+    fprintf(stderr, "[MEMDISP] Memory framebuffer initialized: %dx%d\n", (int)mem_width, (int)mem_height);
+    return 1;
+}
+
+static void display_mem_flush(lv_disp_drv_t *drv, const lv_area_t *area, lv_color_t *color_p) {
+    uint64_t begin = now_ns();
+
+    int32_t x1 = area->x1 < 0 ? 0 : area->x1;
+    int32_t y1 = area->y1 < 0 ? 0 : area->y1;
+    int32_t x2 = area->x2 >= mem_width ? mem_width - 1 : area->x2;
+    int32_t y2 = area->y2 >= mem_height ? mem_height - 1 : area->y2;
+
+    if (mem_fb && x1 <= x2 && y1 <= y2) {
+        /* color_p 的行跨度是原始区域宽度 */
+        int32_t src_w = area->x2 - area->x1 + 1;
+        int32_t w = x2 - x1 + 1;
+        for (int32_t y = y1; y <= y2; y++) {
+            const lv_color_t *src = color_p + (size_t)(y - area->y1) * (size_t)src_w + (size_t)(x1 - area->x1);
+            uint32_t *dst = mem_fb + (size_t)y * (size_t)mem_width + (size_t)x1;
+#if LV_COLOR_DEPTH == 32
+            memcpy(dst, src, (size_t)w * sizeof(uint32_t));
+#else
+            for (int32_t x = 0; x < w; x++) dst[x] = lv_color_to32(src[x]);
+#endif
+        }
+        mem_stats.flush_px += (uint64_t)w * (uint64_t)(y2 - y1 + 1);
+        mem_stats.flush_bytes += (uint64_t)w * (uint64_t)(y2 - y1 + 1) * sizeof(uint32_t);
+    }
+
+    mem_stats.flush_count++;
+    mem_stats.flush_ns += now_ns() - begin;
+    lv_disp_flush_ready(drv);
+}
+
+static void display_mem_deinit(void) {
+    free(mem_fb);
+    mem_fb = NULL;
+}
+
+static bool display_mem_get_resolution(int32_t *width, int32_t *height) {
+    if (!mem_fb) return false;
+    if (width) *width = mem_width;
+    if (height) *height = mem_height;
+    return true;
+}
+
+display_iface_t DISPLAY = {
+    .init = display_mem_init,
+    .flush = display_mem_flush,
+    .deinit = display_mem_deinit,
+    .get_resolution = display_mem_get_resolution,
+};
@@ -0,0 +1,39 @@
+/**
+ * @file display_mem.h
+ * @brief 无头显示驱动（内存帧缓冲），用于 ktvlv_ui_bench 等不接屏幕的场景
+ *
+ * 与 display_fbdev.c 实现同一 display_iface_t 接口，flush 拷贝到进程内缓冲区，
+ * 并累计刷新次数、字节数和耗时，供基准程序按帧读取。
+ */
+
+#ifndef KTVLV_PLATFORM_HEADLESS_DISPLAY_MEM_H
+#define KTVLV_PLATFORM_HEADLESS_DISPLAY_MEM_H
+
+#include "drivers/display_driver.h"
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct {
+    uint32_t flush_count;   /* flush_cb 调用次数 */
+    uint64_t flush_bytes;   /* 拷贝到帧缓冲的字节数 */
+    uint64_t flush_ns;      /* flush_cb 内累计耗时 */
+    uint64_t flush_px;      /* 刷新像素数 */
+} display_mem_stats_t;
+
+/* 设置分辨率（需在 DISPLAY.init() 之前调用，默认 LV_HOR_RES_MAX x LV_VER_RES_MAX） */
+void display_mem_set_resolution(int32_t width, int32_t height);
+
+/* 读取并清零统计 */
+void display_mem_take_stats(display_mem_stats_t *out);
+
+/* 帧缓冲（ARGB8888，行跨度 = 宽度），未初始化时返回 NULL */
+const uint32_t *display_mem_framebuffer(void);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // KTVLV_PLATFORM_HEADLESS_DISPLAY_MEM_H
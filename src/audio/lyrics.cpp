@@ -0,0 +1,312 @@
+#include "lyrics.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <fstream>
+#include <sstream>
+
+namespace ktv::audio {
+
+namespace {
+
+// 解析阶段的临时结构，时长 < 0 表示待推断
+struct RawWord {
+    int64_t start = 0;
+    int64_t duration = -1;
+    std::string text;
+};
+
+struct RawLine {
+    int64_t start = 0;
+    int64_t duration = -1;
+    std::vector<RawWord> words;
+};
+
+bool parse_uint(const std::string& s, size_t& pos, uint32_t& out, size_t* digits = nullptr) {
+    size_t begin = pos;
+    uint64_t v = 0;
+    while (pos < s.size() && std::isdigit(static_cast<unsigned char>(s[pos]))) {
+        v = v * 10 + static_cast<uint64_t>(s[pos] - '0');
+        if (v > 0xFFFFFFFFULL) return false;
+        ++pos;
+    }
+    if (digits) *digits = pos - begin;
+    out = static_cast<uint32_t>(v);
+    return pos > begin;
+}
+
+// mm:ss / mm:ss.x / mm:ss.xx / mm:ss.xxx（小数点也可以是冒号）
+bool parse_time(const std::string& s, uint32_t& ms) {
+    size_t pos = 0;
+    uint32_t min = 0, sec = 0, frac = 0;
+    if (!parse_uint(s, pos, min) || pos >= s.size() || s[pos] != ':') return false;
+    ++pos;
+    if (!parse_uint(s, pos, sec) || sec >= 60) return false;
+    if (pos < s.size()) {
+        if (s[pos] != '.' && s[pos] != ':') return false;
+        ++pos;
+        size_t digits = 0;
+        if (!parse_uint(s, pos, frac, &digits) || digits > 3) return false;
+        if (digits == 1) frac *= 100;
+        if (digits == 2) frac *= 10;
+    }
+    if (pos != s.size()) return false;
+    ms = min * 60000U + sec * 1000U + frac;
+    return true;
+}
+
+// "a,b" 或 "a,b,c"（KRC 行标签 / 字标签）
+bool parse_pair(const std::string& s, uint32_t& a, uint32_t& b) {
+    size_t pos = 0;
+    if (!parse_uint(s, pos, a) || pos >= s.size() || s[pos] != ',') return false;
+    ++pos;
+    if (!parse_uint(s, pos, b)) return false;
+    if (pos == s.size()) return true;
+    uint32_t unused = 0;
+    return s[pos] == ',' && parse_uint(s, ++pos, unused) && pos == s.size();
+}
+
+/**
+ * 把 <tag>文本<tag>文本... 拆成字；tag 由 on_tag 解释（返回 false 时按普通文本处理）
+ * on_tag 设置下一个字的开始时间，并可补上前一个字的时长
+ */
+template <typename OnTag>
+void split_words(const std::string& body, int64_t line_start, std::vector<RawWord>& words, OnTag on_tag) {
+    int64_t next_start = line_start;
+    std::string seg;
+    auto flush = [&] {
+        if (seg.empty()) return;
+        RawWord w;
+        w.start = next_start;
+        w.text = std::move(seg);
+        words.push_back(std::move(w));
+        seg.clear();
+    };
+
+    size_t pos = 0;
+    while (pos < body.size()) {
+        if (body[pos] == '<') {
+            size_t close = body.find('>', pos + 1);
+            if (close != std::string::npos) {
+                int64_t start = 0, duration = -1;
+                if (on_tag(body.substr(pos + 1, close - pos - 1), start, duration)) {
+                    flush();
+                    if (!words.empty() && words.back().duration < 0) {
+                        words.back().duration = std::max<int64_t>(0, start - words.back().start);
+                    }
+                    next_start = start;
+                    // KRC 字标签自带时长：先建一个空字占位，后续文本并入
+                    if (duration >= 0) {
+                        RawWord w;
+                        w.start = start;
+                        w.duration = duration;
+                        words.push_back(std::move(w));
+                        next_start = -1;
+                    }
+                    pos = close + 1;
+                    continue;
+                }
+            }
+        }
+        if (next_start < 0) {
+            words.back().text += body[pos];
+        } else {
+            seg += body[pos];
+        }
+        ++pos;
+    }
+    flush();
+    words.erase(std::remove_if(words.begin(), words.end(), [](const RawWord& w) { return w.text.empty(); }),
+                words.end());
+}
+
+}  // namespace
+
+bool Lyrics::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open";
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return parse(ss.str(), error);
+}
+
+bool Lyrics::parse(const std::string& content, std::string& error) {
+    lines.clear();
+    words.clear();
+    text.clear();
+
+    std::vector<RawLine> raw;
+    int64_t offset_ms = 0;
+
+    std::istringstream in(content);
+    std::string row;
+    size_t row_no = 0;
+    while (std::getline(in, row)) {
+        ++row_no;
+        if (row_no == 1 && row.compare(0, 3, "\xEF\xBB\xBF") == 0) row.erase(0, 3);
+        while (!row.empty() && (row.back() == '\r' || row.back() == ' ' || row.back() == '\t')) row.pop_back();
+        size_t first = row.find_first_not_of(" \t");
+        if (first == std::string::npos || row[first] != '[') continue;
+
+        // 行首的连续 [..] 标签
+        std::vector<uint32_t> stamps;
+        bool krc = false;
+        uint32_t krc_start = 0, krc_dur = 0;
+        size_t pos = first;
+        while (pos < row.size() && row[pos] == '[') {
+            size_t close = row.find(']', pos + 1);
+            if (close == std::string::npos) break;
+            std::string tag = row.substr(pos + 1, close - pos - 1);
+            uint32_t t = 0;
+            if (parse_time(tag, t)) {
+                stamps.push_back(t);
+            } else if (stamps.empty() && !krc && parse_pair(tag, krc_start, krc_dur)) {
+                krc = true;
+            } else if (tag.compare(0, 7, "offset:") == 0) {
+                offset_ms = std::strtol(tag.c_str() + 7, nullptr, 10);
+            } else {
+                break;  // [ti:] [ar:] 等元数据，或无法识别的行
+            }
+            pos = close + 1;
+        }
+        if (stamps.empty() && !krc) continue;
+        const std::string body = row.substr(pos);
+
+        if (krc) {
+            RawLine line;
+            line.start = krc_start;
+            line.duration = krc_dur;
+            split_words(body, line.start, line.words, [&](const std::string& tag, int64_t& start, int64_t& dur) {
+                uint32_t off = 0, d = 0;
+                if (!parse_pair(tag, off, d)) return false;
+                start = static_cast<int64_t>(krc_start) + off;
+                dur = d;
+                return true;
+            });
+            raw.push_back(std::move(line));
+        } else {
+            RawLine line;
+            line.start = stamps.front();
+            split_words(body, line.start, line.words, [](const std::string& tag, int64_t& start, int64_t&) {
+                uint32_t t = 0;
+                if (!parse_time(tag, t)) return false;
+                start = t;
+                return true;
+            });
+            // 同一行多个时间戳：逐字时间按行开始时间平移
+            for (uint32_t stamp : stamps) {
+                RawLine copy = line;
+                int64_t shift = static_cast<int64_t>(stamp) - line.start;
+                copy.start += shift;
+                for (auto& w : copy.words) w.start += shift;
+                raw.push_back(std::move(copy));
+            }
+        }
+        if (raw.size() > kMaxLines * 2) {
+            error = "too many lines (max " + std::to_string(kMaxLines) + ")";
+            return false;
+        }
+    }
+
+    std::stable_sort(raw.begin(), raw.end(), [](const RawLine& a, const RawLine& b) { return a.start < b.start; });
+
+    for (size_t i = 0; i < raw.size(); ++i) {
+        RawLine& l = raw[i];
+        if (l.words.empty()) continue;  // 空行只用来结束上一行
+        const int64_t next_line = i + 1 < raw.size() ? raw[i + 1].start : l.start + kMaxInferredMs;
+        const int64_t line_end = l.duration >= 0 ? l.start + l.duration
+                                                 : std::min<int64_t>(next_line, l.start + kMaxInferredMs);
+
+        int64_t prev_start = l.start;
+        for (size_t k = 0; k < l.words.size(); ++k) {
+            RawWord& w = l.words[k];
+            w.start = std::max(w.start, prev_start);
+            if (w.duration < 0) {
+                int64_t end = k + 1 < l.words.size() ? l.words[k + 1].start : line_end;
+                w.duration = std::max<int64_t>(0, end - w.start);
+            }
+            prev_start = w.start;
+        }
+        const RawWord& last = l.words.back();
+        int64_t end = std::max(l.duration >= 0 ? l.start + l.duration : 0, last.start + last.duration);
+
+        if (lines.size() >= kMaxLines || words.size() + l.words.size() > kMaxWords) {
+            error = "too many lines or words (max " + std::to_string(kMaxLines) + "/" +
+                    std::to_string(kMaxWords) + ")";
+            return false;
+        }
+        auto shifted = [offset_ms](int64_t t) { return static_cast<uint32_t>(std::max<int64_t>(0, t - offset_ms)); };
+
+        LyricLine line;
+        line.start_ms = shifted(l.start);
+        line.duration_ms = shifted(end) - line.start_ms;
+        line.first_word = static_cast<uint32_t>(words.size());
+        line.text_offset = static_cast<uint32_t>(text.size());
+        for (const auto& w : l.words) {
+            if (w.text.size() > 0xFFFF || text.size() - line.text_offset + w.text.size() > 0xFFFF) {
+                error = "line too long at " + std::to_string(l.start) + "ms";
+                return false;
+            }
+            LyricWord word;
+            word.start_ms = shifted(w.start);
+            word.duration_ms = shifted(w.start + w.duration) - word.start_ms;
+            word.text_offset = static_cast<uint32_t>(text.size());
+            word.text_len = static_cast<uint16_t>(w.text.size());
+            text += w.text;
+            words.push_back(word);
+        }
+        line.word_count = static_cast<uint16_t>(l.words.size());
+        line.text_len = static_cast<uint16_t>(text.size() - line.text_offset);
+        lines.push_back(line);
+    }
+
+    if (lines.empty()) {
+        error = "no timed lines";
+        return false;
+    }
+    return true;
+}
+
+int Lyrics::lineAt(uint32_t ms) const {
+    auto it = std::upper_bound(lines.begin(), lines.end(), ms,
+                               [](uint32_t t, const LyricLine& l) { return t < l.start_ms; });
+    return static_cast<int>(it - lines.begin()) - 1;
+}
+
+LyricPosition Lyrics::locate(uint32_t ms) const {
+    LyricPosition pos;
+    pos.line = lineAt(ms);
+    if (pos.line < 0) return pos;
+
+    const LyricLine& l = lines[static_cast<size_t>(pos.line)];
+    auto first = words.begin() + l.first_word;
+    auto last = first + l.word_count;
+    auto it = std::upper_bound(first, last, ms, [](uint32_t t, const LyricWord& w) { return t < w.start_ms; });
+    int w = static_cast<int>(it - first) - 1;
+    if (w < 0) return pos;  // 行已开始，第一个字还没到
+
+    const LyricWord& word = *(first + w);
+    if (ms >= word.endMs()) {
+        // 字与字之间的空隙按前一个字已唱完处理
+        pos.word = w + 1;
+        return pos;
+    }
+    pos.word = w;
+    pos.progress = static_cast<float>(ms - word.start_ms) / static_cast<float>(word.duration_ms);
+    return pos;
+}
+
+std::string Lyrics::lineText(size_t line) const {
+    if (line >= lines.size()) return {};
+    return text.substr(lines[line].text_offset, lines[line].text_len);
+}
+
+std::string Lyrics::wordText(size_t word) const {
+    if (word >= words.size()) return {};
+    return text.substr(words[word].text_offset, words[word].text_len);
+}
+
+}  // namespace ktv::audio
@@ -0,0 +1,77 @@
+#ifndef KTVLV_AUDIO_LYRICS_H
+#define KTVLV_AUDIO_LYRICS_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ktv::audio {
+
+// 一个逐字时间单元（KRC 的一个字/词，或增强 LRC 的一个 <mm:ss.xx> 段）
+struct LyricWord {
+    uint32_t start_ms = 0;     // 歌曲时间
+    uint32_t duration_ms = 0;
+    uint32_t text_offset = 0;  // 在 Lyrics::text 中的字节偏移
+    uint16_t text_len = 0;     // UTF-8 字节数
+
+    uint32_t endMs() const { return start_ms + duration_ms; }
+};
+
+// 一行歌词：字在 Lyrics::words 中连续存放，文本在 Lyrics::text 中连续存放
+struct LyricLine {
+    uint32_t start_ms = 0;
+    uint32_t duration_ms = 0;
+    uint32_t first_word = 0;
+    uint16_t word_count = 0;
+    uint32_t text_offset = 0;
+    uint16_t text_len = 0;
+
+    uint32_t endMs() const { return start_ms + duration_ms; }
+};
+
+// 某一时刻的演唱位置：word == word_count 表示该行已唱完
+struct LyricPosition {
+    int line = -1;             // -1 表示第一行开始之前
+    int word = 0;
+    float progress = 0.0f;     // 当前字内的进度 0..1
+};
+
+/**
+ * Lyrics - 逐字时间轴歌词（卡拉 OK 擦除用）
+ *
+ * 支持的文本格式（UTF-8，可带 BOM），按内容自动识别：
+ *   KRC（已解密的文本）：[行开始ms,行时长ms]<字偏移ms,字时长ms,0>字...
+ *   增强 LRC：[mm:ss.xx]<mm:ss.xx>字<mm:ss.xx>字...<mm:ss.xx>
+ *   普通 LRC：[mm:ss.xx]整行文本（整行视为一个字，时长推到下一行开始，最长 kMaxInferredMs）
+ * 普通 LRC 一行可带多个时间戳（重复的副歌），支持 [offset:±ms]；[ti:] 等标签忽略。
+ *
+ * 解析后全部行/字/文本各存一个连续数组，按 start_ms 排序，locate() 两次二分查找，
+ * 每帧调用无内存分配。行数、字数有上限，保证每首歌内存有界。
+ */
+struct Lyrics {
+    static constexpr size_t kMaxLines = 1024;
+    static constexpr size_t kMaxWords = 16384;
+    static constexpr uint32_t kMaxInferredMs = 8000;
+
+    std::vector<LyricLine> lines;
+    std::vector<LyricWord> words;
+    std::string text;
+
+    // 读取并解析文件；失败时 error 为可读原因（含行号）
+    bool load(const std::string& path, std::string& error);
+    bool parse(const std::string& content, std::string& error);
+
+    // 最后一个 start_ms ≤ ms 的行，没有则 -1
+    int lineAt(uint32_t ms) const;
+    LyricPosition locate(uint32_t ms) const;
+
+    std::string lineText(size_t line) const;
+    std::string wordText(size_t word) const;
+
+    uint32_t durationMs() const { return lines.empty() ? 0 : lines.back().endMs(); }
+};
+
+}  // namespace ktv::audio
+
+#endif  // KTVLV_AUDIO_LYRICS_H
@@ -0,0 +1,262 @@
+#include "pitch_detector.h"
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#define KTV_PITCH_NEON 1
+#endif
+
+namespace ktv::audio {
+
+namespace {
+
+constexpr int kTargetRate = 16000;   // 抽取目标采样率
+constexpr int kFirTapsPerPhase = 16; // 抽取滤波器长度 = 16 * 倍数 + 1
+constexpr float kPi = 3.14159265358979f;
+
+// Σ (a[i] - b[i])²：YIN 差分函数的内层循环，占全部计算量的绝大部分
+#ifdef KTV_PITCH_NEON
+float diff_energy(const float* a, const float* b, int n) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 8 <= n; i += 8) {
+        float32x4_t d0 = vsubq_f32(vld1q_f32(a + i), vld1q_f32(b + i));
+        float32x4_t d1 = vsubq_f32(vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+        acc0 = vmlaq_f32(acc0, d0, d0);
+        acc1 = vmlaq_f32(acc1, d1, d1);
+    }
+    float32x4_t acc = vaddq_f32(acc0, acc1);
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    float sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+    for (; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+float dot(const float* a, const float* b, int n) {
+    float32x4_t acc = vdupq_n_f32(0.0f);
+    int i = 0;
+    for (; i + 4 <= n; i += 4) acc = vmlaq_f32(acc, vld1q_f32(a + i), vld1q_f32(b + i));
+    float32x2_t pair = vadd_f32(vget_low_f32(acc), vget_high_f32(acc));
+    float sum = vget_lane_f32(vpadd_f32(pair, pair), 0);
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+#else
+// 4 路独立累加，打破依赖链，编译器可自动向量化（RVV / SSE）
+float diff_energy(const float* a, const float* b, int n) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        float d0 = a[i] - b[i];
+        float d1 = a[i + 1] - b[i + 1];
+        float d2 = a[i + 2] - b[i + 2];
+        float d3 = a[i + 3] - b[i + 3];
+        s0 += d0 * d0;
+        s1 += d1 * d1;
+        s2 += d2 * d2;
+        s3 += d3 * d3;
+    }
+    float sum = (s0 + s1) + (s2 + s3);
+    for (; i < n; ++i) {
+        float d = a[i] - b[i];
+        sum += d * d;
+    }
+    return sum;
+}
+
+float dot(const float* a, const float* b, int n) {
+    float s0 = 0.0f, s1 = 0.0f, s2 = 0.0f, s3 = 0.0f;
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        s0 += a[i] * b[i];
+        s1 += a[i + 1] * b[i + 1];
+        s2 += a[i + 2] * b[i + 2];
+        s3 += a[i + 3] * b[i + 3];
+    }
+    float sum = (s0 + s1) + (s2 + s3);
+    for (; i < n; ++i) sum += a[i] * b[i];
+    return sum;
+}
+#endif
+
+}  // namespace
+
+PitchDetector::PitchDetector(const Config& cfg) : cfg_(cfg) {
+    cfg_.sample_rate = std::max(8000, cfg_.sample_rate);
+    cfg_.channels = std::max(1, cfg_.channels);
+    cfg_.min_hz = std::max(40.0f, cfg_.min_hz);
+    cfg_.max_hz = std::max(cfg_.min_hz * 2.0f, cfg_.max_hz);
+
+    decim_ = std::max(1, cfg_.sample_rate / kTargetRate);
+    rate_ = cfg_.sample_rate / decim_;
+    window_ = std::max(64, rate_ * cfg_.window_ms / 1000);
+    hop_ = std::max(1, rate_ * cfg_.hop_ms / 1000);
+    tau_max_ = static_cast<int>(std::ceil(static_cast<float>(rate_) / cfg_.min_hz));
+    tau_min_ = std::max(2, static_cast<int>(static_cast<float>(rate_) / cfg_.max_hz));
+
+    if (decim_ > 1) {
+        // 加 Hamming 窗的 sinc 低通，截止在抽取后奈奎斯特频率的 90%
+        int taps = kFirTapsPerPhase * decim_ + 1;
+        int mid = taps / 2;
+        float fc = 0.45f / static_cast<float>(decim_);
+        fir_.resize(static_cast<size_t>(taps));
+        float sum = 0.0f;
+        for (int n = 0; n < taps; ++n) {
+            float x = static_cast<float>(n - mid);
+            float sinc = x == 0.0f ? 2.0f * fc : std::sin(2.0f * kPi * fc * x) / (kPi * x);
+            float win = 0.54f - 0.46f * std::cos(2.0f * kPi * static_cast<float>(n) / static_cast<float>(taps - 1));
+            fir_[static_cast<size_t>(n)] = sinc * win;
+            sum += fir_[static_cast<size_t>(n)];
+        }
+        for (float& h : fir_) h /= sum;
+        fir_hist_.assign(fir_.size() * 2, 0.0f);
+        fir_delay_ = mid / decim_;
+    }
+
+    span_ = static_cast<size_t>(window_ + tau_max_);
+    buf_.assign(span_ * 2, 0.0f);
+    diff_.assign(static_cast<size_t>(tau_max_ + 2), 0.0f);
+}
+
+void PitchDetector::reset() {
+    std::fill(fir_hist_.begin(), fir_hist_.end(), 0.0f);
+    std::fill(buf_.begin(), buf_.end(), 0.0f);
+    fir_pos_ = 0;
+    decim_phase_ = 0;
+    pos_ = 0;
+    filled_ = 0;
+    since_hop_ = 0;
+    samples_out_ = 0;
+}
+
+void PitchDetector::skip(uint64_t frames) {
+    if (frames == 0) return;
+    std::fill(fir_hist_.begin(), fir_hist_.end(), 0.0f);
+    fir_pos_ = 0;
+    filled_ = 0;
+    since_hop_ = 0;
+    // 输入帧换算到分析采样率；余数留在抽取相位里，时钟不随跳过次数累积误差
+    const uint64_t total = frames + static_cast<uint64_t>(decim_phase_);
+    samples_out_ += total / static_cast<uint64_t>(decim_);
+    decim_phase_ = static_cast<int>(total % static_cast<uint64_t>(decim_));
+}
+
+float PitchDetector::hzToMidi(float hz) {
+    if (hz <= 0.0f) return 0.0f;
+    return 69.0f + 12.0f * std::log2(hz / 440.0f);
+}
+
+size_t PitchDetector::process(const void* data, size_t frames, std::vector<PitchFrame>& out) {
+    size_t produced = 0;
+    const int ch = cfg_.channels;
+    const float inv = 1.0f / static_cast<float>(ch);
+    if (cfg_.format == SampleFormat::S16) {
+        const int16_t* p = static_cast<const int16_t*>(data);
+        constexpr float kScale = 1.0f / 32768.0f;
+        for (size_t i = 0; i < frames; ++i, p += ch) {
+            int32_t acc = 0;
+            for (int c = 0; c < ch; ++c) acc += p[c];
+            pushSample(static_cast<float>(acc) * kScale * inv, out, produced);
+        }
+    } else {
+        const int32_t* p = static_cast<const int32_t*>(data);
+        constexpr float kScale = 1.0f / 2147483648.0f;
+        for (size_t i = 0; i < frames; ++i, p += ch) {
+            float acc = 0.0f;
+            for (int c = 0; c < ch; ++c) acc += static_cast<float>(p[c]) * kScale;
+            pushSample(acc * inv, out, produced);
+        }
+    }
+    return produced;
+}
+
+void PitchDetector::pushSample(float s, std::vector<PitchFrame>& out, size_t& produced) {
+    if (decim_ > 1) {
+        size_t taps = fir_.size();
+        fir_hist_[fir_pos_] = s;
+        fir_hist_[fir_pos_ + taps] = s;
+        fir_pos_ = (fir_pos_ + 1) % taps;
+        if (++decim_phase_ < decim_) return;
+        decim_phase_ = 0;
+        // fir_hist_[fir_pos_ .. fir_pos_ + taps) 由旧到新；对称滤波器，方向无关
+        s = dot(&fir_hist_[fir_pos_], fir_.data(), static_cast<int>(taps));
+    }
+
+    buf_[pos_] = s;
+    buf_[pos_ + span_] = s;
+    pos_ = (pos_ + 1) % span_;
+    ++samples_out_;
+    if (filled_ < span_) ++filled_;
+    if (++since_hop_ < hop_ || filled_ < span_) return;
+    since_hop_ = 0;
+
+    PitchFrame frame;
+    // 窗口是缓冲中最早的 W 个样本，时间取窗口中心（扣除抽取滤波器延迟）
+    int64_t center = static_cast<int64_t>(samples_out_) - static_cast<int64_t>(span_) + window_ / 2 - fir_delay_;
+    frame.time_ms = center > 0 ? static_cast<uint64_t>(center) * 1000ULL / static_cast<uint64_t>(rate_) : 0;
+    analyze(frame);
+    out.push_back(frame);
+    ++produced;
+}
+
+void PitchDetector::analyze(PitchFrame& frame) {
+    const float* x = &buf_[pos_];
+    const int w = window_;
+
+    float energy = dot(x, x, w);
+    frame.rms = std::sqrt(energy / static_cast<float>(w));
+    if (frame.rms < cfg_.silence_rms) return;
+
+    // d(τ)，τ = 1..tau_max（累计均值归一化需要从 1 开始）
+    float* d = diff_.data();
+    d[0] = 0.0f;
+    for (int tau = 1; tau <= tau_max_; ++tau) d[tau] = diff_energy(x, x + tau, w);
+
+    // d'(τ) = d(τ) · τ / Σ_{1..τ} d
+    float running = 0.0f;
+    d[0] = 1.0f;
+    for (int tau = 1; tau <= tau_max_; ++tau) {
+        running += d[tau];
+        d[tau] = running > 0.0f ? d[tau] * static_cast<float>(tau) / running : 1.0f;
+    }
+
+    // 绝对阈值：第一个低于阈值的谷底；都不低于阈值时取全局最小（判为清音）
+    int best = -1;
+    for (int tau = tau_min_; tau <= tau_max_; ++tau) {
+        if (d[tau] < cfg_.threshold) {
+            while (tau + 1 <= tau_max_ && d[tau + 1] < d[tau]) ++tau;
+            best = tau;
+            break;
+        }
+    }
+    bool below = best >= 0;
+    if (!below) {
+        best = tau_min_;
+        for (int tau = tau_min_ + 1; tau <= tau_max_; ++tau) {
+            if (d[tau] < d[best]) best = tau;
+        }
+    }
+
+    // 抛物线插值得到亚采样精度的周期
+    float period = static_cast<float>(best);
+    if (best > tau_min_ && best < tau_max_) {
+        float s0 = d[best - 1], s1 = d[best], s2 = d[best + 1];
+        float denom = s0 - 2.0f * s1 + s2;
+        if (denom > 0.0f) {
+            float shift = 0.5f * (s0 - s2) / denom;
+            if (shift > -1.0f && shift < 1.0f) period += shift;
+        }
+    }
+
+    frame.confidence = std::min(1.0f, std::max(0.0f, 1.0f - d[best]));
+    frame.voiced = below;
+    frame.f0_hz = below ? static_cast<float>(rate_) / period : 0.0f;
+}
+
+}  // namespace ktv::audio
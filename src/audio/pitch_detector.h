@@ -0,0 +1,102 @@
+#ifndef KTVLV_AUDIO_PITCH_DETECTOR_H
+#define KTVLV_AUDIO_PITCH_DETECTOR_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+namespace ktv::audio {
+
+enum class SampleFormat { S16, S32 };
+
+// 一个分析帧的结果（时间为该帧窗口中心相对流起点的毫秒数）
+struct PitchFrame {
+    uint64_t time_ms = 0;
+    float f0_hz = 0.0f;        // 0 表示无声/清音
+    float confidence = 0.0f;   // 0..1，1 - YIN 归一化差分最小值
+    float rms = 0.0f;          // 帧能量（满幅 = 1）
+    bool voiced = false;
+};
+
+/**
+ * PitchDetector - YIN 基频检测（唱歌打分用）
+ *
+ * - 输入：交错 PCM（S16/S32，任意声道数，取各声道平均），16k–48k 采样率
+ * - 高于 16k 的输入先整数倍抽取（FIR 低通）到 ~16k 再分析，人声 F0 范围内精度足够
+ * - 差分函数 d(τ) 直接计算，内层循环 NEON 向量化（无 NEON 时为可自动向量化的 4 路累加）
+ * - 累计均值归一化 + 绝对阈值 + 抛物线插值，输出 F0 与置信度
+ * - 所有缓冲在构造时分配，process() 不分配内存（out 需由调用方预留）
+ *
+ * 非线程安全：一个实例只能由一个线程使用
+ */
+class PitchDetector {
+public:
+    struct Config {
+        int sample_rate = 16000;
+        int channels = 1;
+        SampleFormat format = SampleFormat::S16;
+        float min_hz = 70.0f;         // 最低可检测基频（决定最大 τ）
+        float max_hz = 1000.0f;
+        float threshold = 0.15f;      // YIN 绝对阈值，越小越严格
+        float silence_rms = 0.01f;    // 低于该能量直接判为无声（约 -40 dBFS）
+        int window_ms = 32;           // 积分窗口
+        int hop_ms = 10;              // 帧移
+    };
+
+    explicit PitchDetector(const Config& cfg);
+
+    /**
+     * 输入 frames 帧交错 PCM，每凑满一个帧移追加一个结果到 out
+     * @return 本次产生的结果数
+     */
+    size_t process(const void* data, size_t frames, std::vector<PitchFrame>& out);
+
+    // 清空内部缓冲，时间从 0 重新开始
+    void reset();
+
+    /**
+     * 输入流中丢了 frames 帧（读者落后被覆盖 / 主动跳过积压）：时钟前进相应时长，
+     * 清空分析窗口与抽取滤波器历史（跨越断点的窗口不可信），重新填满窗口后才继续出帧
+     */
+    void skip(uint64_t frames);
+
+    const Config& config() const { return cfg_; }
+    int analysisRate() const { return rate_; }
+
+    // F0（Hz）→ MIDI 音高（浮点，A4 = 69）；f0 <= 0 返回 0
+    static float hzToMidi(float hz);
+
+private:
+    void pushSample(float s, std::vector<PitchFrame>& out, size_t& produced);
+    void analyze(PitchFrame& frame);
+
+    Config cfg_;
+    int decim_ = 1;             // 抽取倍数
+    int rate_ = 16000;          // 分析采样率
+    int window_ = 0;            // W
+    int tau_min_ = 2;
+    int tau_max_ = 0;
+    int hop_ = 0;
+
+    // 抽取 FIR
+    std::vector<float> fir_;
+    std::vector<float> fir_hist_;   // 环形历史（同样双写，点积时连续访问）
+    size_t fir_pos_ = 0;
+    int decim_phase_ = 0;
+    int fir_delay_ = 0;         // FIR 群延迟（分析采样率下的样本数）
+
+    // 分析缓冲：最近 N = W + tau_max 个样本，每个样本写两份（i 与 i + N），
+    // 任意时刻 buf_[pos_ .. pos_ + N) 都是按时间顺序的连续数组
+    std::vector<float> buf_;
+    size_t span_ = 0;           // N
+    size_t pos_ = 0;
+    size_t filled_ = 0;
+    int since_hop_ = 0;
+    uint64_t samples_out_ = 0;  // 分析采样率下已输入的样本数
+
+    std::vector<float> diff_;   // d(τ)，再原地变为 d'(τ)
+};
+
+}  // namespace ktv::audio
+
+#endif  // KTVLV_AUDIO_PITCH_DETECTOR_H
@@ -0,0 +1,65 @@
+#include "reference_melody.h"
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+
+namespace ktv::audio {
+
+bool ReferenceMelody::load(const std::string& path, std::string& error) {
+    std::ifstream in(path, std::ios::binary);
+    if (!in) {
+        error = "cannot open";
+        return false;
+    }
+    std::ostringstream ss;
+    ss << in.rdbuf();
+    return parse(ss.str(), error);
+}
+
+bool ReferenceMelody::parse(const std::string& text, std::string& error) {
+    notes.clear();
+    line_count = 0;
+
+    std::istringstream in(text);
+    std::string row;
+    size_t row_no = 0;
+    while (std::getline(in, row)) {
+        ++row_no;
+        size_t first = row.find_first_not_of(" \t\r");
+        if (first == std::string::npos || row[first] == '#') continue;
+
+        unsigned long start = 0, duration = 0;
+        float midi = 0.0f;
+        unsigned line = 0;
+        if (std::sscanf(row.c_str() + first, "%lu %lu %f %u", &start, &duration, &midi, &line) != 4) {
+            error = "line " + std::to_string(row_no) + ": expected 'start_ms duration_ms midi line'";
+            return false;
+        }
+        if (duration == 0 || midi < 0.0f || midi > 127.0f || line >= 0xFFFF) {
+            error = "line " + std::to_string(row_no) + ": value out of range";
+            return false;
+        }
+        if (notes.size() >= kMaxNotes) {
+            error = "too many notes (max " + std::to_string(kMaxNotes) + ")";
+            return false;
+        }
+        MelodyNote note;
+        note.start_ms = static_cast<uint32_t>(start);
+        note.duration_ms = static_cast<uint32_t>(duration);
+        note.midi = midi;
+        note.line = static_cast<uint16_t>(line);
+        notes.push_back(note);
+        line_count = std::max<uint16_t>(line_count, static_cast<uint16_t>(line + 1));
+    }
+
+    if (notes.empty()) {
+        error = "no notes";
+        return false;
+    }
+    std::stable_sort(notes.begin(), notes.end(),
+                     [](const MelodyNote& a, const MelodyNote& b) { return a.start_ms < b.start_ms; });
+    return true;
+}
+
+}  // namespace ktv::audio
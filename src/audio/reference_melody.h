@@ -0,0 +1,44 @@
+#ifndef KTVLV_AUDIO_REFERENCE_MELODY_H
+#define KTVLV_AUDIO_REFERENCE_MELODY_H
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+namespace ktv::audio {
+
+// 参考旋律中的一个音符（时间相对歌曲开头）
+struct MelodyNote {
+    uint32_t start_ms = 0;
+    uint32_t duration_ms = 0;
+    float midi = 0.0f;         // MIDI 音高，A4 = 69，可带小数
+    uint16_t line = 0;         // 所属歌词行（从 0 开始）
+
+    uint32_t endMs() const { return start_ms + duration_ms; }
+};
+
+/**
+ * ReferenceMelody - 每首歌的参考旋律（打分基准）
+ *
+ * 文件为纯文本，随歌曲缓存存放在 <song_dir>/melody.txt，每行一个音符：
+ *   start_ms duration_ms midi line
+ * '#' 开头为注释，空行忽略。加载后按 start_ms 排序，音符数上限 kMaxNotes，
+ * 保证每首歌的打分内存有界。
+ */
+struct ReferenceMelody {
+    static constexpr size_t kMaxNotes = 4096;
+
+    std::vector<MelodyNote> notes;
+    uint16_t line_count = 0;
+
+    // 读取并解析文件；失败时 error 为可读原因（含行号）
+    bool load(const std::string& path, std::string& error);
+    bool parse(const std::string& text, std::string& error);
+
+    uint32_t durationMs() const { return notes.empty() ? 0 : notes.back().endMs(); }
+};
+
+}  // namespace ktv::audio
+
+#endif  // KTVLV_AUDIO_REFERENCE_MELODY_H
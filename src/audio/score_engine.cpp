@@ -0,0 +1,113 @@
+#include "score_engine.h"
+#include <algorithm>
+#include <cmath>
+#include <utility>
+
+namespace ktv::audio {
+
+ScoreEngine::ScoreEngine(ReferenceMelody melody, const Config& cfg) : melody_(std::move(melody)), cfg_(cfg) {
+    cfg_.time_tolerance_ms = std::max(0, cfg_.time_tolerance_ms);
+    cfg_.zero_credit_cents = std::max(cfg_.full_credit_cents + 1.0f, cfg_.zero_credit_cents);
+    cfg_.coverage = std::min(1.0f, std::max(0.1f, cfg_.coverage));
+    cfg_.hop_ms = std::max(1, cfg_.hop_ms);
+    for (const auto& n : melody_.notes) total_weight_ += n.duration_ms;
+    reset();
+}
+
+void ScoreEngine::reset() {
+    credit_.assign(melody_.notes.size(), 0.0f);
+    next_final_ = 0;
+    settled_sum_ = 0.0;
+    settled_weight_ = 0;
+    line_ = LineScore{};
+    line_sum_ = 0.0;
+    line_weight_ = 0;
+    live_ = LiveScore{};
+}
+
+float ScoreEngine::pitchCredit(float sung_midi, float ref_midi, float* cents_out) const {
+    float d = sung_midi - ref_midi;
+    if (cfg_.octave_fold) d -= 12.0f * std::round(d / 12.0f);
+    float cents = d * 100.0f;
+    if (cents_out) *cents_out = cents;
+    float a = std::fabs(cents);
+    if (a <= cfg_.full_credit_cents) return 1.0f;
+    if (a >= cfg_.zero_credit_cents) return 0.0f;
+    return (cfg_.zero_credit_cents - a) / (cfg_.zero_credit_cents - cfg_.full_credit_cents);
+}
+
+void ScoreEngine::feed(uint32_t song_ms, const PitchFrame& frame, std::vector<LineScore>& lines) {
+    settleUntil(song_ms, lines);
+
+    const auto& notes = melody_.notes;
+    const uint32_t tol = static_cast<uint32_t>(cfg_.time_tolerance_ms);
+    const bool voiced = frame.voiced && frame.f0_hz > 0.0f && frame.confidence >= cfg_.min_confidence;
+    const float sung = voiced ? PitchDetector::hzToMidi(frame.f0_hz) : 0.0f;
+
+    live_.song_ms = song_ms;
+    live_.sung_midi = sung;
+    live_.ref_midi = 0.0f;
+    live_.cents = 0.0f;
+
+    // 时间窗 [start - tol, end + tol] 覆盖 song_ms 的音符，游标之后通常只有 1–2 个
+    for (size_t i = next_final_; i < notes.size(); ++i) {
+        const MelodyNote& n = notes[i];
+        if (n.start_ms > song_ms + tol) break;
+        if (song_ms > n.endMs() + tol) continue;
+        if (song_ms >= n.start_ms && song_ms < n.endMs()) live_.ref_midi = n.midi;
+        if (!voiced) continue;
+        float cents = 0.0f;
+        float c = pitchCredit(sung, n.midi, &cents);
+        credit_[i] += c;
+        if (song_ms >= n.start_ms && song_ms < n.endMs()) live_.cents = cents;
+    }
+}
+
+void ScoreEngine::finish(std::vector<LineScore>& lines) {
+    while (next_final_ < melody_.notes.size()) settleNote(next_final_++, lines);
+}
+
+float ScoreEngine::totalScore() const {
+    if (total_weight_ == 0) return 0.0f;
+    return static_cast<float>(settled_sum_ * 100.0 / static_cast<double>(total_weight_));
+}
+
+void ScoreEngine::settleUntil(uint32_t song_ms, std::vector<LineScore>& lines) {
+    const auto& notes = melody_.notes;
+    const uint64_t tol = static_cast<uint64_t>(cfg_.time_tolerance_ms);
+    while (next_final_ < notes.size() && static_cast<uint64_t>(notes[next_final_].endMs()) + tol < song_ms) {
+        settleNote(next_final_++, lines);
+    }
+}
+
+void ScoreEngine::settleNote(size_t index, std::vector<LineScore>& lines) {
+    const auto& notes = melody_.notes;
+    const MelodyNote& n = notes[index];
+    float expected = static_cast<float>(std::max<uint32_t>(1, n.duration_ms / static_cast<uint32_t>(cfg_.hop_ms)));
+    float score = std::min(1.0f, credit_[index] / (expected * cfg_.coverage));
+
+    if (line_.notes == 0) {
+        line_.line = n.line;
+        line_.start_ms = n.start_ms;
+    }
+    line_.end_ms = std::max(line_.end_ms, n.endMs());
+    ++line_.notes;
+    if (score >= 0.5f) ++line_.hit_notes;
+    line_sum_ += static_cast<double>(score) * n.duration_ms;
+    line_weight_ += n.duration_ms;
+
+    settled_sum_ += static_cast<double>(score) * n.duration_ms;
+    settled_weight_ += n.duration_ms;
+    live_.score = static_cast<float>(settled_sum_ * 100.0 / static_cast<double>(settled_weight_));
+
+    bool line_end = index + 1 >= notes.size() || notes[index + 1].line != n.line;
+    if (!line_end) return;
+    line_.score = line_weight_ > 0 ? static_cast<float>(line_sum_ * 100.0 / static_cast<double>(line_weight_)) : 0.0f;
+    lines.push_back(line_);
+    ++live_.lines_done;
+    line_ = LineScore{};
+    line_sum_ = 0.0;
+    line_weight_ = 0;
+}
+
+}  // namespace ktv::audio
@@ -0,0 +1,102 @@
+#ifndef KTVLV_AUDIO_SCORE_ENGINE_H
+#define KTVLV_AUDIO_SCORE_ENGINE_H
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+#include "pitch_detector.h"
+#include "reference_melody.h"
+
+namespace ktv::audio {
+
+// 一句歌词唱完后的得分
+struct LineScore {
+    uint16_t line = 0;
+    uint32_t start_ms = 0;
+    uint32_t end_ms = 0;
+    uint16_t notes = 0;
+    uint16_t hit_notes = 0;    // 得分 ≥ 50% 的音符数
+    float score = 0.0f;        // 0..100，按音符时长加权
+};
+
+// 最近一帧的实时状态（音高条 / 实时分显示用）
+struct LiveScore {
+    uint32_t song_ms = 0;
+    float sung_midi = 0.0f;    // 0 表示当前无声
+    float ref_midi = 0.0f;     // 0 表示当前没有参考音符
+    float cents = 0.0f;        // 演唱相对参考音的偏差（已做八度折叠）
+    float score = 0.0f;        // 已结算音符的累计得分 0..100
+    uint16_t lines_done = 0;
+};
+
+/**
+ * ScoreEngine - 音高流与参考旋律对齐打分
+ *
+ * - 逐帧输入（时间已换算到歌曲时间），增量推进：音符游标只前进不回退，
+ *   每帧只检查时间窗内的少数音符，内存只有每个音符一个累加值（上限见 ReferenceMelody）
+ * - 时间容差：音符窗口向两侧各放宽 time_tolerance_ms，抢拍/拖拍在容差内不扣分
+ * - 音高容差：偏差 ≤ full_credit_cents 满分，到 zero_credit_cents 线性降为 0；
+ *   开启 octave_fold 时先折叠到 ±6 个半音以内（男女声唱同一旋律高低八度都算对）
+ * - 音符得分 = 唱准帧的累计得分 / (音符帧数 × coverage)，封顶 1；
+ *   音符窗口结束后结算，一句的最后一个音符结算时输出 LineScore
+ *
+ * 同一句的音符在文件中必须连续。非线程安全：由调用方保证单线程使用。
+ */
+class ScoreEngine {
+public:
+    struct Config {
+        int time_tolerance_ms = 150;
+        float full_credit_cents = 50.0f;
+        float zero_credit_cents = 200.0f;
+        bool octave_fold = true;
+        float min_confidence = 0.5f;   // 低于该置信度的帧视为无声
+        float coverage = 0.7f;         // 音符时长中唱准多少比例即得满分
+        int hop_ms = 10;               // 音高帧间隔（与 PitchDetector 一致）
+    };
+
+    ScoreEngine(ReferenceMelody melody, const Config& cfg);
+
+    /**
+     * 输入一帧音高，song_ms 为该帧对应的歌曲时间（已扣除采集延迟）
+     * 因时间推进而结算完的句子追加到 lines
+     */
+    void feed(uint32_t song_ms, const PitchFrame& frame, std::vector<LineScore>& lines);
+
+    // 歌曲结束（或中途停止）：结算剩余全部音符，未唱的音符计 0 分
+    void finish(std::vector<LineScore>& lines);
+
+    // 从头开始（同一首歌重唱）
+    void reset();
+
+    const LiveScore& live() const { return live_; }
+    // 全曲得分 0..100（未结算的音符按 0 分计入分母）
+    float totalScore() const;
+    bool finished() const { return next_final_ >= melody_.notes.size(); }
+    const ReferenceMelody& melody() const { return melody_; }
+
+    // 演唱与参考的音高得分 0..1
+    float pitchCredit(float sung_midi, float ref_midi, float* cents_out = nullptr) const;
+
+private:
+    void settleUntil(uint32_t song_ms, std::vector<LineScore>& lines);
+    void settleNote(size_t index, std::vector<LineScore>& lines);
+
+    ReferenceMelody melody_;
+    Config cfg_;
+    std::vector<float> credit_;     // 每个音符已累计的帧得分
+    uint64_t total_weight_ = 0;     // 全部音符时长之和
+    size_t next_final_ = 0;         // 下一个待结算的音符
+
+    double settled_sum_ = 0.0;      // 已结算音符的 得分 × 时长
+    uint64_t settled_weight_ = 0;
+
+    LineScore line_;                // 当前句累计
+    double line_sum_ = 0.0;
+    uint64_t line_weight_ = 0;
+
+    LiveScore live_;
+};
+
+}  // namespace ktv::audio
+
+#endif  // KTVLV_AUDIO_SCORE_ENGINE_H
@@ -0,0 +1,131 @@
+#include "wav_file.h"
+#include <cstdio>
+#include <cstring>
+
+namespace ktv::audio {
+
+namespace {
+
+uint32_t le32(const uint8_t* p) {
+    return static_cast<uint32_t>(p[0]) | (static_cast<uint32_t>(p[1]) << 8) |
+           (static_cast<uint32_t>(p[2]) << 16) | (static_cast<uint32_t>(p[3]) << 24);
+}
+
+uint16_t le16(const uint8_t* p) {
+    return static_cast<uint16_t>(p[0] | (p[1] << 8));
+}
+
+void put_le(std::vector<uint8_t>& out, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xFF));
+}
+
+}  // namespace
+
+bool WavFile::load(const std::string& path, std::string& error) {
+    FILE* f = std::fopen(path.c_str(), "rb");
+    if (!f) {
+        error = "cannot open " + path;
+        return false;
+    }
+    std::vector<uint8_t> raw;
+    uint8_t chunk[64 * 1024];
+    size_t n;
+    while ((n = std::fread(chunk, 1, sizeof(chunk), f)) > 0) raw.insert(raw.end(), chunk, chunk + n);
+    std::fclose(f);
+
+    if (raw.size() < 12 || std::memcmp(raw.data(), "RIFF", 4) != 0 || std::memcmp(raw.data() + 8, "WAVE", 4) != 0) {
+        error = "not a RIFF/WAVE file";
+        return false;
+    }
+
+    int bits = 0;
+    const uint8_t* pcm = nullptr;
+    size_t pcm_size = 0;
+    size_t off = 12;
+    while (off + 8 <= raw.size()) {
+        const uint8_t* hdr = raw.data() + off;
+        size_t size = le32(hdr + 4);
+        size_t body = off + 8;
+        if (body + size > raw.size()) size = raw.size() - body;   // 截断的文件按实际长度读
+        if (std::memcmp(hdr, "fmt ", 4) == 0 && size >= 16) {
+            uint16_t tag = le16(hdr + 8);
+            channels = le16(hdr + 10);
+            sample_rate = static_cast<int>(le32(hdr + 12));
+            bits = le16(hdr + 22);
+            // WAVE_FORMAT_EXTENSIBLE 的子格式同样是 PCM 时也接受
+            if (tag != 1 && tag != 0xFFFE) {
+                error = "only integer PCM is supported";
+                return false;
+            }
+        } else if (std::memcmp(hdr, "data", 4) == 0) {
+            pcm = raw.data() + body;
+            pcm_size = size;
+        }
+        off = body + size + (size & 1);
+    }
+
+    if (!pcm || channels <= 0 || sample_rate <= 0) {
+        error = "missing fmt or data chunk";
+        return false;
+    }
+
+    size_t in_bytes = static_cast<size_t>(bits / 8);
+    if (bits != 16 && bits != 24 && bits != 32) {
+        error = "unsupported bit depth " + std::to_string(bits);
+        return false;
+    }
+    frames = pcm_size / (in_bytes * static_cast<size_t>(channels));
+    size_t samples = frames * static_cast<size_t>(channels);
+
+    if (bits == 16) {
+        format = SampleFormat::S16;
+        data.assign(pcm, pcm + samples * 2);
+    } else {
+        format = SampleFormat::S32;
+        data.resize(samples * 4);
+        for (size_t i = 0; i < samples; ++i) {
+            int32_t v;
+            if (bits == 32) {
+                v = static_cast<int32_t>(le32(pcm + i * 4));
+            } else {
+                const uint8_t* p = pcm + i * 3;
+                v = static_cast<int32_t>((static_cast<uint32_t>(p[0]) << 8) | (static_cast<uint32_t>(p[1]) << 16) |
+                                         (static_cast<uint32_t>(p[2]) << 24));
+            }
+            std::memcpy(&data[i * 4], &v, 4);
+        }
+    }
+    return true;
+}
+
+bool WavFile::save(const std::string& path, std::string& error) const {
+    const uint32_t bits = format == SampleFormat::S16 ? 16 : 32;
+    const uint32_t block = static_cast<uint32_t>(frameBytes());
+    const uint32_t data_bytes = static_cast<uint32_t>(frames * block);
+    std::vector<uint8_t> hdr;
+    hdr.insert(hdr.end(), {'R', 'I', 'F', 'F'});
+    put_le(hdr, 36 + data_bytes, 4);
+    hdr.insert(hdr.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put_le(hdr, 16, 4);
+    put_le(hdr, 1, 2);
+    put_le(hdr, static_cast<uint32_t>(channels), 2);
+    put_le(hdr, static_cast<uint32_t>(sample_rate), 4);
+    put_le(hdr, static_cast<uint32_t>(sample_rate) * block, 4);
+    put_le(hdr, block, 2);
+    put_le(hdr, bits, 2);
+    hdr.insert(hdr.end(), {'d', 'a', 't', 'a'});
+    put_le(hdr, data_bytes, 4);
+
+    FILE* f = std::fopen(path.c_str(), "wb");
+    if (!f) {
+        error = "cannot create " + path;
+        return false;
+    }
+    bool ok = std::fwrite(hdr.data(), 1, hdr.size(), f) == hdr.size() &&
+              std::fwrite(data.data(), 1, data_bytes, f) == data_bytes;
+    ok = std::fclose(f) == 0 && ok;
+    if (!ok) error = "write failed";
+    return ok;
+}
+
+}  // namespace ktv::audio
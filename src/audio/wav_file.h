@@ -0,0 +1,34 @@
+#ifndef KTVLV_AUDIO_WAV_FILE_H
+#define KTVLV_AUDIO_WAV_FILE_H
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include "pitch_detector.h"
+
+namespace ktv::audio {
+
+/**
+ * WavFile - 读写 PCM WAV（读 16/24/32 位整数，写 16/32 位），供离线基准和打分回放使用
+ *
+ * 24 位样本展开为 S32；整个文件读入内存，不用于设备上的实时路径
+ */
+struct WavFile {
+    int sample_rate = 0;
+    int channels = 0;
+    SampleFormat format = SampleFormat::S16;
+    size_t frames = 0;
+    std::vector<uint8_t> data;   // 交错 PCM，format 决定每个样本 2 或 4 字节
+
+    // 失败时返回 false，error 写入原因
+    bool load(const std::string& path, std::string& error);
+    bool save(const std::string& path, std::string& error) const;
+
+    size_t frameBytes() const {
+        return static_cast<size_t>(channels) * (format == SampleFormat::S16 ? 2 : 4);
+    }
+};
+
+}  // namespace ktv::audio
+
+#endif  // KTVLV_AUDIO_WAV_FILE_H
@@ -0,0 +1,200 @@
+/**
+ * ktvlv_fx_bench：人声监听效果链离线基准
+ *
+ * 把 WAV（多声道先平均为单声道，S32 取高 16 位）按监听路径相同的块长喂给 audio_fx，
+ * 可选写出处理后的单声道 S16 WAV，stderr 输出峰值、最大限幅量、每帧耗时与实时倍率。
+ *
+ * 用法：
+ *   ktvlv_fx_bench [--gain-db 0] [--echo [--echo-ms 250] [--echo-fb 0.35] [--echo-mix 0.3]]
+ *                  [--reverb [--room 0.6] [--damp 0.4] [--reverb-mix 0.25]] [--limit-db -1]
+ *                  [--block 64] [--storm] in.wav [out.wav]
+ *
+ * --storm 另起一个线程不停发布参数（模拟 UI 拖动滑块），用来检查无锁更新路径的开销与稳定性。
+ */
+
+#include "audio/wav_file.h"
+#include "core/audio_fx.h"
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    audio_fx_params_t params;
+    uint32_t block = 64;
+    bool storm = false;
+    std::string in_path;
+    std::string out_path;
+};
+
+float peak_dbfs(const std::vector<int16_t>& v) {
+    int peak = 0;
+    for (int16_t s : v) peak = std::max(peak, std::abs(static_cast<int>(s)));
+    return peak > 0 ? 20.0f * std::log10(static_cast<float>(peak) / 32768.0f) : -120.0f;
+}
+
+std::vector<int16_t> to_mono(const ktv::audio::WavFile& wav) {
+    std::vector<int16_t> mono(wav.frames);
+    const int ch = wav.channels;
+    for (size_t i = 0; i < wav.frames; ++i) {
+        int64_t acc = 0;
+        for (int c = 0; c < ch; ++c) {
+            size_t idx = i * static_cast<size_t>(ch) + static_cast<size_t>(c);
+            if (wav.format == ktv::audio::SampleFormat::S16) {
+                int16_t s;
+                std::memcpy(&s, &wav.data[idx * 2], 2);
+                acc += s;
+            } else {
+                int32_t s;
+                std::memcpy(&s, &wav.data[idx * 4], 4);
+                acc += s >> 16;
+            }
+        }
+        mono[i] = static_cast<int16_t>(acc / ch);
+    }
+    return mono;
+}
+
+bool parse_args(int argc, char* argv[], Options& opts) {
+    audio_fx_default_params(&opts.params);
+    std::vector<std::string> files;
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+        float fval = val ? static_cast<float>(std::atof(val)) : 0.0f;
+        if (arg == "--echo") {
+            opts.params.echo_enabled = true;
+        } else if (arg == "--reverb") {
+            opts.params.reverb_enabled = true;
+        } else if (arg == "--storm") {
+            opts.storm = true;
+        } else if (arg == "--gain-db" && val) {
+            opts.params.gain_db = fval;
+            ++i;
+        } else if (arg == "--echo-ms" && val) {
+            opts.params.echo_ms = static_cast<uint32_t>(std::max(0, std::atoi(val)));
+            ++i;
+        } else if (arg == "--echo-fb" && val) {
+            opts.params.echo_feedback = fval;
+            ++i;
+        } else if (arg == "--echo-mix" && val) {
+            opts.params.echo_mix = fval;
+            ++i;
+        } else if (arg == "--room" && val) {
+            opts.params.reverb_room = fval;
+            ++i;
+        } else if (arg == "--damp" && val) {
+            opts.params.reverb_damp = fval;
+            ++i;
+        } else if (arg == "--reverb-mix" && val) {
+            opts.params.reverb_mix = fval;
+            ++i;
+        } else if (arg == "--limit-db" && val) {
+            opts.params.limiter_db = fval;
+            ++i;
+        } else if (arg == "--block" && val) {
+            opts.block = static_cast<uint32_t>(std::max(1, std::atoi(val)));
+            ++i;
+        } else if (!arg.empty() && arg[0] != '-') {
+            files.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    if (files.empty() || files.size() > 2) return false;
+    opts.in_path = files[0];
+    if (files.size() == 2) opts.out_path = files[1];
+    return true;
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        std::fprintf(stderr,
+                     "usage: %s [--gain-db 0] [--echo [--echo-ms 250] [--echo-fb 0.35] [--echo-mix 0.3]]\n"
+                     "          [--reverb [--room 0.6] [--damp 0.4] [--reverb-mix 0.25]] [--limit-db -1]\n"
+                     "          [--block 64] [--storm] in.wav [out.wav]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    ktv::audio::WavFile wav;
+    std::string error;
+    if (!wav.load(opts.in_path, error)) {
+        std::fprintf(stderr, "%s: %s\n", opts.in_path.c_str(), error.c_str());
+        return 2;
+    }
+    std::vector<int16_t> in = to_mono(wav);
+    std::vector<int16_t> out(in.size());
+
+    audio_fx_t* fx = audio_fx_create(static_cast<uint32_t>(wav.sample_rate), opts.block);
+    if (!fx) {
+        std::fprintf(stderr, "audio_fx_create failed\n");
+        return 2;
+    }
+    audio_fx_set_params(fx, &opts.params);
+
+    // 参数风暴：在基础参数上来回拨动增益与混响量
+    std::atomic<bool> stop{false};
+    std::atomic<uint64_t> updates{0};
+    std::thread storm;
+    if (opts.storm) {
+        storm = std::thread([&] {
+            audio_fx_params_t p = opts.params;
+            for (uint32_t k = 0; !stop.load(std::memory_order_relaxed); ++k) {
+                p.gain_db = opts.params.gain_db + ((k & 1U) ? -3.0f : 0.0f);
+                p.reverb_mix = opts.params.reverb_mix * static_cast<float>(k % 8) / 7.0f;
+                audio_fx_set_params(fx, &p);
+                updates.fetch_add(1, std::memory_order_relaxed);
+            }
+        });
+    }
+
+    auto begin = Clock::now();
+    for (size_t off = 0; off < in.size(); off += opts.block) {
+        uint32_t n = static_cast<uint32_t>(std::min<size_t>(opts.block, in.size() - off));
+        audio_fx_process(fx, in.data() + off, out.data() + off, n);
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    float max_gr = audio_fx_take_gain_reduction_db(fx);
+    stop.store(true);
+    if (storm.joinable()) storm.join();
+    audio_fx_destroy(fx);
+
+    double audio_ms = static_cast<double>(in.size()) * 1000.0 / wav.sample_rate;
+    std::fprintf(stderr,
+                 "%s: rate=%d frames=%zu block=%u echo=%d reverb=%d in_peak=%.1fdBFS out_peak=%.1fdBFS "
+                 "max_gr=%.1fdB elapsed_ms=%.1f ns_per_frame=%.1f realtime_x=%.1f",
+                 opts.in_path.c_str(), wav.sample_rate, in.size(), opts.block, opts.params.echo_enabled ? 1 : 0,
+                 opts.params.reverb_enabled ? 1 : 0, peak_dbfs(in), peak_dbfs(out), max_gr, elapsed_ms,
+                 in.empty() ? 0.0 : elapsed_ms * 1e6 / static_cast<double>(in.size()),
+                 elapsed_ms > 0.0 ? audio_ms / elapsed_ms : 0.0);
+    if (opts.storm) std::fprintf(stderr, " param_updates=%llu", static_cast<unsigned long long>(updates.load()));
+    std::fprintf(stderr, "\n");
+
+    if (opts.out_path.empty()) return 0;
+    ktv::audio::WavFile result;
+    result.sample_rate = wav.sample_rate;
+    result.channels = 1;
+    result.format = ktv::audio::SampleFormat::S16;
+    result.frames = out.size();
+    result.data.resize(out.size() * 2);
+    std::memcpy(result.data.data(), out.data(), result.data.size());
+    if (!result.save(opts.out_path, error)) {
+        std::fprintf(stderr, "%s: %s\n", opts.out_path.c_str(), error.c_str());
+        return 2;
+    }
+    return 0;
+}
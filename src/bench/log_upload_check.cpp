@@ -0,0 +1,295 @@
+/**
+ * ktvlv_log_upload_check：日志上传端到端检查（本地 HTTP 替身服务器，不依赖 LVGL/外网）
+ *
+ * 进程内起一个 127.0.0.1 上的最小 HTTP/1.1 服务器（每个连接一个线程），然后：
+ *   1. 往日志环写入 kRecords 条记录，LogUploadService::notify() 触发一次上传；
+ *      服务器解析 chunked 请求体与 multipart，解压 file 字段，逐字节对比 LogRing::snapshot()
+ *   2. 上传进行中（服务器故意延迟应答）从主线程调用 HttpService::get()，确认不被上传阻塞
+ *   3. 读回调返回 -1 时 postMultipart 中止并返回 false；连不上服务器时返回 false
+ *
+ * 用法：ktvlv_log_upload_check        全部通过返回 0，否则返回 1（stderr 输出每项结果）
+ */
+
+#include "core/executor.h"
+#include "core/log_ring.h"
+#include "services/http_service.h"
+#include "services/log_upload_service.h"
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <syslog.h>
+#include <unistd.h>
+#include <zlib.h>
+#include <atomic>
+#include <cctype>
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using namespace std::chrono_literals;
+
+constexpr int kRecords = 5000;
+constexpr auto kUploadDelay = 800ms;   // 替身服务器延迟应答上传请求，制造"上传进行中"
+
+struct Upload {
+    std::string path;
+    bool chunked = false;
+    std::string content_type;          // file 字段的 Content-Type
+    std::string filename;
+    std::string device_id;
+    size_t gz_bytes = 0;
+    std::string text;                  // 解压后的日志
+    bool gunzip_ok = false;
+};
+
+bool gunzip(const std::string& in, std::string& out) {
+    z_stream zs{};
+    if (inflateInit2(&zs, 16 + MAX_WBITS) != Z_OK) return false;
+    zs.next_in = reinterpret_cast<Bytef*>(const_cast<char*>(in.data()));
+    zs.avail_in = static_cast<uInt>(in.size());
+    char buf[16384];
+    int rc = Z_OK;
+    while (rc == Z_OK) {
+        zs.next_out = reinterpret_cast<Bytef*>(buf);
+        zs.avail_out = sizeof(buf);
+        rc = inflate(&zs, Z_NO_FLUSH);
+        out.append(buf, sizeof(buf) - zs.avail_out);
+    }
+    inflateEnd(&zs);
+    return rc == Z_STREAM_END;
+}
+
+std::string header_value(const std::string& head, const char* name) {
+    std::string lower = head;
+    for (auto& c : lower) c = static_cast<char>(std::tolower(static_cast<unsigned char>(c)));
+    const std::string key = std::string("\r\n") + name + ":";
+    size_t p = lower.find(key);
+    if (p == std::string::npos) return "";
+    p += key.size();
+    while (p < head.size() && head[p] == ' ') ++p;
+    return head.substr(p, head.find("\r\n", p) - p);
+}
+
+// 解析 multipart：按 boundary 切分，每段 "headers\r\n\r\nbody\r\n"
+void parse_multipart(const std::string& body, const std::string& boundary, Upload& up) {
+    const std::string delim = "--" + boundary;
+    size_t pos = body.find(delim);
+    while (pos != std::string::npos) {
+        pos += delim.size();
+        if (body.compare(pos, 2, "--") == 0) break;
+        pos += 2;   // \r\n
+        const size_t head_end = body.find("\r\n\r\n", pos);
+        const size_t next = body.find("\r\n" + delim, head_end);
+        if (head_end == std::string::npos || next == std::string::npos) break;
+        const std::string head = "\r\n" + body.substr(pos, head_end - pos);
+        const std::string data = body.substr(head_end + 4, next - head_end - 4);
+        const std::string disp = header_value(head, "content-disposition");
+        if (disp.find("name=\"file\"") != std::string::npos) {
+            up.content_type = header_value(head, "content-type");
+            const size_t f = disp.find("filename=\"");
+            if (f != std::string::npos) up.filename = disp.substr(f + 10, disp.find('"', f + 10) - f - 10);
+            up.gz_bytes = data.size();
+            up.gunzip_ok = gunzip(data, up.text);
+        } else if (disp.find("name=\"device_id\"") != std::string::npos) {
+            up.device_id = data;
+        }
+        pos = next + 2;
+    }
+}
+
+class StandInServer {
+public:
+    bool start() {
+        fd_ = socket(AF_INET, SOCK_STREAM, 0);
+        sockaddr_in addr{};
+        addr.sin_family = AF_INET;
+        addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+        socklen_t len = sizeof(addr);
+        if (fd_ < 0 || bind(fd_, reinterpret_cast<sockaddr*>(&addr), len) != 0 || listen(fd_, 8) != 0) return false;
+        getsockname(fd_, reinterpret_cast<sockaddr*>(&addr), &len);
+        port_ = ntohs(addr.sin_port);
+        accept_thread_ = std::thread([this] { acceptLoop(); });
+        return true;
+    }
+
+    void stop() {
+        shutdown(fd_, SHUT_RDWR);
+        close(fd_);
+        if (accept_thread_.joinable()) accept_thread_.join();
+        for (auto& t : conns_) t.join();
+    }
+
+    int port() const { return port_; }
+
+    bool waitUpload(std::chrono::milliseconds timeout, Upload& out) {
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!cv_.wait_for(lock, timeout, [this] { return !uploads_.empty(); })) return false;
+        out = uploads_.front();
+        return true;
+    }
+
+    bool uploadStarted() const { return upload_started_.load(); }
+
+private:
+    void acceptLoop() {
+        for (;;) {
+            int c = accept(fd_, nullptr, nullptr);
+            if (c < 0) return;
+            conns_.emplace_back([this, c] { serve(c); });
+        }
+    }
+
+    static bool read_some(int c, std::string& buf) {
+        char tmp[8192];
+        ssize_t n = recv(c, tmp, sizeof(tmp), 0);
+        if (n <= 0) return false;
+        buf.append(tmp, static_cast<size_t>(n));
+        return true;
+    }
+
+    void serve(int c) {
+        std::string buf;
+        size_t head_end;
+        while ((head_end = buf.find("\r\n\r\n")) == std::string::npos) {
+            if (!read_some(c, buf)) return (void)close(c);
+        }
+        const std::string head = buf.substr(0, head_end + 2);
+        std::string rest = buf.substr(head_end + 4);
+        Upload up;
+        up.path = head.substr(head.find(' ') + 1, head.find(' ', head.find(' ') + 1) - head.find(' ') - 1);
+
+        std::string body;
+        if (header_value(head, "transfer-encoding").find("chunked") != std::string::npos) {
+            up.chunked = true;
+            upload_started_ = true;
+            for (;;) {
+                size_t eol;
+                while ((eol = rest.find("\r\n")) == std::string::npos) {
+                    if (!read_some(c, rest)) return (void)close(c);
+                }
+                const size_t len = std::strtoul(rest.c_str(), nullptr, 16);
+                while (rest.size() < eol + 2 + len + 2) {
+                    if (!read_some(c, rest)) return (void)close(c);
+                }
+                body.append(rest, eol + 2, len);
+                rest.erase(0, eol + 2 + len + 2);
+                if (len == 0) break;
+            }
+        } else {
+            const size_t len = std::strtoul(header_value(head, "content-length").c_str(), nullptr, 10);
+            while (rest.size() < len) {
+                if (!read_some(c, rest)) return (void)close(c);
+            }
+            body = rest.substr(0, len);
+        }
+
+        const std::string ct = header_value(head, "content-type");
+        const size_t b = ct.find("boundary=");
+        if (b != std::string::npos) {
+            parse_multipart(body, ct.substr(b + 9), up);
+            std::this_thread::sleep_for(kUploadDelay);
+        }
+        const char* resp = "HTTP/1.1 200 OK\r\nContent-Length: 2\r\nConnection: close\r\n\r\nok";
+        send(c, resp, std::strlen(resp), MSG_NOSIGNAL);
+        close(c);
+        if (b != std::string::npos) {
+            std::lock_guard<std::mutex> lock(mtx_);
+            uploads_.push_back(std::move(up));
+            cv_.notify_all();
+        }
+    }
+
+    int fd_ = -1;
+    int port_ = 0;
+    std::thread accept_thread_;
+    std::vector<std::thread> conns_;
+    std::mutex mtx_;
+    std::condition_variable cv_;
+    std::vector<Upload> uploads_;
+    std::atomic<bool> upload_started_{false};
+};
+
+int g_failures = 0;
+
+void check(bool ok, const char* what) {
+    std::fprintf(stderr, "[%s] %s\n", ok ? "PASS" : "FAIL", what);
+    if (!ok) ++g_failures;
+}
+
+}  // namespace
+
+int main() {
+    using ktv::core::LogRing;
+    using ktv::services::HttpResponse;
+    using ktv::services::HttpService;
+    using ktv::services::LogUploadService;
+    using ktv::services::MultipartField;
+
+    StandInServer server;
+    if (!server.start()) {
+        std::fprintf(stderr, "cannot start stand-in server\n");
+        return 1;
+    }
+    ktv::core::Executor::instance().start();
+    for (int i = 0; i < kRecords; ++i) {
+        LogRing::instance().write(LOG_INFO, "[ktv][check][line] seq=%d song=%s score=%.2f", i, "stand-in", i * 0.5);
+    }
+    const std::string expected = LogRing::instance().snapshot(256 * 1024, 2000, "[ktv]");
+
+    char base[64];
+    std::snprintf(base, sizeof(base), "http://127.0.0.1:%d", server.port());
+    HttpService::getInstance().initialize(base, 5);
+
+    // 1. 端到端上传
+    LogUploadService::instance().start();
+    LogUploadService::instance().notify(ktv::services::UploadReason::USER_FEEDBACK);
+
+    // 2. 上传进行中，get() 不应等待上传结束
+    const auto wait_begin = Clock::now();
+    while (!server.uploadStarted() && Clock::now() - wait_begin < 5s) std::this_thread::sleep_for(5ms);
+    HttpResponse resp;
+    const auto get_begin = Clock::now();
+    const bool get_ok = HttpService::getInstance().get("/ping", resp);
+    const auto get_ms = std::chrono::duration_cast<std::chrono::milliseconds>(Clock::now() - get_begin).count();
+    std::fprintf(stderr, "get during upload: %lld ms\n", static_cast<long long>(get_ms));
+    check(server.uploadStarted() && get_ok && get_ms < 400, "get() is not blocked by an upload in progress");
+
+    Upload up;
+    const bool got = server.waitUpload(10s, up);
+    check(got, "upload reached the stand-in server");
+    if (got) {
+        std::fprintf(stderr, "path=%s file=%s type=%s gz=%zu raw=%zu\n", up.path.c_str(), up.filename.c_str(),
+                     up.content_type.c_str(), up.gz_bytes, up.text.size());
+        check(up.path == "/karaoke_sdk/log/upload", "posted to /karaoke_sdk/log/upload");
+        check(up.chunked, "request body uses chunked transfer");
+        check(up.content_type == "application/gzip" && up.gunzip_ok, "file part is valid gzip");
+        check(!up.device_id.empty() && up.filename.find(up.device_id) != std::string::npos,
+              "device_id field and file name");
+        check(up.text == expected, "decompressed log equals LogRing::snapshot()");
+        check(up.gz_bytes * 4 < up.text.size(), "compressed to under a quarter");
+    }
+    LogUploadService::instance().stop();
+
+    // 3. 读回调出错中止；服务器不可达
+    std::vector<MultipartField> fields;
+    fields.push_back({"file", "", "x.gz", "application/gzip", [](char*, size_t) { return -1L; }});
+    check(!HttpService::getInstance().postMultipart("/karaoke_sdk/log/upload", fields, resp, 2),
+          "read callback error aborts the upload");
+    fields.back().read = [](char*, size_t) { return 0L; };
+    check(!HttpService::getInstance().postMultipart("http://127.0.0.1:1/karaoke_sdk/log/upload", fields, resp, 2),
+          "unreachable server reports failure");
+
+    ktv::core::Executor::instance().stop();
+    HttpService::getInstance().cleanup();
+    server.stop();
+    std::fprintf(stderr, "%s\n", g_failures == 0 ? "all checks passed" : "checks failed");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,169 @@
+/**
+ * ktvlv_lyrics_check：歌词解析与定位检查（纯内存，不依赖 LVGL/文件）
+ *
+ * 覆盖 Lyrics::parse() 的三种格式与规则，以及 locate() 的边界：
+ *   1. 普通 LRC：整行一个字、时长推到下一行、末行最长 kMaxInferredMs、[ti:] 等标签忽略
+ *   2. [offset:±ms]：所有时间整体提前/推后，不小于 0
+ *   3. 同一行多个时间戳（重复的副歌）：按时间排序展开为多行
+ *   4. 增强 LRC：<mm:ss.xx> 逐字时间，最后一个标签结束末字
+ *   5. KRC：[行开始,行时长]<偏移,时长,0>字，字间空隙、零时长字
+ *   6. locate()：第一行之前、行已开始但第一个字未到、字内进度、字间空隙、行唱完
+ *
+ * 用法：ktvlv_lyrics_check        全部通过返回 0，否则返回 1（stderr 输出每项结果）
+ */
+
+#include "audio/lyrics.h"
+#include <cmath>
+#include <cstdio>
+#include <string>
+
+namespace {
+
+using ktv::audio::LyricPosition;
+using ktv::audio::Lyrics;
+
+int g_failures = 0;
+
+void check(bool ok, const char* what) {
+    std::fprintf(stderr, "[%s] %s\n", ok ? "PASS" : "FAIL", what);
+    if (!ok) ++g_failures;
+}
+
+bool parse(Lyrics& lyrics, const char* content) {
+    std::string error;
+    if (lyrics.parse(content, error)) return true;
+    std::fprintf(stderr, "parse error: %s\n", error.c_str());
+    return false;
+}
+
+bool at(const Lyrics& lyrics, uint32_t ms, int line, int word, float progress) {
+    const LyricPosition pos = lyrics.locate(ms);
+    const bool ok = pos.line == line && pos.word == word && std::fabs(pos.progress - progress) < 1e-3f;
+    if (!ok) {
+        std::fprintf(stderr, "  locate(%u) = line %d word %d progress %.3f, expected %d/%d/%.3f\n", ms, pos.line,
+                     pos.word, pos.progress, line, word, progress);
+    }
+    return ok;
+}
+
+bool line_is(const Lyrics& lyrics, size_t i, uint32_t start, uint32_t duration, const char* text) {
+    if (i >= lyrics.lines.size()) return false;
+    const auto& l = lyrics.lines[i];
+    const bool ok = l.start_ms == start && l.duration_ms == duration && lyrics.lineText(i) == text;
+    if (!ok) {
+        std::fprintf(stderr, "  line %zu = %u+%u \"%s\", expected %u+%u \"%s\"\n", i, l.start_ms, l.duration_ms,
+                     lyrics.lineText(i).c_str(), start, duration, text);
+    }
+    return ok;
+}
+
+bool word_is(const Lyrics& lyrics, size_t i, uint32_t start, uint32_t duration, const char* text) {
+    if (i >= lyrics.words.size()) return false;
+    const auto& w = lyrics.words[i];
+    const bool ok = w.start_ms == start && w.duration_ms == duration && lyrics.wordText(i) == text;
+    if (!ok) {
+        std::fprintf(stderr, "  word %zu = %u+%u \"%s\", expected %u+%u \"%s\"\n", i, w.start_ms, w.duration_ms,
+                     lyrics.wordText(i).c_str(), start, duration, text);
+    }
+    return ok;
+}
+
+void plain_lrc() {
+    Lyrics l;
+    const bool ok = parse(l, "\xEF\xBB\xBF[ti:Song]\r\n[ar:Artist]\r\n[00:01.00]Hello\r\n[00:03.5]World\r\n");
+    check(ok && l.lines.size() == 2 && l.words.size() == 2, "plain LRC: BOM, CRLF and [ti:]/[ar:] tags ignored");
+    check(ok && line_is(l, 0, 1000, 2500, "Hello"), "plain LRC: line runs to the next line start");
+    check(ok && line_is(l, 1, 3500, Lyrics::kMaxInferredMs, "World"), "plain LRC: last line capped at kMaxInferredMs");
+    check(ok && at(l, 999, -1, 0, 0.0f) && at(l, 2250, 0, 0, 0.5f), "plain LRC: before first line, whole-line wipe");
+
+    Lyrics gap;
+    const bool gap_ok = parse(gap, "[00:01.000]A\n[00:20.000]B\n");
+    check(gap_ok && line_is(gap, 0, 1000, Lyrics::kMaxInferredMs, "A") && at(gap, 15000, 0, 1, 0.0f),
+          "plain LRC: long instrumental gap caps the line, then the line reads as finished");
+
+    Lyrics blank;
+    const bool blank_ok = parse(blank, "[00:01.00]A\n[00:02.00]\n[00:05.00]B\n");
+    check(blank_ok && blank.lines.size() == 2 && line_is(blank, 0, 1000, 1000, "A"),
+          "plain LRC: an empty timed line only ends the previous line");
+}
+
+void offset() {
+    Lyrics later;
+    const bool ok = parse(later, "[offset:500]\n[00:01.00]A\n[00:02.00]B\n");
+    check(ok && line_is(later, 0, 500, 1000, "A") && line_is(later, 1, 1500, Lyrics::kMaxInferredMs, "B"),
+          "[offset:+500] shows lyrics 500 ms earlier");
+
+    Lyrics earlier;
+    const bool ok2 = parse(earlier, "[offset:-250]\n[00:01.00]A\n");
+    check(ok2 && line_is(earlier, 0, 1250, Lyrics::kMaxInferredMs, "A"), "[offset:-250] shows lyrics 250 ms later");
+
+    Lyrics clamp;
+    const bool ok3 = parse(clamp, "[offset:3000]\n[00:01.00]A\n[00:05.00]B\n");
+    check(ok3 && clamp.lines[0].start_ms == 0 && clamp.lines[1].start_ms == 2000, "offset never goes below 0");
+}
+
+void repeated_stamps() {
+    Lyrics l;
+    const bool ok = parse(l, "[00:30.00][00:10.00]Chorus\n[00:20.00]Verse\n");
+    check(ok && l.lines.size() == 3, "repeated stamps expand to one line each");
+    check(ok && line_is(l, 0, 10000, 8000, "Chorus") && line_is(l, 1, 20000, 8000, "Verse") &&
+              line_is(l, 2, 30000, Lyrics::kMaxInferredMs, "Chorus"),
+          "repeated stamps sort by time with other lines");
+
+    Lyrics enhanced;
+    const bool ok2 = parse(enhanced, "[00:10.00][00:40.00]<00:10.00>La<00:10.50>La<00:11.00>\n");
+    check(ok2 && enhanced.lines.size() == 2 && word_is(enhanced, 2, 40000, 500, "La") &&
+              word_is(enhanced, 3, 40500, 500, "La"),
+          "repeated stamps shift enhanced word times with the line");
+}
+
+void enhanced_lrc() {
+    Lyrics l;
+    const bool ok = parse(l, "[00:05.00]<00:05.00>We <00:05.50>will <00:06.20>rock<00:07.00>\n[00:09.00]Next\n");
+    check(ok && l.lines.size() == 2 && l.words.size() == 4, "enhanced LRC: words split at <mm:ss.xx>");
+    check(ok && word_is(l, 0, 5000, 500, "We ") && word_is(l, 1, 5500, 700, "will ") && word_is(l, 2, 6200, 800, "rock"),
+          "enhanced LRC: word ends at the next tag, trailing tag ends the last word");
+    check(ok && line_is(l, 0, 5000, 2000, "We will rock"), "enhanced LRC: line ends with its last word");
+    check(ok && at(l, 5850, 0, 1, 0.5f) && at(l, 7500, 0, 3, 0.0f), "enhanced LRC: progress inside a word, line finished");
+
+    Lyrics lead;
+    const bool ok2 = parse(lead, "[00:05.00]Intro <00:06.00>go<00:07.00>\n");
+    check(ok2 && word_is(lead, 0, 5000, 1000, "Intro ") && word_is(lead, 1, 6000, 1000, "go"),
+          "enhanced LRC: untagged text starts at the line stamp");
+}
+
+void krc() {
+    Lyrics l;
+    const bool ok = parse(l, "[id:$00000000]\n[1000,2000]<0,300,0>一<500,300,0>二<900,0,0>三<1000,500,0>四\n"
+                             "[4000,1000]<0,1000,0>五\n");
+    check(ok && l.lines.size() == 2 && l.words.size() == 5, "KRC: [start,duration] lines with <offset,duration,0> words");
+    check(ok && line_is(l, 0, 1000, 2000, "一二三四") && word_is(l, 1, 1500, 300, "二") && word_is(l, 2, 1900, 0, "三"),
+          "KRC: word times are offsets from the line start");
+    check(ok && at(l, 500, -1, 0, 0.0f) && at(l, 1150, 0, 0, 0.5f), "KRC: before first line, inside the first word");
+    check(ok && at(l, 1400, 0, 1, 0.0f), "KRC: gap between words reads as previous word finished");
+    check(ok && at(l, 1900, 0, 3, 0.0f) && at(l, 1950, 0, 3, 0.0f), "KRC: zero-length word is passed, no division by zero");
+    check(ok && at(l, 2600, 0, 4, 0.0f) && at(l, 4500, 1, 0, 0.5f), "KRC: line finished, next line");
+
+    Lyrics late;
+    const bool ok2 = parse(late, "[1000,1000]<200,300,0>a<600,300,0>b\n");
+    check(ok2 && at(late, 1100, 0, 0, 0.0f), "KRC: line started but first word not reached");
+}
+
+void errors() {
+    Lyrics l;
+    std::string error;
+    check(!l.parse("[ti:Only tags]\nno stamps here\n", error) && !error.empty(), "no timed lines is an error");
+}
+
+}  // namespace
+
+int main() {
+    plain_lrc();
+    offset();
+    repeated_stamps();
+    enhanced_lrc();
+    krc();
+    errors();
+    std::fprintf(stderr, "%s\n", g_failures == 0 ? "all checks passed" : "checks failed");
+    return g_failures == 0 ? 0 : 1;
+}
@@ -0,0 +1,323 @@
+/**
+ * ktvlv_pitch_bench：离线音高检测基准 / 回归工具
+ *
+ * 对每个 WAV 文件按录音路径相同的分块大小喂给 PitchDetector，输出：
+ *   stdout（--csv）逐帧 CSV：file,time_ms,f0_hz,midi,confidence,rms,voiced
+ *   stderr 每个文件的汇总：有声比例、F0 中位数、平均置信度、分析耗时与实时倍率
+ *
+ * 用法：
+ *   ktvlv_pitch_bench [--csv] [--window-ms 32] [--hop-ms 10] [--threshold 0.15]
+ *                     [--expect-hz 220 [--tolerance-cents 30] [--min-voiced 0.6]] a.wav [b.wav ...]
+ *   ktvlv_pitch_bench --melody melody.txt [--offset-ms 0] [--expect-score 80] song.wav [...]
+ *   ktvlv_pitch_bench --gen out.wav --hz 220 [--seconds 3] [--rate 48000] [--channels 1]
+ *   ktvlv_pitch_bench --gen out.wav --melody melody.txt [--transpose 12] [--rate 48000]
+ *
+ * 给出 --expect-hz 时检查 F0 中位数与有声比例，不满足返回 1（可直接用作回归检查）。
+ * 给出 --melody 时按参考旋律整曲打分（ScoreEngine），stdout 输出每句得分，stderr 输出总分与
+ * 打分耗时；--expect-score 低于期望返回 1。
+ * --gen 生成带谐波和固定种子噪声的测试音，结果逐字节可复现；配合 --melody 时按旋律逐音符生成
+ * （音符间静音，--transpose 按半音移调，可用来验证八度折叠）。
+ */
+
+#include "audio/pitch_detector.h"
+#include "audio/score_engine.h"
+#include "audio/wav_file.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+using ktv::audio::PitchDetector;
+using ktv::audio::PitchFrame;
+using ktv::audio::ReferenceMelody;
+using ktv::audio::ScoreEngine;
+
+constexpr size_t kChunkFrames = 128;   // 与默认录音周期一致
+
+struct Options {
+    bool csv = false;
+    PitchDetector::Config cfg;
+    float expect_hz = 0.0f;
+    float tolerance_cents = 30.0f;
+    float min_voiced = 0.6f;
+    std::vector<std::string> files;
+
+    std::string melody_path;
+    ReferenceMelody melody;
+    ScoreEngine::Config score_cfg;
+    int offset_ms = 0;
+    float expect_score = -1.0f;
+
+    std::string gen_path;
+    float gen_hz = 220.0f;
+    float gen_seconds = 3.0f;
+    int gen_rate = 48000;
+    int gen_channels = 1;
+    float gen_transpose = 0.0f;
+};
+
+void put_le(std::vector<uint8_t>& out, uint32_t v, int bytes) {
+    for (int i = 0; i < bytes; ++i) out.push_back(static_cast<uint8_t>((v >> (8 * i)) & 0xFF));
+}
+
+// 第 i 个采样的目标频率：给了旋律时按音符取（音符之间为 0，即静音），否则为固定 --hz
+float gen_freq(const Options& opts, size_t i, size_t& note) {
+    if (opts.melody.notes.empty()) return opts.gen_hz;
+    const auto& notes = opts.melody.notes;
+    uint64_t ms = static_cast<uint64_t>(i) * 1000ULL / static_cast<uint64_t>(opts.gen_rate);
+    while (note < notes.size() && notes[note].endMs() <= ms) ++note;
+    if (note >= notes.size() || ms < notes[note].start_ms) return 0.0f;
+    float midi = notes[note].midi + opts.gen_transpose;
+    return 440.0f * std::pow(2.0f, (midi - 69.0f) / 12.0f);
+}
+
+// 5 个谐波（幅度 1/k）+ -40 dB 噪声，线性同余随机数保证可复现
+bool generate(const Options& opts) {
+    float seconds = opts.melody.notes.empty() ? opts.gen_seconds
+                                              : static_cast<float>(opts.melody.durationMs()) / 1000.0f + 0.5f;
+    size_t frames = static_cast<size_t>(seconds * static_cast<float>(opts.gen_rate));
+    std::vector<uint8_t> wav;
+    uint32_t data_bytes = static_cast<uint32_t>(frames * static_cast<size_t>(opts.gen_channels) * 2);
+    wav.insert(wav.end(), {'R', 'I', 'F', 'F'});
+    put_le(wav, 36 + data_bytes, 4);
+    wav.insert(wav.end(), {'W', 'A', 'V', 'E', 'f', 'm', 't', ' '});
+    put_le(wav, 16, 4);
+    put_le(wav, 1, 2);
+    put_le(wav, static_cast<uint32_t>(opts.gen_channels), 2);
+    put_le(wav, static_cast<uint32_t>(opts.gen_rate), 4);
+    put_le(wav, static_cast<uint32_t>(opts.gen_rate * opts.gen_channels * 2), 4);
+    put_le(wav, static_cast<uint32_t>(opts.gen_channels * 2), 2);
+    put_le(wav, 16, 2);
+    wav.insert(wav.end(), {'d', 'a', 't', 'a'});
+    put_le(wav, data_bytes, 4);
+
+    uint32_t seed = 12345;
+    double phase = 0.0;
+    size_t note = 0;
+    for (size_t i = 0; i < frames; ++i) {
+        float hz = gen_freq(opts, i, note);
+        double s = 0.0;
+        if (hz > 0.0f) {
+            for (int k = 1; k <= 5; ++k) s += std::sin(phase * k) / k;
+            phase = std::fmod(phase + 2.0 * M_PI * hz / opts.gen_rate, 2.0 * M_PI);
+        }
+        seed = seed * 1664525u + 1013904223u;
+        double noise = (static_cast<double>(seed >> 8) / 16777216.0 - 0.5) * 0.02;
+        int32_t v = static_cast<int32_t>((s * 0.35 + noise) * 32767.0);
+        v = std::max(-32768, std::min(32767, v));
+        for (int c = 0; c < opts.gen_channels; ++c) put_le(wav, static_cast<uint32_t>(v) & 0xFFFF, 2);
+    }
+
+    FILE* f = std::fopen(opts.gen_path.c_str(), "wb");
+    if (!f) return false;
+    bool ok = std::fwrite(wav.data(), 1, wav.size(), f) == wav.size();
+    std::fclose(f);
+    if (opts.melody.notes.empty()) {
+        std::fprintf(stderr, "generated %s: %.1f Hz, %.1f s, %d Hz, %d ch\n", opts.gen_path.c_str(), opts.gen_hz,
+                     seconds, opts.gen_rate, opts.gen_channels);
+    } else {
+        std::fprintf(stderr, "generated %s: melody %s (%zu notes, transpose %+.1f), %.1f s, %d Hz, %d ch\n",
+                     opts.gen_path.c_str(), opts.melody_path.c_str(), opts.melody.notes.size(), opts.gen_transpose,
+                     seconds, opts.gen_rate, opts.gen_channels);
+    }
+    return ok;
+}
+
+// 整曲打分：stdout 输出每句得分，返回 0 通过，1 低于 --expect-score
+int score_file(const Options& opts, const std::string& path, const std::vector<PitchFrame>& frames) {
+    ScoreEngine::Config cfg = opts.score_cfg;
+    cfg.hop_ms = opts.cfg.hop_ms;
+    ScoreEngine engine(opts.melody, cfg);
+    std::vector<ktv::audio::LineScore> lines;
+    lines.reserve(opts.melody.line_count);
+
+    auto begin = Clock::now();
+    for (const auto& f : frames) {
+        int64_t song_ms = static_cast<int64_t>(f.time_ms) - opts.offset_ms;
+        if (song_ms >= 0) engine.feed(static_cast<uint32_t>(song_ms), f, lines);
+    }
+    engine.finish(lines);
+    double elapsed_us = std::chrono::duration<double, std::micro>(Clock::now() - begin).count();
+
+    uint32_t hit = 0, notes = 0;
+    for (const auto& l : lines) {
+        if (!opts.csv) {
+            std::printf("%s line=%u start_ms=%u end_ms=%u notes=%u hit=%u score=%.1f\n", path.c_str(),
+                        static_cast<unsigned>(l.line), l.start_ms, l.end_ms, static_cast<unsigned>(l.notes),
+                        static_cast<unsigned>(l.hit_notes), l.score);
+        }
+        hit += l.hit_notes;
+        notes += l.notes;
+    }
+    float score = engine.totalScore();
+    std::fprintf(stderr, "%s: score=%.1f lines=%zu notes=%u hit=%u score_us=%.0f (%.2f us/frame)\n", path.c_str(),
+                 score, lines.size(), notes, hit, elapsed_us,
+                 frames.empty() ? 0.0 : elapsed_us / static_cast<double>(frames.size()));
+
+    if (opts.expect_score < 0.0f) return 0;
+    bool ok = score >= opts.expect_score;
+    std::fprintf(stderr, "%s: expect score >= %.1f -> %s\n", path.c_str(), opts.expect_score, ok ? "PASS" : "FAIL");
+    return ok ? 0 : 1;
+}
+
+float median(std::vector<float> v) {
+    if (v.empty()) return 0.0f;
+    size_t mid = v.size() / 2;
+    std::nth_element(v.begin(), v.begin() + static_cast<std::ptrdiff_t>(mid), v.end());
+    return v[mid];
+}
+
+// 返回 0 通过，1 不满足期望，2 读取失败
+int run_file(const Options& opts, const std::string& path) {
+    ktv::audio::WavFile wav;
+    std::string error;
+    if (!wav.load(path, error)) {
+        std::fprintf(stderr, "%s: %s\n", path.c_str(), error.c_str());
+        return 2;
+    }
+
+    PitchDetector::Config cfg = opts.cfg;
+    cfg.sample_rate = wav.sample_rate;
+    cfg.channels = wav.channels;
+    cfg.format = wav.format;
+    PitchDetector detector(cfg);
+
+    std::vector<PitchFrame> frames;
+    frames.reserve(wav.frames / static_cast<size_t>(std::max(1, cfg.sample_rate * cfg.hop_ms / 1000)) + 1);
+    const size_t frame_bytes = wav.frameBytes();
+    auto begin = Clock::now();
+    for (size_t off = 0; off < wav.frames; off += kChunkFrames) {
+        size_t n = std::min(kChunkFrames, wav.frames - off);
+        detector.process(wav.data.data() + off * frame_bytes, n, frames);
+    }
+    double elapsed_ms = std::chrono::duration<double, std::milli>(Clock::now() - begin).count();
+    double audio_ms = static_cast<double>(wav.frames) * 1000.0 / wav.sample_rate;
+
+    std::vector<float> voiced_f0;
+    double conf_sum = 0.0;
+    for (const auto& f : frames) {
+        if (opts.csv) {
+            std::printf("%s,%llu,%.2f,%.2f,%.3f,%.4f,%d\n", path.c_str(), static_cast<unsigned long long>(f.time_ms),
+                        f.f0_hz, PitchDetector::hzToMidi(f.f0_hz), f.confidence, f.rms, f.voiced ? 1 : 0);
+        }
+        if (f.voiced) {
+            voiced_f0.push_back(f.f0_hz);
+            conf_sum += f.confidence;
+        }
+    }
+
+    float voiced_ratio = frames.empty() ? 0.0f : static_cast<float>(voiced_f0.size()) / frames.size();
+    float med = median(voiced_f0);
+    std::fprintf(stderr,
+                 "%s: rate=%d analysis_rate=%d frames=%zu voiced=%.1f%% f0_median=%.2f conf_mean=%.3f "
+                 "elapsed_ms=%.1f audio_ms=%.0f realtime_x=%.1f\n",
+                 path.c_str(), wav.sample_rate, detector.analysisRate(), frames.size(), voiced_ratio * 100.0f, med,
+                 voiced_f0.empty() ? 0.0 : conf_sum / voiced_f0.size(), elapsed_ms, audio_ms,
+                 elapsed_ms > 0.0 ? audio_ms / elapsed_ms : 0.0);
+
+    int result = opts.melody.notes.empty() ? 0 : score_file(opts, path, frames);
+    if (opts.expect_hz <= 0.0f) return result;
+    float cents = med > 0.0f ? 1200.0f * std::fabs(std::log2(med / opts.expect_hz)) : 1e9f;
+    bool ok = cents <= opts.tolerance_cents && voiced_ratio >= opts.min_voiced;
+    std::fprintf(stderr, "%s: expect %.2f Hz -> %s (error %.1f cents, voiced %.1f%%)\n", path.c_str(),
+                 opts.expect_hz, ok ? "PASS" : "FAIL", cents, voiced_ratio * 100.0f);
+    return ok ? result : 1;
+}
+
+bool parse_args(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--csv") {
+            opts.csv = true;
+        } else if (arg == "--window-ms" && val) {
+            opts.cfg.window_ms = std::atoi(val);
+            ++i;
+        } else if (arg == "--hop-ms" && val) {
+            opts.cfg.hop_ms = std::atoi(val);
+            ++i;
+        } else if (arg == "--threshold" && val) {
+            opts.cfg.threshold = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--expect-hz" && val) {
+            opts.expect_hz = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--tolerance-cents" && val) {
+            opts.tolerance_cents = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--min-voiced" && val) {
+            opts.min_voiced = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--melody" && val) {
+            opts.melody_path = val;
+            ++i;
+        } else if (arg == "--offset-ms" && val) {
+            opts.offset_ms = std::atoi(val);
+            ++i;
+        } else if (arg == "--expect-score" && val) {
+            opts.expect_score = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--transpose" && val) {
+            opts.gen_transpose = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--gen" && val) {
+            opts.gen_path = val;
+            ++i;
+        } else if (arg == "--hz" && val) {
+            opts.gen_hz = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--seconds" && val) {
+            opts.gen_seconds = static_cast<float>(std::atof(val));
+            ++i;
+        } else if (arg == "--rate" && val) {
+            opts.gen_rate = std::atoi(val);
+            ++i;
+        } else if (arg == "--channels" && val) {
+            opts.gen_channels = std::max(1, std::atoi(val));
+            ++i;
+        } else if (!arg.empty() && arg[0] != '-') {
+            opts.files.push_back(arg);
+        } else {
+            return false;
+        }
+    }
+    return !opts.files.empty() || !opts.gen_path.empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        std::fprintf(stderr,
+                     "usage: %s [--csv] [--window-ms 32] [--hop-ms 10] [--threshold 0.15]\n"
+                     "          [--expect-hz F [--tolerance-cents 30] [--min-voiced 0.6]]\n"
+                     "          [--melody melody.txt [--offset-ms 0] [--expect-score S]] file.wav...\n"
+                     "       %s --gen out.wav (--hz 220 [--seconds 3] | --melody melody.txt [--transpose 0])\n"
+                     "          [--rate 48000] [--channels 1]\n",
+                     argv[0], argv[0]);
+        return 2;
+    }
+
+    if (!opts.melody_path.empty()) {
+        std::string error;
+        if (!opts.melody.load(opts.melody_path, error)) {
+            std::fprintf(stderr, "%s: %s\n", opts.melody_path.c_str(), error.c_str());
+            return 2;
+        }
+    }
+
+    if (!opts.gen_path.empty()) return generate(opts) ? 0 : 2;
+
+    if (opts.csv) std::printf("file,time_ms,f0_hz,midi,confidence,rms,voiced\n");
+    int result = 0;
+    for (const auto& file : opts.files) result = std::max(result, run_file(opts, file));
+    return result;
+}
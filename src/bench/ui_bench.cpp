@@ -0,0 +1,350 @@
+/**
+ * ktvlv_ui_bench：无头 UI 基准（内存显示驱动，不需要 /dev/fb0）
+ *
+ * 对每个页面（首页/历史/搜索/播放条）按不同列表规模用合成数据构建，
+ * 依次执行滚动序列和焦点移动序列，逐帧记录：
+ *   render_us   帧耗时中除去 flush 的部分（布局 + 绘制）
+ *   flush_us / flush_bytes   显示驱动拷贝耗时与字节数
+ *   objs        当前屏幕对象数
+ *   heap_used   LVGL 内存池已用字节
+ *
+ * 用法：ktvlv_ui_bench [--sizes 0,50,500,5000] [--frames 60] [--res 1280x720] [--partial]
+ * stdout 输出逐帧 CSV，stderr 输出每个场景的汇总。
+ *
+ * 执行器保持停止：页面数据在请求线程同步生成，结果在下一帧 drain 时生效，帧序列可复现。
+ */
+
+extern "C" {
+#include <lvgl.h>
+#include "platform/headless/display_mem.h"
+}
+#include "ui/layouts.h"
+#include "ui/ui_scale.h"
+#include "ui/style_registry.h"
+#include "events/ui_dispatcher.h"
+#include "core/executor.h"
+#include "core/log_ring.h"
+#include "core/lv_mem_pool.h"
+#include <syslog.h>
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+struct Options {
+    std::vector<int> sizes{0, 50, 500, 5000};
+    int frames = 60;   // 滚动、焦点序列各自的帧数
+    int width = LV_HOR_RES_MAX;
+    int height = LV_VER_RES_MAX;
+    bool partial = false;   // 默认与 ktvlv 一致：full_refresh
+    uint32_t frame_ms = 16;
+};
+
+struct FrameSample {
+    long long render_us{0};
+    long long flush_us{0};
+    unsigned long long flush_bytes{0};
+    uint32_t objs{0};
+    size_t heap_used{0};
+};
+
+struct Scenario {
+    const char* page;
+    bool uses_list;
+    void (*build)(lv_obj_t* content);
+    lv_obj_t* (*scroll_target)(lv_obj_t* content);
+};
+
+void build_player_bar(lv_obj_t* content) {
+    ktv::ui::create_player_bar(content);
+}
+
+lv_obj_t* first_child(lv_obj_t* content) {
+    return lv_obj_get_child(content, 0);
+}
+
+// 搜索页：左列 -> [输入框, 键盘, 结果列表]
+lv_obj_t* search_results(lv_obj_t* content) {
+    lv_obj_t* left = lv_obj_get_child(content, 0);
+    return left ? lv_obj_get_child(left, 2) : nullptr;
+}
+
+const Scenario kScenarios[] = {
+    {"home", true, ktv::ui::show_home_tab, first_child},
+    {"history", true, ktv::ui::show_history_tab, first_child},
+    {"search", true, ktv::ui::show_search_page, search_results},
+    {"player_bar", false, build_player_bar, nullptr},
+};
+
+long long elapsed_us(Clock::time_point begin) {
+    return std::chrono::duration_cast<std::chrono::microseconds>(Clock::now() - begin).count();
+}
+
+uint32_t count_objs(lv_obj_t* obj) {
+    uint32_t n = 1;
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < cnt; ++i) n += count_objs(lv_obj_get_child(obj, static_cast<int32_t>(i)));
+    return n;
+}
+
+void collect_buttons(lv_obj_t* obj, std::vector<lv_obj_t*>& out) {
+    if (lv_obj_check_type(obj, &lv_btn_class)) out.push_back(obj);
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < cnt; ++i) collect_buttons(lv_obj_get_child(obj, static_cast<int32_t>(i)), out);
+}
+
+// 合成歌曲：总数 total，按页切片
+ktv::ui::SongPageProvider synthetic_provider(int total) {
+    return [total](int page, int size) {
+        std::vector<ktv::services::SongItem> out;
+        int begin = page * size;
+        int end = std::min(total, begin + size);
+        for (int i = begin; i < end; ++i) {
+            char buf[32];
+            ktv::services::SongItem s;
+            std::snprintf(buf, sizeof(buf), "bench-%06d", i);
+            s.id = buf;
+            std::snprintf(buf, sizeof(buf), "Song %06d", i);
+            s.title = buf;
+            std::snprintf(buf, sizeof(buf), "Artist %03d", i % 997);
+            s.artist = buf;
+            out.push_back(std::move(s));
+        }
+        return out;
+    };
+}
+
+class Bench {
+public:
+    explicit Bench(const Options& opts) : opts_(opts) {}
+
+    bool init() {
+        display_mem_set_resolution(opts_.width, opts_.height);
+        if (!DISPLAY.init()) return false;
+
+        draw_pixels_.resize(static_cast<size_t>(opts_.width) * static_cast<size_t>(opts_.height));
+        lv_disp_draw_buf_init(&draw_buf_, draw_pixels_.data(), nullptr, static_cast<uint32_t>(draw_pixels_.size()));
+        lv_disp_drv_init(&disp_drv_);
+        disp_drv_.hor_res = static_cast<lv_coord_t>(opts_.width);
+        disp_drv_.ver_res = static_cast<lv_coord_t>(opts_.height);
+        disp_drv_.flush_cb = DISPLAY.flush;
+        disp_drv_.draw_buf = &draw_buf_;
+        disp_drv_.full_refresh = opts_.partial ? 0 : 1;
+        lv_disp_t* disp = lv_disp_drv_register(&disp_drv_);
+        if (!disp) return false;
+        lv_disp_set_default(disp);
+
+        ktv::ui::init_ui_system(static_cast<lv_coord_t>(opts_.width), static_cast<lv_coord_t>(opts_.height));
+        return true;
+    }
+
+    void run() {
+        std::printf("page,size,frame,action,render_us,flush_us,flush_bytes,objs,heap_used\n");
+        std::fprintf(stderr, "[BENCH] res=%dx%d refresh=%s scale=%s(%.3f)\n", opts_.width, opts_.height,
+                     opts_.partial ? "partial" : "full", ktv::ui::UIScale::isFixed() ? "fixed" : "runtime",
+                     static_cast<double>(ktv::ui::UIScale::getInstance().getScale()));
+        for (const Scenario& sc : kScenarios) {
+            if (!sc.uses_list) {
+                runScenario(sc, 0);
+                continue;
+            }
+            for (int size : opts_.sizes) runScenario(sc, size);
+        }
+    }
+
+private:
+    void runScenario(const Scenario& sc, int size) {
+        lv_obj_t* scr = lv_scr_act();
+        lv_obj_clean(scr);
+        ktv::ui::set_song_page_provider(sc.uses_list ? synthetic_provider(size) : nullptr);
+        frame();   // 清屏后的整帧不计入
+
+        page_ = sc.page;
+        size_ = size;
+        frame_ = 0;
+        samples_.clear();
+
+        const size_t heap_before = heapUsed();
+        auto begin = Clock::now();
+        lv_obj_t* content = lv_obj_create(scr);
+        lv_obj_set_size(content, LV_PCT(100), LV_PCT(100));
+        sc.build(content);
+        lv_obj_update_layout(content);
+        const long long build_us = elapsed_us(begin);
+        emit("build", sample(build_us, 0, 0));
+
+        // 首屏稳定（合成数据同步到达，之后几帧是布局与绘制收尾）
+        for (int i = 0; i < 3; ++i) emit("settle", frame());
+
+        if (lv_obj_t* list = sc.scroll_target ? sc.scroll_target(content) : nullptr) {
+            const lv_coord_t step = ktv::ui::UIScale::s(72 + 6) * 3;   // 每帧 3 行
+            lv_coord_t dir = 1;
+            for (int i = 0; i < opts_.frames; ++i) {
+                if (dir > 0 && lv_obj_get_scroll_bottom(list) <= 0) dir = -1;
+                else if (dir < 0 && lv_obj_get_scroll_top(list) <= 0) dir = 1;
+                lv_obj_scroll_by(list, 0, -dir * step, LV_ANIM_OFF);
+                emit(dir > 0 ? "scroll_down" : "scroll_up", frame());
+            }
+        }
+
+        std::vector<lv_obj_t*> buttons;
+        collect_buttons(content, buttons);
+        if (!buttons.empty()) {
+            lv_group_t* group = lv_group_create();
+            for (lv_obj_t* b : buttons) lv_group_add_obj(group, b);
+            for (int i = 0; i < opts_.frames; ++i) {
+                lv_group_focus_next(group);
+                emit("focus_next", frame());
+            }
+            lv_group_del(group);
+        }
+
+        summarize(build_us, heap_before);
+    }
+
+    FrameSample frame() {
+        lv_tick_inc(opts_.frame_ms);
+        display_mem_stats_t discard;
+        display_mem_take_stats(&discard);
+
+        auto begin = Clock::now();
+        ktv::events::UiDispatcher::getInstance().drain();
+        lv_timer_handler();
+        lv_refr_now(nullptr);
+        long long total_us = elapsed_us(begin);
+
+        display_mem_stats_t st;
+        display_mem_take_stats(&st);
+        long long flush_us = static_cast<long long>(st.flush_ns / 1000);
+        return sample(total_us - flush_us, flush_us, st.flush_bytes);
+    }
+
+    FrameSample sample(long long render_us, long long flush_us, unsigned long long flush_bytes) {
+        FrameSample s;
+        s.render_us = render_us;
+        s.flush_us = flush_us;
+        s.flush_bytes = flush_bytes;
+        s.objs = count_objs(lv_scr_act());
+        s.heap_used = heapUsed();
+        return s;
+    }
+
+    static size_t heapUsed() {
+        ktv_lv_pool_stats_t st;
+        ktv_lv_pool_get_stats(&st);
+        return st.used;
+    }
+
+    void emit(const char* action, const FrameSample& s) {
+        std::printf("%s,%d,%d,%s,%lld,%lld,%llu,%u,%zu\n", page_, size_, frame_++, action,
+                    s.render_us, s.flush_us, s.flush_bytes, s.objs, s.heap_used);
+        if (std::strcmp(action, "build") != 0) samples_.push_back(s);
+    }
+
+    void summarize(long long build_us, size_t heap_before) {
+        if (samples_.empty()) return;
+        std::vector<long long> render;
+        unsigned long long bytes = 0;
+        long long flush_us = 0;
+        uint32_t objs = 0;
+        size_t heap_peak = 0;
+        for (const auto& s : samples_) {
+            render.push_back(s.render_us);
+            bytes += s.flush_bytes;
+            flush_us += s.flush_us;
+            objs = std::max(objs, s.objs);
+            heap_peak = std::max(heap_peak, s.heap_used);
+        }
+        std::sort(render.begin(), render.end());
+        auto pct = [&](int p) { return render[(render.size() - 1) * static_cast<size_t>(p) / 100]; };
+        const size_t n = samples_.size();
+        std::fprintf(stderr,
+                     "[BENCH] page=%s size=%d build_us=%lld frames=%zu render_us p50=%lld p95=%lld max=%lld "
+                     "flush_us_avg=%lld flush_kb_avg=%llu objs_max=%u heap_page_kb=%zu heap_peak_kb=%zu\n",
+                     page_, size_, build_us, n, pct(50), pct(95), render.back(),
+                     flush_us / static_cast<long long>(n), bytes / n / 1024, objs,
+                     heap_peak > heap_before ? (heap_peak - heap_before) / 1024 : 0, heap_peak / 1024);
+    }
+
+    Options opts_;
+    lv_disp_draw_buf_t draw_buf_{};
+    lv_disp_drv_t disp_drv_{};
+    std::vector<lv_color_t> draw_pixels_;
+
+    const char* page_{""};
+    int size_{0};
+    int frame_{0};
+    std::vector<FrameSample> samples_;
+};
+
+bool parse_args(int argc, char* argv[], Options& opts) {
+    for (int i = 1; i < argc; ++i) {
+        std::string arg = argv[i];
+        const char* val = i + 1 < argc ? argv[i + 1] : nullptr;
+        if (arg == "--sizes" && val) {
+            opts.sizes.clear();
+            std::string list = val;
+            size_t pos = 0;
+            while (pos <= list.size()) {
+                size_t comma = list.find(',', pos);
+                if (comma == std::string::npos) comma = list.size();
+                if (comma > pos) opts.sizes.push_back(std::atoi(list.substr(pos, comma - pos).c_str()));
+                pos = comma + 1;
+            }
+            ++i;
+        } else if (arg == "--frames" && val) {
+            opts.frames = std::max(1, std::atoi(val));
+            ++i;
+        } else if (arg == "--res" && val) {
+            if (std::sscanf(val, "%dx%d", &opts.width, &opts.height) != 2 || opts.width <= 0 || opts.height <= 0) {
+                return false;
+            }
+            ++i;
+        } else if (arg == "--partial") {
+            opts.partial = true;
+        } else {
+            return false;
+        }
+    }
+    return !opts.sizes.empty();
+}
+
+}  // namespace
+
+int main(int argc, char* argv[]) {
+    Options opts;
+    if (!parse_args(argc, argv, opts)) {
+        std::fprintf(stderr, "usage: %s [--sizes 0,50,500,5000] [--frames 60] [--res 1280x720] [--partial]\n",
+                     argv[0]);
+        return 2;
+    }
+
+    // 页面构建过程中的 INFO 日志会干扰计时
+    openlog("ktv_bench", LOG_PID, LOG_USER);
+    setlogmask(LOG_UPTO(LOG_WARNING));
+
+    // 合成数据源在 UI 线程同步取页，不需要后台线程
+    ktv::core::Executor::instance().stop();
+
+    lv_init();
+    Bench bench(opts);
+    if (!bench.init()) {
+        std::fprintf(stderr, "[BENCH] display init failed\n");
+        return 1;
+    }
+    bench.run();
+
+    ktv::ui::set_song_page_provider(nullptr);
+    DISPLAY.deinit();
+    // 执行器已停，日志环没有周期排空：退出前同步写出（WARNING 以上）
+    ktv::core::LogRing::instance().drain();
+    closelog();
+    return 0;
+}
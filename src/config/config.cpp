@@ -21,10 +21,207 @@ static int handler(void* user, const char* section, const char* name, const char
     return 1;
 }
 
+static int prefetch_handler(void* user, const char* section, const char* name, const char* value) {
+    PrefetchConfig* cfg = static_cast<PrefetchConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "prefetch") {
+        if (key == "enabled") cfg->enabled = std::atoi(val.c_str()) != 0;
+        else if (key == "head_seconds") cfg->head_seconds = std::atoi(val.c_str());
+        else if (key == "max_queue_songs") cfg->max_queue_songs = std::atoi(val.c_str());
+        else if (key == "max_trending_songs") cfg->max_trending_songs = std::atoi(val.c_str());
+        else if (key == "rate_limit_kbps") cfg->rate_limit_kbps = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int cache_handler(void* user, const char* section, const char* name, const char* value) {
+    CacheConfig* cfg = static_cast<CacheConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "cache") {
+        if (key == "root") cfg->root = val;
+        else if (key == "verify_on_download") cfg->verify_on_download = std::atoi(val.c_str()) != 0;
+        else if (key == "verify_on_play") cfg->verify_on_play = std::atoi(val.c_str()) != 0;
+        else if (key == "budget_mb") cfg->budget_mb = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int ui_handler(void* user, const char* section, const char* name, const char* value) {
+    UiConfig* cfg = static_cast<UiConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "ui") {
+        if (key == "page_cache_pages") cfg->page_cache_pages = std::atoi(val.c_str());
+        else if (key == "page_cache_budget_kb") cfg->page_cache_budget_kb = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int image_handler(void* user, const char* section, const char* name, const char* value) {
+    ImageCacheConfig* cfg = static_cast<ImageCacheConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "image") {
+        if (key == "mem_budget_kb") cfg->mem_budget_kb = std::atoi(val.c_str());
+        else if (key == "thumb_dir") cfg->thumb_dir = val;
+        else if (key == "disk_budget_mb") cfg->disk_budget_mb = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int perf_handler(void* user, const char* section, const char* name, const char* value) {
+    PerfConfig* cfg = static_cast<PerfConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "perf") {
+        if (key == "hud") cfg->hud = std::atoi(val.c_str()) != 0;
+        else if (key == "hud_hotkey") cfg->hud_hotkey = std::atoi(val.c_str()) != 0;
+        else if (key == "log_interval_s") cfg->log_interval_s = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int input_handler(void* user, const char* section, const char* name, const char* value) {
+    InputConfig* cfg = static_cast<InputConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "input") {
+        if (key == "repeat_delay_ms") cfg->repeat_delay_ms = std::atoi(val.c_str());
+        else if (key == "repeat_interval_ms") cfg->repeat_interval_ms = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
+static int audio_handler(void* user, const char* section, const char* name, const char* value) {
+    AudioConfig* cfg = static_cast<AudioConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "audio") {
+        if (key == "capture_device") cfg->capture_device = val;
+        else if (key == "period_frames") cfg->period_frames = std::atoi(val.c_str());
+        else if (key == "periods") cfg->periods = std::atoi(val.c_str());
+        else if (key == "ring_ms") cfg->ring_ms = std::atoi(val.c_str());
+        else if (key == "sample_rate") cfg->sample_rate = std::atoi(val.c_str());
+        else if (key == "monitor_enabled") cfg->monitor_enabled = std::atoi(val.c_str()) != 0;
+        else if (key == "monitor_device") cfg->monitor_device = val;
+        else if (key == "monitor_period_frames") cfg->monitor_period_frames = std::atoi(val.c_str());
+        else if (key == "monitor_periods") cfg->monitor_periods = std::atoi(val.c_str());
+        else if (key == "monitor_channels") cfg->monitor_channels = std::atoi(val.c_str());
+        else if (key == "monitor_target_ms") cfg->monitor_target_ms = std::atoi(val.c_str());
+        else if (key == "monitor_measure_latency") cfg->monitor_measure_latency = std::atoi(val.c_str()) != 0;
+        else if (key == "fx_gain_db") cfg->fx_gain_db = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_echo") cfg->fx_echo = std::atoi(val.c_str()) != 0;
+        else if (key == "fx_echo_ms") cfg->fx_echo_ms = std::atoi(val.c_str());
+        else if (key == "fx_echo_feedback") cfg->fx_echo_feedback = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_echo_mix") cfg->fx_echo_mix = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_reverb") cfg->fx_reverb = std::atoi(val.c_str()) != 0;
+        else if (key == "fx_reverb_room") cfg->fx_reverb_room = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_reverb_damp") cfg->fx_reverb_damp = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_reverb_mix") cfg->fx_reverb_mix = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "fx_limiter_db") cfg->fx_limiter_db = static_cast<float>(std::atof(val.c_str()));
+    }
+    return 1;
+}
+
+static int score_handler(void* user, const char* section, const char* name, const char* value) {
+    ScoreConfig* cfg = static_cast<ScoreConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "score") {
+        if (key == "enabled") cfg->enabled = std::atoi(val.c_str()) != 0;
+        else if (key == "time_tolerance_ms") cfg->time_tolerance_ms = std::atoi(val.c_str());
+        else if (key == "full_credit_cents") cfg->full_credit_cents = std::atoi(val.c_str());
+        else if (key == "zero_credit_cents") cfg->zero_credit_cents = std::atoi(val.c_str());
+        else if (key == "octave_fold") cfg->octave_fold = std::atoi(val.c_str()) != 0;
+        else if (key == "latency_ms") cfg->latency_ms = std::atoi(val.c_str());
+        else if (key == "ui_interval_ms") cfg->ui_interval_ms = std::atoi(val.c_str());
+        else if (key == "min_confidence") cfg->min_confidence = static_cast<float>(std::atof(val.c_str()));
+        else if (key == "coverage") cfg->coverage = static_cast<float>(std::atof(val.c_str()));
+    }
+    return 1;
+}
+
+static int log_handler(void* user, const char* section, const char* name, const char* value) {
+    LogConfig* cfg = static_cast<LogConfig*>(user);
+    std::string sec(section);
+    std::string key(name);
+    std::string val(value ? value : "");
+
+    if (sec == "log") {
+        if (key == "level") cfg->level = val;
+        else if (key == "components") cfg->components = val;
+        else if (key == "rate_per_sec") cfg->rate_per_sec = std::atoi(val.c_str());
+        else if (key == "burst") cfg->burst = std::atoi(val.c_str());
+    }
+    return 1;
+}
+
 bool loadFromFile(const std::string& path, NetworkConfig& out_cfg) {
     int ret = ini_parse(path.c_str(), handler, &out_cfg);
     return ret == 0;
 }
 
-}  // namespace ktv::config
+bool loadPrefetchConfig(const std::string& path, PrefetchConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), prefetch_handler, &out_cfg);
+    return ret == 0;
+}
 
+bool loadCacheConfig(const std::string& path, CacheConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), cache_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadUiConfig(const std::string& path, UiConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), ui_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadImageCacheConfig(const std::string& path, ImageCacheConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), image_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadPerfConfig(const std::string& path, PerfConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), perf_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadInputConfig(const std::string& path, InputConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), input_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadAudioConfig(const std::string& path, AudioConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), audio_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadScoreConfig(const std::string& path, ScoreConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), score_handler, &out_cfg);
+    return ret == 0;
+}
+
+bool loadLogConfig(const std::string& path, LogConfig& out_cfg) {
+    int ret = ini_parse(path.c_str(), log_handler, &out_cfg);
+    return ret == 0;
+}
+
+}  // namespace ktv::config
@@ -14,9 +14,130 @@ struct NetworkConfig {
     std::string vn = "1.0.0";
 };
 
+// 预取配置：队列/热门歌曲的开头部分提前缓存到本地
+struct PrefetchConfig {
+    bool enabled = true;
+    int head_seconds = 20;        // 每首歌预取的开头时长（秒）
+    int max_queue_songs = 3;      // 已点队列中最多预取的歌曲数
+    int max_trending_songs = 2;   // 热门/历史中最多预取的歌曲数
+    int rate_limit_kbps = 2048;   // 预取下载限速（KB/s），0 表示不限速
+};
+
+// 片段缓存配置：ts 片段按内容哈希存储（去重），每首歌一个 manifest
+struct CacheConfig {
+    std::string root = "/data/ktv_cache";
+    bool verify_on_download = true;  // 落盘后回读校验哈希
+    bool verify_on_play = false;     // 播放前后台重新校验已缓存片段
+    int budget_mb = 2048;            // 片段对象库大小上限（MB），超出后按最久未播放淘汰整首歌，0 表示不限
+};
+
+// UI 配置：页面缓存（切换页面时隐藏而不是销毁）
+struct UiConfig {
+    int page_cache_pages = 3;         // 最多保留的页面数（含当前页），<=1 表示每次切换都重建
+    int page_cache_budget_kb = 1024;  // 缓存页面占用的 LVGL 内存上限（KB），0 表示不限
+};
+
+// 图片缓存配置：封面/歌手图解码后的内存 LRU 与磁盘缩略图
+struct ImageCacheConfig {
+    int mem_budget_kb = 2048;                        // 已解码图片占用内存上限（KB）
+    std::string thumb_dir = "/data/ktv_cache/thumbs";  // 缩略图目录，为空表示不落盘
+    int disk_budget_mb = 32;                         // 缩略图目录大小上限（MB）
+};
+
+// 性能统计：帧耗时/输入延迟 HUD 与周期日志（运行中可用组合键切换 HUD）
+struct PerfConfig {
+    bool hud = false;           // 启动时是否显示 HUD
+    bool hud_hotkey = false;    // 是否响应 HUD 切换按键（左右左右 / F12），正常导航会误触，只在调试时打开
+    int log_interval_s = 60;    // 分位数写 syslog 的周期（秒），0 表示不写
+};
+
+// 输入：遥控器方向键长按连发
+struct InputConfig {
+    int repeat_delay_ms = 400;      // 按住多久开始连发
+    int repeat_interval_ms = 80;    // 连发间隔，0 表示关闭连发
+};
+
+// 录音：ALSA mmap 采集与无锁环形缓冲，可选人声监听
+struct AudioConfig {
+    std::string capture_device = "hw:0,0";
+    int period_frames = 128;      // 周期大小（帧），越小延迟越低
+    int periods = 4;              // 硬件缓冲周期数
+    int ring_ms = 500;            // 软件环形缓冲时长，消费者最多可落后的时间
+    int sample_rate = 48000;      // 录音采样率（单声道），监听与音高检测共用
+
+    // 人声监听（录音 → 回声/混响/限幅 → 播放）
+    bool monitor_enabled = false;         // 开始录音时自动开启监听
+    std::string monitor_device = "hw:0,0";
+    int monitor_period_frames = 64;       // 监听周期，越小延迟越低
+    int monitor_periods = 2;              // 播放缓冲周期数
+    int monitor_channels = 2;
+    int monitor_target_ms = 20;           // 往返延迟目标，超出时丢弃积压并告警
+    bool monitor_measure_latency = false; // 每次开启监听后做一次回环实测（需输出能回到输入）
+
+    // 监听效果链（audio_fx），默认值与 audio_fx_default_params 一致
+    float fx_gain_db = 0.0f;
+    bool fx_echo = false;
+    int fx_echo_ms = 250;
+    float fx_echo_feedback = 0.35f;
+    float fx_echo_mix = 0.3f;
+    bool fx_reverb = false;
+    float fx_reverb_room = 0.6f;
+    float fx_reverb_damp = 0.4f;
+    float fx_reverb_mix = 0.25f;
+    float fx_limiter_db = -1.0f;
+};
+
+// 演唱打分：参考旋律对齐与事件限频
+struct ScoreConfig {
+    bool enabled = true;          // 起播时开录音 + 音高跟踪 + 打分（歌曲没有 melody.txt 时不打分）
+    int time_tolerance_ms = 150;  // 抢拍/拖拍容差
+    int full_credit_cents = 50;   // 偏差在此以内满分
+    int zero_credit_cents = 200;  // 偏差超过此值不得分
+    bool octave_fold = true;      // 高低八度算唱对
+    int latency_ms = 0;           // 采集链路延迟补偿（麦克风到音高帧）
+    int ui_interval_ms = 200;     // 实时分事件最小间隔
+    float min_confidence = 0.5f;  // 低于该置信度的音高帧视为无声
+    float coverage = 0.7f;        // 音符时长中唱准多少比例即得满分
+};
+
+// 日志：运行时级别与限频（编译期下限由 KTV_LOG_MIN_LEVEL 决定）
+struct LogConfig {
+    std::string level = "info";   // 默认级别：debug/info/notice/warn/err
+    std::string components;       // 按组件覆盖，如 "download:warn,player:debug"
+    int rate_per_sec = 20;        // 每个调用点每秒允许的条数，0 表示不限频
+    int burst = 50;               // 突发上限（条）
+};
+
 // 从 ini 文件加载配置，不存在则返回默认值；返回是否成功解析文件
 bool loadFromFile(const std::string& path, NetworkConfig& out_cfg);
 
+// 从 ini 文件加载 [prefetch] 段，不存在则保留默认值
+bool loadPrefetchConfig(const std::string& path, PrefetchConfig& out_cfg);
+
+// 从 ini 文件加载 [cache] 段，不存在则保留默认值
+bool loadCacheConfig(const std::string& path, CacheConfig& out_cfg);
+
+// 从 ini 文件加载 [ui] 段，不存在则保留默认值
+bool loadUiConfig(const std::string& path, UiConfig& out_cfg);
+
+// 从 ini 文件加载 [image] 段，不存在则保留默认值
+bool loadImageCacheConfig(const std::string& path, ImageCacheConfig& out_cfg);
+
+// 从 ini 文件加载 [perf] 段，不存在则保留默认值
+bool loadPerfConfig(const std::string& path, PerfConfig& out_cfg);
+
+// 从 ini 文件加载 [input] 段，不存在则保留默认值
+bool loadInputConfig(const std::string& path, InputConfig& out_cfg);
+
+// 从 ini 文件加载 [audio] 段，不存在则保留默认值
+bool loadAudioConfig(const std::string& path, AudioConfig& out_cfg);
+
+// 从 ini 文件加载 [score] 段，不存在则保留默认值
+bool loadScoreConfig(const std::string& path, ScoreConfig& out_cfg);
+
+// 从 ini 文件加载 [log] 段，不存在则保留默认值
+bool loadLogConfig(const std::string& path, LogConfig& out_cfg);
+
 }  // namespace ktv::config
 
 #endif  // KTVLV_CONFIG_CONFIG_H
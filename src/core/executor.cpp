@@ -0,0 +1,493 @@
+#include "executor.h"
+#include <syslog.h>
+#include <algorithm>
+#include <cstdio>
+#include <exception>
+#include <pthread.h>
+#include <sys/resource.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+
+namespace ktv::core {
+
+using std::chrono::duration_cast;
+using std::chrono::microseconds;
+using std::chrono::milliseconds;
+
+static constexpr size_t kLaneCount = static_cast<size_t>(Lane::Count);
+static constexpr milliseconds kStatsLogPeriod{60 * 1000};
+
+static uint64_t us_between(Executor::Clock::time_point a, Executor::Clock::time_point b) {
+    return b > a ? static_cast<uint64_t>(duration_cast<microseconds>(b - a).count()) : 0;
+}
+
+static Lane lane_of(TaskId id) {
+    return static_cast<Lane>(id & 0xFF);
+}
+
+Executor::Executor() {
+    static const LaneConfig kDefaults[kLaneCount] = {
+        // name         threads capacity policy                    nice  block_ms
+        {"player",      1,      32,      RejectPolicy::Block,      -5,   50},
+        {"audio",       1,      16,      RejectPolicy::Reject,     -2,   0},
+        {"download",    1,      64,      RejectPolicy::Reject,      5,   0},
+        {"background",  1,      128,     RejectPolicy::DropOldest, 10,   0},
+        {"upload",      1,      16,      RejectPolicy::Reject,     15,   0},
+    };
+    for (size_t i = 0; i < kLaneCount; ++i) {
+        lanes_[i].reset(new LaneState());
+        lanes_[i]->cfg = kDefaults[i];
+    }
+}
+
+Executor::~Executor() {
+    stop();
+}
+
+const char* Executor::laneName(Lane lane) {
+    switch (lane) {
+        case Lane::Player: return "player";
+        case Lane::Audio: return "audio";
+        case Lane::Download: return "download";
+        case Lane::Background: return "background";
+        case Lane::Upload: return "upload";
+        case Lane::Count: break;
+    }
+    return "unknown";
+}
+
+void Executor::configure(Lane lane, const LaneConfig& cfg) {
+    if (running_.load()) {
+        syslog(LOG_WARNING, "[ktv][executor] configure ignored after start, lane=%s", laneName(lane));
+        return;
+    }
+    LaneState& ls = state(lane);
+    std::lock_guard<std::mutex> lock(ls.mtx);
+    ls.cfg = cfg;
+    if (ls.cfg.threads < 1) ls.cfg.threads = 1;
+    if (ls.cfg.capacity < 1) ls.cfg.capacity = 1;
+}
+
+size_t Executor::threadCount() const {
+    size_t n = 0;
+    for (const auto& ls : lanes_) n += static_cast<size_t>(ls->cfg.threads);
+    return n;
+}
+
+void Executor::start() {
+    if (running_.exchange(true)) {
+        return;
+    }
+    stopped_ = false;
+    for (size_t i = 0; i < kLaneCount; ++i) {
+        LaneState& ls = *lanes_[i];
+        for (int t = 0; t < ls.cfg.threads; ++t) {
+            ls.workers.emplace_back(&Executor::workerLoop, this, static_cast<Lane>(i), t);
+        }
+    }
+    schedulePeriodic(Lane::Background, kStatsLogPeriod, [this] { logStats(); });
+    syslog(LOG_INFO, "[ktv][executor] started, threads=%zu", threadCount());
+}
+
+void Executor::stop() {
+    stopped_ = true;
+    if (!running_.exchange(false)) {
+        return;
+    }
+    for (auto& ls : lanes_) {
+        std::lock_guard<std::mutex> lock(ls->mtx);
+        ls->not_empty.notify_all();
+        ls->not_full.notify_all();
+    }
+    for (size_t i = 0; i < kLaneCount; ++i) {
+        LaneState& ls = *lanes_[i];
+        for (auto& t : ls.workers) {
+            if (t.joinable()) t.join();
+        }
+        ls.workers.clear();
+
+        std::lock_guard<std::mutex> lock(ls.mtx);
+        if (!ls.ready.empty() || !ls.timers.empty()) {
+            syslog(LOG_INFO, "[ktv][executor] lane=%s discarded ready=%zu timed=%zu",
+                   ls.cfg.name, ls.ready.size(), ls.timers.size());
+        }
+        ls.ready.clear();
+        ls.timers.clear();
+        ls.periodic.clear();
+    }
+    syslog(LOG_INFO, "[ktv][executor] stopped");
+}
+
+bool Executor::post(Lane lane, Task fn, Task on_drop) {
+    if (!fn) return false;
+    return enqueue(lane, Item{std::move(fn), Clock::now(), std::move(on_drop), false});
+}
+
+bool Executor::enqueue(Lane lane, Item item) {
+    if (lane == Lane::Count) return false;
+    LaneState& ls = state(lane);
+    std::unique_lock<std::mutex> lock(ls.mtx);
+    ++ls.stats.submitted;
+    if (stopped_.load()) {
+        ++ls.stats.rejected;
+        return false;
+    }
+
+    Task dropped;   // 被挤掉任务的 on_drop，锁外调用
+    if (ls.ready.size() >= ls.cfg.capacity && !item.internal) {
+        switch (ls.cfg.policy) {
+            case RejectPolicy::Reject:
+                ++ls.stats.rejected;
+                syslog(LOG_WARNING, "[ktv][executor] lane=%s rejected, depth=%zu", ls.cfg.name, ls.ready.size());
+                return false;
+            case RejectPolicy::DropOldest: {
+                // 只丢普通任务：内部任务丢了会让周期任务/串行队列永久停摆
+                auto victim = std::find_if(ls.ready.begin(), ls.ready.end(), [](const Item& it) { return !it.internal; });
+                ++ls.stats.dropped;
+                if (victim == ls.ready.end()) {
+                    // 队列里全是内部任务：丢新任务本身
+                    lock.unlock();
+                    if (item.on_drop) item.on_drop();
+                    return false;
+                }
+                dropped = std::move(victim->on_drop);
+                ls.ready.erase(victim);
+                break;
+            }
+            case RejectPolicy::CallerRuns:
+                lock.unlock();
+                item.fn();
+                return true;
+            case RejectPolicy::Block: {
+                bool ok = ls.not_full.wait_for(lock, milliseconds(ls.cfg.block_timeout_ms), [&] {
+                    return ls.ready.size() < ls.cfg.capacity || !running_.load();
+                });
+                if (!ok || ls.ready.size() >= ls.cfg.capacity) {
+                    ++ls.stats.rejected;
+                    syslog(LOG_WARNING, "[ktv][executor] lane=%s rejected after block, depth=%zu",
+                           ls.cfg.name, ls.ready.size());
+                    return false;
+                }
+                break;
+            }
+        }
+    }
+
+    ls.ready.push_back(std::move(item));
+    if (ls.ready.size() > ls.stats.queue_depth_max) ls.stats.queue_depth_max = ls.ready.size();
+    lock.unlock();
+    ls.not_empty.notify_one();
+    if (dropped) dropped();
+    return true;
+}
+
+TaskId Executor::schedule(Lane lane, milliseconds delay, Task fn) {
+    if (delay.count() < 0) delay = milliseconds(0);
+    return scheduleTimed(lane, Clock::now() + delay, milliseconds(0), std::move(fn));
+}
+
+TaskId Executor::schedulePeriodic(Lane lane, milliseconds period, Task fn, milliseconds initial_delay) {
+    if (period.count() <= 0) return 0;
+    if (initial_delay.count() < 0) initial_delay = period;
+    return scheduleTimed(lane, Clock::now() + initial_delay, period, std::move(fn));
+}
+
+TaskId Executor::scheduleTimed(Lane lane, Clock::time_point due, milliseconds period, Task fn) {
+    if (!fn || lane == Lane::Count || stopped_.load()) return 0;
+    TaskId id = (next_id_.fetch_add(1) << 8) | static_cast<TaskId>(lane);
+    LaneState& ls = state(lane);
+    {
+        std::lock_guard<std::mutex> lock(ls.mtx);
+        if (period.count() == 0) {
+            ls.timers.add(id, due, std::move(fn));
+        } else {
+            ls.periodic.insert(id);
+            armPeriodicLocked(lane, ls, id, due, period, std::make_shared<Task>(std::move(fn)));
+        }
+    }
+    // 唤醒一个 worker 重新计算等待时间
+    ls.not_empty.notify_one();
+    return id;
+}
+
+void Executor::armPeriodicLocked(Lane lane, LaneState& ls, TaskId id, Clock::time_point due,
+                                 milliseconds period, std::shared_ptr<Task> fn) {
+    // 周期任务：执行完成后再按 period 重新挂上时间轮，慢任务不会堆积
+    ls.timers.add(id, due, [this, lane, id, period, fn] {
+        (*fn)();
+        LaneState& st = state(lane);
+        {
+            std::lock_guard<std::mutex> lock(st.mtx);
+            if (!st.periodic.count(id) || !running_.load()) return;
+            armPeriodicLocked(lane, st, id, Clock::now() + period, period, fn);
+        }
+        st.not_empty.notify_one();
+    });
+}
+
+bool Executor::cancel(TaskId id) {
+    if (id == 0) return false;
+    Lane lane = lane_of(id);
+    if (lane >= Lane::Count) return false;
+    LaneState& ls = state(lane);
+    std::lock_guard<std::mutex> lock(ls.mtx);
+    bool was_periodic = ls.periodic.erase(id) > 0;
+    return ls.timers.cancel(id) || was_periodic;
+}
+
+bool Executor::reschedule(TaskId id, milliseconds delay) {
+    if (id == 0) return false;
+    Lane lane = lane_of(id);
+    if (lane >= Lane::Count) return false;
+    if (delay.count() < 0) delay = milliseconds(0);
+    LaneState& ls = state(lane);
+    {
+        std::lock_guard<std::mutex> lock(ls.mtx);
+        if (!ls.timers.reschedule(id, Clock::now() + delay)) return false;
+    }
+    ls.not_empty.notify_one();
+    return true;
+}
+
+Executor::Clock::time_point Executor::promoteDueLocked(LaneState& ls, Clock::time_point now) {
+    ls.timers.advance(now, ls.expired);
+    for (auto& e : ls.expired) {
+        ls.ready.push_back(Item{std::move(e.second), now, nullptr, true});
+    }
+    if (!ls.expired.empty() && ls.ready.size() > ls.stats.queue_depth_max) {
+        ls.stats.queue_depth_max = ls.ready.size();
+    }
+    ls.expired.clear();
+    return ls.timers.nextDeadline();
+}
+
+void Executor::workerLoop(Lane lane, int index) {
+    LaneState& ls = state(lane);
+
+    char name[16]{0};
+    std::snprintf(name, sizeof(name), "ktv-%.7s-%d", ls.cfg.name, index);
+    pthread_setname_np(pthread_self(), name);
+    if (ls.cfg.nice != 0) {
+        // Linux 下 nice 值按线程生效
+        setpriority(PRIO_PROCESS, static_cast<id_t>(::syscall(SYS_gettid)), ls.cfg.nice);
+    }
+
+    std::unique_lock<std::mutex> lock(ls.mtx);
+    while (running_.load()) {
+        Clock::time_point next_due = promoteDueLocked(ls, Clock::now());
+        if (ls.ready.empty()) {
+            if (next_due == Clock::time_point::max()) {
+                ls.not_empty.wait(lock);
+            } else {
+                ls.not_empty.wait_until(lock, next_due);
+            }
+            continue;
+        }
+
+        Item item = std::move(ls.ready.front());
+        ls.ready.pop_front();
+        ls.not_full.notify_one();
+        lock.unlock();
+
+        Clock::time_point begin = Clock::now();
+        try {
+            item.fn();
+        } catch (const std::exception& e) {
+            syslog(LOG_ERR, "[ktv][executor] lane=%s task failed: %s", ls.cfg.name, e.what());
+        } catch (...) {
+            syslog(LOG_ERR, "[ktv][executor] lane=%s task failed: unknown exception", ls.cfg.name);
+        }
+        Clock::time_point end = Clock::now();
+        item.fn = nullptr;   // 在锁外释放捕获的资源
+
+        lock.lock();
+        uint64_t wait_us = us_between(item.enqueued, begin);
+        uint64_t run_us = us_between(begin, end);
+        ++ls.stats.executed;
+        ls.wait_us_sum += wait_us;
+        ls.run_us_sum += run_us;
+        if (wait_us > ls.stats.wait_us_max) ls.stats.wait_us_max = wait_us;
+        if (run_us > ls.stats.run_us_max) ls.stats.run_us_max = run_us;
+    }
+}
+
+LaneStats Executor::stats(Lane lane, bool reset) {
+    LaneState& ls = state(lane);
+    std::lock_guard<std::mutex> lock(ls.mtx);
+    LaneStats out = ls.stats;
+    out.queue_depth = ls.ready.size();
+    out.delayed_pending = ls.timers.size();
+    if (out.executed > 0) {
+        out.wait_us_avg = ls.wait_us_sum / out.executed;
+        out.run_us_avg = ls.run_us_sum / out.executed;
+    }
+    if (reset) {
+        ls.stats = LaneStats{};
+        ls.stats.queue_depth_max = ls.ready.size();
+        ls.wait_us_sum = 0;
+        ls.run_us_sum = 0;
+    }
+    return out;
+}
+
+void Executor::logStats() {
+    for (size_t i = 0; i < kLaneCount; ++i) {
+        Lane lane = static_cast<Lane>(i);
+        LaneStats st = stats(lane, true);
+        syslog(LOG_INFO,
+               "[ktv][executor][stats] lane=%s submitted=%llu executed=%llu rejected=%llu dropped=%llu "
+               "depth=%zu depth_max=%zu delayed=%zu wait_us_avg=%llu wait_us_max=%llu run_us_avg=%llu run_us_max=%llu",
+               laneName(lane),
+               static_cast<unsigned long long>(st.submitted), static_cast<unsigned long long>(st.executed),
+               static_cast<unsigned long long>(st.rejected), static_cast<unsigned long long>(st.dropped),
+               st.queue_depth, st.queue_depth_max, st.delayed_pending,
+               static_cast<unsigned long long>(st.wait_us_avg), static_cast<unsigned long long>(st.wait_us_max),
+               static_cast<unsigned long long>(st.run_us_avg), static_cast<unsigned long long>(st.run_us_max));
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SerialQueue
+// ---------------------------------------------------------------------------
+
+SerialQueue::SerialQueue(Lane lane, size_t capacity)
+    : lane_(lane), capacity_(capacity) {
+}
+
+SerialQueue::~SerialQueue() {
+    shutdown();
+}
+
+bool SerialQueue::post(Executor::Task fn) {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (closed_ || !fn) return false;
+        if (tasks_.size() >= capacity_) {
+            syslog(LOG_WARNING, "[ktv][executor] serial queue full, lane=%s depth=%zu",
+                   Executor::laneName(lane_), tasks_.size());
+            return false;
+        }
+        tasks_.push_back(std::move(fn));
+        if (scheduled_) return true;
+        scheduled_ = true;
+    }
+    if (!schedule()) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        scheduled_ = false;
+        tasks_.clear();
+        idle_cv_.notify_all();
+        return false;
+    }
+    return true;
+}
+
+bool SerialQueue::schedule() {
+    // 续排标记为内部任务：DropOldest 不会丢掉它，否则 scheduled_ 永远为 true，队列停摆
+    return Executor::instance().enqueue(lane_, Executor::Item{[this] { runOne(); }, Executor::Clock::now(), nullptr, true});
+}
+
+void SerialQueue::runOne() {
+    Executor::Task fn;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (tasks_.empty()) {
+            scheduled_ = false;
+            idle_cv_.notify_all();
+            return;
+        }
+        fn = std::move(tasks_.front());
+        tasks_.pop_front();
+    }
+
+    try {
+        fn();
+    } catch (const std::exception& e) {
+        syslog(LOG_ERR, "[ktv][executor] serial task failed: %s", e.what());
+    } catch (...) {
+        syslog(LOG_ERR, "[ktv][executor] serial task failed: unknown exception");
+    }
+    fn = nullptr;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (tasks_.empty()) {
+            scheduled_ = false;
+            idle_cv_.notify_all();
+            return;
+        }
+    }
+    // 每次只执行一个任务后重新排队，让同一 Lane 上的其他任务有机会执行
+    if (!schedule()) {
+        std::lock_guard<std::mutex> lock(mtx_);
+        scheduled_ = false;
+        tasks_.clear();
+        idle_cv_.notify_all();
+    }
+}
+
+void SerialQueue::shutdown() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    closed_ = true;
+    tasks_.clear();
+    // 注意：不能在本队列的任务内调用，否则等待自身
+    if (!idle_cv_.wait_for(lock, std::chrono::seconds(5), [this] { return !scheduled_; })) {
+        syslog(LOG_ERR, "[ktv][executor] serial queue shutdown timeout, lane=%s", Executor::laneName(lane_));
+    }
+}
+
+void SerialQueue::reopen() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    closed_ = false;
+}
+
+size_t SerialQueue::pending() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return tasks_.size();
+}
+
+// ---------------------------------------------------------------------------
+// Debouncer
+// ---------------------------------------------------------------------------
+
+Debouncer::Debouncer(Lane lane, milliseconds delay)
+    : lane_(lane), delay_(delay) {
+}
+
+Debouncer::~Debouncer() {
+    cancel();
+}
+
+void Debouncer::trigger(Executor::Task fn) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    pending_ = std::move(fn);
+    if (timer_ != 0 && Executor::instance().reschedule(timer_, delay_)) {
+        return;
+    }
+    // 定时器已到期（可能已在就绪队列里）：换一代，旧的一次执行时直接忽略
+    uint64_t gen = ++generation_;
+    timer_ = Executor::instance().schedule(lane_, delay_, [this, gen] { fire(gen); });
+}
+
+void Debouncer::cancel() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (timer_ != 0) {
+        Executor::instance().cancel(timer_);
+        timer_ = 0;
+    }
+    ++generation_;
+    pending_ = nullptr;
+}
+
+void Debouncer::fire(uint64_t generation) {
+    Executor::Task fn;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (generation != generation_) return;
+        fn = std::move(pending_);
+        pending_ = nullptr;
+        timer_ = 0;
+    }
+    if (fn) fn();
+}
+
+}  // namespace ktv::core
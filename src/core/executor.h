@@ -0,0 +1,242 @@
+/**
+ * @file executor.h
+ * @brief 进程内共享线程池（按 Lane 划分，Tina / F133 单核 SoC）
+ *
+ * 核心原则：
+ * - 线程数固定、可预期：每个 Lane 固定 N 个线程，start() 时一次性创建
+ * - Lane 即优先级：不同 Lane 线程使用不同 nice 值，播放器命令不被下载/上传拖慢
+ * - 有界队列 + 拒绝策略：队列满时按 Lane 配置拒绝/丢弃最旧/调用方执行/限时阻塞；
+ *   到期的延时/周期任务与 SerialQueue 的续排属于内部任务，不会被 DropOldest 丢弃
+ * - 延时/周期任务挂在每个 Lane 的分层时间轮上（可取消、可改期），
+ *   worker 只睡到最近的到期时间，空闲时不产生任何定时唤醒
+ * - 每个 Lane 统计排队时延、执行耗时、队列深度
+ *
+ * 默认 Lane（共 5 个线程）：
+ * - Player     1 线程，nice -5，tplayer 命令（串行，保证顺序）
+ * - Audio      1 线程，nice -2，实时音高分析/打分（周期 20 ms，任务必须短）
+ * - Download   1 线程，nice  5，m3u8/ts 下载
+ * - Background 1 线程，nice 10，搜索/图片解码/日志排空等低优先级短任务
+ * - Upload     1 线程，nice 15，日志上传等可能阻塞数秒的批量网络任务（与 Background 隔离）
+ *
+ * 使用方式：
+ * 1. App 启动时调用 Executor::instance().start()
+ * 2. 各服务通过 post()/schedule() 投递任务，不再自建 std::thread
+ * 3. 需要严格串行的任务流使用 SerialQueue，防抖使用 Debouncer
+ * 4. App 退出时先停止各服务，再调用 Executor::instance().stop()
+ */
+
+#ifndef KTVLV_CORE_EXECUTOR_H
+#define KTVLV_CORE_EXECUTOR_H
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <unordered_set>
+#include <vector>
+#include "timer_wheel.h"
+
+namespace ktv::core {
+
+enum class Lane {
+    Player = 0,
+    Audio,
+    Download,
+    Background,
+    Upload,
+    Count,
+};
+
+// 队列满时的处理方式
+enum class RejectPolicy {
+    Reject,       // 直接拒绝，post() 返回 false
+    DropOldest,   // 丢弃队首最旧任务，新任务入队
+    CallerRuns,   // 在调用方线程直接执行
+    Block,        // 阻塞等待空位，超时后拒绝
+};
+
+struct LaneConfig {
+    const char* name = "";
+    int threads = 1;
+    size_t capacity = 64;
+    RejectPolicy policy = RejectPolicy::Reject;
+    int nice = 0;
+    int block_timeout_ms = 100;   // 仅 Block 策略使用
+};
+
+// Lane 统计快照（时间单位：微秒）
+struct LaneStats {
+    uint64_t submitted = 0;
+    uint64_t executed = 0;
+    uint64_t rejected = 0;
+    uint64_t dropped = 0;
+    size_t queue_depth = 0;
+    size_t queue_depth_max = 0;
+    size_t delayed_pending = 0;
+    uint64_t wait_us_avg = 0;     // 入队 → 开始执行
+    uint64_t wait_us_max = 0;
+    uint64_t run_us_avg = 0;
+    uint64_t run_us_max = 0;
+};
+
+using TaskId = uint64_t;   // 0 表示无效
+
+class Executor {
+public:
+    using Task = std::function<void()>;
+    using Clock = std::chrono::steady_clock;
+
+    static Executor& instance() {
+        static Executor inst;
+        return inst;
+    }
+
+    Executor(const Executor&) = delete;
+    Executor& operator=(const Executor&) = delete;
+
+    // 需在 start() 之前调用，否则忽略
+    void configure(Lane lane, const LaneConfig& cfg);
+
+    void start();
+    // 停止所有 Lane：正在执行的任务跑完，排队/延时任务丢弃
+    void stop();
+    bool isRunning() const { return running_.load(); }
+
+    /**
+     * 投递任务（start() 之前投递的任务会在启动后执行）
+     * @param on_drop 可选：任务入队后被 DropOldest 挤掉时调用（在投递新任务的线程上，锁外），
+     *                用于清理"已投递"标记等状态
+     * @return false 被拒绝（队列满且策略为 Reject/Block 超时，或已 stop）
+     */
+    bool post(Lane lane, Task fn, Task on_drop = nullptr);
+
+    // 延时任务：到期后进入 Lane 就绪队列（不受容量限制）
+    TaskId schedule(Lane lane, std::chrono::milliseconds delay, Task fn);
+
+    // 周期任务：每次执行完成后按 period 重新计时（不会堆积）
+    TaskId schedulePeriodic(Lane lane, std::chrono::milliseconds period, Task fn,
+                            std::chrono::milliseconds initial_delay = std::chrono::milliseconds(-1));
+
+    // 取消延时/周期任务；已开始执行的一次不受影响
+    bool cancel(TaskId id);
+
+    // 改期：从现在起 delay 后到期（退避调整 / TTL 续期）；任务已到期或已取消时返回 false
+    bool reschedule(TaskId id, std::chrono::milliseconds delay);
+
+    LaneStats stats(Lane lane, bool reset = false);
+    void logStats();
+
+    static const char* laneName(Lane lane);
+    size_t threadCount() const;
+
+private:
+    Executor();
+    ~Executor();
+
+    struct Item {
+        Task fn;
+        Clock::time_point enqueued;
+        Task on_drop;
+        bool internal = false;    // 定时到期 / 串行队列续排：不参与 DropOldest
+    };
+
+    struct LaneState {
+        LaneConfig cfg;
+        std::mutex mtx;
+        std::condition_variable not_empty;
+        std::condition_variable not_full;
+        std::deque<Item> ready;
+        TimerWheel timers;
+        std::unordered_set<TaskId> periodic;   // 尚未取消的周期任务（执行期间不在时间轮上）
+        std::vector<std::pair<TaskId, Task>> expired;   // advance() 输出缓冲，复用避免分配
+        std::vector<std::thread> workers;
+        LaneStats stats;
+        uint64_t wait_us_sum = 0;
+        uint64_t run_us_sum = 0;
+    };
+
+    friend class SerialQueue;
+
+    LaneState& state(Lane lane) { return *lanes_[static_cast<size_t>(lane)]; }
+    bool enqueue(Lane lane, Item item);
+    void workerLoop(Lane lane, int index);
+    TaskId scheduleTimed(Lane lane, Clock::time_point due, std::chrono::milliseconds period, Task fn);
+    void armPeriodicLocked(Lane lane, LaneState& ls, TaskId id, Clock::time_point due,
+                           std::chrono::milliseconds period, std::shared_ptr<Task> fn);
+    // 将到期的延时任务移入就绪队列，返回下一个到期时间（无则 max）
+    Clock::time_point promoteDueLocked(LaneState& ls, Clock::time_point now);
+
+    std::unique_ptr<LaneState> lanes_[static_cast<size_t>(Lane::Count)];
+    std::atomic<bool> running_{false};
+    std::atomic<bool> stopped_{false};
+    std::atomic<TaskId> next_id_{1};
+};
+
+/**
+ * @brief 串行任务队列：在共享 Lane 上保证任务按投递顺序逐个执行
+ *
+ * 同一时刻最多只有一个任务占用 Lane 线程，适合有状态的服务（替代私有线程）。
+ * 析构前必须调用 shutdown()，确保没有任务仍引用 this。
+ */
+class SerialQueue {
+public:
+    explicit SerialQueue(Lane lane, size_t capacity = 256);
+    ~SerialQueue();
+    SerialQueue(const SerialQueue&) = delete;
+    SerialQueue& operator=(const SerialQueue&) = delete;
+
+    bool post(Executor::Task fn);
+    // 丢弃未执行的任务，等待正在执行的任务结束；之后 post() 一律拒绝
+    void shutdown();
+    // 重新接受任务（shutdown 之后）
+    void reopen();
+    size_t pending() const;
+
+private:
+    void runOne();
+    bool schedule();
+
+    Lane lane_;
+    size_t capacity_;
+    mutable std::mutex mtx_;
+    std::condition_variable idle_cv_;
+    std::deque<Executor::Task> tasks_;
+    bool scheduled_{false};
+    bool closed_{false};
+};
+
+/**
+ * @brief 防抖：连续 trigger() 只在静默 delay 之后执行最后一次提交的任务
+ *
+ * 复用同一个时间轮定时器改期，不会为每次触发创建新任务。
+ * 生命周期需覆盖到 Executor::stop()（服务单例即可）。
+ */
+class Debouncer {
+public:
+    Debouncer(Lane lane, std::chrono::milliseconds delay);
+    ~Debouncer();
+    Debouncer(const Debouncer&) = delete;
+    Debouncer& operator=(const Debouncer&) = delete;
+
+    void trigger(Executor::Task fn);
+    void cancel();
+
+private:
+    void fire(uint64_t generation);
+
+    Lane lane_;
+    std::chrono::milliseconds delay_;
+    std::mutex mtx_;
+    Executor::Task pending_;
+    TaskId timer_{0};
+    uint64_t generation_{0};
+};
+
+}  // namespace ktv::core
+
+#endif  // KTVLV_CORE_EXECUTOR_H
@@ -0,0 +1,201 @@
+#include "log_filter.h"
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <ctime>
+
+namespace ktv::core {
+
+namespace {
+
+constexpr uint64_t kReportPeriodUs = 1000000;
+
+uint64_t now_us() {
+    timespec ts;
+    // 限频只需毫秒级精度：COARSE 时钟走 vDSO，不进内核
+    clock_gettime(CLOCK_MONOTONIC_COARSE, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+}
+
+const char* base_name(const char* path) {
+    const char* slash = std::strrchr(path, '/');
+    return slash ? slash + 1 : path;
+}
+
+}  // namespace
+
+LogFilter& LogFilter::instance() {
+    static LogFilter filter;
+    return filter;
+}
+
+LogFilter::Entry* LogFilter::find(const char* component, size_t len) {
+    if (len >= kNameBytes) len = kNameBytes - 1;
+    for (size_t i = 0; i < count_; ++i) {
+        if (std::strncmp(entries_[i].name, component, len) == 0 && entries_[i].name[len] == '\0') {
+            return &entries_[i];
+        }
+    }
+    return nullptr;
+}
+
+LogFilter::Entry* LogFilter::findOrAdd(const char* component, size_t len) {
+    if (Entry* e = find(component, len)) return e;
+    if (count_ >= kMaxComponents) return nullptr;
+    Entry& e = entries_[count_++];
+    len = std::min(len, kNameBytes - 1);
+    std::memcpy(e.name, component, len);
+    e.name[len] = '\0';
+    e.level.store(default_level_.load(std::memory_order_relaxed), std::memory_order_relaxed);
+    return &e;
+}
+
+std::atomic<int>* LogFilter::slot(const char* component, size_t len) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Entry* e = len > 0 ? findOrAdd(component, len) : nullptr;
+    return e ? &e->level : &default_level_;
+}
+
+void LogFilter::setDefaultLevel(int level) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    default_level_.store(level, std::memory_order_relaxed);
+    for (size_t i = 0; i < count_; ++i) {
+        if (!entries_[i].pinned) entries_[i].level.store(level, std::memory_order_relaxed);
+    }
+}
+
+void LogFilter::setLevel(const char* component, int level) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Entry* e = findOrAdd(component, std::strlen(component));
+    if (!e) return;
+    e->pinned = true;
+    e->level.store(level, std::memory_order_relaxed);
+}
+
+int LogFilter::level(const char* component) const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    Entry* e = const_cast<LogFilter*>(this)->find(component, std::strlen(component));
+    return (e ? e->level : default_level_).load(std::memory_order_relaxed);
+}
+
+bool LogFilter::applyOverrides(const char* spec) {
+    bool ok = true;
+    const char* p = spec ? spec : "";
+    while (*p) {
+        const char* end = std::strchr(p, ',');
+        if (!end) end = p + std::strlen(p);
+        const char* colon = static_cast<const char*>(std::memchr(p, ':', static_cast<size_t>(end - p)));
+        if (colon) {
+            char name[kNameBytes]{};
+            char lvl[16]{};
+            const char* n0 = p;
+            const char* n1 = colon;
+            while (n0 < n1 && std::isspace(static_cast<unsigned char>(*n0))) ++n0;
+            while (n1 > n0 && std::isspace(static_cast<unsigned char>(n1[-1]))) --n1;
+            std::memcpy(name, n0, std::min(static_cast<size_t>(n1 - n0), sizeof(name) - 1));
+            std::memcpy(lvl, colon + 1, std::min(static_cast<size_t>(end - colon - 1), sizeof(lvl) - 1));
+            const int level = levelFromName(lvl, -1);
+            if (name[0] && level >= 0) {
+                setLevel(name, level);
+            } else {
+                ok = false;
+            }
+        } else if (end > p) {
+            ok = false;
+        }
+        p = *end ? end + 1 : end;
+    }
+    return ok;
+}
+
+void LogFilter::setRateLimit(uint32_t per_sec, uint32_t burst) {
+    const uint64_t interval = per_sec > 0 ? 1000000ULL / per_sec : 0;
+    interval_us_.store(interval, std::memory_order_relaxed);
+    tolerance_us_.store(interval * std::max<uint32_t>(burst, 1), std::memory_order_relaxed);
+}
+
+int LogFilter::levelFromName(const char* name, int fallback) {
+    if (!name) return fallback;
+    while (std::isspace(static_cast<unsigned char>(*name))) ++name;
+    char buf[16]{};
+    for (size_t i = 0; i + 1 < sizeof(buf) && name[i] && !std::isspace(static_cast<unsigned char>(name[i])); ++i) {
+        buf[i] = static_cast<char>(std::tolower(static_cast<unsigned char>(name[i])));
+    }
+    static const struct {
+        const char* name;
+        int level;
+    } kNames[] = {
+        {"emerg", LOG_EMERG}, {"alert", LOG_ALERT}, {"crit", LOG_CRIT},   {"err", LOG_ERR},
+        {"error", LOG_ERR},   {"warn", LOG_WARNING}, {"warning", LOG_WARNING}, {"notice", LOG_NOTICE},
+        {"info", LOG_INFO},   {"debug", LOG_DEBUG},
+    };
+    for (const auto& n : kNames) {
+        if (std::strcmp(buf, n.name) == 0) return n.level;
+    }
+    if (buf[0] >= '0' && buf[0] <= '7' && buf[1] == '\0') return buf[0] - '0';
+    return fallback;
+}
+
+void LogFilter::link(LogSite* site) {
+    LogSite* head = sites_.load(std::memory_order_relaxed);
+    do {
+        site->next_ = head;
+    } while (!sites_.compare_exchange_weak(head, site, std::memory_order_release, std::memory_order_relaxed));
+}
+
+void LogFilter::reportSuppressed() {
+    const uint64_t now = now_us();
+    uint64_t last = last_report_us_.load(std::memory_order_relaxed);
+    if (now - last < kReportPeriodUs) return;
+    if (!last_report_us_.compare_exchange_strong(last, now, std::memory_order_relaxed)) return;
+
+    for (LogSite* s = sites_.load(std::memory_order_acquire); s; s = s->next_) {
+        if (s->suppressed_.load(std::memory_order_relaxed) == 0) continue;
+        const uint32_t n = s->suppressed_.exchange(0, std::memory_order_relaxed);
+        if (n > 0) s->report(s->suppressed_level_.load(std::memory_order_relaxed), n);
+    }
+}
+
+LogSite::LogSite(const char* fmt, const char* file, int line) : file_(base_name(file)), line_(line) {
+    // 组件名：格式串 "[ktv][<component>]..." 的第二段
+    const char* name = "";
+    size_t len = 0;
+    if (fmt && std::strncmp(fmt, "[ktv][", 6) == 0) {
+        name = fmt + 6;
+        const char* close = std::strchr(name, ']');
+        len = close ? static_cast<size_t>(close - name) : 0;
+    }
+    LogFilter& filter = LogFilter::instance();
+    slot_ = filter.slot(name, len);
+    filter.link(this);
+}
+
+bool LogSite::admit(int level, uint32_t& suppressed) {
+    LogFilter& filter = LogFilter::instance();
+    const uint64_t interval = filter.interval_us_.load(std::memory_order_relaxed);
+    if (interval == 0) {
+        suppressed = suppressed_.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+    const uint64_t tolerance = filter.tolerance_us_.load(std::memory_order_relaxed);
+    const uint64_t now = now_us();
+    uint64_t tat = tat_us_.load(std::memory_order_relaxed);
+    for (;;) {
+        const uint64_t next = std::max(tat, now) + interval;
+        if (next - now > tolerance) {
+            suppressed_level_.store(level, std::memory_order_relaxed);
+            suppressed_.fetch_add(1, std::memory_order_relaxed);
+            filter.suppressed_total_.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        if (tat_us_.compare_exchange_weak(tat, next, std::memory_order_relaxed)) break;
+    }
+    suppressed = suppressed_.load(std::memory_order_relaxed) ? suppressed_.exchange(0, std::memory_order_relaxed) : 0;
+    return true;
+}
+
+void LogSite::report(int level, uint32_t suppressed) const {
+    LogRing::instance().write(level, "[ktv][log][ratelimit] site=%s:%d suppressed=%u", file_, line_, suppressed);
+}
+
+}  // namespace ktv::core
@@ -0,0 +1,130 @@
+/**
+ * @file log_filter.h
+ * @brief 日志过滤：按组件的运行时级别 + 按调用点的令牌桶限频
+ *
+ * - 组件名取自格式串前缀 "[ktv][<component>]"，每个组件一个级别槽位（原子 int），
+ *   调用点首次执行时登记并缓存槽位指针，之后每次只是一次 relaxed load
+ * - 每个调用点一个令牌桶（GCRA：单个原子"理论到达时间"），超出的记录直接丢弃并计数；
+ *   下一条放行的记录前补一条 "[ktv][log][ratelimit] site=file:line suppressed=N"，
+ *   一直静默的调用点由 LogRing 排空时每秒汇总一次
+ * - 编译期下限见 utils/log_macros.h 的 KTV_LOG_MIN_LEVEL
+ *
+ * 线程：全部接口任意线程；登记/配置走互斥锁，热路径无锁。
+ */
+
+#ifndef KTVLV_CORE_LOG_FILTER_H
+#define KTVLV_CORE_LOG_FILTER_H
+
+#include <syslog.h>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include "log_ring.h"
+
+namespace ktv::core {
+
+class LogSite;
+
+class LogFilter {
+public:
+    static constexpr size_t kMaxComponents = 32;
+    static constexpr size_t kNameBytes = 16;
+
+    static LogFilter& instance();
+
+    LogFilter(const LogFilter&) = delete;
+    LogFilter& operator=(const LogFilter&) = delete;
+
+    // 组件的级别槽位（同名共享，首次调用时登记）；表满时返回默认槽位
+    std::atomic<int>* slot(const char* component, size_t len);
+
+    // 默认级别：作用于所有未单独设置过的组件
+    void setDefaultLevel(int level);
+    // 单独设置某组件的级别（组件尚未出现时先登记）
+    void setLevel(const char* component, int level);
+    int level(const char* component) const;
+
+    // 逗号分隔的 "component:level" 列表，如 "download:warn,player:debug"；返回是否全部解析成功
+    bool applyOverrides(const char* spec);
+
+    // 每个调用点每秒允许的条数与突发上限；per_sec 为 0 表示不限频
+    void setRateLimit(uint32_t per_sec, uint32_t burst);
+
+    // "debug"/"info"/"notice"/"warn"/"err"… → syslog 优先级，无法识别时返回 fallback
+    static int levelFromName(const char* name, int fallback);
+
+    // 汇总所有有未报告丢弃计数的调用点（LogRing 排空时调用，内部限制为每秒一次）
+    void reportSuppressed();
+
+    uint64_t suppressedTotal() const { return suppressed_total_.load(std::memory_order_relaxed); }
+
+private:
+    friend class LogSite;
+
+    struct Entry {
+        char name[kNameBytes]{};
+        std::atomic<int> level{LOG_INFO};
+        bool pinned = false;                 // 单独设置过，不跟随默认级别
+    };
+
+    LogFilter() = default;
+
+    Entry* find(const char* component, size_t len);
+    Entry* findOrAdd(const char* component, size_t len);
+    void link(LogSite* site);
+
+    mutable std::mutex mtx_;
+    Entry entries_[kMaxComponents];
+    size_t count_ = 0;
+    std::atomic<int> default_level_{LOG_INFO};
+
+    // GCRA 参数：两条之间的最小间隔与允许提前量（微秒），interval 为 0 表示不限频
+    std::atomic<uint64_t> interval_us_{50000};
+    std::atomic<uint64_t> tolerance_us_{50000 * 50};
+
+    std::atomic<LogSite*> sites_{nullptr};   // 所有调用点（只增不删）
+    std::atomic<uint64_t> suppressed_total_{0};
+    std::atomic<uint64_t> last_report_us_{0};
+};
+
+/**
+ * 一个日志调用点（KTV_SYSLOG 展开为函数内 static 对象）
+ */
+class LogSite {
+public:
+    LogSite(const char* fmt, const char* file, int line);
+
+    LogSite(const LogSite&) = delete;
+    LogSite& operator=(const LogSite&) = delete;
+
+    bool enabled(int level) const { return level <= slot_->load(std::memory_order_relaxed); }
+
+    // 调用方已检查 enabled()
+    template <typename... Args>
+    void log(int level, const char* fmt, const Args&... args) {
+        uint32_t suppressed = 0;
+        if (!admit(level, suppressed)) return;
+        if (suppressed > 0) report(level, suppressed);
+        LogRing::instance().write(level, fmt, args...);
+    }
+
+private:
+    friend class LogFilter;
+
+    // 令牌桶放行返回 true，suppressed 带回此前未报告的丢弃条数
+    bool admit(int level, uint32_t& suppressed);
+    void report(int level, uint32_t suppressed) const;
+
+    std::atomic<int>* slot_;
+    const char* file_;
+    int line_;
+    std::atomic<uint64_t> tat_us_{0};        // 理论到达时间
+    std::atomic<uint32_t> suppressed_{0};
+    std::atomic<int> suppressed_level_{LOG_INFO};
+    LogSite* next_ = nullptr;
+};
+
+}  // namespace ktv::core
+
+#endif  // KTVLV_CORE_LOG_FILTER_H
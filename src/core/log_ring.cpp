@@ -0,0 +1,336 @@
+#include "log_ring.h"
+#include "log_filter.h"
+#include <syslog.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace ktv::core {
+
+namespace {
+
+constexpr size_t kLineBytes = 512;
+constexpr size_t kTsBytes = 32;     // 排空行尾 " ts=<秒>.<微秒>" 预留
+
+const char* level_name(int level) {
+    switch (level) {
+        case LOG_EMERG: return "emerg";
+        case LOG_ALERT: return "alert";
+        case LOG_CRIT: return "crit";
+        case LOG_ERR: return "err";
+        case LOG_WARNING: return "warn";
+        case LOG_NOTICE: return "notice";
+        case LOG_INFO: return "info";
+        default: return "debug";
+    }
+}
+
+int64_t as_int(LogRing::ArgType type, uint64_t raw) {
+    if (type == LogRing::ArgType::F64) {
+        double d;
+        std::memcpy(&d, &raw, sizeof(d));
+        return static_cast<int64_t>(d);
+    }
+    return static_cast<int64_t>(raw);
+}
+
+double as_double(LogRing::ArgType type, uint64_t raw) {
+    switch (type) {
+        case LogRing::ArgType::F64: {
+            double d;
+            std::memcpy(&d, &raw, sizeof(d));
+            return d;
+        }
+        case LogRing::ArgType::I64: return static_cast<double>(static_cast<int64_t>(raw));
+        default: return static_cast<double>(raw);
+    }
+}
+
+}  // namespace
+
+LogRing& LogRing::instance() {
+    static LogRing ring;
+    return ring;
+}
+
+void LogRing::start() {
+    if (timer_.load() != 0) return;
+    TaskId id = Executor::instance().schedulePeriodic(Lane::Background, kDrainPeriod, [this] { drain(); });
+    TaskId expected = 0;
+    if (!timer_.compare_exchange_strong(expected, id)) Executor::instance().cancel(id);
+}
+
+void LogRing::stop() {
+    Executor::instance().cancel(timer_.exchange(0));
+    drain();
+}
+
+void LogRing::putString(Record& r, size_t i, const char* s) {
+    if (!s) {
+        r.types[i] = ArgType::Ptr;
+        r.args[i] = 0;
+        return;
+    }
+    const size_t off = r.str_used;
+    const size_t room = kStringBytes - off;   // 总留 1 字节给结尾 '\0'
+    const size_t len = room > 1 ? strnlen(s, room - 1) : 0;
+    if (len > 0) std::memcpy(r.strings + off, s, len);
+    if (room > 0) r.strings[off + len] = '\0';
+    const uint64_t truncated = s[len] != '\0' ? 1 : 0;
+    r.types[i] = ArgType::Str;
+    r.args[i] = (truncated << 16) | (static_cast<uint64_t>(std::min(off, kStringBytes - 1)) << 8) | len;
+    r.str_used = static_cast<uint8_t>(std::min(kStringBytes, off + len + 1));
+}
+
+bool LogRing::read(uint64_t idx, Record& out) const {
+    const Slot& slot = slots_[idx & (kCapacity - 1)];
+    const uint64_t seq = slot.seq.load(std::memory_order_acquire);
+    if (seq != idx * 2 + 2) return false;
+    std::memcpy(&out, &slot.rec, sizeof(Record));
+    std::atomic_thread_fence(std::memory_order_acquire);
+    return slot.seq.load(std::memory_order_relaxed) == seq;
+}
+
+size_t LogRing::format(const Record& r, char* out, size_t cap) {
+    if (cap == 0) return 0;
+    size_t n = 0;
+    auto emit = [&](const char* s, size_t len) {
+        len = std::min(len, cap - 1 - n);
+        std::memcpy(out + n, s, len);
+        n += len;
+    };
+    auto emitf = [&](const char* spec, auto value) {
+        int w = std::snprintf(out + n, cap - n, spec, value);
+        if (w > 0) n += std::min(static_cast<size_t>(w), cap - 1 - n);
+    };
+
+    size_t ai = 0;
+    const char* p = r.fmt ? r.fmt : "";
+    while (*p && n + 1 < cap) {
+        const char* pct = std::strchr(p, '%');
+        if (!pct) {
+            emit(p, std::strlen(p));
+            break;
+        }
+        emit(p, static_cast<size_t>(pct - p));
+        p = pct + 1;
+        if (*p == '%') {
+            emit("%", 1);
+            ++p;
+            continue;
+        }
+
+        // %[flags][width][.precision][length]conv，长度修饰统一换成记录里的 64 位类型
+        char spec[32] = "%";
+        size_t sl = 1;
+        auto add = [&](const char* s) {
+            while (*s && sl + 4 < sizeof(spec)) spec[sl++] = *s++;
+            spec[sl] = '\0';
+        };
+        auto add_star = [&] {
+            char num[16];
+            int v = ai < r.nargs ? static_cast<int>(as_int(r.types[ai], r.args[ai])) : 0;
+            ++ai;
+            std::snprintf(num, sizeof(num), "%d", v);
+            add(num);
+        };
+        while (*p && std::strchr("-+ #0'", *p)) {
+            const char f[2] = {*p++, '\0'};
+            add(f);
+        }
+        if (*p == '*') {
+            add_star();
+            ++p;
+        }
+        while (*p >= '0' && *p <= '9') {
+            const char f[2] = {*p++, '\0'};
+            add(f);
+        }
+        if (*p == '.') {
+            add(".");
+            ++p;
+            if (*p == '*') {
+                add_star();
+                ++p;
+            }
+            while (*p >= '0' && *p <= '9') {
+                const char f[2] = {*p++, '\0'};
+                add(f);
+            }
+        }
+        while (*p && std::strchr("hlLqjzt", *p)) ++p;
+        const char conv = *p;
+        if (!conv) break;
+        ++p;
+
+        if (ai >= r.nargs) {
+            emit("?", 1);
+            continue;
+        }
+        const ArgType type = r.types[ai];
+        const uint64_t raw = r.args[ai++];
+        switch (conv) {
+            case 'd':
+            case 'i':
+                add("lld");
+                emitf(spec, static_cast<long long>(as_int(type, raw)));
+                break;
+            case 'u':
+            case 'o':
+            case 'x':
+            case 'X': {
+                const char c[4] = {'l', 'l', conv, '\0'};
+                add(c);
+                emitf(spec, static_cast<unsigned long long>(as_int(type, raw)));
+                break;
+            }
+            case 'f':
+            case 'F':
+            case 'e':
+            case 'E':
+            case 'g':
+            case 'G':
+            case 'a':
+            case 'A': {
+                const char c[2] = {conv, '\0'};
+                add(c);
+                emitf(spec, as_double(type, raw));
+                break;
+            }
+            case 'c':
+                add("c");
+                emitf(spec, static_cast<int>(as_int(type, raw)));
+                break;
+            case 's': {
+                add("s");
+                const char* s = "?";
+                char cut[kStringBytes + 4];
+                if (type == ArgType::Str) {
+                    s = r.strings + ((raw >> 8) & 0xFF);
+                    if (raw >> 16) {
+                        // 写入时被截断：标出来，避免把半截 URL/路径当成完整值
+                        std::snprintf(cut, sizeof(cut), "%s…", s);
+                        s = cut;
+                    }
+                } else if (type == ArgType::Ptr && raw == 0) {
+                    s = "(null)";
+                }
+                emitf(spec, s);
+                break;
+            }
+            case 'p':
+                add("p");
+                emitf(spec, reinterpret_cast<void*>(static_cast<uintptr_t>(raw)));
+                break;
+            default:
+                emit("?", 1);
+                break;
+        }
+    }
+    out[n] = '\0';
+    return n;
+}
+
+size_t LogRing::drain() {
+    // 长时间静默的限频调用点：被丢弃的条数在这里补报（每秒至多一次）
+    LogFilter::instance().reportSuppressed();
+    std::lock_guard<std::mutex> lock(drain_mtx_);
+    const uint64_t head = head_.load(std::memory_order_acquire);
+    uint64_t lost = 0;
+    if (head - cursor_ > kCapacity) {
+        lost = head - kCapacity - cursor_;
+        cursor_ = head - kCapacity;
+    }
+
+    size_t count = 0;
+    Record rec;
+    char line[kLineBytes];
+    while (cursor_ < head) {
+        if (!read(cursor_, rec)) {
+            // 已被下一圈覆盖：跳过；还在写（写入方被抢占）：留到下次
+            const uint64_t seq = slots_[cursor_ & (kCapacity - 1)].seq.load(std::memory_order_acquire);
+            if (seq <= cursor_ * 2 + 2) break;
+            ++lost;
+            ++cursor_;
+            continue;
+        }
+        // syslog 打的是排空时刻（落后最多一个 kDrainPeriod，且常只到秒），事件时刻以行尾 ts= 为准
+        const size_t n = format(rec, line, sizeof(line) - kTsBytes);
+        std::snprintf(line + n, sizeof(line) - n, " ts=%llu.%06u",
+                      static_cast<unsigned long long>(rec.ts_us / 1000000ULL),
+                      static_cast<unsigned>(rec.ts_us % 1000000ULL));
+        syslog(rec.level, "%s", line);
+        ++cursor_;
+        ++count;
+    }
+    drained_ += count;
+    if (lost > 0) {
+        overwritten_ += lost;
+        syslog(LOG_WARNING, "[ktv][log][ring] action=drain status=overrun lost=%llu total_lost=%llu",
+               static_cast<unsigned long long>(lost), static_cast<unsigned long long>(overwritten_));
+    }
+    return count;
+}
+
+LogRing::Range LogRing::recent(size_t max_bytes, size_t max_lines, const char* keyword) const {
+    Range range;
+    range.end = head_.load(std::memory_order_acquire);
+    range.begin = range.end;
+    const uint64_t oldest = range.end > kCapacity ? range.end - kCapacity : 0;
+
+    std::string line;
+    for (uint64_t idx = range.end; idx > oldest && range.lines < max_lines;) {
+        --idx;
+        if (!formatLine(idx, keyword, line)) {
+            range.begin = idx;   // 被覆盖/过滤的记录不计数，区间照常向前延伸
+            continue;
+        }
+        if (range.bytes + line.size() > max_bytes) break;
+        range.bytes += line.size();
+        ++range.lines;
+        range.begin = idx;
+    }
+    return range;
+}
+
+bool LogRing::formatLine(uint64_t idx, const char* keyword, std::string& out) const {
+    Record rec;
+    if (!read(idx, rec)) return false;
+    char msg[kLineBytes];
+    format(rec, msg, sizeof(msg));
+    if (keyword && *keyword && !std::strstr(msg, keyword)) return false;
+
+    time_t sec = static_cast<time_t>(rec.ts_us / 1000000ULL);
+    struct tm tm_buf;
+    localtime_r(&sec, &tm_buf);
+    char prefix[48];
+    int plen = std::snprintf(prefix, sizeof(prefix), "%02d-%02d %02d:%02d:%02d.%03u %s ", tm_buf.tm_mon + 1,
+                             tm_buf.tm_mday, tm_buf.tm_hour, tm_buf.tm_min, tm_buf.tm_sec,
+                             static_cast<unsigned>(rec.ts_us / 1000ULL % 1000ULL), level_name(rec.level));
+    out.assign(prefix, static_cast<size_t>(std::max(plen, 0)));
+    out.append(msg);
+    out.push_back('\n');
+    return true;
+}
+
+std::string LogRing::snapshot(size_t max_bytes, size_t max_lines, const char* keyword) const {
+    const Range range = recent(max_bytes, max_lines, keyword);
+    std::string out;
+    out.reserve(range.bytes);
+    std::string line;
+    for (uint64_t idx = range.begin; idx < range.end; ++idx) {
+        // 两次读取之间被覆盖的记录可能比原来长，仍按上限截住
+        if (formatLine(idx, keyword, line) && out.size() + line.size() <= max_bytes) out += line;
+    }
+    return out;
+}
+
+LogRing::Stats LogRing::stats() const {
+    std::lock_guard<std::mutex> lock(drain_mtx_);
+    Stats s;
+    s.written = head_.load(std::memory_order_relaxed);
+    s.drained = drained_;
+    s.overwritten = overwritten_;
+    return s;
+}
+
+}  // namespace ktv::core
@@ -0,0 +1,178 @@
+/**
+ * @file log_ring.h
+ * @brief 进程内无锁二进制日志环（热路径日志不再同步写 syslog socket）
+ *
+ * - 写入：一次 fetch_add 领取槽位 + 按槽位 seqlock 填写定长记录
+ *   （格式串指针、最多 kMaxArgs 个参数、微秒时间戳），不加锁、不分配、不格式化；
+ *   const char* 参数拷贝进记录内的字符串区，超出部分截断，排空时在被截断的参数后加 "…"
+ * - 格式串必须是字符串常量（记录里只存指针，排空时才格式化）
+ * - 排空：Background Lane 周期任务把新记录格式化后写 syslog（行尾附 " ts=<秒>.<微秒>"，
+ *   即记录写入时的 CLOCK_REALTIME），排空落后超过一圈时统计并报告被覆盖的条数；
+ *   stop() 时同步排空剩余记录
+ * - 快照：日志上传直接从环里取最近的记录（从新到旧，受字节/行数上限约束），不依赖 logread
+ * - 环满时覆盖最旧记录，写入方永不阻塞
+ *
+ * 线程：write() 任意线程；drain()/snapshot() 任意线程（内部串行）。
+ */
+
+#ifndef KTVLV_CORE_LOG_RING_H
+#define KTVLV_CORE_LOG_RING_H
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <ctime>
+#include <mutex>
+#include <string>
+#include <type_traits>
+#include "executor.h"
+
+namespace ktv::core {
+
+class LogRing {
+public:
+    static constexpr size_t kCapacity = 2048;          // 记录数，2 的幂
+    static constexpr size_t kMaxArgs = 12;
+    static constexpr size_t kStringBytes = 192;        // 每条记录的字符串参数总字节（含各自的 '\0'）
+    static constexpr std::chrono::milliseconds kDrainPeriod{100};
+
+    enum class ArgType : uint8_t { I64, U64, F64, Str, Ptr };
+
+    struct Record {
+        uint64_t ts_us = 0;                  // CLOCK_REALTIME 微秒
+        const char* fmt = nullptr;
+        uint8_t level = 0;                   // syslog 优先级
+        uint8_t nargs = 0;
+        uint8_t str_used = 0;
+        ArgType types[kMaxArgs]{};
+        uint64_t args[kMaxArgs]{};           // 按 types 解释；Str 为 (截断标记 << 16 | offset << 8 | len)
+        char strings[kStringBytes]{};
+    };
+
+    static_assert(kStringBytes <= 255, "str_used/offset are 8-bit");
+
+    struct Stats {
+        uint64_t written = 0;
+        uint64_t drained = 0;
+        uint64_t overwritten = 0;            // 排空前被覆盖的条数
+    };
+
+    static LogRing& instance();
+
+    LogRing(const LogRing&) = delete;
+    LogRing& operator=(const LogRing&) = delete;
+
+    // 在 Background Lane 上启动周期排空（Executor 启动之后调用）
+    void start();
+    // 取消周期任务并同步排空剩余记录（Executor 停止之前调用）
+    void stop();
+
+    template <typename... Args>
+    void write(int level, const char* fmt, const Args&... args) {
+        static_assert(sizeof...(Args) <= kMaxArgs, "too many log arguments");
+        const uint64_t idx = head_.fetch_add(1, std::memory_order_relaxed);
+        Slot& slot = slots_[idx & (kCapacity - 1)];
+        slot.seq.store(idx * 2 + 1, std::memory_order_relaxed);
+        std::atomic_thread_fence(std::memory_order_release);
+
+        Record& r = slot.rec;
+        timespec ts;
+        clock_gettime(CLOCK_REALTIME, &ts);
+        r.ts_us = static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+        r.fmt = fmt;
+        r.level = static_cast<uint8_t>(level);
+        r.nargs = 0;
+        r.str_used = 0;
+        (put(r, args), ...);
+
+        slot.seq.store(idx * 2 + 2, std::memory_order_release);
+    }
+
+    // 把新记录写入 syslog；返回本次排空的条数
+    size_t drain();
+
+    // 序号区间 [begin, end)，lines/bytes 为选中时统计的行数与文本字节数
+    struct Range {
+        uint64_t begin = 0;
+        uint64_t end = 0;
+        size_t lines = 0;
+        size_t bytes = 0;
+    };
+
+    /**
+     * 选出最近的记录：从最新一条往回，直到 max_bytes / max_lines；keyword 非空时只计包含它的行
+     * 只确定区间不拼接文本，调用方再用 formatLine() 从旧到新逐行取（流式上传）
+     */
+    Range recent(size_t max_bytes, size_t max_lines, const char* keyword = nullptr) const;
+
+    /**
+     * 序号 idx 的记录格式化为一行 "MM-DD HH:MM:SS.mmm <level> message\n"
+     * 记录已被覆盖或不含 keyword 时返回 false
+     */
+    bool formatLine(uint64_t idx, const char* keyword, std::string& out) const;
+
+    // recent() 选中的记录拼成文本（从旧到新）
+    std::string snapshot(size_t max_bytes, size_t max_lines, const char* keyword = nullptr) const;
+
+    // 单条记录格式化（不含时间戳与换行），返回写入长度
+    static size_t format(const Record& r, char* out, size_t cap);
+
+    Stats stats() const;
+
+private:
+    struct Slot {
+        std::atomic<uint64_t> seq{0};        // 2*idx+1 写入中，2*idx+2 已提交
+        Record rec;
+    };
+
+    LogRing() = default;
+    ~LogRing() = default;
+
+    template <typename T>
+    static void put(Record& r, const T& v) {
+        using D = std::decay_t<T>;
+        const size_t i = r.nargs++;
+        if constexpr (std::is_same_v<D, const char*> || std::is_same_v<D, char*>) {
+            putString(r, i, v);
+        } else if constexpr (std::is_same_v<D, bool>) {
+            r.types[i] = ArgType::I64;
+            r.args[i] = v ? 1 : 0;
+        } else if constexpr (std::is_enum_v<D>) {
+            r.types[i] = ArgType::I64;
+            r.args[i] = static_cast<uint64_t>(static_cast<int64_t>(v));
+        } else if constexpr (std::is_integral_v<D> && std::is_signed_v<D>) {
+            r.types[i] = ArgType::I64;
+            r.args[i] = static_cast<uint64_t>(static_cast<int64_t>(v));
+        } else if constexpr (std::is_integral_v<D>) {
+            r.types[i] = ArgType::U64;
+            r.args[i] = static_cast<uint64_t>(v);
+        } else if constexpr (std::is_floating_point_v<D>) {
+            r.types[i] = ArgType::F64;
+            double d = static_cast<double>(v);
+            std::memcpy(&r.args[i], &d, sizeof(d));
+        } else if constexpr (std::is_pointer_v<D> || std::is_null_pointer_v<D>) {
+            r.types[i] = ArgType::Ptr;
+            r.args[i] = static_cast<uint64_t>(reinterpret_cast<uintptr_t>(static_cast<const void*>(v)));
+        } else {
+            static_assert(std::is_pointer_v<D>, "unsupported log argument type");
+        }
+    }
+
+    static void putString(Record& r, size_t i, const char* s);
+
+    bool read(uint64_t idx, Record& out) const;
+
+    Slot slots_[kCapacity];
+    std::atomic<uint64_t> head_{0};
+
+    mutable std::mutex drain_mtx_;
+    uint64_t cursor_ = 0;                    // 下一条待排空的序号
+    uint64_t drained_ = 0;
+    uint64_t overwritten_ = 0;
+    std::atomic<TaskId> timer_{0};
+};
+
+}  // namespace ktv::core
+
+#endif  // KTVLV_CORE_LOG_RING_H
@@ -4,28 +4,28 @@
  * 
  * 核心原则：
  * - Singleton 模式（宿主对象全局唯一）
- * - std::thread 成员变量（不在构造函数中启动）
- * - 阻塞等待（condition_variable，零 busy-loop）
+ * - 任务在共享线程池（Executor）的指定 Lane 上串行执行，不再自建 std::thread
+ * - 阻塞等待（Lane 线程 condition_variable，零 busy-loop）
  * - 显式 start/stop（由 App 主流程控制）
- * - 显式 join（确保线程安全退出）
+ * - stop() 等待当前任务与 onThreadStop() 执行完毕
  * 
  * 使用方式：
  * 1. 继承 ThreadBase
  * 2. 实现 processTask() 方法
  * 3. 可选：重写 onThreadStart() 和 onThreadStop()
  * 4. 在 App 启动时调用 instance().start()
- * 5. 在 App 退出时调用 instance().stop()
+ * 5. 在 App 退出时调用 instance().stop()（需在 Executor::stop() 之前）
  */
 
 #ifndef KTVLV_CORE_THREAD_BASE_H
 #define KTVLV_CORE_THREAD_BASE_H
 
-#include <thread>
 #include <atomic>
-#include <queue>
-#include <mutex>
-#include <condition_variable>
+#include <chrono>
+#include <future>
+#include <memory>
 #include <syslog.h>
+#include "executor.h"
 
 namespace ktv::core {
 
@@ -34,14 +34,16 @@ namespace ktv::core {
  * 
  * 特点：
  * - Singleton 模式
- * - std::thread 成员变量
- * - 阻塞等待（condition_variable）
+ * - 基于 SerialQueue：任务按投递顺序执行，onThreadStart/onThreadStop 与任务在同一 Lane
  * - 显式 start/stop
- * - 显式 join
  */
 template<typename TaskType>
 class ThreadBase {
 public:
+    explicit ThreadBase(Lane lane = Lane::Background)
+        : queue_(lane) {
+    }
+
     virtual ~ThreadBase() {
         if (running_.load()) {
             syslog(LOG_ERR, "[ktv][thread] ThreadBase destroyed without stop()!");
@@ -50,7 +52,7 @@ public:
     }
 
     /**
-     * @brief 启动线程（必须在 App 启动时显式调用）
+     * @brief 启动（必须在 App 启动时显式调用）
      */
     void start() {
         bool expected = false;
@@ -59,12 +61,14 @@ public:
             return;
         }
         
-        worker_ = std::thread(&ThreadBase::threadLoop, this);
+        queue_.reopen();
+        queue_.post([this] { onThreadStart(); });
         syslog(LOG_INFO, "[ktv][thread] ThreadBase started");
     }
 
     /**
-     * @brief 停止线程（必须在 App 退出时显式调用）
+     * @brief 停止（必须在 App 退出时显式调用）
+     * 未执行的任务被丢弃，onThreadStop() 在 Lane 上执行完才返回
      */
     void stop() {
         if (!running_.exchange(false)) {
@@ -72,10 +76,14 @@ public:
             return;
         }
         
-        cv_.notify_all();
-        if (worker_.joinable()) {
-            worker_.join();
+        auto done = std::make_shared<std::promise<void>>();
+        std::future<void> stopped = done->get_future();
+        if (queue_.post([this, done] { onThreadStop(); done->set_value(); })) {
+            if (stopped.wait_for(std::chrono::seconds(5)) != std::future_status::ready) {
+                syslog(LOG_ERR, "[ktv][thread] ThreadBase onThreadStop timeout");
+            }
         }
+        queue_.shutdown();
         
         syslog(LOG_INFO, "[ktv][thread] ThreadBase stopped");
     }
@@ -84,16 +92,21 @@ public:
      * @brief 投递任务到队列
      */
     void post(TaskType task) {
-        {
-            std::lock_guard<std::mutex> lock(mtx_);
-            tasks_.push(std::move(task));
-        }
-        cv_.notify_one();
+        queue_.post([this, task = std::move(task)]() {
+            if (!running_.load()) {
+                return;  // stop() 之后残留的任务直接丢弃
+            }
+            try {
+                processTask(task);
+            } catch (const std::exception& e) {
+                syslog(LOG_ERR, "[ktv][thread] Task execution failed: %s", e.what());
+            }
+        });
     }
 
 protected:
     /**
-     * @brief 线程启动时调用（资源初始化）
+     * @brief 启动时调用（资源初始化，在 Lane 线程上执行）
      * 子类可以重写此方法进行资源初始化
      */
     virtual void onThreadStart() {
@@ -101,7 +114,7 @@ protected:
     }
 
     /**
-     * @brief 线程停止时调用（资源清理）
+     * @brief 停止时调用（资源清理，在 Lane 线程上执行）
      * 子类可以重写此方法进行资源清理
      */
     virtual void onThreadStop() {
@@ -120,56 +133,13 @@ protected:
         return running_.load();
     }
 
-private:
-    void threadLoop() {
-        syslog(LOG_INFO, "[ktv][thread] ThreadBase loop started");
-        
-        onThreadStart();
-
-        while (running_.load()) {
-            TaskType task;
-            
-            {
-                std::unique_lock<std::mutex> lock(mtx_);
-                cv_.wait(lock, [this]() {
-                    return !tasks_.empty() || !running_.load();
-                });
-
-                if (!running_.load()) {
-                    break;
-                }
-
-                if (tasks_.empty()) {
-                    continue;
-                }
-
-                task = std::move(tasks_.front());
-                tasks_.pop();
-            }
-
-            try {
-                processTask(task);
-            } catch (const std::exception& e) {
-                syslog(LOG_ERR, "[ktv][thread] Task execution failed: %s", e.what());
-            }
-        }
-
-        onThreadStop();
-        syslog(LOG_INFO, "[ktv][thread] ThreadBase loop exited");
-    }
-
 protected:
-    std::thread worker_;
     std::atomic<bool> running_{false};
 
 private:
-    std::mutex mtx_;
-    std::condition_variable cv_;
-    std::queue<TaskType> tasks_;
+    SerialQueue queue_;
 };
 
 }  // namespace ktv::core
 
 #endif  // KTVLV_CORE_THREAD_BASE_H
-
-
@@ -0,0 +1,158 @@
+#include "timer_wheel.h"
+
+#include <algorithm>
+
+namespace ktv::core {
+
+static constexpr uint64_t kSlotMask = TimerWheel::kSlots - 1;
+
+// 第 level 层单个槽位覆盖的 tick 数
+static inline uint64_t level_span(int level) {
+    return uint64_t{1} << (TimerWheel::kSlotBits * level);
+}
+
+// 从 start 的下一个槽位开始（绕一圈，最后是 start 本身）找第一个非空槽
+static inline int first_occupied_after(uint64_t bitmap, int start) {
+    if (bitmap == 0) return -1;
+    int shift = (start + 1) & static_cast<int>(kSlotMask);
+    uint64_t rotated = shift == 0 ? bitmap : ((bitmap >> shift) | (bitmap << (TimerWheel::kSlots - shift)));
+    return (shift + __builtin_ctzll(rotated)) & static_cast<int>(kSlotMask);
+}
+
+TimerWheel::TimerWheel(std::chrono::milliseconds tick, Clock::time_point origin)
+    : tick_(tick.count() > 0 ? tick : std::chrono::milliseconds(1)), origin_(origin) {}
+
+uint64_t TimerWheel::toTick(Clock::time_point t) const {
+    if (t <= origin_) return 0;
+    auto ms = std::chrono::duration_cast<std::chrono::milliseconds>(t - origin_).count();
+    if (t - origin_ > std::chrono::milliseconds(ms)) ++ms;   // 不足 1ms 的部分向上取整
+    return static_cast<uint64_t>((ms + tick_.count() - 1) / tick_.count());
+}
+
+void TimerWheel::place(TimerId id, Node& node) {
+    // delta == 0 仅出现在下放时，落在当前 tick 的槽位，随后即被处理
+    uint64_t delta = node.expire - now_tick_;
+
+    int level = 0;
+    while (level < kLevels - 1 && delta >= level_span(level + 1)) ++level;
+    uint64_t expire = node.expire;
+    if (delta >= level_span(kLevels)) {
+        // 超出总跨度：先挂在最高层最远的槽，下放时再重新计算
+        expire = now_tick_ + level_span(kLevels) - 1;
+    }
+    int slot = static_cast<int>((expire >> (kSlotBits * level)) & kSlotMask);
+
+    auto& list = slots_[level][slot];
+    list.push_back(id);
+    node.level = level;
+    node.slot = slot;
+    node.pos = std::prev(list.end());
+    occupied_[level] |= uint64_t{1} << slot;
+}
+
+void TimerWheel::unlink(Node& node) {
+    auto& list = slots_[node.level][node.slot];
+    list.erase(node.pos);
+    if (list.empty()) occupied_[node.level] &= ~(uint64_t{1} << node.slot);
+}
+
+bool TimerWheel::add(TimerId id, Clock::time_point deadline, Callback cb) {
+    if (id == 0) return false;
+    auto res = nodes_.emplace(id, Node{});
+    if (!res.second) return false;
+    Node& node = res.first->second;
+    // 已过期的放到下一个 tick，下一次 advance 立即触发
+    node.expire = std::max(toTick(deadline), now_tick_ + 1);
+    node.cb = std::move(cb);
+    place(id, node);
+    return true;
+}
+
+bool TimerWheel::cancel(TimerId id) {
+    auto it = nodes_.find(id);
+    if (it == nodes_.end()) return false;
+    unlink(it->second);
+    nodes_.erase(it);
+    return true;
+}
+
+bool TimerWheel::reschedule(TimerId id, Clock::time_point deadline) {
+    auto it = nodes_.find(id);
+    if (it == nodes_.end()) return false;
+    unlink(it->second);
+    it->second.expire = std::max(toTick(deadline), now_tick_ + 1);
+    place(id, it->second);
+    return true;
+}
+
+void TimerWheel::cascade(int level) {
+    int slot = static_cast<int>((now_tick_ >> (kSlotBits * level)) & kSlotMask);
+    std::list<TimerId> moving;
+    moving.swap(slots_[level][slot]);
+    occupied_[level] &= ~(uint64_t{1} << slot);
+    for (TimerId id : moving) {
+        place(id, nodes_.at(id));
+    }
+}
+
+void TimerWheel::advance(Clock::time_point now, std::vector<std::pair<TimerId, Callback>>& out) {
+    // toTick 向上取整；推进只处理已完整经过的 tick
+    uint64_t target = now <= origin_ ? 0
+        : static_cast<uint64_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - origin_).count() /
+                                tick_.count());
+    if (nodes_.empty()) {
+        now_tick_ = std::max(now_tick_, target);
+        return;
+    }
+
+    while (now_tick_ < target && !nodes_.empty()) {
+        ++now_tick_;
+        // 低层转完一圈时，把上层对应槽位的定时器下放（从高层往低层，保证逐级落到位）
+        int top = 0;
+        while (top + 1 < kLevels && (now_tick_ & (level_span(top + 1) - 1)) == 0) ++top;
+        for (int level = top; level >= 1; --level) cascade(level);
+
+        int slot = static_cast<int>(now_tick_ & kSlotMask);
+        auto& list = slots_[0][slot];
+        if (list.empty()) continue;
+        std::list<TimerId> due;
+        due.swap(list);
+        occupied_[0] &= ~(uint64_t{1} << slot);
+        for (TimerId id : due) {
+            auto it = nodes_.find(id);
+            out.emplace_back(id, std::move(it->second.cb));
+            nodes_.erase(it);
+        }
+    }
+    now_tick_ = std::max(now_tick_, target);
+}
+
+TimerWheel::Clock::time_point TimerWheel::nextDeadline() const {
+    if (nodes_.empty()) return Clock::time_point::max();
+
+    // 每层中相对当前位置最近的非空槽包含该层最早的定时器，取各层最小值
+    uint64_t best = UINT64_MAX;
+    for (int level = 0; level < kLevels; ++level) {
+        int cur = static_cast<int>((now_tick_ >> (kSlotBits * level)) & kSlotMask);
+        int slot = first_occupied_after(occupied_[level], cur);
+        if (slot < 0) continue;
+        for (TimerId id : slots_[level][slot]) {
+            best = std::min(best, nodes_.at(id).expire);
+        }
+    }
+    // 超出总跨度的定时器 expire 仍是真实值（place 只截断槽位），这里直接换算即可；
+    // 极远的到期时间（如 time_point::max() 附近）换算会溢出，按"无限等待"处理
+    const auto max_ticks = (Clock::time_point::max() - origin_) / tick_;
+    if (best >= static_cast<uint64_t>(max_ticks)) return Clock::time_point::max();
+    return origin_ + tick_ * static_cast<int64_t>(best);
+}
+
+void TimerWheel::clear() {
+    for (auto& level : slots_) {
+        for (auto& list : level) list.clear();
+    }
+    for (auto& bits : occupied_) bits = 0;
+    nodes_.clear();
+}
+
+}  // namespace ktv::core
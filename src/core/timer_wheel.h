@@ -0,0 +1,83 @@
+/**
+ * @file timer_wheel.h
+ * @brief 分层时间轮（延时/周期/退避/防抖/TTL 的统一定时结构）
+ *
+ * 核心原则：
+ * - 4 层 × 64 槽，默认 tick 10ms：覆盖 0.64s / 41s / 44min / 46h；更远的定时器只把槽位截断到
+ *   最高层最远处，每转一圈重新计算，到期 tick 保持真实值（触发与 nextDeadline 都不会提前）
+ * - 插入/取消 O(1)，到期时逐层下放（cascade）
+ * - nextDeadline() 给出最近到期时间：工作线程 wait_until 到该时刻，无定时器时无限等待，
+ *   不需要任何周期性轮询
+ * - 到期判断按 tick 向上取整，定时器不会提前触发
+ *
+ * 非线程安全：由持有者（Executor Lane）在自己的锁内调用。
+ */
+
+#ifndef KTVLV_CORE_TIMER_WHEEL_H
+#define KTVLV_CORE_TIMER_WHEEL_H
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <unordered_map>
+#include <utility>
+#include <vector>
+
+namespace ktv::core {
+
+class TimerWheel {
+public:
+    using Clock = std::chrono::steady_clock;
+    using Callback = std::function<void()>;
+    using TimerId = uint64_t;
+
+    static constexpr int kLevels = 4;
+    static constexpr int kSlotBits = 6;
+    static constexpr int kSlots = 1 << kSlotBits;
+
+    explicit TimerWheel(std::chrono::milliseconds tick = std::chrono::milliseconds(10),
+                        Clock::time_point origin = Clock::now());
+
+    // id 由调用方分配（非 0 且唯一）；id 已存在时返回 false
+    bool add(TimerId id, Clock::time_point deadline, Callback cb);
+    bool cancel(TimerId id);
+    // 修改到期时间（防抖/TTL 续期），不存在时返回 false
+    bool reschedule(TimerId id, Clock::time_point deadline);
+    bool contains(TimerId id) const { return nodes_.count(id) > 0; }
+
+    // 推进到 now，到期的定时器按到期顺序追加到 out（并从时间轮移除）
+    void advance(Clock::time_point now, std::vector<std::pair<TimerId, Callback>>& out);
+
+    // 最近到期时间（真实到期时刻，不是槽位边界）；为空或超出 time_point 表示范围时返回 Clock::time_point::max()
+    Clock::time_point nextDeadline() const;
+
+    size_t size() const { return nodes_.size(); }
+    bool empty() const { return nodes_.empty(); }
+    void clear();
+
+private:
+    struct Node {
+        uint64_t expire = 0;       // 到期 tick
+        Callback cb;
+        int level = 0;
+        int slot = 0;
+        std::list<TimerId>::iterator pos;
+    };
+
+    uint64_t toTick(Clock::time_point t) const;   // 向上取整
+    void place(TimerId id, Node& node);
+    void unlink(Node& node);
+    void cascade(int level);
+
+    std::chrono::milliseconds tick_;
+    Clock::time_point origin_;
+    uint64_t now_tick_ = 0;
+    std::list<TimerId> slots_[kLevels][kSlots];
+    uint64_t occupied_[kLevels] = {0, 0, 0, 0};   // 每层非空槽位图，加速 nextDeadline
+    std::unordered_map<TimerId, Node> nodes_;
+};
+
+}  // namespace ktv::core
+
+#endif  // KTVLV_CORE_TIMER_WHEEL_H
@@ -61,8 +61,11 @@ public:
 protected:
     /**
      * @brief 受保护的构造函数（子类必须实现 Singleton）
+     * @param lane 任务执行的 Executor Lane，默认 Background
      */
-    WorkerThread() = default;
+    explicit WorkerThread(Lane lane = Lane::Background)
+        : ThreadBase<TaskType>(lane) {
+    }
 
     /**
      * @brief 受保护的析构函数
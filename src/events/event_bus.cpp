@@ -1,5 +1,8 @@
 #include "event_bus.h"
-#include <syslog.h>
+#include "../ui/download_view.h"
+#include "../ui/now_playing_view.h"
+#include "../ui/score_view.h"
+#include "../utils/log_macros.h"
 
 namespace ktv::events {
 
@@ -19,41 +22,65 @@ bool EventBus::poll(Event& ev) {
     return true;
 }
 
+size_t EventBus::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
 void EventBus::dispatchOnUiThread() {
     Event ev;
     // 从队列中取出所有待处理的事件
     while (poll(ev)) {
         // 根据事件类型进行分发处理
+        // 逐事件日志只在 debug 级别输出（[log] components = event:debug），各业务模块已在源头记录关键状态
         // 注意：所有 UI 操作（lv_obj_xxx）必须在这里执行，确保在主线程
         switch (ev.type) {
             case EventType::SongSelected:
-                syslog(LOG_INFO, "[ktv][event][song_selected] payload=%s", ev.payload.c_str());
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][song_selected] payload=%s", ev.payload.c_str());
                 // TODO: 更新 UI（如播放列表、历史记录等）
                 // 示例：更新播放列表 UI、添加到历史记录显示等
                 break;
             case EventType::SongFavoriteToggle:
-                syslog(LOG_INFO, "[ktv][event][song_favorite_toggle] payload=%s", ev.payload.c_str());
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][song_favorite_toggle] payload=%s", ev.payload.c_str());
                 // TODO: 更新收藏状态 UI
                 break;
             case EventType::PageChange:
-                syslog(LOG_INFO, "[ktv][event][page_change] payload=%s", ev.payload.c_str());
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][page_change] payload=%s", ev.payload.c_str());
                 // TODO: 切换页面（如果需要通过事件触发）
                 break;
             case EventType::DownloadCompleted:
-                syslog(LOG_INFO, "[ktv][event][download_completed] payload=%s", ev.payload.c_str());
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][download_completed] payload=%s", ev.payload.c_str());
                 // TODO: 更新下载状态 UI
                 break;
+            case EventType::DownloadProgress:
+                // 已在下载线程限频（≤2 次/秒/任务）
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][download_progress] payload=%s", ev.payload.c_str());
+                ktv::ui::DownloadView::getInstance().onProgress(ev.payload);
+                break;
             case EventType::PlayerStateChanged:
-                syslog(LOG_INFO, "[ktv][event][player_state_changed] payload=%s", ev.payload.c_str());
-                // TODO: 更新播放器状态 UI（播放/暂停按钮、进度条等）
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][player_state_changed] payload=%s", ev.payload.c_str());
+                ktv::ui::NowPlayingView::getInstance().onPlayerState(ev.payload);
                 break;
             case EventType::LicenceStateChanged:
-                syslog(LOG_INFO, "[ktv][event][licence_state_changed] payload=%s", ev.payload.c_str());
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][licence_state_changed] payload=%s", ev.payload.c_str());
                 // TODO: 更新许可证状态 UI
                 break;
+            case EventType::ScoreLive:
+                // 已在 ScoreService 限频（ui_interval_ms）
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][score_live] payload=%s", ev.payload.c_str());
+                ktv::ui::ScoreView::getInstance().onLive(ev.payload);
+                break;
+            case EventType::ScoreLine:
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][score_line] payload=%s", ev.payload.c_str());
+                ktv::ui::ScoreView::getInstance().onLine(ev.payload);
+                break;
+            case EventType::ScoreFinal:
+                KTV_SYSLOG(LOG_DEBUG, "[ktv][event][score_final] payload=%s", ev.payload.c_str());
+                ktv::ui::ScoreView::getInstance().onFinal(ev.payload);
+                break;
             case EventType::None:
             default:
-                syslog(LOG_WARNING, "[ktv][event][unknown] type=%d", static_cast<int>(ev.type));
+                KTV_SYSLOG(LOG_WARNING, "[ktv][event][unknown] type=%d", static_cast<int>(ev.type));
                 break;
         }
     }
@@ -28,12 +28,15 @@ public:
      */
     void dispatchOnUiThread();
 
+    // 队列中待分发的事件数
+    size_t pending() const;
+
 private:
     EventBus() = default;
     ~EventBus() = default;
 
     std::queue<Event> queue_;
-    std::mutex mutex_;
+    mutable std::mutex mutex_;
     std::condition_variable condition_;
 };
 
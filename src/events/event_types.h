@@ -11,8 +11,12 @@ enum class EventType {
     SongFavoriteToggle,
     PageChange,
     DownloadCompleted,
+    DownloadProgress,    // payload: JSON（见 M3u8DownloadService::DownloadProgress）
     PlayerStateChanged,
     LicenceStateChanged,
+    ScoreLive,           // payload: JSON（实时音高/累计分，ScoreService 限频）
+    ScoreLine,           // payload: JSON（一句歌词的得分）
+    ScoreFinal,          // payload: JSON（全曲得分）
 };
 
 struct Event {
@@ -0,0 +1,38 @@
+#include "ui_dispatcher.h"
+#include "../utils/log_macros.h"
+#include <exception>
+
+namespace ktv::events {
+
+void UiDispatcher::post(Task task) {
+    if (!task) return;
+    std::lock_guard<std::mutex> lock(mutex_);
+    queue_.push_back(std::move(task));
+}
+
+size_t UiDispatcher::drain() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        if (queue_.empty()) return 0;
+        running_.swap(queue_);
+    }
+    size_t n = running_.size();
+    for (auto& task : running_) {
+        try {
+            task();
+        } catch (const std::exception& e) {
+            KTV_SYSLOG(LOG_ERR, "[ktv][ui][error] component=ui_dispatcher exception=%s", e.what());
+        } catch (...) {
+            KTV_SYSLOG(LOG_ERR, "[ktv][ui][error] component=ui_dispatcher exception=unknown");
+        }
+    }
+    running_.clear();
+    return n;
+}
+
+size_t UiDispatcher::pending() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_.size();
+}
+
+}  // namespace ktv::events
@@ -0,0 +1,48 @@
+#ifndef KTVLV_EVENTS_UI_DISPATCHER_H
+#define KTVLV_EVENTS_UI_DISPATCHER_H
+
+#include <cstddef>
+#include <functional>
+#include <mutex>
+#include <vector>
+
+namespace ktv::events {
+
+/**
+ * UI 线程任务派发：后台线程投递闭包，主循环在 lv_timer_handler() 之后统一执行
+ *
+ * - post() 任意线程可调用（lv_async_call 不是线程安全的，后台线程不能直接用）
+ * - drain() 只能在 UI 线程调用，一次取走全部任务，执行期间新投递的任务留到下一帧
+ * - 一次后台结果对应一个闭包：闭包内完成全部 LVGL 修改（批量更新，只触发一次重排）
+ */
+class UiDispatcher {
+public:
+    using Task = std::function<void()>;
+
+    static UiDispatcher& getInstance() {
+        static UiDispatcher instance;
+        return instance;
+    }
+
+    UiDispatcher(const UiDispatcher&) = delete;
+    UiDispatcher& operator=(const UiDispatcher&) = delete;
+
+    void post(Task task);
+
+    // 执行已投递的任务，返回执行个数
+    size_t drain();
+
+    size_t pending() const;
+
+private:
+    UiDispatcher() = default;
+    ~UiDispatcher() = default;
+
+    mutable std::mutex mutex_;
+    std::vector<Task> queue_;
+    std::vector<Task> running_;   // drain() 复用，避免每帧分配
+};
+
+}  // namespace ktv::events
+
+#endif  // KTVLV_EVENTS_UI_DISPATCHER_H
@@ -3,11 +3,14 @@ extern "C" {
 #include <lvgl.h>
 }
 #include <cstdio>
+#include <algorithm>
 #include <exception>
 #include <unistd.h>
 #include <time.h>
 #include "ui/layouts.h"
 #include "ui/page_manager.h"
+#include "ui/image_cache.h"
+#include "ui/perf_hud.h"
 #include "ui/ui_scale.h"
 #include <syslog.h>
 #include "config/config.h"
@@ -17,14 +20,24 @@ extern "C" {
 #include "services/history_service.h"
 #include "services/m3u8_download_service.h"
 #include "services/player_service.h"
+#include "services/pitch_service.h"
+#include "services/prefetch_service.h"
+#include "services/score_service.h"
 #include "events/event_bus.h"
+#include "events/ui_dispatcher.h"
+#include "core/executor.h"
+#include "core/log_filter.h"
+#include "core/log_ring.h"
+#include "core/lv_mem_pool.h"   // 仓库根目录 core/（LVGL 内存池）
 
 // F133 平台驱动接口
 #ifdef KTV_PLATFORM_F133_LINUX
 extern "C" {
 #include "drivers/display_driver.h"
 #include "drivers/input_driver.h"
+#include "drivers/audio_driver.h"
 #include "platform/f133_linux/input_evdev.h"
+#include "platform/f133_linux/audio_alsa.h"
 }
 #endif
 
@@ -260,6 +273,35 @@ int main(int argc, char* argv[]) {
         if (!cfg_ok) {
             syslog(LOG_WARNING, "[ktv][sys][config] file=config.ini status=not_found action=using_defaults");
         }
+        ktv::config::PrefetchConfig prefetch_cfg;
+        ktv::config::loadPrefetchConfig("config.ini", prefetch_cfg);
+        ktv::config::CacheConfig cache_cfg;
+        ktv::config::loadCacheConfig("config.ini", cache_cfg);
+        ktv::config::UiConfig ui_cfg;
+        ktv::config::loadUiConfig("config.ini", ui_cfg);
+        ktv::config::ImageCacheConfig image_cfg;
+        ktv::config::loadImageCacheConfig("config.ini", image_cfg);
+        ktv::config::PerfConfig perf_cfg;
+        ktv::config::loadPerfConfig("config.ini", perf_cfg);
+        ktv::config::InputConfig input_cfg;
+        ktv::config::loadInputConfig("config.ini", input_cfg);
+        ktv::config::AudioConfig audio_cfg;
+        ktv::config::loadAudioConfig("config.ini", audio_cfg);
+        ktv::config::ScoreConfig score_cfg;
+        ktv::config::loadScoreConfig("config.ini", score_cfg);
+        ktv::config::LogConfig log_cfg;
+        ktv::config::loadLogConfig("config.ini", log_cfg);
+        {
+            // 运行时日志级别与限频：尽早生效，UI 初始化阶段的日志也受控
+            auto& filter = ktv::core::LogFilter::instance();
+            filter.setDefaultLevel(ktv::core::LogFilter::levelFromName(log_cfg.level.c_str(), LOG_INFO));
+            if (!filter.applyOverrides(log_cfg.components.c_str())) {
+                syslog(LOG_WARNING, "[ktv][sys][config] section=log key=components status=partially_invalid value=%s",
+                       log_cfg.components.c_str());
+            }
+            filter.setRateLimit(static_cast<uint32_t>(std::max(log_cfg.rate_per_sec, 0)),
+                                static_cast<uint32_t>(std::max(log_cfg.burst, 1)));
+        }
         
         syslog(LOG_INFO, "[ktv][sys][init] component=display");
         if (!init_display()) {
@@ -275,6 +317,40 @@ int main(int argc, char* argv[]) {
         
         syslog(LOG_INFO, "[ktv][sys][init] component=input");
         init_input();
+#ifdef KTV_PLATFORM_F133_LINUX
+        evdev_set_autorepeat(static_cast<uint32_t>(std::max(0, input_cfg.repeat_delay_ms)),
+                             static_cast<uint32_t>(std::max(0, input_cfg.repeat_interval_ms)));
+        // 录音参数（开始录音时生效）
+        alsa_capture_config_t capture_cfg;
+        capture_cfg.device = audio_cfg.capture_device.c_str();
+        capture_cfg.period_frames = static_cast<uint32_t>(std::max(0, audio_cfg.period_frames));
+        capture_cfg.periods = static_cast<uint32_t>(std::max(0, audio_cfg.periods));
+        capture_cfg.ring_ms = static_cast<uint32_t>(std::max(0, audio_cfg.ring_ms));
+        alsa_capture_configure(&capture_cfg);
+        // 人声监听参数（monitor_enabled 时随录音自动开启）
+        alsa_monitor_config_t monitor_cfg;
+        monitor_cfg.enabled = audio_cfg.monitor_enabled;
+        monitor_cfg.device = audio_cfg.monitor_device.c_str();
+        monitor_cfg.period_frames = static_cast<uint32_t>(std::max(0, audio_cfg.monitor_period_frames));
+        monitor_cfg.periods = static_cast<uint32_t>(std::max(0, audio_cfg.monitor_periods));
+        monitor_cfg.channels = static_cast<uint32_t>(std::max(0, audio_cfg.monitor_channels));
+        monitor_cfg.target_latency_ms = static_cast<uint32_t>(std::max(0, audio_cfg.monitor_target_ms));
+        alsa_monitor_configure(&monitor_cfg);
+        // 监听效果参数（未监听时保存，开启监听时生效；范围由 audio_fx 钳位）
+        audio_fx_params_t fx_params;
+        audio_fx_default_params(&fx_params);
+        fx_params.gain_db = audio_cfg.fx_gain_db;
+        fx_params.echo_enabled = audio_cfg.fx_echo;
+        fx_params.echo_ms = static_cast<uint32_t>(std::max(0, audio_cfg.fx_echo_ms));
+        fx_params.echo_feedback = audio_cfg.fx_echo_feedback;
+        fx_params.echo_mix = audio_cfg.fx_echo_mix;
+        fx_params.reverb_enabled = audio_cfg.fx_reverb;
+        fx_params.reverb_room = audio_cfg.fx_reverb_room;
+        fx_params.reverb_damp = audio_cfg.fx_reverb_damp;
+        fx_params.reverb_mix = audio_cfg.fx_reverb_mix;
+        fx_params.limiter_db = audio_cfg.fx_limiter_db;
+        alsa_monitor_set_fx(&fx_params);
+#endif
     
         // ✅ 关键修复：UIScale 必须从实际显示驱动分辨率初始化
         // 不能使用宏，必须从 lv_disp_get_*_res 获取实际分辨率
@@ -323,13 +399,56 @@ int main(int argc, char* argv[]) {
         syslog(LOG_INFO, "[ktv][sys][init] component=ui");
         // ✅ 使用实际分辨率初始化 UIScale，设计稿标准为 1920x1080
         ktv::ui::init_ui_system(actual_width, actual_height);
+        ktv::ui::PageManager::getInstance().setCacheConfig(ui_cfg);
+        // 帧耗时/输入延迟统计：包装显示驱动回调，HUD 由配置或组合键切换
+        ktv::ui::PerfHud::getInstance().setConfig(perf_cfg);
+        ktv::ui::PerfHud::getInstance().attach(default_disp);
+
+        syslog(LOG_INFO, "[ktv][sys][init] component=executor");
+        // 共享线程池：下载/播放器/日志上传等后台任务的唯一线程来源
+        ktv::core::Executor::instance().start();
+        // 日志环排空到 syslog（此前 UI 初始化写入的记录也在这里补写）
+        ktv::core::LogRing::instance().start();
 
         syslog(LOG_INFO, "[ktv][sys][init] component=services");
         // Initialize services (placeholder/optional parameters)
         ktv::services::HttpService::getInstance().initialize(net_cfg.base_url, net_cfg.timeout);
         ktv::services::LicenceService::getInstance().initialize();
         ktv::services::HistoryService::getInstance().setCapacity(50);
+        ktv::services::M3u8DownloadService::getInstance().setCacheConfig(cache_cfg);
         ktv::services::M3u8DownloadService::getInstance().initialize();
+        ktv::services::PrefetchService::getInstance().setConfig(prefetch_cfg);
+        ktv::services::ScoreService::getInstance().setConfig(score_cfg);
+        ktv::ui::ImageCache::getInstance().setConfig(image_cfg);
+#ifdef KTV_PLATFORM_F133_LINUX
+        // 演唱会话：起播时 录音 → 音高跟踪 → 打分，停止时逆序关闭（均在 Player Lane 上执行）
+        auto stop_session = [](const std::string&) {
+            ktv::services::ScoreService::getInstance().stop();
+            ktv::services::PitchService::getInstance().stop();   // 必须先于 stop_record（环形缓冲随之销毁）
+            if (AUDIO.is_recording()) AUDIO.stop_record();
+        };
+        auto start_session = [audio_cfg, score_cfg](const std::string& song_id) {
+            if (!score_cfg.enabled && !audio_cfg.monitor_enabled) return;
+            if (!AUDIO.start_record(audio_cfg.sample_rate, 1, 0, nullptr, nullptr)) {
+                syslog(LOG_WARNING, "[ktv][audio][session] song_id=%s action=start_record status=failed", song_id.c_str());
+                return;
+            }
+            if (!score_cfg.enabled) return;
+            alsa_capture_stats_t cap;
+            alsa_capture_get_stats(&cap);
+            ktv::audio::PitchDetector::Config pitch_cfg;
+            pitch_cfg.sample_rate = static_cast<int>(cap.rate);
+            pitch_cfg.channels = static_cast<int>(cap.channels);
+            auto& pitch = ktv::services::PitchService::getInstance();
+            if (!pitch.start(alsa_capture_ring(), pitch_cfg)) {
+                syslog(LOG_WARNING, "[ktv][audio][session] song_id=%s action=pitch_start status=failed", song_id.c_str());
+                return;
+            }
+            // 没有参考旋律的歌曲不打分，音高跟踪也随之停掉（录音留给监听）
+            if (!ktv::services::ScoreService::getInstance().start(song_id)) pitch.stop();
+        };
+        ktv::services::PlayerService::getInstance().setSessionHooks(start_session, stop_session);
+#endif
 
         syslog(LOG_INFO, "[ktv][sys][init] component=main_screen");
         fprintf(stderr, "Creating main screen...\n");
@@ -399,6 +518,10 @@ int main(int argc, char* argv[]) {
         // 顺序：先更新 tick，再 lv_timer_handler（触发渲染），再处理输入事件
         bool quit = false;
         int loop_count = 0;
+#ifdef KTV_PLATFORM_F133_LINUX
+        bool latency_requested = false;   // 本次监听已请求回环实测（结果在下一次心跳读取）
+        bool latency_reported = false;
+#endif
         
         // ✅ 关键修复：初始化 tick 跟踪（使用 clock_gettime）
         struct timespec last_time;
@@ -472,7 +595,13 @@ int main(int argc, char* argv[]) {
                 }
                 
                 // ⚠️ 关键：调用 timer handler，这会触发 flush_cb
+                struct timespec th_begin, th_end;
+                clock_gettime(CLOCK_MONOTONIC, &th_begin);
                 task_delay = safe_lv_timer_handler();
+                clock_gettime(CLOCK_MONOTONIC, &th_end);
+                ktv::ui::PerfHud::getInstance().recordTimerHandler(
+                    static_cast<uint64_t>((th_end.tv_sec - th_begin.tv_sec) * 1000000LL +
+                                          (th_end.tv_nsec - th_begin.tv_nsec) / 1000));
                 
                 // ✅ 调试：前几次循环输出信息
                 loop_count_before_flush++;
@@ -493,6 +622,8 @@ int main(int argc, char* argv[]) {
             // 所有后台线程（下载、播放器等）只能通过 EventBus 发布事件，不能直接操作 UI
             try {
                 ktv::events::EventBus::getInstance().dispatchOnUiThread();
+                // 后台任务结果（页面数据等）在这里批量应用到 UI
+                ktv::events::UiDispatcher::getInstance().drain();
             } catch (const std::exception& e) {
                 fprintf(stderr, "ERROR in EventBus dispatch: %s\n", e.what());
                 syslog(LOG_ERR, "[ktv][sys][error] component=eventbus exception=%s", e.what());
@@ -502,21 +633,96 @@ int main(int argc, char* argv[]) {
             }
             
 #ifdef KTV_PLATFORM_F133_LINUX
-            // F133 平台：读取 evdev 输入事件
+            // F133 平台：evdev 由读取线程读取，此处仅在线程不可用时轮询
             evdev_read_events_exported();
+            // 上一次 lv_timer_handler 已读取的按键：输入延迟统计 + HUD 组合键
+            uint16_t key_code = 0;
+            uint64_t key_ts_us = 0;
+            while (evdev_take_key_press(&key_code, &key_ts_us)) {
+                ktv::ui::PerfHud::getInstance().onKeyPress(key_code, key_ts_us);
+            }
 #endif
             
             // ✅ 关键修复：避免 CPU 打满，让 LVGL 有机会触发刷新
             // 这是 LVGL 刷新循环的关键，没有 delay → 刷新可能被跳过
             uint32_t delay_ms = task_delay > 5 ? task_delay : 5;
+#ifdef KTV_PLATFORM_F133_LINUX
+            // 有按键/触摸时立即唤醒，不必等满 delay_ms
+            evdev_wait(delay_ms);
+#else
             usleep(delay_ms * 1000);  // 转换为微秒
+#endif
 
             loop_count++;
             if (loop_count % 1000 == 0) {
                 syslog(LOG_INFO, "[ktv][sys][heartbeat] loop_count=%d", loop_count);
+                // LVGL 内存池：长时间运行时 used/frag 应保持平稳
+                ktv_lv_pool_stats_t pool;
+                ktv_lv_pool_get_stats(&pool);
+                syslog(LOG_INFO,
+                       "[ktv][mem][lv_pool] used=%zu high_water=%zu total=%zu largest_free=%zu frag_pct=%u "
+                       "used_blocks=%u free_blocks=%u fails=%u",
+                       pool.used, pool.high_water, pool.total, pool.largest_free, pool.frag_pct,
+                       pool.used_blocks, pool.free_blocks, pool.fail_count);
+#ifdef KTV_PLATFORM_F133_LINUX
+                evdev_stats_t in;
+                evdev_get_stats(&in);
+                syslog(LOG_INFO,
+                       "[ktv][input][evdev] devices=%u hotplugs=%u keys=%u touches=%u repeats=%u "
+                       "coalesced=%u dropped=%u syn_dropped=%u max_queue_us=%u",
+                       in.devices, in.hotplugs, in.key_events, in.touch_events, in.repeats,
+                       in.coalesced, in.dropped, in.syn_dropped, in.max_queue_us);
+                alsa_capture_stats_t cap;
+                alsa_capture_get_stats(&cap);
+                if (cap.active) {
+                    syslog(LOG_INFO,
+                           "[ktv][audio][capture] mode=%s rate=%u period=%u buffer=%u ring=%u xruns=%u "
+                           "suspends=%u wakeups=%u frames=%llu hw_fill_max=%u cb_fill=%u cb_overruns=%u",
+                           cap.mmap ? "mmap" : "readi", cap.rate, cap.period_frames, cap.buffer_frames,
+                           cap.ring_frames, cap.xruns, cap.suspends, cap.wakeups,
+                           static_cast<unsigned long long>(cap.frames), cap.hw_fill_max,
+                           cap.callback_fill, cap.callback_overruns);
+                }
+                alsa_monitor_stats_t mon;
+                alsa_monitor_get_stats(&mon);
+                // 回环实测：每次开启监听后请求一次；心跳间隔远大于测量超时（1 s），
+                // 下一次心跳时结果必然已出：-1 表示没有回环通路
+                if (!mon.active) {
+                    latency_requested = latency_reported = false;
+                } else if (audio_cfg.monitor_measure_latency && !latency_requested) {
+                    latency_requested = alsa_monitor_measure_latency();
+                } else if (latency_requested && !latency_reported) {
+                    latency_reported = true;
+                    const bool measured = mon.latency_measured_us >= 0;
+                    const bool over = measured && mon.latency_measured_us > audio_cfg.monitor_target_ms * 1000;
+                    syslog(over || !measured ? LOG_WARNING : LOG_INFO,
+                           "[ktv][audio][monitor_latency] measured_us=%d target_ms=%d est_us=%u result=%s",
+                           mon.latency_measured_us, audio_cfg.monitor_target_ms, mon.latency_est_us,
+                           !measured ? "timeout" : (over ? "over_target" : "ok"));
+                }
+                if (mon.active) {
+                    bool over = mon.latency_est_max_us > static_cast<uint32_t>(audio_cfg.monitor_target_ms) * 1000U;
+                    syslog(over ? LOG_WARNING : LOG_INFO,
+                           "[ktv][audio][monitor] period=%u buffer=%u latency_est_us=%u latency_est_max_us=%u "
+                           "latency_measured_us=%d underruns=%u starved=%u dropped=%llu dsp_load=%u%% gr_db=%.1f",
+                           mon.period_frames, mon.buffer_frames, mon.latency_est_us, mon.latency_est_max_us,
+                           mon.latency_measured_us, mon.underruns, mon.starved,
+                           static_cast<unsigned long long>(mon.dropped_frames), mon.dsp_load_pct,
+                           mon.gain_reduction_db);
+                }
+#endif
             }
         }
         
+        // 先停服务（等待其在线程池上的任务结束），再停线程池
+        ktv::services::M3u8DownloadService::getInstance().cleanup();
+        ktv::core::LogRing::instance().stop();
+        ktv::core::Executor::instance().stop();
+#ifdef KTV_PLATFORM_F133_LINUX
+        // 线程池已停，Player Lane 上不会再有起播/停止钩子：直接关闭演唱会话
+        stop_session(std::string());
+#endif
+
         syslog(LOG_INFO, "[ktv][sys][exit] reason=normal");
         return 0;
     } catch (const std::exception& e) {
@@ -525,6 +731,8 @@ int main(int argc, char* argv[]) {
         fprintf(stderr, "Exception message: %s\n", e.what());
         try {
             syslog(LOG_ERR, "[ktv][sys][exit] reason=exception exception=%s", e.what());
+            // 日志环里还没排空的记录直接补写
+            ktv::core::LogRing::instance().drain();
         } catch (...) {
             // Logger system may also have problems, ignore
         }
@@ -535,6 +743,8 @@ int main(int argc, char* argv[]) {
         fprintf(stderr, "Exception type: Unknown exception\n");
         try {
             syslog(LOG_ERR, "[ktv][sys][exit] reason=unknown_exception");
+            // 日志环里还没排空的记录直接补写
+            ktv::core::LogRing::instance().drain();
         } catch (...) {
             // Logger system may also have problems, ignore
         }
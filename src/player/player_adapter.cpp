@@ -1,13 +1,13 @@
 // player_adapter.cpp
 #include "player_adapter.h"
-#include "player_cmd_queue.h"
+#include "player_cmd.h"
 #include "ui_event_queue.h"
 #include "ui_dispatcher.h"
+#include "../core/executor.h"
 
 // TODO: 引入 tplayer 头文件
 // #include "tplayer.h"
 
-#include <thread>
 #include <atomic>
 #include <iostream> // 临时调试用
 
@@ -36,14 +36,14 @@ public:
     void onSdkEvent(int code, int extra);
 
 private:
-    void threadLoop();               // 播放器线程主循环
-    void handleCmd(const PlayerCmd& cmd);
+    void enqueue(const PlayerCmd& cmd);
+    void handleCmd(const PlayerCmd& cmd);  // Player Lane 上串行执行
     void emitToUi(const PlayerEvent& ev);
 
-    std::thread worker_;
     std::atomic<bool> running_{false};
 
-    PlayerCmdQueue cmdQueue_;
+    // 命令串行执行在共享线程池的 Player Lane（最高优先级），不再自建线程
+    ktv::core::SerialQueue cmdQueue_{ktv::core::Lane::Player, 32};
     UiEventQueue<PlayerEvent> uiQueue_;
 
     // tplayer 相关
@@ -71,52 +71,55 @@ PlayerAdapter::Impl::~Impl() {
 
 void PlayerAdapter::Impl::start() {
     if (running_.exchange(true)) return;
-    worker_ = std::thread([this]{
-        threadLoop();
-    });
+    cmdQueue_.reopen();
 }
 
 void PlayerAdapter::Impl::shutdown() {
     if (!running_.exchange(false)) return;
-    cmdQueue_.stop();
-    if (worker_.joinable()) {
-        worker_.join();
-    }
+    // 丢弃未执行的命令，等待正在执行的 tplayer 调用返回
+    cmdQueue_.shutdown();
+}
+
+void PlayerAdapter::Impl::enqueue(const PlayerCmd& cmd) {
+    if (!running_) return;
+    cmdQueue_.post([this, cmd] {
+        if (running_) handleCmd(cmd);
+    });
 }
 
 void PlayerAdapter::Impl::play(const std::string& url) {
     PlayerCmd cmd{PlayerCmdType::PLAY, url, 0};
-    cmdQueue_.enqueue(cmd);
+    enqueue(cmd);
 }
 
 void PlayerAdapter::Impl::pause() {
-    cmdQueue_.enqueue(PlayerCmd{PlayerCmdType::PAUSE, "", 0});
+    enqueue(PlayerCmd{PlayerCmdType::PAUSE, "", 0});
 }
 
 void PlayerAdapter::Impl::resume() {
-    cmdQueue_.enqueue(PlayerCmd{PlayerCmdType::RESUME, "", 0});
+    enqueue(PlayerCmd{PlayerCmdType::RESUME, "", 0});
 }
 
 void PlayerAdapter::Impl::replay() {
-    cmdQueue_.enqueue(PlayerCmd{PlayerCmdType::REPLAY, "", 0});
+    enqueue(PlayerCmd{PlayerCmdType::REPLAY, "", 0});
 }
 
 void PlayerAdapter::Impl::switchTrack(int mode) {
     PlayerCmd cmd{PlayerCmdType::SWITCH_TRACK, "", mode};
-    cmdQueue_.enqueue(cmd);
+    enqueue(cmd);
 }
 
 void PlayerAdapter::Impl::setVolume(int volume) {
     PlayerCmd cmd{PlayerCmdType::SET_VOLUME, "", volume};
-    cmdQueue_.enqueue(cmd);
+    enqueue(cmd);
 }
 
 void PlayerAdapter::Impl::stop() {
-    cmdQueue_.enqueue(PlayerCmd{PlayerCmdType::STOP, "", 0});
+    enqueue(PlayerCmd{PlayerCmdType::STOP, "", 0});
 }
 
 void PlayerAdapter::Impl::exit() {
-    cmdQueue_.enqueue(PlayerCmd{PlayerCmdType::EXIT, "", 0});
+    enqueue(PlayerCmd{PlayerCmdType::EXIT, "", 0});
 }
 
 void PlayerAdapter::Impl::setListener(PlayerListener listener) {
@@ -124,13 +127,6 @@ void PlayerAdapter::Impl::setListener(PlayerListener listener) {
     listener_ = std::move(listener);
 }
 
-void PlayerAdapter::Impl::threadLoop() {
-    while (running_) {
-        PlayerCmd cmd = cmdQueue_.waitDequeue();
-        handleCmd(cmd);
-    }
-}
-
 void PlayerAdapter::Impl::handleCmd(const PlayerCmd& cmd) {
     // TODO: 根据 cmd.type 调用 tplayer_* 接口
     // + 做好状态机保护（PREPARING/PLAYING/PAUSED/...）
@@ -1,22 +1,8 @@
 // ui_dispatcher.cpp
 #include "ui_dispatcher.h"
-
-extern "C" {
-    #include <lvgl.h>
-}
+#include "../events/ui_dispatcher.h"
 
 void UiDispatcher::post(const std::function<void()>& task) {
-    auto heapTask = new std::function<void()>(task);
-    lv_async_call(
-        [](void* data){
-            auto fn = static_cast<std::function<void()>*>(data);
-            (*fn)();
-            delete fn;
-        },
-        heapTask
-    );
+    // lv_async_call 不是线程安全的；统一走主循环 drain 的队列
+    ktv::events::UiDispatcher::getInstance().post(task);
 }
-
-
-
-
@@ -19,6 +19,7 @@ bool HttpService::initialize(const std::string& base_url, int timeout_seconds) {
 }
 
 void HttpService::cleanup() {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (curl_handle_) {
         curl_easy_cleanup(curl_handle_);
         curl_handle_ = nullptr;
@@ -37,7 +38,19 @@ size_t HttpService::writeCallback(void* contents, size_t size, size_t nmemb, voi
     return total;
 }
 
-bool HttpService::get(const char* url, HttpResponse& response) {
+int HttpService::progressCallback(void* clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    const CancelFn* cancelled = static_cast<const CancelFn*>(clientp);
+    return (*cancelled)() ? 1 : 0;   // 非 0 → curl_easy_perform 返回 CURLE_ABORTED_BY_CALLBACK
+}
+
+size_t HttpService::mimeReadCallback(char* buffer, size_t size, size_t nitems, void* arg) {
+    const MultipartField* field = static_cast<const MultipartField*>(arg);
+    long n = field->read(buffer, size * nitems);
+    return n < 0 ? CURL_READFUNC_ABORT : static_cast<size_t>(n);
+}
+
+bool HttpService::get(const char* url, HttpResponse& response, const CancelFn& cancelled) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!curl_handle_) return false;
     response = {};
     char full[512]{0};
@@ -47,14 +60,25 @@ bool HttpService::get(const char* url, HttpResponse& response) {
         std::snprintf(full, sizeof(full), "%s", url);
     }
     curl_easy_setopt(curl_handle_, CURLOPT_URL, full);
+    curl_easy_setopt(curl_handle_, CURLOPT_HTTPGET, 1L);   // 句柄复用：清掉上一次 post 的方法/请求体
     curl_easy_setopt(curl_handle_, CURLOPT_WRITEDATA, &response);
+    if (cancelled) {
+        curl_easy_setopt(curl_handle_, CURLOPT_XFERINFOFUNCTION, progressCallback);
+        curl_easy_setopt(curl_handle_, CURLOPT_XFERINFODATA, &cancelled);
+        curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 0L);
+    }
     CURLcode res = curl_easy_perform(curl_handle_);
+    if (cancelled) {
+        curl_easy_setopt(curl_handle_, CURLOPT_NOPROGRESS, 1L);
+        curl_easy_setopt(curl_handle_, CURLOPT_XFERINFODATA, nullptr);
+    }
     if (res != CURLE_OK) return false;
     curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &response.status_code);
     return response.status_code == 200;
 }
 
 bool HttpService::post(const char* url, const char* json_data, HttpResponse& response) {
+    std::lock_guard<std::mutex> lock(mutex_);
     if (!curl_handle_) return false;
     response = {};
     char full[512]{0};
@@ -72,11 +96,60 @@ bool HttpService::post(const char* url, const char* json_data, HttpResponse& res
     curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, headers);
 
     CURLcode res = curl_easy_perform(curl_handle_);
+    curl_easy_setopt(curl_handle_, CURLOPT_HTTPHEADER, nullptr);   // headers 即将释放，不能留在句柄上
     curl_slist_free_all(headers);
     if (res != CURLE_OK) return false;
     curl_easy_getinfo(curl_handle_, CURLINFO_RESPONSE_CODE, &response.status_code);
     return response.status_code == 200;
 }
 
-}  // namespace ktv::services
+bool HttpService::postMultipart(const char* url, const std::vector<MultipartField>& fields, HttpResponse& response,
+                                int timeout_seconds) {
+    // 上传可能持续数秒：用独立的一次性句柄，不持有 mutex_，不阻塞 UI 线程的 get()/post()
+    // base_url_/timeout_seconds_ 只在 initialize() 写入，这里只读
+    response = {};
+    CURL* curl = curl_easy_init();
+    if (!curl) return false;
+    char full[512]{0};
+    if (url[0] == '/') {
+        std::snprintf(full, sizeof(full), "%s%s", base_url_.data(), url);
+    } else {
+        std::snprintf(full, sizeof(full), "%s", url);
+    }
+
+    curl_mime* mime = curl_mime_init(curl);
+    if (!mime) {
+        curl_easy_cleanup(curl);
+        return false;
+    }
+    for (const auto& f : fields) {
+        curl_mimepart* part = curl_mime_addpart(mime);
+        curl_mime_name(part, f.name.c_str());
+        if (f.read) {
+            // 大小未知（-1）：请求体按 chunked 发送，内容边读边发
+            curl_mime_data_cb(part, -1, mimeReadCallback, nullptr, nullptr,
+                              const_cast<MultipartField*>(&f));
+        } else {
+            curl_mime_data(part, f.value.data(), f.value.size());
+        }
+        if (!f.filename.empty()) curl_mime_filename(part, f.filename.c_str());
+        if (!f.content_type.empty()) curl_mime_type(part, f.content_type.c_str());
+    }
+
+    curl_easy_setopt(curl, CURLOPT_URL, full);
+    curl_easy_setopt(curl, CURLOPT_MIMEPOST, mime);
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, writeCallback);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &response);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT,
+                     static_cast<long>(timeout_seconds > 0 ? timeout_seconds : timeout_seconds_));
 
+    CURLcode res = curl_easy_perform(curl);
+    if (res == CURLE_OK) curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response.status_code);
+    curl_easy_cleanup(curl);
+    curl_mime_free(mime);
+    return res == CURLE_OK && response.status_code == 200;
+}
+
+}  // namespace ktv::services
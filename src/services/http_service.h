@@ -2,7 +2,10 @@
 #define KTVLV_SERVICES_HTTP_SERVICE_H
 
 #include <array>
+#include <functional>
+#include <mutex>
 #include <string>
+#include <vector>
 #include <curl/curl.h>
 
 namespace ktv::services {
@@ -13,8 +16,26 @@ struct HttpResponse {
     size_t body_len{0};
 };
 
+/**
+ * multipart/form-data 的一个字段
+ * - read 为空：普通文本字段，内容为 value
+ * - read 非空：文件字段，内容在发送过程中按需拉取（大小未知，按 chunked 发送）；
+ *   read 向 buf 写最多 len 字节并返回字节数，返回 0 表示结束，< 0 表示出错并中止上传
+ */
+struct MultipartField {
+    std::string name;
+    std::string value;
+    std::string filename;
+    std::string content_type;
+    std::function<long(char* buf, size_t len)> read;
+};
+
+// 单个 curl 句柄，get/post 内部串行化（UI 线程与后台页面加载都会调用）
 class HttpService {
 public:
+    // 返回 true 时中止传输（传输过程中周期性调用，用于丢弃已过时的请求）
+    using CancelFn = std::function<bool()>;
+
     static HttpService& getInstance() {
         static HttpService instance;
         return instance;
@@ -25,18 +46,26 @@ public:
     bool initialize(const std::string& base_url, int timeout_seconds = 10);
     void cleanup();
 
-    bool get(const char* url, HttpResponse& response);
+    bool get(const char* url, HttpResponse& response, const CancelFn& cancelled = nullptr);
     bool post(const char* url, const char* json_data, HttpResponse& response);
+    // multipart 上传：每次使用独立句柄、不经过 mutex_，可在任意线程长时间执行（需已 initialize）；
+    // timeout_seconds > 0 时本次请求使用该超时（默认沿用 initialize 的设置）
+    bool postMultipart(const char* url, const std::vector<MultipartField>& fields, HttpResponse& response,
+                       int timeout_seconds = 0);
 
 private:
     HttpService() = default;
     ~HttpService() = default;
 
+    std::mutex mutex_;
     CURL* curl_handle_{nullptr};
     std::array<char, 256> base_url_{};
     int timeout_seconds_{10};
 
     static size_t writeCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static size_t mimeReadCallback(char* buffer, size_t size, size_t nitems, void* arg);
+    static int progressCallback(void* clientp, curl_off_t dltotal, curl_off_t dlnow,
+                                curl_off_t ultotal, curl_off_t ulnow);
 };
 
 }  // namespace ktv::services
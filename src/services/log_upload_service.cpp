@@ -1,18 +1,99 @@
 // log_upload_service.cpp
 // LogUploadService 实现
 #include "log_upload_service.h"
-#include "http_service.h"
 #include <syslog.h>
+#include <zlib.h>
 #include <cstdio>
 #include <cstring>
 #include <chrono>
-#include <sstream>
 #include <algorithm>
 #include <ctime>
-#include <thread>
 
 namespace ktv::services {
 
+namespace {
+
+// deflate 内存约 2^(windowBits+2) + 2^(memLevel+9) = 32KB；日志文本重复度高，小窗口压缩率足够
+constexpr int kGzipWindowBits = 12 + 16;   // +16：输出 gzip 封装
+constexpr int kGzipMemLevel = 5;
+
+/**
+ * 把日志环 [begin, end) 区间边格式化边 gzip 压缩，供 curl 读回调按块拉取
+ * 任意时刻只持有一行文本；被覆盖的记录直接跳过，总量仍受 max_bytes 约束
+ */
+class GzipLogSource {
+public:
+    GzipLogSource(const ktv::core::LogRing::Range& range, const char* keyword, size_t max_bytes)
+        : idx_(range.begin), end_(range.end), keyword_(keyword), max_bytes_(max_bytes) {
+        ok_ = deflateInit2(&zs_, Z_DEFAULT_COMPRESSION, Z_DEFLATED, kGzipWindowBits, kGzipMemLevel,
+                           Z_DEFAULT_STRATEGY) == Z_OK;
+    }
+    ~GzipLogSource() {
+        if (ok_) deflateEnd(&zs_);
+    }
+    GzipLogSource(const GzipLogSource&) = delete;
+    GzipLogSource& operator=(const GzipLogSource&) = delete;
+
+    // 返回写入 buf 的字节数；0 结束；-1 出错
+    long read(char* buf, size_t len) {
+        if (!ok_) return -1;
+        if (done_) return 0;
+        zs_.next_out = reinterpret_cast<Bytef*>(buf);
+        zs_.avail_out = static_cast<uInt>(len);
+        while (zs_.avail_out > 0) {
+            int flush = Z_NO_FLUSH;
+            if (zs_.avail_in == 0 && !nextLine()) flush = Z_FINISH;
+            const int rc = deflate(&zs_, flush);
+            if (rc == Z_STREAM_END) {
+                done_ = true;
+                break;
+            }
+            if (rc != Z_OK && rc != Z_BUF_ERROR) return -1;
+        }
+        const size_t n = len - zs_.avail_out;
+        out_bytes_ += n;
+        return static_cast<long>(n);
+    }
+
+    size_t rawBytes() const { return raw_bytes_; }
+    size_t outBytes() const { return out_bytes_; }
+
+private:
+    bool nextLine() {
+        while (idx_ < end_) {
+            if (!ktv::core::LogRing::instance().formatLine(idx_++, keyword_, line_)) continue;
+            if (raw_bytes_ + line_.size() > max_bytes_) {
+                idx_ = end_;
+                break;
+            }
+            raw_bytes_ += line_.size();
+            zs_.next_in = reinterpret_cast<Bytef*>(&line_[0]);
+            zs_.avail_in = static_cast<uInt>(line_.size());
+            return true;
+        }
+        return false;
+    }
+
+    z_stream zs_{};
+    bool ok_ = false;
+    bool done_ = false;
+    uint64_t idx_;
+    uint64_t end_;
+    const char* keyword_;
+    size_t max_bytes_;
+    std::string line_;
+    size_t raw_bytes_ = 0;
+    size_t out_bytes_ = 0;
+};
+
+long uptime_seconds() {
+    timespec ts{};
+    clock_gettime(CLOCK_BOOTTIME, &ts);
+    return static_cast<long>(ts.tv_sec);
+}
+
+}  // namespace
+
 LogUploadService& LogUploadService::instance() {
     static LogUploadService inst;
     return inst;
@@ -41,10 +122,10 @@ void LogUploadService::start() {
     if (running_.exchange(true)) {
         return;  // 已经启动
     }
+    serial_.reopen();
     
-    worker_ = std::thread([this] {
-        threadLoop();
-    });
+    // 启动前已触发的上传
+    scheduleNextStep();
     
     syslog(LOG_INFO, "[ktv][log] LogUploadService started");
 }
@@ -54,15 +135,8 @@ void LogUploadService::stop() {
         return;  // 已经停止
     }
     
-    // 唤醒等待的线程
-    {
-        std::lock_guard<std::mutex> lock(queue_mtx_);
-        queue_cv_.notify_all();
-    }
-    
-    if (worker_.joinable()) {
-        worker_.join();
-    }
+    ktv::core::Executor::instance().cancel(backoff_timer_.exchange(0));
+    serial_.shutdown();
     
     syslog(LOG_INFO, "[ktv][log] LogUploadService stopped");
 }
@@ -87,7 +161,9 @@ void LogUploadService::notify(UploadReason reason) {
         last_trigger_time_ = now;
     }
     
-    queue_cv_.notify_one();
+    if (running_) {
+        serial_.post([this] { step(); });
+    }
     syslog(LOG_INFO, "[ktv][log] upload triggered, reason=%d", (int)reason);
 }
 
@@ -111,209 +187,168 @@ bool LogUploadService::exportToFile(const char* path) {
     return true;
 }
 
-void LogUploadService::threadLoop() {
-    while (running_) {
-        // 状态机主循环
-        {
-            std::lock_guard<std::mutex> lock(state_mtx_);
-            switch (state_) {
-            case State::IDLE:
-                handleIdle();
-                break;
-            case State::COLLECTING:
-                handleCollecting();
-                break;
-            case State::PACKING:
-                handlePacking();
-                break;
-            case State::UPLOADING:
-                handleUploading();
-                break;
-            case State::BACKOFF:
-                handleBackoff();
-                break;
-            }
+void LogUploadService::step() {
+    if (!running_) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(state_mtx_);
+        if (state_ == State::BACKOFF && backoff_timer_.load() != 0) {
+            // notify() 投递的步骤落在退避期内：触发已入队，不提前重试，也不重设定时器
+            syslog(LOG_DEBUG, "[ktv][log] trigger deferred until backoff expires");
+            return;
+        }
+        switch (state_) {
+        case State::IDLE:
+            handleIdle();
+            break;
+        case State::COLLECTING:
+            handleCollecting();
+            break;
+        case State::PACKING:
+            handlePacking();
+            break;
+        case State::UPLOADING:
+            handleUploading();
+            break;
+        case State::BACKOFF:
+            handleBackoff();
+            break;
         }
-        
-        // 短暂休眠，避免 CPU 占用过高
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
     }
+    scheduleNextStep();
 }
 
-void LogUploadService::handleIdle() {
-    // 检查是否有任务
+void LogUploadService::scheduleNextStep() {
+    if (!running_) {
+        return;
+    }
+    State state;
+    int backoff_seconds = 0;
     {
-        std::unique_lock<std::mutex> lock(queue_mtx_);
+        std::lock_guard<std::mutex> lock(state_mtx_);
+        state = state_;
+        backoff_seconds = backoff_seconds_;
+    }
+
+    switch (state) {
+    case State::IDLE: {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
         if (task_queue_.empty()) {
-            // 等待任务或超时
-            queue_cv_.wait_for(lock, std::chrono::seconds(1));
-            if (task_queue_.empty()) {
-                return;  // 无任务，继续等待
-            }
+            return;  // 无任务：不占用线程，等待 notify()
         }
-        
-        // 有任务，进入 COLLECTING
-        state_ = State::COLLECTING;
+        break;
     }
+    case State::BACKOFF: {
+        // 退避期间不轮询：到期后再投递下一步
+        auto id = ktv::core::Executor::instance().schedule(
+            ktv::core::Lane::Upload, std::chrono::seconds(backoff_seconds), [this] {
+                backoff_timer_ = 0;
+                serial_.post([this] { step(); });
+            });
+        ktv::core::Executor::instance().cancel(backoff_timer_.exchange(id));
+        return;
+    }
+    default:
+        break;
+    }
+    serial_.post([this] { step(); });
 }
 
-void LogUploadService::handleCollecting() {
-    std::string logs;
-    if (!collectLogs(logs)) {
-        syslog(LOG_ERR, "[ktv][log] collect logs failed");
-        state_ = State::IDLE;
-        return;
+void LogUploadService::handleIdle() {
+    // 合并所有待处理的触发，一次上传即可覆盖
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        if (task_queue_.empty()) {
+            return;
+        }
+        std::queue<UploadReason>().swap(task_queue_);
     }
     
-    if (logs.empty()) {
+    // 有任务，进入 COLLECTING
+    state_ = State::COLLECTING;
+}
+
+void LogUploadService::handleCollecting() {
+    // 只确定要上传的记录区间，文本在上传时才逐行生成
+    collected_range_ = ktv::core::LogRing::instance().recent(config_.max_bytes, config_.max_lines,
+                                                             config_.include_keyword);
+    if (collected_range_.lines == 0) {
         syslog(LOG_INFO, "[ktv][log] no logs to upload");
         state_ = State::IDLE;
         return;
     }
     
-    // 保存日志，进入 PACKING
-    collected_logs_ = std::move(logs);
+    // 保存区间，进入 PACKING
     state_ = State::PACKING;
 }
 
 void LogUploadService::handlePacking() {
-    std::string payload = buildPayload(collected_logs_);
-    if (payload.empty()) {
-        syslog(LOG_ERR, "[ktv][log] build payload failed");
-        state_ = State::IDLE;
-        return;
-    }
-    
-    // 保存 payload，进入 UPLOADING
-    upload_payload_ = std::move(payload);
+    // multipart 的元数据字段；日志文件字段在每次上传时重新生成数据源
+    const long now = static_cast<long>(std::time(nullptr));
+    upload_fields_.clear();
+    upload_fields_.push_back({"device_id", device_id_, "", "", nullptr});
+    upload_fields_.push_back({"fw_version", fw_version_, "", "", nullptr});
+    upload_fields_.push_back({"uptime", std::to_string(uptime_seconds()), "", "", nullptr});
+    upload_fields_.push_back({"lines", std::to_string(collected_range_.lines), "", "", nullptr});
+    upload_filename_ = "ktv_" + device_id_ + "_" + std::to_string(now) + ".log.gz";
     state_ = State::UPLOADING;
 }
 
 void LogUploadService::handleUploading() {
-    if (!uploadLogs(upload_payload_)) {
-        syslog(LOG_ERR, "[ktv][log] upload failed");
-        enterBackoff();
+    if (!uploadLogs()) {
+        if (retries_ < config_.max_retries) {
+            ++retries_;
+            syslog(LOG_ERR, "[ktv][log] upload failed, retry=%d", retries_);
+            enterBackoff();
+            return;
+        }
+        syslog(LOG_ERR, "[ktv][log] upload failed, give up after %d retries", retries_);
+        retries_ = 0;
+        backoff_seconds_ = 0;
+        collected_range_ = {};
+        upload_fields_.clear();
+        state_ = State::IDLE;
         return;
     }
+    retries_ = 0;
+    backoff_seconds_ = 0;
     
     syslog(LOG_INFO, "[ktv][log] upload success");
     
     // 清理
-    collected_logs_.clear();
-    upload_payload_.clear();
+    collected_range_ = {};
+    upload_fields_.clear();
     
     // 回到 IDLE
     state_ = State::IDLE;
 }
 
 void LogUploadService::handleBackoff() {
-    auto now = std::chrono::steady_clock::now();
-    if (now < backoff_until_) {
-        // 还在退避期，继续等待
-        return;
-    }
-    
-    // 退避期结束，回到 IDLE
+    // 只会在退避定时器到期后执行：按同一区间重新流式上传（期间被覆盖的记录会缺失）
     exitBackoff();
-    state_ = State::IDLE;
+    state_ = State::UPLOADING;
 }
 
 bool LogUploadService::collectLogs(std::string& out) {
-    out.clear();
-    
-    FILE* fp = popen("logread", "r");
-    if (!fp) {
-        return false;
-    }
-    
-    char line[512];
-    size_t lines = 0;
-    
-    while (fgets(line, sizeof(line), fp)) {
-        // 过滤关键词
-        if (config_.include_keyword && 
-            std::strstr(line, config_.include_keyword) == nullptr) {
-            continue;
-        }
-        
-        size_t len = std::strlen(line);
-        
-        // 检查字节上限
-        if (out.size() + len > config_.max_bytes) {
-            out.append("[ktv][log][truncate] reason=max_bytes\n");
-            break;
-        }
-        
-        out.append(line);
-        lines++;
-        
-        // 检查行数上限
-        if (lines >= config_.max_lines) {
-            out.append("[ktv][log][truncate] reason=max_lines\n");
-            break;
-        }
-    }
-    
-    int ret = pclose(fp);
-    if (ret != 0) {
-        return false;
-    }
-    
+    // 直接取进程内日志环的快照（最近的记录优先），不再 popen("logread")
+    out = ktv::core::LogRing::instance().snapshot(config_.max_bytes, config_.max_lines, config_.include_keyword);
     return true;
 }
 
-std::string LogUploadService::buildPayload(const std::string& logs) {
-    // JSON 转义函数
-    auto escapeJson = [](const std::string& s) -> std::string {
-        std::string o;
-        o.reserve(s.size() + 64);
-        for (char c : s) {
-            switch (c) {
-            case '\\': o += "\\\\"; break;
-            case '"':  o += "\\\""; break;
-            case '\n': o += "\\n";  break;
-            case '\r': o += "\\r";  break;
-            case '\t': o += "\\t";  break;
-            default:   o += c;      break;
-            }
-        }
-        return o;
-    };
-    
-    // 计算运行时间（简化实现：使用当前时间戳）
-    // TODO: 从系统获取真实 uptime（/proc/uptime）
-    long uptime_sec = std::time(nullptr);  // 临时使用时间戳
-    
-    // 构建 JSON
-    std::ostringstream oss;
-    oss << "{"
-        << "\"device_id\":\"" << device_id_ << "\","
-        << "\"fw_version\":\"" << fw_version_ << "\","
-        << "\"uptime\":" << uptime_sec << ","
-        << "\"logs\":\"" << escapeJson(logs) << "\""
-        << "}";
-    
-    return oss.str();
-}
+bool LogUploadService::uploadLogs() {
+    // 每次尝试新建压缩流：重试时从区间开头重新生成
+    GzipLogSource source(collected_range_, config_.include_keyword, config_.max_bytes);
+    std::vector<MultipartField> fields = upload_fields_;
+    fields.push_back({"file", "", upload_filename_, "application/gzip",
+                      [&source](char* buf, size_t len) { return source.read(buf, len); }});
 
-bool LogUploadService::uploadLogs(const std::string& payload) {
-    // 使用 HttpService 上传
     HttpResponse response;
-    bool success = HttpService::getInstance().post(
-        "/api/logs/upload", 
-        payload.c_str(), 
-        response);
-    
-    if (!success) {
-        return false;
-    }
-    
-    // 检查响应状态码
-    if (response.status_code != 200) {
-        return false;
-    }
-    
-    return true;
+    const bool success = HttpService::getInstance().postMultipart("/karaoke_sdk/log/upload", fields, response,
+                                                                  config_.upload_timeout_sec);
+    syslog(LOG_INFO, "[ktv][log] upload status=%ld raw=%zu gz=%zu",
+           response.status_code, source.rawBytes(), source.outBytes());
+    return success && response.status_code == 200;
 }
 
 void LogUploadService::enterBackoff() {
@@ -324,15 +359,12 @@ void LogUploadService::enterBackoff() {
         backoff_seconds_ = std::min(backoff_seconds_ * 3, 60);
     }
     
-    backoff_until_ = std::chrono::steady_clock::now() + 
-                     std::chrono::seconds(backoff_seconds_);
-    
     syslog(LOG_WARNING, "[ktv][log] enter backoff, seconds=%d", backoff_seconds_);
     state_ = State::BACKOFF;
 }
 
 void LogUploadService::exitBackoff() {
-    backoff_seconds_ = 0;
+    // backoff_seconds_ 保留到上传成功/放弃时清零，保证退避时长递增
     syslog(LOG_INFO, "[ktv][log] exit backoff");
 }
 
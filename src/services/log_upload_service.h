@@ -3,11 +3,14 @@
 #pragma once
 
 #include <string>
-#include <thread>
 #include <atomic>
+#include <chrono>
 #include <queue>
 #include <mutex>
-#include <condition_variable>
+#include <vector>
+#include "../core/executor.h"
+#include "../core/log_ring.h"
+#include "http_service.h"
 
 namespace ktv::services {
 
@@ -26,15 +29,17 @@ enum class UploadReason {
  * LogUploadService - 日志上传服务
  * 
  * 设计原则：
- * 1. 独立后台线程（低优先级）
+ * 1. 运行在共享线程池 Upload Lane（最低优先级，不自建线程；上传阻塞数秒也不影响 Background 上的日志排空/搜索/图片解码）
  * 2. 按需触发，不实时上传
- * 3. 数据上限保护（256KB/2000行）
+ * 3. 数据上限保护（256KB/2000行），gzip 流式压缩后以 multipart 分块上传，
+ *    不在内存里拼完整日志/请求体（峰值约为 zlib 状态 + 一行日志）
  * 4. 失败进入 backoff（指数退避）
  * 5. 不影响 UI/播放
  * 
  * 使用方式：
  * - 各模块只调用 Notify(reason)，不传日志内容
- * - 服务线程负责 logread 抓取、过滤、打包、上传
+ * - 服务线程负责从日志环（core/log_ring.h）取快照、过滤、打包、上传
+ *   （main.cpp 启动/退出阶段、Executor 与本服务自身仍直接写 syslog，不在快照内）
  */
 class LogUploadService {
 public:
@@ -45,17 +50,18 @@ public:
     LogUploadService& operator=(const LogUploadService&) = delete;
     
     /**
-     * 启动服务线程
+     * 启动服务（开始接受上传请求）
      */
     void start();
     
     /**
-     * 停止服务线程
+     * 停止服务（取消退避定时器，等待当前步骤结束）
      */
     void stop();
     
     /**
      * 通知上传（非阻塞）
+     * 退避期间只入队，不提前唤醒：退避到期后的重试上传会覆盖这次触发
      * @param reason 上传原因
      */
     void notify(UploadReason reason);
@@ -71,8 +77,10 @@ private:
     LogUploadService();
     ~LogUploadService();
     
-    // 线程主循环
-    void threadLoop();
+    // 状态机单步执行（Upload Lane，串行）
+    void step();
+    // 投递下一步；BACKOFF 状态改为延时投递
+    void scheduleNextStep();
     
     // 状态机
     enum class State {
@@ -92,8 +100,7 @@ private:
     
     // 辅助函数
     bool collectLogs(std::string& out);
-    std::string buildPayload(const std::string& logs);
-    bool uploadLogs(const std::string& payload);
+    bool uploadLogs();
     void enterBackoff();
     void exitBackoff();
     
@@ -110,14 +117,14 @@ private:
     std::string device_id_;
     std::string fw_version_;
     
-    // 线程控制
-    std::thread worker_;
+    // 执行控制：状态机每一步作为一个任务串行执行
     std::atomic<bool> running_{false};
+    ktv::core::SerialQueue serial_{ktv::core::Lane::Upload, 4};
+    std::atomic<ktv::core::TaskId> backoff_timer_{0};   // 非 0 表示退避尚未到期
     
     // 任务队列
     std::queue<UploadReason> task_queue_;
     std::mutex queue_mtx_;
-    std::condition_variable queue_cv_;
     
     // 状态机
     State state_{State::IDLE};
@@ -125,15 +132,16 @@ private:
     
     // Backoff 控制
     int backoff_seconds_{0};
-    std::chrono::steady_clock::time_point backoff_until_;
+    int retries_{0};
     
     // 触发合并（10分钟内多次触发合并为一次）
     std::chrono::steady_clock::time_point last_trigger_time_;
     static constexpr int TRIGGER_MERGE_SECONDS = 600;  // 10分钟
     
     // 状态机临时数据
-    std::string collected_logs_;   // COLLECTING -> PACKING 传递
-    std::string upload_payload_;   // PACKING -> UPLOADING 传递
+    ktv::core::LogRing::Range collected_range_;    // COLLECTING -> PACKING 传递（只记序号区间）
+    std::vector<MultipartField> upload_fields_;    // PACKING -> UPLOADING 传递（不含日志文件字段）
+    std::string upload_filename_;
 };
 
 }  // namespace ktv::services
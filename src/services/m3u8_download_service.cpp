@@ -1,74 +1,817 @@
 #include "m3u8_download_service.h"
-#include <syslog.h>
+#include "../utils/json_escape.h"
+#include "../utils/log_macros.h"
 #include "../events/event_bus.h"
+#include "../core/executor.h"
+#include <algorithm>
+#include <cerrno>
 #include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <cmath>
+#include <sys/stat.h>
+#include <sys/types.h>
 
 namespace ktv::services {
 
+// playlist 文本上限（防止异常响应撑爆内存）
+static constexpr size_t kMaxPlaylistBytes = 256 * 1024;
+// 进度事件最小间隔（每个任务），避免刷屏 UI 事件队列
+static constexpr long kProgressEmitIntervalMs = 500;
+// 吞吐采样窗口与平滑系数
+static constexpr long kThroughputSampleMs = 250;
+static constexpr double kThroughputAlpha = 0.3;
+
+static uint64_t fnv1a64(const std::string& s) {
+    uint64_t h = 1469598103934665603ULL;
+    for (unsigned char c : s) {
+        h ^= c;
+        h *= 1099511628211ULL;
+    }
+    return h;
+}
+
+static bool file_exists(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0;
+}
+
+static bool make_dirs(const std::string& path) {
+    std::string cur;
+    for (size_t i = 0; i < path.size(); ++i) {
+        cur += path[i];
+        if ((path[i] == '/' && i > 0) || i + 1 == path.size()) {
+            if (::mkdir(cur.c_str(), 0755) != 0 && errno != EEXIST) {
+                return false;
+            }
+        }
+    }
+    return true;
+}
+
+static long ms_between(std::chrono::steady_clock::time_point a, std::chrono::steady_clock::time_point b) {
+    return static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(b - a).count());
+}
+
+static DownloadFailure classify_curl(CURLcode res, long status) {
+    if (res == CURLE_OPERATION_TIMEDOUT) return DownloadFailure::Timeout;
+    if (res == CURLE_WRITE_ERROR) return DownloadFailure::Disk;
+    if (res != CURLE_OK) return DownloadFailure::Network;
+    return status != 200 ? DownloadFailure::HttpStatus : DownloadFailure::Network;
+}
+
+static bool write_text_file(const std::string& path, const std::string& text) {
+    std::string tmp = path + ".part";
+    FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) return false;
+    size_t n = std::fwrite(text.data(), 1, text.size(), fp);
+    std::fclose(fp);
+    if (n != text.size()) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return std::rename(tmp.c_str(), path.c_str()) == 0;
+}
+
+void M3u8DownloadService::setCacheConfig(const ktv::config::CacheConfig& cfg) {
+    cache_cfg_ = cfg;
+    store_.setRoot(cfg.root);
+}
+
 bool M3u8DownloadService::initialize() {
-    ensureThreadStarted();
+    if (!make_dirs(cache_cfg_.root)) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][init] cache_root=%s reason=mkdir_failed", cache_cfg_.root.c_str());
+    }
+    running_ = true;
+    std::lock_guard<std::mutex> lock(mtx_);
+    // 启动时先做一次对象回收；initialize 之前入队的任务也在这里开始执行
+    schedulePumpLocked();
     return true;
 }
 
 void M3u8DownloadService::cleanup() {
-    stopThread();
+    if (!running_.exchange(false)) {
+        return;
+    }
+    {
+        // 正在执行的任务通过 xferinfo 回调中止传输，这里等待它退出
+        std::unique_lock<std::mutex> lock(mtx_);
+        if (!cv_.wait_for(lock, std::chrono::seconds(10), [this] { return !pump_scheduled_; })) {
+            KTV_SYSLOG(LOG_ERR, "[ktv][download][stop] reason=wait_timeout");
+            return;   // 任务仍可能引用 curl_，不释放
+        }
+    }
+    if (curl_) {
+        curl_easy_cleanup(curl_);
+        curl_ = nullptr;
+    }
+    KTV_SYSLOG(LOG_INFO, "[ktv][download][stop] status=stopped");
+}
+
+std::string M3u8DownloadService::songDirName(const std::string& song_id) {
+    char name[32]{0};
+    std::snprintf(name, sizeof(name), "%016llx", static_cast<unsigned long long>(fnv1a64(song_id)));
+    return name;
+}
+
+bool M3u8DownloadService::isCached(const std::string& song_id, int head_seconds) const {
+    std::string dir = songDir(song_id);
+    if (file_exists(dir + "/.complete")) return true;
+    if (head_seconds <= 0) return false;
+
+    FILE* fp = std::fopen((dir + "/.head").c_str(), "r");
+    if (!fp) return false;
+    int cached = 0;
+    if (std::fscanf(fp, "%d", &cached) != 1) cached = 0;
+    std::fclose(fp);
+    return cached >= head_seconds;
 }
 
 void M3u8DownloadService::startDownload(const std::string& song_id, const std::string& m3u8_url) {
-    // MVP 简化：下载线程串行处理下载任务
-    ensureThreadStarted();
+    // 下载任务在 Download Lane 上串行执行
     {
         std::lock_guard<std::mutex> lock(mtx_);
-        queue_.push(Task{song_id, m3u8_url});
+        // 完整下载覆盖同一首歌的预取任务
+        for (auto it = prefetch_queue_.begin(); it != prefetch_queue_.end(); ++it) {
+            if (it->song_id == song_id) {
+                prefetch_queue_.erase(it);
+                pending_.erase(song_id);
+                break;
+            }
+        }
+        queue_.push(Task{song_id, m3u8_url, 0, false});
+        pending_.insert(song_id);
+        schedulePumpLocked();
     }
-    cv_.notify_one();
-    syslog(LOG_INFO, "[ktv][download][enqueue] song_id=%s url=%s", song_id.c_str(), m3u8_url.c_str());
+    KTV_SYSLOG(LOG_INFO, "[ktv][download][enqueue] song_id=%s url=%s", song_id.c_str(), m3u8_url.c_str());
 }
 
-void M3u8DownloadService::ensureThreadStarted() {
-    bool expected = false;
-    if (!running_.compare_exchange_strong(expected, true)) {
-        return; // already running
+bool M3u8DownloadService::prefetch(const std::string& song_id, const std::string& m3u8_url, int head_seconds) {
+    if (song_id.empty() || m3u8_url.empty() || head_seconds <= 0) return false;
+    if (isCached(song_id, head_seconds)) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (pending_.count(song_id)) return false;
+        prefetch_queue_.push_back(Task{song_id, m3u8_url, head_seconds, true});
+        pending_.insert(song_id);
+        schedulePumpLocked();
     }
-    worker_ = std::thread([this] { threadLoop(); });
-    syslog(LOG_INFO, "[ktv][download][thread] status=started");
+    KTV_SYSLOG(LOG_INFO, "[ktv][download][prefetch_enqueue] song_id=%s head_seconds=%d", song_id.c_str(), head_seconds);
+    return true;
 }
 
-void M3u8DownloadService::stopThread() {
-    bool expected = true;
-    if (!running_.compare_exchange_strong(expected, false)) {
-        return; // not running
+bool M3u8DownloadService::verifyBeforePlay(const std::string& song_id) {
+    // 调用方通常是 UI 线程：这里不碰文件系统，没有缓存的歌曲由 runVerify 在下载线程直接跳过
+    if (!cache_cfg_.verify_on_play || song_id.empty()) return false;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        // 插到正常下载之前：std::queue 不支持插队，重建一次（队列很短）
+        std::queue<Task> reordered;
+        Task t;
+        t.song_id = song_id;
+        t.verify = true;
+        reordered.push(std::move(t));
+        while (!queue_.empty()) {
+            reordered.push(std::move(queue_.front()));
+            queue_.pop();
+        }
+        queue_.swap(reordered);
+        schedulePumpLocked();
     }
-    cv_.notify_all();
-    if (worker_.joinable()) {
-        worker_.join();
+    return true;
+}
+
+void M3u8DownloadService::enforceBudget(const std::string& just_done) {
+    if (cache_cfg_.budget_mb <= 0) return;
+    std::unordered_set<std::string> keep{songDirName(just_done)};
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        for (const auto& id : pending_) keep.insert(songDirName(id));
+    }
+    uint64_t freed = 0;
+    size_t evicted = store_.evictToBudget(static_cast<uint64_t>(cache_cfg_.budget_mb) * 1024 * 1024, keep, &freed);
+    if (evicted > 0) {
+        KTV_SYSLOG(LOG_INFO, "[ktv][download][evict] after=%s songs=%zu freed_bytes=%llu", just_done.c_str(), evicted,
+                   static_cast<unsigned long long>(freed));
+    }
+}
+
+bool M3u8DownloadService::hasForegroundTask() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return !queue_.empty();
+}
+
+void M3u8DownloadService::schedulePumpLocked() {
+    if (!running_ || pump_scheduled_) return;
+    pump_scheduled_ = true;
+    if (!ktv::core::Executor::instance().post(ktv::core::Lane::Download, [this] { pumpOnce(); })) {
+        pump_scheduled_ = false;
+        KTV_SYSLOG(LOG_ERR, "[ktv][download][pump] reason=executor_rejected");
     }
-    syslog(LOG_INFO, "[ktv][download][thread] status=stopped");
 }
 
-void M3u8DownloadService::threadLoop() {
-    while (running_) {
-        Task task;
-        {
-            std::unique_lock<std::mutex> lock(mtx_);
-            cv_.wait(lock, [this] { return !running_ || !queue_.empty(); });
-            if (!running_) break;
+void M3u8DownloadService::pumpOnce() {
+    // 每次只执行一个任务，执行完重新投递：预取任务可在片段边界让出给新到的正常下载
+    if (!curl_) {
+        curl_ = curl_easy_init();
+        if (!curl_) {
+            KTV_SYSLOG(LOG_ERR, "[ktv][download][pump] reason=curl_init_failed");
+        }
+    }
+    if (!store_ready_) {
+        // 首次运行时回收孤儿对象（歌曲目录被删除 / playlist 更新后遗留的片段）
+        store_ready_ = true;
+        if (store_.initialize()) {
+            store_.collectGarbage();
+        }
+    }
+
+    Task task;
+    bool has_task = false;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (running_ && !queue_.empty()) {
             task = std::move(queue_.front());
             queue_.pop();
+            has_task = true;
+        } else if (running_ && !prefetch_queue_.empty()) {
+            task = std::move(prefetch_queue_.front());
+            prefetch_queue_.pop_front();
+            has_task = true;
         }
+    }
+    if (has_task) {
+        processTask(task);
+    }
+
+    std::lock_guard<std::mutex> lock(mtx_);
+    pump_scheduled_ = false;
+    if (running_ && (!queue_.empty() || !prefetch_queue_.empty())) {
+        schedulePumpLocked();
+    }
+    cv_.notify_all();
+}
+
+void M3u8DownloadService::processTask(Task& task) {
+    if (task.verify) {
+        runVerify(task);
+        return;
+    }
+
+    const char* kind = task.prefetch ? "prefetch" : "full";
+    KTV_SYSLOG(LOG_INFO, "[ktv][download][start] song_id=%s kind=%s", task.song_id.c_str(), kind);
+    auto t0 = std::chrono::steady_clock::now();
+    last_failure_ = DownloadFailure::Network;
+    RunResult result = curl_ ? runTask(task) : RunResult::Failed;
+    endProgress(result);
+    long cost_ms = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+
+    if (result == RunResult::Yielded) {
+        // 已下载的片段会被跳过，重新入队即可从断点继续
+        std::lock_guard<std::mutex> lock(mtx_);
+        KTV_SYSLOG(LOG_INFO, "[ktv][download][yield] song_id=%s", task.song_id.c_str());
+        prefetch_queue_.push_front(std::move(task));
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        pending_.erase(task.song_id);
+    }
 
-        // TODO: 真实实现：下载 m3u8、解析 ts 列表、顺序下载 ts、写入缓存目录
-        // MVP阶段：先用模拟流程验证“DownloadThread → EventBus → UI主线程”闭环
-        syslog(LOG_INFO, "[ktv][download][start] song_id=%s", task.song_id.c_str());
-        std::this_thread::sleep_for(std::chrono::milliseconds(100));
+    if (result == RunResult::Failed) {
+        if (running_) recordFailure(last_failure_);
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][failed] song_id=%s kind=%s cause=%s cost_ms=%ld",
+                   task.song_id.c_str(), kind, failureName(last_failure_), cost_ms);
+        return;
+    }
 
+    DownloadStats stats = getStats();
+    KTV_SYSLOG(LOG_INFO, "[ktv][download][done] song_id=%s kind=%s cost_ms=%ld avg_mbps=%.2f queue=%zu prefetch_queue=%zu",
+               task.song_id.c_str(), kind, cost_ms, stats.avg_mbps, stats.queue_depth, stats.prefetch_depth);
+    if (!task.prefetch) {
         ktv::events::Event ev;
         ev.type = ktv::events::EventType::DownloadCompleted;
         ev.payload = task.song_id;
         ktv::events::EventBus::getInstance().publish(ev);
-        syslog(LOG_INFO, "[ktv][download][done] song_id=%s status=mock", task.song_id.c_str());
     }
+    enforceBudget(task.song_id);
 }
 
-}  // namespace ktv::services
+M3u8DownloadService::RunResult M3u8DownloadService::runTask(const Task& task) {
+    std::string dir = songDir(task.song_id);
+    if (!make_dirs(dir)) {
+        KTV_SYSLOG(LOG_ERR, "[ktv][download][error] song_id=%s reason=mkdir_failed dir=%s",
+                   task.song_id.c_str(), dir.c_str());
+        last_failure_ = DownloadFailure::Disk;
+        return RunResult::Failed;
+    }
+    // 起播时的完整下载也会走到这里（已缓存的歌曲只刷新 playlist），顺便作为 LRU 的"最近使用"
+    SegmentStore::touchSong(dir);
+
+    std::string text;
+    std::string media_url;
+    if (!fetchPlaylist(task.m3u8_url, text, media_url)) {
+        return RunResult::Failed;
+    }
+
+    std::vector<Segment> segments;
+    if (!parseMediaPlaylist(text, media_url, segments) || segments.empty()) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][error] song_id=%s reason=playlist_unsupported", task.song_id.c_str());
+        last_failure_ = DownloadFailure::Playlist;
+        return RunResult::Failed;
+    }
+    write_text_file(dir + "/playlist.m3u8", text);
+
+    // 确定需要下载的片段数：预取只取覆盖 head_seconds 的前几个片段
+    size_t wanted = segments.size();
+    if (task.head_seconds > 0) {
+        double acc = 0.0;
+        wanted = 0;
+        while (wanted < segments.size() && acc < task.head_seconds) {
+            acc += segments[wanted].duration;
+            ++wanted;
+        }
+    }
+
+    // manifest 记录已缓存的前缀片段；playlist 地址变化说明内容已更新，重新开始
+    SegmentStore::Manifest manifest;
+    SegmentStore::loadManifest(dir, manifest);
+    if (manifest.media_url != media_url) {
+        manifest.entries.clear();
+        manifest.media_url = media_url;
+    }
+    if (manifest.entries.size() > segments.size()) {
+        manifest.entries.resize(segments.size());
+    }
+    for (size_t i = 0; i < manifest.entries.size(); ++i) {
+        if (!store_.exists(manifest.entries[i])) {
+            manifest.entries.resize(i);
+            break;
+        }
+    }
+
+    uint64_t cached_bytes = 0;
+    for (const auto& e : manifest.entries) cached_bytes += e.size;
+    beginProgress(task, wanted, std::min(manifest.entries.size(), wanted), cached_bytes);
+
+    size_t deduped_count = 0;
+    RunResult result = RunResult::Done;
+    for (size_t i = manifest.entries.size(); i < wanted; ++i) {
+        if (!running_) {
+            result = RunResult::Failed;
+            break;
+        }
+        if (task.prefetch && hasForegroundTask()) {
+            result = RunResult::Yielded;
+            break;
+        }
+
+        SegmentStore::Entry entry;
+        bool deduped = false;
+        if (!fetchSegment(segments[i].url, task.prefetch, entry, deduped)) {
+            KTV_SYSLOG(LOG_WARNING, "[ktv][download][error] song_id=%s reason=segment_failed index=%zu",
+                       task.song_id.c_str(), i);
+            result = RunResult::Failed;
+            break;
+        }
+        if (deduped) ++deduped_count;
+        onSegmentDone(entry.size);
+        manifest.entries.push_back(entry);
+        SegmentStore::saveManifest(dir, manifest);
+    }
+
+    writeLocalState(dir, segments, manifest);
+    if (deduped_count > 0) {
+        KTV_SYSLOG(LOG_INFO, "[ktv][download][dedup] song_id=%s segments=%zu", task.song_id.c_str(), deduped_count);
+    }
+    return result;
+}
+
+M3u8DownloadService::RunResult M3u8DownloadService::runVerify(const Task& task) {
+    std::string dir = songDir(task.song_id);
+    SegmentStore::Manifest manifest;
+    if (!SegmentStore::loadManifest(dir, manifest) || manifest.entries.empty()) {
+        KTV_SYSLOG(LOG_DEBUG, "[ktv][cache][verify] song_id=%s status=not_cached", task.song_id.c_str());
+        return RunResult::Done;
+    }
+
+    auto t0 = std::chrono::steady_clock::now();
+    size_t total = manifest.entries.size();
+    for (size_t i = 0; i < total; ++i) {
+        if (!running_) return RunResult::Failed;
+        if (store_.verify(manifest.entries[i])) continue;
+
+        // 损坏对象可能被多首歌共用，直接删除；其他歌曲下次下载/校验时自行补齐
+        KTV_SYSLOG(LOG_WARNING, "[ktv][cache][corrupt] song_id=%s index=%zu hash=%s", task.song_id.c_str(), i,
+                   SegmentStore::hashHex(manifest.entries[i].hash).c_str());
+        store_.remove(manifest.entries[i]);
+        manifest.entries.resize(i);
+        break;
+    }
+    long cost_ms = static_cast<long>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - t0).count());
+
+    if (manifest.entries.size() == total) {
+        KTV_SYSLOG(LOG_INFO, "[ktv][cache][verify] song_id=%s segments=%zu status=ok cost_ms=%ld",
+                   task.song_id.c_str(), total, cost_ms);
+        return RunResult::Done;
+    }
+
+    std::vector<Segment> segments;
+    std::string text;
+    FILE* fp = std::fopen((dir + "/playlist.m3u8").c_str(), "rb");
+    if (fp) {
+        char buf[4096];
+        size_t n = 0;
+        while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0 && text.size() < kMaxPlaylistBytes) {
+            text.append(buf, n);
+        }
+        std::fclose(fp);
+    }
+    SegmentStore::saveManifest(dir, manifest);
+    if (parseMediaPlaylist(text, manifest.media_url, segments) && !segments.empty()) {
+        writeLocalState(dir, segments, manifest);
+    } else {
+        // 无法重建 local.m3u8：删除它，播放器回退到在线地址
+        std::remove((dir + "/local.m3u8").c_str());
+        std::remove((dir + "/.complete").c_str());
+        std::remove((dir + "/.head").c_str());
+    }
+    KTV_SYSLOG(LOG_WARNING, "[ktv][cache][verify] song_id=%s segments=%zu valid=%zu status=repaired cost_ms=%ld",
+               task.song_id.c_str(), total, manifest.entries.size(), cost_ms);
+    return RunResult::Failed;
+}
+
+void M3u8DownloadService::writeLocalState(const std::string& dir, const std::vector<Segment>& segments,
+                                          const SegmentStore::Manifest& manifest) {
+    // 生成本地 playlist：已缓存片段指向对象库，其余片段保留远端 URL，
+    // 播放器直接播放 local.m3u8 即可"本地起播 + 远端续播"
+    size_t done = std::min(manifest.entries.size(), segments.size());
+    double target = 0.0;
+    double cached_seconds = 0.0;
+    for (size_t i = 0; i < segments.size(); ++i) {
+        target = std::max(target, segments[i].duration);
+        if (i < done) cached_seconds += segments[i].duration;
+    }
+    std::string local;
+    local.reserve(segments.size() * 96);
+    char line[64]{0};
+    local += "#EXTM3U\n#EXT-X-VERSION:3\n";
+    std::snprintf(line, sizeof(line), "#EXT-X-TARGETDURATION:%d\n", static_cast<int>(std::ceil(target)));
+    local += line;
+    local += "#EXT-X-MEDIA-SEQUENCE:0\n";
+    for (size_t i = 0; i < segments.size(); ++i) {
+        std::snprintf(line, sizeof(line), "#EXTINF:%.3f,\n", segments[i].duration);
+        local += line;
+        local += i < done ? SegmentStore::relativeObjectPath(manifest.entries[i].hash) : segments[i].url;
+        local += '\n';
+    }
+    local += "#EXT-X-ENDLIST\n";
+    write_text_file(dir + "/local.m3u8", local);
+
+    if (done == segments.size()) {
+        write_text_file(dir + "/.complete", "1\n");
+    } else {
+        std::remove((dir + "/.complete").c_str());
+    }
+    if (done > 0) {
+        char head[16]{0};
+        std::snprintf(head, sizeof(head), "%d\n", static_cast<int>(cached_seconds));
+        write_text_file(dir + "/.head", head);
+    } else {
+        std::remove((dir + "/.head").c_str());
+    }
+}
+
+bool M3u8DownloadService::fetchPlaylist(const std::string& url, std::string& out_text, std::string& out_url) {
+    if (!fetchToString(url, out_text, kMaxPlaylistBytes)) {
+        return false;
+    }
+    out_url = url;
+
+    // master playlist：取第一个 variant（MVP 不做码率自适应）
+    if (out_text.find("#EXT-X-STREAM-INF") == std::string::npos) {
+        return true;
+    }
+    size_t pos = out_text.find("#EXT-X-STREAM-INF");
+    size_t eol = out_text.find('\n', pos);
+    while (eol != std::string::npos) {
+        size_t start = eol + 1;
+        eol = out_text.find('\n', start);
+        std::string ref = out_text.substr(start, eol == std::string::npos ? std::string::npos : eol - start);
+        while (!ref.empty() && (ref.back() == '\r' || ref.back() == ' ')) ref.pop_back();
+        if (ref.empty() || ref[0] == '#') continue;
+        out_url = resolveUrl(url, ref);
+        return fetchToString(out_url, out_text, kMaxPlaylistBytes);
+    }
+    return false;
+}
+
+bool M3u8DownloadService::parseMediaPlaylist(const std::string& text, const std::string& base_url,
+                                             std::vector<Segment>& out) {
+    out.clear();
+    double pending_duration = -1.0;
+    size_t pos = 0;
+    while (pos < text.size()) {
+        size_t eol = text.find('\n', pos);
+        if (eol == std::string::npos) eol = text.size();
+        std::string line = text.substr(pos, eol - pos);
+        pos = eol + 1;
+        while (!line.empty() && (line.back() == '\r' || line.back() == ' ')) line.pop_back();
+        if (line.empty()) continue;
+
+        if (line.compare(0, 8, "#EXTINF:") == 0) {
+            pending_duration = std::atof(line.c_str() + 8);
+        } else if (line.compare(0, 11, "#EXT-X-KEY:") == 0 && line.find("METHOD=NONE") == std::string::npos) {
+            // 加密流无法改写为本地 playlist，交给播放器在线播放
+            return false;
+        } else if (line[0] != '#') {
+            if (pending_duration < 0.0) continue;
+            out.push_back(Segment{resolveUrl(base_url, line), pending_duration});
+            pending_duration = -1.0;
+        }
+    }
+    return true;
+}
+
+std::string M3u8DownloadService::resolveUrl(const std::string& base_url, const std::string& ref) {
+    if (ref.find("://") != std::string::npos) return ref;
+    size_t scheme = base_url.find("://");
+    if (!ref.empty() && ref[0] == '/') {
+        size_t host_end = base_url.find('/', scheme == std::string::npos ? 0 : scheme + 3);
+        return base_url.substr(0, host_end) + ref;
+    }
+    size_t query = base_url.find('?');
+    size_t slash = base_url.rfind('/', query);
+    if (slash == std::string::npos) return ref;
+    return base_url.substr(0, slash + 1) + ref;
+}
+
+size_t M3u8DownloadService::writeStringCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    auto* out = static_cast<std::pair<std::string*, size_t>*>(userp);
+    size_t total = size * nmemb;
+    if (out->first->size() + total > out->second) {
+        return 0;  // 超过上限，中止传输
+    }
+    out->first->append(static_cast<const char*>(contents), total);
+    return total;
+}
+
+size_t M3u8DownloadService::writeFileCallback(void* contents, size_t size, size_t nmemb, void* userp) {
+    size_t total = size * nmemb;
+    return static_cast<SegmentStore::Writer*>(userp)->write(contents, total) ? total : 0;
+}
+
+bool M3u8DownloadService::fetchToString(const std::string& url, std::string& out, size_t max_bytes) {
+    out.clear();
+    std::pair<std::string*, size_t> sink{&out, max_bytes};
+    curl_easy_reset(curl_);
+    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT, 10L);
+    curl_easy_setopt(curl_, CURLOPT_TIMEOUT, 15L);
+    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeStringCallback);
+    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &sink);
+
+    CURLcode res = curl_easy_perform(curl_);
+    long status = 0;
+    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status);
+    if (res != CURLE_OK || status != 200) {
+        last_failure_ = classify_curl(res, status);
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][error] action=fetch_playlist curl=%d status=%ld url=%s",
+                   static_cast<int>(res), status, url.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool M3u8DownloadService::fetchSegment(const std::string& url, bool throttled,
+                                       SegmentStore::Entry& out, bool& deduped) {
+    SegmentStore::Writer writer;
+    if (!writer.open(store_.tempPath())) {
+        KTV_SYSLOG(LOG_ERR, "[ktv][download][error] action=open_file path=%s", writer.path().c_str());
+        last_failure_ = DownloadFailure::Disk;
+        return false;
+    }
+
+    curl_easy_reset(curl_);
+    curl_easy_setopt(curl_, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl_, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl_, CURLOPT_CONNECTTIMEOUT, 10L);
+    // 不设总超时：弱网下大片段可能很慢，改用低速检测
+    curl_easy_setopt(curl_, CURLOPT_LOW_SPEED_LIMIT, 1024L);
+    curl_easy_setopt(curl_, CURLOPT_LOW_SPEED_TIME, 15L);
+    curl_easy_setopt(curl_, CURLOPT_WRITEFUNCTION, writeFileCallback);
+    curl_easy_setopt(curl_, CURLOPT_WRITEDATA, &writer);
+    long limit = throttled ? prefetch_rate_limit_.load() : 0;
+    curl_easy_setopt(curl_, CURLOPT_MAX_RECV_SPEED_LARGE, static_cast<curl_off_t>(limit));
+    curl_easy_setopt(curl_, CURLOPT_NOPROGRESS, 0L);
+    curl_easy_setopt(curl_, CURLOPT_XFERINFOFUNCTION, xferInfoCallback);
+    curl_easy_setopt(curl_, CURLOPT_XFERINFODATA, this);
+
+    auto t0 = std::chrono::steady_clock::now();
+    CURLcode res = curl_easy_perform(curl_);
+    double seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - t0).count();
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        stats_.bytes_downloaded += writer.size();
+        transfer_seconds_ += seconds;
+        if (transfer_seconds_ > 0.0) {
+            stats_.avg_mbps = static_cast<double>(stats_.bytes_downloaded) * 8.0 / 1e6 / transfer_seconds_;
+        }
+    }
+    long status = 0;
+    curl_off_t content_length = -1;
+    curl_easy_getinfo(curl_, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_getinfo(curl_, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &content_length);
+    if (res != CURLE_OK || status != 200) {
+        writer.abort();
+        last_failure_ = classify_curl(res, status);
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][error] action=fetch_segment curl=%d status=%ld url=%s",
+                   static_cast<int>(res), status, url.c_str());
+        return false;
+    }
+    // 截断响应（连接中途断开但服务端未报错）
+    if (content_length >= 0 && static_cast<uint64_t>(content_length) != writer.size()) {
+        writer.abort();
+        last_failure_ = DownloadFailure::ShortBody;
+        KTV_SYSLOG(LOG_WARNING, "[ktv][download][error] action=fetch_segment reason=short_body expected=%lld got=%llu url=%s",
+                   static_cast<long long>(content_length), static_cast<unsigned long long>(writer.size()), url.c_str());
+        return false;
+    }
+
+    std::string tmp = writer.path();
+    if (!writer.finish(out.hash, out.size)) {
+        KTV_SYSLOG(LOG_ERR, "[ktv][download][error] action=write_file path=%s", tmp.c_str());
+        last_failure_ = DownloadFailure::Disk;
+        return false;
+    }
+    if (!store_.commit(tmp, out, cache_cfg_.verify_on_download, deduped)) {
+        last_failure_ = DownloadFailure::Integrity;
+        return false;
+    }
+    return true;
+}
+
+int M3u8DownloadService::xferInfoCallback(void* userp, curl_off_t /*dltotal*/, curl_off_t dlnow,
+                                          curl_off_t /*ultotal*/, curl_off_t /*ulnow*/) {
+    auto* self = static_cast<M3u8DownloadService*>(userp);
+    self->onTransferBytes(static_cast<uint64_t>(dlnow));
+    // 退出时中止正在进行的传输，避免 cleanup() 卡在慢速片段上
+    return self->running_ ? 0 : 1;
+}
+
+// ---------------------------------------------------------------------------
+// 进度 / 统计
+// ---------------------------------------------------------------------------
+
+void M3u8DownloadService::beginProgress(const Task& task, size_t total, size_t done, uint64_t done_bytes) {
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        auto now = std::chrono::steady_clock::now();
+        progress_ = DownloadProgress{};
+        progress_.song_id = task.song_id;
+        progress_.prefetch = task.prefetch;
+        progress_.segments_total = total;
+        progress_.segments_done = done;
+        progress_.bytes_done = done_bytes;
+        committed_bytes_ = done_bytes;
+        sample_bytes_ = done_bytes;
+        sample_time_ = now;
+        has_progress_ = true;
+        stats_.active_tasks = 1;
+        payload = progressPayloadLocked(now);
+    }
+    publishProgress(std::move(payload));
+}
+
+void M3u8DownloadService::onTransferBytes(uint64_t segment_bytes) {
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        if (!has_progress_) return;
+        auto now = std::chrono::steady_clock::now();
+        progress_.bytes_done = committed_bytes_ + segment_bytes;
+
+        long dt_ms = ms_between(sample_time_, now);
+        if (dt_ms >= kThroughputSampleMs && progress_.bytes_done >= sample_bytes_) {
+            double inst = static_cast<double>(progress_.bytes_done - sample_bytes_) * 1000.0 / dt_ms;
+            progress_.bytes_per_sec = progress_.bytes_per_sec <= 0.0
+                ? inst : (1.0 - kThroughputAlpha) * progress_.bytes_per_sec + kThroughputAlpha * inst;
+            stats_.current_mbps = progress_.bytes_per_sec * 8.0 / 1e6;
+            sample_bytes_ = progress_.bytes_done;
+            sample_time_ = now;
+        }
+        if (ms_between(last_emit_, now) < kProgressEmitIntervalMs) return;
+        payload = progressPayloadLocked(now);
+    }
+    publishProgress(std::move(payload));
+}
+
+void M3u8DownloadService::onSegmentDone(uint64_t size) {
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        committed_bytes_ += size;
+        progress_.bytes_done = committed_bytes_;
+        ++progress_.segments_done;
+        auto now = std::chrono::steady_clock::now();
+        if (ms_between(last_emit_, now) < kProgressEmitIntervalMs) return;
+        payload = progressPayloadLocked(now);
+    }
+    publishProgress(std::move(payload));
+}
 
+void M3u8DownloadService::endProgress(RunResult result) {
+    std::string payload;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        stats_.active_tasks = 0;
+        if (result == RunResult::Done) ++stats_.tasks_completed;
+        if (!has_progress_) return;
+        // 结束时总是推送一次，保证 UI 看到最终状态
+        has_progress_ = false;
+        const char* state = result == RunResult::Done ? "done" : result == RunResult::Yielded ? "yielded" : "failed";
+        payload = progressPayloadLocked(std::chrono::steady_clock::now(), state);
+    }
+    publishProgress(std::move(payload));
+}
+
+std::string M3u8DownloadService::progressPayloadLocked(std::chrono::steady_clock::time_point now, const char* state) {
+    DownloadProgress& p = progress_;
+    if (p.segments_done > 0) {
+        p.bytes_total = committed_bytes_ / p.segments_done * p.segments_total;
+        if (p.bytes_total < p.bytes_done) p.bytes_total = p.bytes_done;
+    }
+    p.eta_ms = -1;
+    if (p.segments_done >= p.segments_total) {
+        p.eta_ms = 0;
+    } else if (p.bytes_total > 0 && p.bytes_per_sec > 0.0) {
+        p.eta_ms = static_cast<long>(static_cast<double>(p.bytes_total - p.bytes_done) * 1000.0 / p.bytes_per_sec);
+    }
+    last_emit_ = now;
+
+    char buf[512]{0};
+    std::snprintf(buf, sizeof(buf),
+                  "{\"song_id\":\"%s\",\"kind\":\"%s\",\"state\":\"%s\",\"segments_done\":%zu,\"segments_total\":%zu,"
+                  "\"bytes_done\":%llu,\"bytes_total\":%llu,\"bytes_per_sec\":%.0f,\"eta_ms\":%ld}",
+                  ktv::utils::json_escape(p.song_id).c_str(), p.prefetch ? "prefetch" : "full", state,
+                  p.segments_done, p.segments_total,
+                  static_cast<unsigned long long>(p.bytes_done), static_cast<unsigned long long>(p.bytes_total),
+                  p.bytes_per_sec, p.eta_ms);
+    return buf;
+}
+
+void M3u8DownloadService::publishProgress(std::string payload) {
+    // 不在 stats_mtx_ 内发布：EventBus 有自己的锁，且 getProgress()/getStats() 不应被事件队列拖慢
+    ktv::events::Event ev;
+    ev.type = ktv::events::EventType::DownloadProgress;
+    ev.payload = std::move(payload);
+    ktv::events::EventBus::getInstance().publish(ev);
+}
+
+void M3u8DownloadService::recordFailure(DownloadFailure cause) {
+    std::lock_guard<std::mutex> lock(stats_mtx_);
+    ++stats_.failures[static_cast<size_t>(cause)];
+}
+
+bool M3u8DownloadService::getProgress(DownloadProgress& out) const {
+    std::lock_guard<std::mutex> lock(stats_mtx_);
+    if (!has_progress_) return false;
+    out = progress_;
+    return true;
+}
+
+DownloadStats M3u8DownloadService::getStats() const {
+    DownloadStats out;
+    {
+        std::lock_guard<std::mutex> lock(stats_mtx_);
+        out = stats_;
+    }
+    std::lock_guard<std::mutex> lock(mtx_);
+    out.queue_depth = queue_.size();
+    out.prefetch_depth = prefetch_queue_.size();
+    return out;
+}
+
+const char* M3u8DownloadService::failureName(DownloadFailure cause) {
+    switch (cause) {
+        case DownloadFailure::Network: return "network";
+        case DownloadFailure::Timeout: return "timeout";
+        case DownloadFailure::HttpStatus: return "http_status";
+        case DownloadFailure::ShortBody: return "short_body";
+        case DownloadFailure::Integrity: return "integrity";
+        case DownloadFailure::Disk: return "disk";
+        case DownloadFailure::Playlist: return "playlist";
+        case DownloadFailure::Count: break;
+    }
+    return "unknown";
+}
+
+}  // namespace ktv::services
@@ -1,15 +1,59 @@
+
 #ifndef KTVLV_SERVICES_M3U8_DOWNLOAD_SERVICE_H
 #define KTVLV_SERVICES_M3U8_DOWNLOAD_SERVICE_H
 
 #include <string>
+#include <vector>
+#include <deque>
+#include <unordered_set>
 #include <atomic>
+#include <chrono>
+#include <cstdint>
 #include <condition_variable>
 #include <mutex>
 #include <queue>
-#include <thread>
+#include <curl/curl.h>
+#include "segment_store.h"
+#include "../config/config.h"
 
 namespace ktv::services {
 
+// 下载失败原因（统计用）
+enum class DownloadFailure {
+    Network = 0,   // 连接失败 / 传输中断
+    Timeout,       // 低速超时
+    HttpStatus,    // 非 200
+    ShortBody,     // 响应长度与 Content-Length 不符
+    Integrity,     // 片段格式/哈希校验失败
+    Disk,          // 写文件失败
+    Playlist,      // playlist 无法解析或不支持
+    Count,
+};
+
+// 单个任务的进度（DownloadProgress 事件 payload 的结构化形式）
+struct DownloadProgress {
+    std::string song_id;
+    bool prefetch = false;
+    size_t segments_done = 0;
+    size_t segments_total = 0;
+    uint64_t bytes_done = 0;
+    uint64_t bytes_total = 0;   // 按已完成片段的平均大小估算，未知时为 0
+    double bytes_per_sec = 0.0; // 当前吞吐（指数平滑）
+    long eta_ms = -1;           // -1 表示未知
+};
+
+// 全局统计快照
+struct DownloadStats {
+    int active_tasks = 0;
+    size_t queue_depth = 0;      // 正常下载排队数
+    size_t prefetch_depth = 0;   // 预取排队数
+    double avg_mbps = 0.0;       // 累计字节 / 累计传输时间
+    double current_mbps = 0.0;
+    uint64_t bytes_downloaded = 0;
+    uint32_t tasks_completed = 0;
+    uint32_t failures[static_cast<size_t>(DownloadFailure::Count)]{};
+};
+
 class M3u8DownloadService {
 public:
     static M3u8DownloadService& getInstance() {
@@ -20,15 +64,59 @@ public:
     M3u8DownloadService& operator=(const M3u8DownloadService&) = delete;
 
     /**
-     * MVP 简化架构：唯一允许的后台线程（Download Thread）
-     * - 串行执行 m3u8/ts 下载任务
+     * 下载任务在共享线程池的 Download Lane 上串行执行（不再自建线程）
+     * - 正常下载优先，预取在片段边界让出
      * - 通过 EventBus（UiEventQueue）回到 UI 主线程更新状态
+     * - cleanup() 需在 Executor::stop() 之前调用
      */
     bool initialize();
     void cleanup();
 
+    // 缓存配置（根目录 / 校验策略），需在 initialize() 之前设置
+    void setCacheConfig(const ktv::config::CacheConfig& cfg);
+    const std::string& cacheRoot() const { return cache_cfg_.root; }
+
+    // 预取限速（字节/秒），0 表示不限速；正常下载不受限
+    void setPrefetchRateLimit(long bytes_per_sec) { prefetch_rate_limit_ = bytes_per_sec; }
+
+    // 完整下载（点歌播放后触发），优先级高于预取
     void startDownload(const std::string& song_id, const std::string& m3u8_url);
 
+    /**
+     * 预取歌曲开头部分（playlist + 前 head_seconds 秒的 ts 片段）
+     * - 低优先级：有正常下载任务时，预取在片段边界让出
+     * - 已在队列中 / 已缓存的歌曲直接忽略
+     * @return true 已入队；false 已缓存或已在队列中
+     */
+    bool prefetch(const std::string& song_id, const std::string& m3u8_url, int head_seconds);
+
+    // 本地是否已有至少 head_seconds 秒的缓存（0 表示要求完整缓存）
+    bool isCached(const std::string& song_id, int head_seconds = 0) const;
+
+    /**
+     * 播放前校验已缓存片段（verify_on_play 开启时生效）
+     * - 调用线程只入队，不访问文件系统；在下载线程执行，优先于其他任务
+     * - 没有缓存清单的歌曲在下载线程直接跳过
+     * - 损坏片段从对象库删除，local.m3u8 改回远端地址
+     * @return true 已入队（verify_on_play 关闭时返回 false）
+     */
+    bool verifyBeforePlay(const std::string& song_id);
+
+    // 歌曲缓存目录：<cache_root>/<fnv1a64(song_id)>
+    std::string songDir(const std::string& song_id) const { return cache_cfg_.root + "/" + songDirName(song_id); }
+    static std::string songDirName(const std::string& song_id);
+    // 本地起播清单路径（只拼路径，不检查是否存在）
+    std::string localPlaylist(const std::string& song_id) const { return songDir(song_id) + "/local.m3u8"; }
+
+    /**
+     * 进度与统计（任意线程可调用）
+     * - 进度同时以 DownloadProgress 事件推给 UI，每个任务最多 2 次/秒
+     * - getProgress 返回 false 表示当前没有正在下载的任务
+     */
+    bool getProgress(DownloadProgress& out) const;
+    DownloadStats getStats() const;
+    static const char* failureName(DownloadFailure cause);
+
 private:
     M3u8DownloadService() = default;
     ~M3u8DownloadService() = default;
@@ -36,20 +124,82 @@ private:
     struct Task {
         std::string song_id;
         std::string m3u8_url;
+        int head_seconds = 0;  // 0 = 完整下载
+        bool prefetch = false;
+        bool verify = false;   // 仅校验已缓存片段
+    };
+
+    struct Segment {
+        std::string url;
+        double duration = 0.0;
     };
 
-    void ensureThreadStarted();
-    void stopThread();
-    void threadLoop();
+    enum class RunResult {
+        Done,
+        Failed,
+        Yielded,  // 预取任务让出给正常下载，稍后继续
+    };
+
+    void schedulePumpLocked();
+    void pumpOnce();
+    void processTask(Task& task);
+
+    RunResult runTask(const Task& task);
+    RunResult runVerify(const Task& task);
+    bool fetchPlaylist(const std::string& url, std::string& out_text, std::string& out_url);
+    bool fetchToString(const std::string& url, std::string& out, size_t max_bytes);
+    bool fetchSegment(const std::string& url, bool throttled, SegmentStore::Entry& out, bool& deduped);
+    void writeLocalState(const std::string& dir, const std::vector<Segment>& segments,
+                         const SegmentStore::Manifest& manifest);
+    bool hasForegroundTask();
+    // 超出 cache_cfg_.budget_mb 时淘汰最久未用的歌曲，保留排队中与刚完成的歌曲
+    void enforceBudget(const std::string& just_done);
+
+    void beginProgress(const Task& task, size_t total, size_t done, uint64_t done_bytes);
+    void onTransferBytes(uint64_t segment_bytes);
+    void onSegmentDone(uint64_t size);
+    void endProgress(RunResult result);
+    // 在 stats_mtx_ 内生成事件 payload，调用方解锁后再 publishProgress()
+    // state：running 进行中；done/failed/yielded 为任务结束时的最后一条
+    std::string progressPayloadLocked(std::chrono::steady_clock::time_point now, const char* state = "running");
+    void publishProgress(std::string payload);
+    void recordFailure(DownloadFailure cause);
+    static int xferInfoCallback(void* userp, curl_off_t dltotal, curl_off_t dlnow,
+                                curl_off_t ultotal, curl_off_t ulnow);
+
+    static bool parseMediaPlaylist(const std::string& text, const std::string& base_url,
+                                   std::vector<Segment>& out);
+    static std::string resolveUrl(const std::string& base_url, const std::string& ref);
+    static size_t writeStringCallback(void* contents, size_t size, size_t nmemb, void* userp);
+    static size_t writeFileCallback(void* contents, size_t size, size_t nmemb, void* userp);
 
     std::atomic<bool> running_{false};
-    std::thread worker_;
-    std::mutex mtx_;
-    std::condition_variable cv_;
-    std::queue<Task> queue_;
+    bool pump_scheduled_{false};   // Download Lane 上是否已有 pumpOnce（受 mtx_ 保护）
+    bool store_ready_{false};      // 仅 Download Lane 访问
+    mutable std::mutex mtx_;
+    std::condition_variable cv_;        // pumpOnce 退出通知（cleanup 等待）
+    std::queue<Task> queue_;            // 正常下载
+    std::deque<Task> prefetch_queue_;   // 预取（低优先级）
+    std::unordered_set<std::string> pending_;  // 已入队的 song_id（去重）
+
+    ktv::config::CacheConfig cache_cfg_;
+    std::atomic<long> prefetch_rate_limit_{0};
+    CURL* curl_{nullptr};  // 仅下载线程访问
+    SegmentStore store_;   // 仅下载线程访问
+    DownloadFailure last_failure_{DownloadFailure::Network};  // 仅下载线程访问
+
+    // 进度/统计：下载线程写，其他线程读快照
+    mutable std::mutex stats_mtx_;
+    DownloadStats stats_;
+    DownloadProgress progress_;
+    bool has_progress_{false};
+    uint64_t committed_bytes_{0};   // 当前任务已完成片段的字节数
+    uint64_t sample_bytes_{0};
+    double transfer_seconds_{0.0};
+    std::chrono::steady_clock::time_point sample_time_;
+    std::chrono::steady_clock::time_point last_emit_;
 };
 
 }  // namespace ktv::services
 
 #endif  // KTVLV_SERVICES_M3U8_DOWNLOAD_SERVICE_H
-
@@ -0,0 +1,131 @@
+#include "pitch_service.h"
+#include "../utils/log_macros.h"
+#include <algorithm>
+#include <chrono>
+
+namespace ktv::services {
+
+namespace {
+
+constexpr std::chrono::milliseconds kPollPeriod{20};
+constexpr uint32_t kChunkFrames = 1024;          // 每次从环形缓冲取的采样帧
+constexpr uint32_t kMaxBacklogPermille = 500;    // 积压超过一半时跳到最新
+constexpr uint64_t kLoadWindowUs = 2000000;      // 负载按 2 秒音频统计一次
+
+}  // namespace
+
+bool PitchService::start(audio_ring_t* ring, const ktv::audio::PitchDetector::Config& cfg) {
+    if (!ring) return false;
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (detector_) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][pitch][start] already running");
+        return false;
+    }
+    detector_ = std::make_unique<ktv::audio::PitchDetector>(cfg);
+    audio_ring_reader_init(&reader_, ring);
+    start_pos_ = reader_.pos;
+    fed_frames_ = 0;
+    chunk_.resize(static_cast<size_t>(kChunkFrames) * audio_ring_frame_bytes(ring));
+    frames_.clear();
+    stats_ = Stats{};
+    busy_us_ = audio_us_ = 0;
+    poll_task_ = ktv::core::Executor::instance().schedulePeriodic(ktv::core::Lane::Audio, kPollPeriod,
+                                                                   [this] { poll(); });
+    KTV_SYSLOG(LOG_INFO, "[ktv][pitch][start] rate=%d analysis_rate=%d channels=%d window_ms=%d hop_ms=%d",
+               cfg.sample_rate, detector_->analysisRate(), cfg.channels, cfg.window_ms, cfg.hop_ms);
+    return true;
+}
+
+void PitchService::stop() {
+    ktv::core::TaskId task;
+    Stats last;
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!detector_) return;
+        task = poll_task_;
+        poll_task_ = 0;
+        detector_.reset();
+        reader_ = audio_ring_reader_t{};
+        last = stats_;
+    }
+    ktv::core::Executor::instance().cancel(task);
+    KTV_SYSLOG(LOG_INFO, "[ktv][pitch][stop] frames=%llu voiced=%llu overruns=%u lost=%llu",
+               static_cast<unsigned long long>(last.frames), static_cast<unsigned long long>(last.voiced),
+               last.overruns, static_cast<unsigned long long>(last.lost_frames));
+}
+
+bool PitchService::running() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return detector_ != nullptr;
+}
+
+ktv::audio::PitchDetector::Config PitchService::config() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return detector_ ? detector_->config() : ktv::audio::PitchDetector::Config{};
+}
+
+void PitchService::setListener(Listener listener) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    listener_ = std::move(listener);
+}
+
+PitchService::Stats PitchService::stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+void PitchService::poll() {
+    std::unique_lock<std::mutex> lock(mtx_);
+    // stop() 之后已取消，但可能已经在执行队列中
+    if (!detector_ || !reader_.ring) return;
+
+    stats_.fill_permille = audio_ring_fill_permille(&reader_);
+    if (stats_.fill_permille > kMaxBacklogPermille) {
+        uint32_t before = audio_ring_available(&reader_);
+        audio_ring_reader_skip(&reader_, kChunkFrames);
+        reader_.lost_frames += before - audio_ring_available(&reader_);
+    }
+
+    auto begin = std::chrono::steady_clock::now();
+    frames_.clear();
+    uint64_t consumed = 0;
+    uint32_t n;
+    while ((n = audio_ring_read(&reader_, chunk_.data(), kChunkFrames)) > 0) {
+        // 检测器时间必须跟录音流位置一致：跳过积压/被覆盖的帧要让检测器时钟同步前进，
+        // 否则之后每一帧的 time_ms 都落后，打分按音符对齐时整曲错位
+        const uint64_t chunk_pos = reader_.pos - n - start_pos_;
+        if (chunk_pos > fed_frames_) {
+            detector_->skip(chunk_pos - fed_frames_);
+            fed_frames_ = chunk_pos;
+        }
+        detector_->process(chunk_.data(), n, frames_);
+        fed_frames_ += n;
+        consumed += n;
+    }
+    if (consumed == 0) return;
+
+    busy_us_ += static_cast<uint64_t>(
+        std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - begin).count());
+    audio_us_ += consumed * 1000000ULL / static_cast<uint64_t>(detector_->config().sample_rate);
+    if (audio_us_ >= kLoadWindowUs) {
+        stats_.load_pct = static_cast<uint32_t>(busy_us_ * 100 / audio_us_);
+        busy_us_ = audio_us_ = 0;
+    }
+
+    stats_.overruns = reader_.overruns;
+    stats_.lost_frames = reader_.lost_frames;
+    stats_.frames += frames_.size();
+    for (const auto& f : frames_) {
+        if (f.voiced) ++stats_.voiced;
+    }
+    if (!listener_ || frames_.empty()) return;
+
+    // 回调时不持锁，监听者可以查询 stats()
+    Listener listener = listener_;
+    std::vector<ktv::audio::PitchFrame> batch;
+    batch.swap(frames_);
+    lock.unlock();
+    listener(batch);
+}
+
+}  // namespace ktv::services
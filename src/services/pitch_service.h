@@ -0,0 +1,83 @@
+#ifndef KTVLV_SERVICES_PITCH_SERVICE_H
+#define KTVLV_SERVICES_PITCH_SERVICE_H
+
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include "../audio/pitch_detector.h"
+#include "../core/executor.h"
+#include "core/audio_ring.h"   // 仓库根目录 core/（录音环形缓冲）
+
+namespace ktv::services {
+
+/**
+ * PitchService - 实时音高跟踪（唱歌打分的输入）
+ *
+ * - 在录音环形缓冲上挂一个独立读者，Audio Lane（专用线程）周期任务按 poll 周期取数分析，
+ *   不占录音线程，也不影响其他读者；不与上传/搜索/图片解码共用线程
+ * - 帧时间按录音流位置计算：跳过或被覆盖的帧会让检测器时钟同步前进
+ * - 积压超过半个环形缓冲时跳到最新数据（打分只关心当前演唱，不补算历史）
+ * - 结果批量回调给监听者（在 Audio Lane 上调用，不能直接操作 UI）
+ *
+ * 调用线程：start/stop/setListener 任意线程（内部加锁）。
+ * stop() 必须在 AUDIO.stop_record() 之前调用（环形缓冲随录音停止销毁）。
+ */
+class PitchService {
+public:
+    using Listener = std::function<void(const std::vector<ktv::audio::PitchFrame>&)>;
+
+    struct Stats {
+        uint64_t frames = 0;         // 已输出的分析帧
+        uint64_t voiced = 0;
+        uint32_t overruns = 0;       // 读者被录音线程超过的次数
+        uint64_t lost_frames = 0;    // 因落后或主动跳过丢弃的采样帧
+        uint32_t fill_permille = 0;  // 最近一次 poll 时的积压
+        uint32_t load_pct = 0;       // 分析耗时 / 音频时长（%），>100 表示跟不上实时
+    };
+
+    static PitchService& getInstance() {
+        static PitchService instance;
+        return instance;
+    }
+    PitchService(const PitchService&) = delete;
+    PitchService& operator=(const PitchService&) = delete;
+
+    /**
+     * 开始跟踪：ring 为录音环形缓冲（alsa_capture_ring()），格式与录音参数一致
+     */
+    bool start(audio_ring_t* ring, const ktv::audio::PitchDetector::Config& cfg);
+    void stop();
+    bool running() const;
+
+    // 正在使用的检测参数（未运行时为默认参数）；打分按其 hop_ms 计算音符应有帧数
+    ktv::audio::PitchDetector::Config config() const;
+
+    void setListener(Listener listener);
+
+    Stats stats() const;
+
+private:
+    PitchService() = default;
+    ~PitchService() = default;
+
+    void poll();
+
+    mutable std::mutex mtx_;
+    std::unique_ptr<ktv::audio::PitchDetector> detector_;
+    audio_ring_reader_t reader_{};
+    uint64_t start_pos_{0};     // 开始跟踪时的录音流位置（time_ms 的零点）
+    uint64_t fed_frames_{0};    // 检测器时钟对应的流位置（相对 start_pos_，含跳过的帧）
+    std::vector<uint8_t> chunk_;
+    std::vector<ktv::audio::PitchFrame> frames_;
+    Listener listener_;
+    ktv::core::TaskId poll_task_{0};
+    Stats stats_;
+    uint64_t busy_us_{0};       // 当前统计窗口的分析耗时
+    uint64_t audio_us_{0};      // 当前统计窗口处理的音频时长
+};
+
+}  // namespace ktv::services
+
+#endif  // KTVLV_SERVICES_PITCH_SERVICE_H
@@ -1,36 +1,110 @@
 #include "player_service.h"
-#include <syslog.h>
+#include "../utils/log_macros.h"
 #include "../events/event_bus.h"
+#include "prefetch_service.h"
+#include "m3u8_download_service.h"
+#include "../core/executor.h"
+#include <sys/stat.h>
 
 namespace ktv::services {
 
+void PlayerService::setSessionHooks(SessionHook on_start, SessionHook on_stop) {
+    on_start_ = std::move(on_start);
+    on_stop_ = std::move(on_stop);
+}
+
 void PlayerService::play(const std::string& song_id, const std::string& m3u8_url) {
-    syslog(LOG_INFO, "[ktv][player][action] action=play song_id=%s url=%s status=mock", song_id.c_str(), m3u8_url.c_str());
+    std::string prev = state_ != PlayerState::Stopped ? current_song_ : std::string();
     state_ = PlayerState::Playing;
+    current_song_ = song_id;
+    started_at_ = std::chrono::steady_clock::now();
+    PrefetchService::getInstance().onSongStarted(song_id);
+    auto& downloader = M3u8DownloadService::getInstance();
+    downloader.verifyBeforePlay(song_id);
+    if (!m3u8_url.empty()) {
+        // 边播边把剩余片段下完，local.m3u8 随之逐段改写为本地地址
+        downloader.startDownload(song_id, m3u8_url);
+    }
+
+    // 判断 local.m3u8 要访问文件系统，放到 Player Lane（真实播放器的命令也在这条 Lane 上执行）
+    std::string local = downloader.localPlaylist(song_id);
+    bool posted = ktv::core::Executor::instance().post(ktv::core::Lane::Player,
+            [song_id, m3u8_url, local, prev, on_start = on_start_, on_stop = on_stop_] {
+        if (!prev.empty() && on_stop) on_stop(prev);
+        struct stat st;
+        const bool has_local = ::stat(local.c_str(), &st) == 0;
+        const std::string& url = has_local ? local : m3u8_url;
+        KTV_SYSLOG(LOG_INFO, "[ktv][player][action] action=play song_id=%s source=%s url=%s status=mock",
+                   song_id.c_str(), has_local ? "local" : "remote", url.c_str());
+        if (on_start) on_start(song_id);
+    });
+    if (!posted) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][player][error] action=play song_id=%s reason=executor_rejected", song_id.c_str());
+    }
+
     ktv::events::Event ev;
     ev.type = ktv::events::EventType::PlayerStateChanged;
     ev.payload = "playing";
     ktv::events::EventBus::getInstance().publish(ev);
 }
 
+bool PlayerService::playNext() {
+    SongItem next;
+    if (!SongService::getInstance().popQueue(next)) {
+        stop();
+        return false;
+    }
+    play(next.id, next.m3u8_url);
+    return true;
+}
+
+void PlayerService::onSongQueued() {
+    if (state_ == PlayerState::Stopped) playNext();
+}
+
 void PlayerService::pause() {
     if (state_ == PlayerState::Playing) {
         state_ = PlayerState::Paused;
-        syslog(LOG_INFO, "[ktv][player][action] action=pause");
+        paused_at_ = std::chrono::steady_clock::now();
+        KTV_SYSLOG(LOG_INFO, "[ktv][player][action] action=pause");
     }
 }
 
 void PlayerService::resume() {
     if (state_ == PlayerState::Paused) {
         state_ = PlayerState::Playing;
-        syslog(LOG_INFO, "[ktv][player][action] action=resume");
+        started_at_ += std::chrono::steady_clock::now() - paused_at_;
+        KTV_SYSLOG(LOG_INFO, "[ktv][player][action] action=resume");
+    }
+}
+
+uint32_t PlayerService::positionMs() const {
+    if (state_ == PlayerState::Stopped) return 0;
+    auto now = state_ == PlayerState::Paused ? paused_at_ : std::chrono::steady_clock::now();
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(now - started_at_).count());
+}
+
+void PlayerService::togglePause() {
+    if (state_ == PlayerState::Playing) {
+        pause();
+    } else {
+        resume();
     }
 }
 
 void PlayerService::stop() {
     if (state_ != PlayerState::Stopped) {
         state_ = PlayerState::Stopped;
-        syslog(LOG_INFO, "[ktv][player][action] action=stop");
+        if (on_stop_) {
+            ktv::core::Executor::instance().post(ktv::core::Lane::Player,
+                                                 [song_id = current_song_, on_stop = on_stop_] { on_stop(song_id); });
+        }
+        current_song_.clear();
+        KTV_SYSLOG(LOG_INFO, "[ktv][player][action] action=stop");
+        ktv::events::Event ev;
+        ev.type = ktv::events::EventType::PlayerStateChanged;
+        ev.payload = "stopped";
+        ktv::events::EventBus::getInstance().publish(ev);
     }
 }
 
@@ -1,7 +1,11 @@
 #ifndef KTVLV_SERVICES_PLAYER_SERVICE_H
 #define KTVLV_SERVICES_PLAYER_SERVICE_H
 
+#include <chrono>
+#include <cstdint>
+#include <functional>
 #include <string>
+#include "song_service.h"
 
 namespace ktv::services {
 
@@ -20,17 +24,44 @@ public:
     PlayerService(const PlayerService&) = delete;
     PlayerService& operator=(const PlayerService&) = delete;
 
+    /**
+     * 起播（UI 线程调用）
+     * - 通知预取规划、排队播放前校验与完整下载
+     * - 起播地址在 Player Lane 上决定：已有 local.m3u8（预取/缓存过）时本地起播，否则用在线地址
+     */
     void play(const std::string& song_id, const std::string& m3u8_url);
+    // 播放已点队列的下一首（切歌 / 本首结束 / 空闲时点歌）；队列为空时停止，返回 false
+    bool playNext();
+    // 点歌成功后调用：当前没有在播时直接起播队首
+    void onSongQueued();
     void pause();
     void resume();
+    void togglePause();
     void stop();
     PlayerState state() const { return state_; }
+    const std::string& currentSong() const { return current_song_; }
+    // 当前歌曲的播放进度（暂停时停住）；播放器未接入进度回调前按起播时刻推算
+    uint32_t positionMs() const;
+
+    /**
+     * 演唱会话钩子（main 注入：录音 → 音高 → 打分，停止时逆序）
+     * - 在 Player Lane 上按起播/停止顺序串行调用，可以做阻塞的设备操作
+     * - 切歌时先对上一首调用 on_stop，再对新歌调用 on_start
+     * 需在第一次 play() 之前设置
+     */
+    using SessionHook = std::function<void(const std::string& song_id)>;
+    void setSessionHooks(SessionHook on_start, SessionHook on_stop);
 
 private:
     PlayerService() = default;
     ~PlayerService() = default;
 
     PlayerState state_{PlayerState::Stopped};
+    std::string current_song_;
+    std::chrono::steady_clock::time_point started_at_{};   // 减去暂停时长后的起播时刻
+    std::chrono::steady_clock::time_point paused_at_{};
+    SessionHook on_start_;
+    SessionHook on_stop_;
 };
 
 }  // namespace ktv::services
@@ -0,0 +1,88 @@
+#include "prefetch_service.h"
+#include "m3u8_download_service.h"
+#include "../utils/log_macros.h"
+#include <algorithm>
+#include <unordered_set>
+
+namespace ktv::services {
+
+static constexpr std::chrono::minutes kTrendingTtl{10};
+
+void PrefetchService::setConfig(const ktv::config::PrefetchConfig& cfg) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    cfg_ = cfg;
+    long rate = cfg_.rate_limit_kbps > 0 ? static_cast<long>(cfg_.rate_limit_kbps) * 1024 : 0;
+    M3u8DownloadService::getInstance().setPrefetchRateLimit(rate);
+}
+
+void PrefetchService::onQueueChanged(const std::vector<SongItem>& queue) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    upcoming_ = queue;
+    requestReplanLocked();
+}
+
+void PrefetchService::onSongStarted(const std::string& song_id) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    auto it = std::find_if(upcoming_.begin(), upcoming_.end(),
+                           [&](const SongItem& s) { return s.id == song_id; });
+    if (it != upcoming_.end()) {
+        upcoming_.erase(it);
+    }
+    requestReplanLocked();
+}
+
+void PrefetchService::setTrending(const std::vector<SongItem>& songs) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    trending_ = songs;
+    auto& executor = ktv::core::Executor::instance();
+    if (!executor.reschedule(trending_ttl_, kTrendingTtl)) {
+        trending_ttl_ = executor.schedule(ktv::core::Lane::Background, kTrendingTtl, [this] { expireTrending(); });
+    }
+    requestReplanLocked();
+}
+
+void PrefetchService::expireTrending() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    trending_ttl_ = 0;
+    if (trending_.empty()) return;
+    KTV_SYSLOG(LOG_INFO, "[ktv][prefetch][ttl] trending expired, count=%zu", trending_.size());
+    trending_.clear();
+}
+
+void PrefetchService::requestReplanLocked() {
+    if (!cfg_.enabled || cfg_.head_seconds <= 0) return;
+    replan_debounce_.trigger([this] { replan(); });
+}
+
+void PrefetchService::replan() {
+    std::lock_guard<std::mutex> lock(mtx_);
+    if (!cfg_.enabled || cfg_.head_seconds <= 0) return;
+
+    auto& downloader = M3u8DownloadService::getInstance();
+    std::unordered_set<std::string> seen;
+    int submitted = 0;
+
+    // 候选顺序即优先级：下载服务按入队顺序执行预取
+    auto consider = [&](const std::vector<SongItem>& list, int limit) {
+        int taken = 0;
+        for (const auto& s : list) {
+            if (taken >= limit) break;
+            if (s.id.empty() || s.m3u8_url.empty() || !seen.insert(s.id).second) continue;
+            // 已缓存的歌曲不占名额，否则点满 max_queue_songs 首之后的歌永远轮不到
+            if (downloader.isCached(s.id, cfg_.head_seconds)) continue;
+            ++taken;
+            if (downloader.prefetch(s.id, s.m3u8_url, cfg_.head_seconds)) {
+                ++submitted;
+            }
+        }
+    };
+    consider(upcoming_, cfg_.max_queue_songs);
+    consider(trending_, cfg_.max_trending_songs);
+
+    if (submitted > 0) {
+        KTV_SYSLOG(LOG_INFO, "[ktv][prefetch][plan] upcoming=%zu trending=%zu submitted=%d",
+                   upcoming_.size(), trending_.size(), submitted);
+    }
+}
+
+}  // namespace ktv::services
@@ -0,0 +1,67 @@
+
+#ifndef KTVLV_SERVICES_PREFETCH_SERVICE_H
+#define KTVLV_SERVICES_PREFETCH_SERVICE_H
+
+#include <mutex>
+#include <string>
+#include <vector>
+#include "song_service.h"
+#include "../config/config.h"
+#include "../core/executor.h"
+
+namespace ktv::services {
+
+/**
+ * PrefetchService - 预取规划（已点队列 + 热门/历史）
+ *
+ * 设计原则：
+ * - 只做规划，不做下载：下载统一交给 M3u8DownloadService（唯一后台线程）
+ * - 已点队列优先，其次热门/历史，总数受配置上限约束
+ * - 只预取开头 head_seconds 秒（playlist + 前几个 ts），限速下载，不抢正常播放带宽
+ * - 规划防抖：连续的队列/热门变化合并为一次规划，在 Background Lane 执行（不占 UI 线程）
+ * - 热门候选有 TTL，过期后不再参与规划（首页长时间不刷新时不预取过时的热门）
+ *
+ * 调用线程：UI 线程（内部加锁，其他线程调用也安全）
+ */
+class PrefetchService {
+public:
+    static PrefetchService& getInstance() {
+        static PrefetchService instance;
+        return instance;
+    }
+    PrefetchService(const PrefetchService&) = delete;
+    PrefetchService& operator=(const PrefetchService&) = delete;
+
+    void setConfig(const ktv::config::PrefetchConfig& cfg);
+    const ktv::config::PrefetchConfig& getConfig() const { return cfg_; }
+
+    // 已点队列变化（SongService::addToQueue 传入完整队列，覆盖本地队列）
+    void onQueueChanged(const std::vector<SongItem>& queue);
+
+    // 歌曲开始播放（PlayerService::play）：从待唱队列移除
+    void onSongStarted(const std::string& song_id);
+
+    // 热门/历史候选（按优先级排序）
+    void setTrending(const std::vector<SongItem>& songs);
+
+private:
+    PrefetchService() = default;
+    ~PrefetchService() = default;
+
+    // 防抖后在 Background Lane 执行 replan()
+    void requestReplanLocked();
+    void replan();
+    void expireTrending();
+
+    ktv::core::Debouncer replan_debounce_{ktv::core::Lane::Background, std::chrono::milliseconds(300)};
+    ktv::core::TaskId trending_ttl_{0};
+
+    ktv::config::PrefetchConfig cfg_;
+    std::vector<SongItem> upcoming_;
+    std::vector<SongItem> trending_;
+    std::mutex mtx_;
+};
+
+}  // namespace ktv::services
+
+#endif  // KTVLV_SERVICES_PREFETCH_SERVICE_H
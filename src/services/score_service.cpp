@@ -0,0 +1,168 @@
+#include "score_service.h"
+#include "../utils/json_escape.h"
+#include "../utils/log_macros.h"
+#include <cstdio>
+#include "m3u8_download_service.h"
+#include "pitch_service.h"
+#include "../events/event_bus.h"
+
+namespace ktv::services {
+
+namespace {
+
+using ktv::utils::json_escape;
+
+void publish(ktv::events::EventType type, const char* payload) {
+    ktv::events::Event ev;
+    ev.type = type;
+    ev.payload = payload;
+    ktv::events::EventBus::getInstance().publish(ev);
+}
+
+}  // namespace
+
+void ScoreService::setConfig(const ktv::config::ScoreConfig& cfg) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    cfg_ = cfg;
+}
+
+bool ScoreService::start(const std::string& song_id, int64_t song_origin_ms) {
+    std::string path = M3u8DownloadService::getInstance().songDir(song_id) + "/melody.txt";
+    ktv::audio::ReferenceMelody melody;
+    std::string error;
+    if (!melody.load(path, error)) {
+        KTV_SYSLOG(LOG_INFO, "[ktv][score][start] song_id=%s status=no_melody reason=%s", song_id.c_str(),
+                   error.c_str());
+        stop();
+        return false;
+    }
+    size_t notes = melody.notes.size();
+    uint16_t line_count = melody.line_count;
+    // 帧间隔必须与实际检测器一致，否则音符应有帧数算错，覆盖率整体偏高/偏低
+    const int hop_ms = PitchService::getInstance().config().hop_ms;
+
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        ktv::audio::ScoreEngine::Config ecfg;
+        ecfg.time_tolerance_ms = cfg_.time_tolerance_ms;
+        ecfg.full_credit_cents = static_cast<float>(cfg_.full_credit_cents);
+        ecfg.zero_credit_cents = static_cast<float>(cfg_.zero_credit_cents);
+        ecfg.octave_fold = cfg_.octave_fold;
+        ecfg.min_confidence = cfg_.min_confidence;
+        ecfg.coverage = cfg_.coverage;
+        ecfg.hop_ms = hop_ms;
+        engine_ = std::make_unique<ktv::audio::ScoreEngine>(std::move(melody), ecfg);
+        song_id_ = song_id;
+        origin_ms_ = song_origin_ms;
+        lines_.clear();
+        lines_.reserve(line_count);
+        last_live_ = std::chrono::steady_clock::time_point{};
+        final_sent_ = false;
+        stats_ = Stats{};
+    }
+    PitchService::getInstance().setListener(
+        [this](const std::vector<ktv::audio::PitchFrame>& frames) { onPitch(frames); });
+    KTV_SYSLOG(LOG_INFO, "[ktv][score][start] song_id=%s notes=%zu lines=%u origin_ms=%lld hop_ms=%d", song_id.c_str(),
+               notes, static_cast<unsigned>(line_count), static_cast<long long>(song_origin_ms), hop_ms);
+    return true;
+}
+
+void ScoreService::finish() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!engine_) return;
+        engine_->finish(lines_);
+        publishLinesLocked();
+        publishFinalLocked();
+        engine_.reset();
+    }
+    PitchService::getInstance().setListener(nullptr);
+}
+
+void ScoreService::stop() {
+    {
+        std::lock_guard<std::mutex> lock(mtx_);
+        if (!engine_) return;
+        KTV_SYSLOG(LOG_INFO, "[ktv][score][stop] song_id=%s frames=%llu lines=%u score=%.1f", song_id_.c_str(),
+                   static_cast<unsigned long long>(stats_.frames), stats_.lines, stats_.score);
+        engine_.reset();
+    }
+    PitchService::getInstance().setListener(nullptr);
+}
+
+bool ScoreService::active() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return engine_ != nullptr;
+}
+
+ScoreService::Stats ScoreService::stats() const {
+    std::lock_guard<std::mutex> lock(mtx_);
+    return stats_;
+}
+
+void ScoreService::onPitch(const std::vector<ktv::audio::PitchFrame>& frames) {
+    std::lock_guard<std::mutex> lock(mtx_);
+    // stop() 之后 PitchService 可能还持有上一次的回调副本
+    if (!engine_ || final_sent_) return;
+
+    const int64_t shift = origin_ms_ + cfg_.latency_ms;
+    for (const auto& f : frames) {
+        int64_t song_ms = static_cast<int64_t>(f.time_ms) - shift;
+        if (song_ms < 0) continue;
+        engine_->feed(static_cast<uint32_t>(song_ms), f, lines_);
+        ++stats_.frames;
+    }
+    publishLinesLocked();
+
+    if (engine_->finished()) {
+        publishFinalLocked();
+        return;
+    }
+    auto now = std::chrono::steady_clock::now();
+    if (now - last_live_ >= std::chrono::milliseconds(cfg_.ui_interval_ms)) {
+        last_live_ = now;
+        publishLiveLocked();
+    }
+}
+
+void ScoreService::publishLinesLocked() {
+    for (const auto& l : lines_) {
+        char buf[256]{0};
+        std::snprintf(buf, sizeof(buf),
+                      "{\"song_id\":\"%s\",\"line\":%u,\"start_ms\":%u,\"end_ms\":%u,\"notes\":%u,"
+                      "\"hit_notes\":%u,\"score\":%.1f}",
+                      json_escape(song_id_).c_str(), static_cast<unsigned>(l.line), l.start_ms, l.end_ms,
+                      static_cast<unsigned>(l.notes), static_cast<unsigned>(l.hit_notes), l.score);
+        publish(ktv::events::EventType::ScoreLine, buf);
+        ++stats_.lines;
+    }
+    lines_.clear();
+    stats_.score = engine_->totalScore();
+}
+
+void ScoreService::publishLiveLocked() {
+    const ktv::audio::LiveScore& live = engine_->live();
+    char buf[256]{0};
+    std::snprintf(buf, sizeof(buf),
+                  "{\"song_id\":\"%s\",\"song_ms\":%u,\"sung_midi\":%.2f,\"ref_midi\":%.2f,\"cents\":%.0f,"
+                  "\"score\":%.1f,\"lines_done\":%u}",
+                  json_escape(song_id_).c_str(), live.song_ms, live.sung_midi, live.ref_midi, live.cents,
+                  live.score, static_cast<unsigned>(live.lines_done));
+    publish(ktv::events::EventType::ScoreLive, buf);
+    ++stats_.live_events;
+}
+
+void ScoreService::publishFinalLocked() {
+    if (final_sent_) return;
+    final_sent_ = true;
+    stats_.score = engine_->totalScore();
+    char buf[256]{0};
+    std::snprintf(buf, sizeof(buf),
+                  "{\"song_id\":\"%s\",\"score\":%.1f,\"lines\":%u,\"notes\":%zu}",
+                  json_escape(song_id_).c_str(), stats_.score, stats_.lines, engine_->melody().notes.size());
+    publish(ktv::events::EventType::ScoreFinal, buf);
+    KTV_SYSLOG(LOG_INFO, "[ktv][score][final] song_id=%s score=%.1f lines=%u frames=%llu", song_id_.c_str(),
+               stats_.score, stats_.lines, static_cast<unsigned long long>(stats_.frames));
+}
+
+}  // namespace ktv::services
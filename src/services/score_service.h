@@ -0,0 +1,85 @@
+#ifndef KTVLV_SERVICES_SCORE_SERVICE_H
+#define KTVLV_SERVICES_SCORE_SERVICE_H
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../audio/score_engine.h"
+#include "../config/config.h"
+
+namespace ktv::services {
+
+/**
+ * ScoreService - 演唱打分（PitchService 音高流 → 参考旋律对齐 → UI 事件）
+ *
+ * - start() 从歌曲缓存目录加载 melody.txt，挂到 PitchService 的监听回调上增量打分
+ * - 事件（payload 均为 JSON）：
+ *   ScoreLive   实时音高/累计分，按 ui_interval_ms 限频
+ *   ScoreLine   每句结算一次
+ *   ScoreFinal  全部音符结算或 finish() 时一次
+ * - 时间换算：song_ms = 音高帧时间 - song_origin_ms - latency_ms，
+ *   song_origin_ms 为歌曲 0 点对应的音高流时间（PitchService 启动时为 0）
+ * - PitchService 须先 start：音符应有帧数按其检测器的 hop_ms 计算
+ * - UI 消费方：ui/score_view（EventBus 在 UI 线程分发）
+ * - 启停：main 注入的 PlayerService 会话钩子（起播时 录音 → PitchService → start，停止时逆序）
+ *
+ * 调用线程：start/finish/stop 任意线程；打分在 PitchService 回调（Audio Lane）中进行。
+ */
+class ScoreService {
+public:
+    struct Stats {
+        uint64_t frames = 0;        // 已处理的音高帧
+        uint32_t lines = 0;         // 已结算的句子
+        uint32_t live_events = 0;
+        float score = 0.0f;         // 当前全曲得分
+    };
+
+    static ScoreService& getInstance() {
+        static ScoreService instance;
+        return instance;
+    }
+    ScoreService(const ScoreService&) = delete;
+    ScoreService& operator=(const ScoreService&) = delete;
+
+    void setConfig(const ktv::config::ScoreConfig& cfg);
+
+    /**
+     * 开始为 song_id 打分；歌曲没有参考旋律时返回 false（该歌曲不打分）
+     * 会替换 PitchService 当前的监听者
+     */
+    bool start(const std::string& song_id, int64_t song_origin_ms = 0);
+
+    // 歌曲播完：结算剩余音符并发布 ScoreFinal
+    void finish();
+    // 中途切歌：不发布最终分
+    void stop();
+
+    bool active() const;
+    Stats stats() const;
+
+private:
+    ScoreService() = default;
+    ~ScoreService() = default;
+
+    void onPitch(const std::vector<ktv::audio::PitchFrame>& frames);
+    void publishLinesLocked();
+    void publishLiveLocked();
+    void publishFinalLocked();
+
+    mutable std::mutex mtx_;
+    ktv::config::ScoreConfig cfg_;
+    std::unique_ptr<ktv::audio::ScoreEngine> engine_;
+    std::string song_id_;
+    int64_t origin_ms_ = 0;
+    std::vector<ktv::audio::LineScore> lines_;
+    std::chrono::steady_clock::time_point last_live_{};
+    bool final_sent_ = false;
+    Stats stats_;
+};
+
+}  // namespace ktv::services
+
+#endif  // KTVLV_SERVICES_SCORE_SERVICE_H
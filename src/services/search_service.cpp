@@ -0,0 +1,224 @@
+#include "search_service.h"
+#include "../events/ui_dispatcher.h"
+#include "../utils/log_macros.h"
+#include <algorithm>
+
+namespace ktv::services {
+
+std::string SearchService::normalize(const std::string& keyword) {
+    size_t begin = keyword.find_first_not_of(" \t");
+    if (begin == std::string::npos) return {};
+    size_t end = keyword.find_last_not_of(" \t");
+    std::string out = keyword.substr(begin, end - begin + 1);
+    // 只处理 ASCII，中文等多字节字符原样保留
+    for (char& c : out) {
+        if (c >= 'A' && c <= 'Z') c = static_cast<char>(c - 'A' + 'a');
+    }
+    return out;
+}
+
+std::vector<SongItem> SearchService::merge(const std::vector<SongItem>& remote, const std::vector<SongItem>& local) {
+    // 服务端排序优先，本地命中但服务端没有返回的追加在后面
+    std::vector<SongItem> out = remote;
+    std::unordered_set<std::string> seen;
+    for (const auto& s : remote) seen.insert(s.id);
+    for (const auto& s : local) {
+        if (seen.insert(s.id).second) out.push_back(s);
+    }
+    return out;
+}
+
+void SearchService::indexSongs(const std::vector<SongItem>& songs) {
+    for (const auto& s : songs) {
+        if (s.id.empty() || !extra_ids_.insert(s.id).second) continue;
+        extra_.push_back({s, normalize(s.title + "\n" + s.artist)});
+    }
+    extra_dirty_ = true;
+}
+
+void SearchService::refreshIndex() {
+    auto& songs = SongService::getInstance();
+    uint64_t version = songs.catalogVersion();
+    if (version == indexed_version_ && !extra_dirty_) return;
+
+    index_.clear();
+    index_ids_.clear();
+    for (auto& s : songs.catalogSnapshot()) {
+        if (!index_ids_.insert(s.id).second) continue;
+        std::string key = normalize(s.title + "\n" + s.artist);
+        index_.push_back({std::move(s), std::move(key)});
+    }
+    for (const auto& e : extra_) {
+        if (index_ids_.insert(e.song.id).second) index_.push_back(e);
+    }
+    indexed_version_ = version;
+    extra_dirty_ = false;
+    last_norm_.clear();
+    last_hits_.clear();
+}
+
+// 匹配程度，越小越靠前：标题全等 < 标题前缀 < 标题包含 < 歌手前缀 < 歌手包含
+static int match_rank(const std::string& key, const std::string& norm) {
+    if (norm.empty()) return 0;
+    const size_t sep = key.find('\n');
+    const size_t title_len = sep == std::string::npos ? key.size() : sep;
+    const size_t pos = key.find(norm);
+    if (pos == std::string::npos) return 5;
+    if (pos + norm.size() <= title_len) {
+        if (pos > 0) return 2;
+        return norm.size() == title_len ? 0 : 1;
+    }
+    if (sep != std::string::npos && pos == sep + 1) return 3;
+    return 4;
+}
+
+std::vector<SongItem> SearchService::searchLocal(const std::string& norm) {
+    std::vector<size_t> hits;
+    if (!last_norm_.empty() && norm.size() >= last_norm_.size() && norm.compare(0, last_norm_.size(), last_norm_) == 0) {
+        // 连续输入：新关键词包含旧关键词，只需在上次命中里继续筛
+        for (size_t i : last_hits_) {
+            if (index_[i].key.find(norm) != std::string::npos) hits.push_back(i);
+        }
+    } else {
+        for (size_t i = 0; i < index_.size(); ++i) {
+            if (norm.empty() || index_[i].key.find(norm) != std::string::npos) hits.push_back(i);
+        }
+    }
+
+    // 索引来自 unordered_map，顺序随机：按匹配程度、再按标题排序，截断前完成
+    std::vector<std::pair<int, size_t>> ranked;
+    ranked.reserve(hits.size());
+    for (size_t i : hits) ranked.emplace_back(match_rank(index_[i].key, norm), i);
+    std::sort(ranked.begin(), ranked.end(), [this](const auto& a, const auto& b) {
+        if (a.first != b.first) return a.first < b.first;
+        return index_[a.second].key < index_[b.second].key;   // 小写 "标题\n歌手"
+    });
+    for (size_t k = 0; k < ranked.size(); ++k) hits[k] = ranked[k].second;
+
+    std::vector<SongItem> out;
+    out.reserve(std::min(hits.size(), kMaxLocalResults));
+    for (size_t i = 0; i < hits.size() && out.size() < kMaxLocalResults; ++i) {
+        out.push_back(index_[hits[i]].song);
+    }
+    last_norm_ = norm;
+    last_hits_ = std::move(hits);
+    return out;
+}
+
+void SearchService::query(const std::string& keyword, ResultCallback cb, bool immediate) {
+    auto begin = std::chrono::steady_clock::now();
+    const uint64_t gen = ++generation_;
+    const std::string norm = normalize(keyword);
+
+    refreshIndex();
+    SearchResult result;
+    result.keyword = keyword;
+    result.songs = searchLocal(norm);
+
+    std::vector<SongItem> cached;
+    if (norm.empty() || cacheGet(norm, cached)) {
+        // 空关键词只显示本地推荐；缓存命中直接给出合并结果，都不再访问网络
+        remote_debounce_.cancel();
+        if (!cached.empty()) result.songs = merge(cached, result.songs);
+        result.remote_done = true;
+        cb(result);
+    } else {
+        cb(result);
+        auto local = std::make_shared<const std::vector<SongItem>>(std::move(result.songs));
+        auto job = [this, gen, keyword, norm, local, cb] { fetchRemote(gen, keyword, norm, local, cb); };
+        if (immediate) {
+            remote_debounce_.cancel();
+            // 投递被拒/被挤掉：只给出本地结果收尾，不在 UI 线程上访问网络
+            auto dropped = [this, gen, keyword, local, cb] { finishLocalOnly(gen, keyword, local, cb); };
+            if (!ktv::core::Executor::instance().post(ktv::core::Lane::Background, job, dropped)) dropped();
+        } else {
+            remote_debounce_.trigger(job);
+        }
+    }
+
+    auto cost_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][service][search] stage=local keyword_len=%zu indexed=%zu cached=%d cost_us=%lld",
+               norm.size(), index_.size(), cached.empty() ? 0 : 1, static_cast<long long>(cost_us));
+}
+
+void SearchService::cancel() {
+    ++generation_;
+    remote_debounce_.cancel();
+}
+
+void SearchService::fetchRemote(uint64_t generation, const std::string& keyword, const std::string& norm,
+                                std::shared_ptr<const std::vector<SongItem>> local, ResultCallback cb) {
+    auto stale = [this, generation] { return generation_.load() != generation; };
+    if (stale()) return;
+
+    auto begin = std::chrono::steady_clock::now();
+    std::vector<SongItem> remote = SongService::getInstance().search(keyword, 1, kRemotePageSize, stale);
+    auto cost_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    if (stale()) {
+        KTV_SYSLOG(LOG_DEBUG, "[ktv][service][search] stage=remote result=superseded cost_ms=%lld",
+                   static_cast<long long>(cost_ms));
+        return;
+    }
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][service][search] stage=remote items=%zu cost_ms=%lld",
+               remote.size(), static_cast<long long>(cost_ms));
+
+    // 空结果可能是网络失败，不缓存
+    if (!remote.empty()) cachePut(norm, remote);
+
+    auto merged = std::make_shared<SearchResult>();
+    merged->keyword = keyword;
+    merged->songs = merge(remote, *local);
+    merged->remote_done = true;
+    ktv::events::UiDispatcher::getInstance().post([this, generation, merged, cb] {
+        if (generation_.load() != generation) return;   // 等待 UI 线程期间又有新输入
+        cb(*merged);
+    });
+}
+
+void SearchService::finishLocalOnly(uint64_t generation, const std::string& keyword,
+                                    std::shared_ptr<const std::vector<SongItem>> local, ResultCallback cb) {
+    KTV_SYSLOG(LOG_WARNING, "[ktv][service][search] stage=remote result=dropped reason=executor_busy");
+    auto result = std::make_shared<SearchResult>();
+    result->keyword = keyword;
+    result->songs = *local;
+    result->remote_done = true;
+    ktv::events::UiDispatcher::getInstance().post([this, generation, result, cb] {
+        if (generation_.load() != generation) return;
+        cb(*result);
+    });
+}
+
+bool SearchService::cacheGet(const std::string& norm, std::vector<SongItem>& out) {
+    std::lock_guard<std::mutex> lock(cache_mtx_);
+    auto it = cache_.find(norm);
+    if (it == cache_.end()) return false;
+    if (std::chrono::steady_clock::now() - it->second.stored > kCacheTtl) {
+        cache_lru_.erase(it->second.lru_pos);
+        cache_.erase(it);
+        return false;
+    }
+    cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second.lru_pos);
+    out = it->second.songs;
+    return true;
+}
+
+void SearchService::cachePut(const std::string& norm, const std::vector<SongItem>& songs) {
+    std::lock_guard<std::mutex> lock(cache_mtx_);
+    auto it = cache_.find(norm);
+    if (it != cache_.end()) {
+        cache_lru_.splice(cache_lru_.begin(), cache_lru_, it->second.lru_pos);
+        it->second.songs = songs;
+        it->second.stored = std::chrono::steady_clock::now();
+        return;
+    }
+    cache_lru_.push_front(norm);
+    cache_[norm] = CacheEntry{songs, std::chrono::steady_clock::now(), cache_lru_.begin()};
+    while (cache_.size() > kCacheEntries) {
+        cache_.erase(cache_lru_.back());
+        cache_lru_.pop_back();
+    }
+}
+
+}  // namespace ktv::services
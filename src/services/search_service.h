@@ -0,0 +1,114 @@
+#ifndef KTVLV_SERVICES_SEARCH_SERVICE_H
+#define KTVLV_SERVICES_SEARCH_SERVICE_H
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "song_service.h"
+#include "../core/executor.h"
+
+namespace ktv::services {
+
+struct SearchResult {
+    std::string keyword;
+    std::vector<SongItem> songs;
+    bool remote_done = false;   // false：仅本地索引结果，防抖结束后还会回调一次合并结果
+};
+
+/**
+ * SearchService - 搜索页的输入即搜
+ *
+ * - 每次按键：在 UI 线程查本地索引（最近列表/搜索结果 + 预置推荐）立即回调，不等网络；
+ *   本地结果按匹配程度（标题全等/前缀/包含，再到歌手）和标题排序
+ * - 输入停顿 kDebounce 后在 Background Lane 请求服务端，结果与本地结果合并后再回调一次
+ * - 新输入使旧查询失效：排队中的请求不再发出，在途请求通过 curl 进度回调中止，
+ *   迟到的结果直接丢弃
+ * - 服务端结果按关键词 LRU 缓存（kCacheEntries 条，kCacheTtl 过期），回删/重复输入不再访问网络
+ *
+ * 调用线程：query()/cancel()/indexSongs() 只在 UI 线程调用，回调也在 UI 线程执行
+ */
+class SearchService {
+public:
+    using ResultCallback = std::function<void(const SearchResult&)>;
+
+    static SearchService& getInstance() {
+        static SearchService instance;
+        return instance;
+    }
+    SearchService(const SearchService&) = delete;
+    SearchService& operator=(const SearchService&) = delete;
+
+    // 追加本地候选（如 mock 推荐），与 SongService 的最近结果一起参与本地搜索
+    void indexSongs(const std::vector<SongItem>& songs);
+
+    // immediate=true（回车提交）跳过防抖立即请求服务端
+    void query(const std::string& keyword, ResultCallback cb, bool immediate = false);
+
+    // 丢弃进行中的查询（搜索页销毁时调用，之后不会再有回调）
+    void cancel();
+
+private:
+    SearchService() = default;
+    ~SearchService() = default;
+
+    struct IndexEntry {
+        SongItem song;
+        std::string key;   // 小写化的 "标题\n歌手"
+    };
+
+    struct CacheEntry {
+        std::vector<SongItem> songs;
+        std::chrono::steady_clock::time_point stored;
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    static std::string normalize(const std::string& keyword);
+    static std::vector<SongItem> merge(const std::vector<SongItem>& remote, const std::vector<SongItem>& local);
+
+    void refreshIndex();
+    std::vector<SongItem> searchLocal(const std::string& norm);
+    void fetchRemote(uint64_t generation, const std::string& keyword, const std::string& norm,
+                     std::shared_ptr<const std::vector<SongItem>> local, ResultCallback cb);
+    // 服务端请求没能投递（队列拒绝/被挤掉）：以本地结果作为最终结果回调（可在任意线程调用）
+    void finishLocalOnly(uint64_t generation, const std::string& keyword,
+                         std::shared_ptr<const std::vector<SongItem>> local, ResultCallback cb);
+
+    bool cacheGet(const std::string& norm, std::vector<SongItem>& out);
+    void cachePut(const std::string& norm, const std::vector<SongItem>& songs);
+
+    static constexpr std::chrono::milliseconds kDebounce{300};
+    static constexpr std::chrono::minutes kCacheTtl{5};
+    static constexpr size_t kCacheEntries = 32;
+    static constexpr size_t kMaxLocalResults = 100;
+    static constexpr int kRemotePageSize = 30;
+
+    ktv::core::Debouncer remote_debounce_{ktv::core::Lane::Background, kDebounce};
+    std::atomic<uint64_t> generation_{0};   // 每次 query/cancel 递增，旧请求据此判定过时
+
+    // 本地索引（仅 UI 线程）
+    std::vector<IndexEntry> index_;
+    std::unordered_set<std::string> index_ids_;
+    std::vector<IndexEntry> extra_;           // indexSongs() 追加的候选
+    std::unordered_set<std::string> extra_ids_;
+    uint64_t indexed_version_{UINT64_MAX};
+    bool extra_dirty_{false};
+    std::string last_norm_;                   // 上一次本地查询：新关键词以它为前缀时只在上次结果里筛
+    std::vector<size_t> last_hits_;
+
+    // 服务端结果缓存（Background Lane 写，UI 线程读）
+    std::mutex cache_mtx_;
+    std::unordered_map<std::string, CacheEntry> cache_;
+    std::list<std::string> cache_lru_;        // 头部为最近使用
+};
+
+}  // namespace ktv::services
+
+#endif  // KTVLV_SERVICES_SEARCH_SERVICE_H
@@ -0,0 +1,395 @@
+#include "segment_store.h"
+#include "../utils/log_macros.h"
+#include <cerrno>
+#include <cinttypes>
+#include <cstdlib>
+#include <algorithm>
+#include <cstring>
+#include <unordered_map>
+#include <unordered_set>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <sys/types.h>
+#include <unistd.h>
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+namespace ktv::services {
+
+static constexpr size_t kTsPacketSize = 188;
+static constexpr size_t kReadChunk = 64 * 1024;
+static const char* kManifestMagic = "#KTVSEG 1";
+
+static bool make_dir(const std::string& path) {
+    return ::mkdir(path.c_str(), 0755) == 0 || errno == EEXIST;
+}
+
+static bool is_dir(const std::string& path) {
+    struct stat st;
+    return ::stat(path.c_str(), &st) == 0 && S_ISDIR(st.st_mode);
+}
+
+static bool parse_hex64(const char* s, uint64_t& out) {
+    char* end = nullptr;
+    errno = 0;
+    unsigned long long v = std::strtoull(s, &end, 16);
+    if (errno != 0 || end == s || (end - s) != 16) return false;
+    out = static_cast<uint64_t>(v);
+    return true;
+}
+
+// ts 片段以 0x47 同步字节按 188 字节分包；纯音频片段可能以 ID3 头开始
+static bool looks_like_segment(const std::string& path) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    unsigned char head[kTsPacketSize + 1]{0};
+    size_t n = std::fread(head, 1, sizeof(head), fp);
+    std::fclose(fp);
+    if (n >= 3 && std::memcmp(head, "ID3", 3) == 0) return true;
+    if (n == 0 || head[0] != 0x47) return false;
+    return n < sizeof(head) || head[kTsPacketSize] == 0x47;
+}
+
+// ---------------------------------------------------------------------------
+// Writer
+// ---------------------------------------------------------------------------
+
+SegmentStore::Writer::Writer() {
+    state_ = XXH3_createState();
+}
+
+SegmentStore::Writer::~Writer() {
+    abort();
+    XXH3_freeState(static_cast<XXH3_state_t*>(state_));
+}
+
+bool SegmentStore::Writer::open(const std::string& tmp_path) {
+    abort();
+    if (!state_) return false;
+    fp_ = std::fopen(tmp_path.c_str(), "wb");
+    if (!fp_) return false;
+    path_ = tmp_path;
+    size_ = 0;
+    XXH3_64bits_reset(static_cast<XXH3_state_t*>(state_));
+    return true;
+}
+
+bool SegmentStore::Writer::write(const void* data, size_t len) {
+    if (!fp_) return false;
+    if (std::fwrite(data, 1, len, fp_) != len) return false;
+    XXH3_64bits_update(static_cast<XXH3_state_t*>(state_), data, len);
+    size_ += len;
+    return true;
+}
+
+bool SegmentStore::Writer::finish(uint64_t& out_hash, uint64_t& out_size) {
+    if (!fp_) return false;
+    bool ok = std::fflush(fp_) == 0 && ::fsync(::fileno(fp_)) == 0;
+    ok = (std::fclose(fp_) == 0) && ok;
+    fp_ = nullptr;
+    if (!ok || size_ == 0) {
+        std::remove(path_.c_str());
+        return false;
+    }
+    out_hash = XXH3_64bits_digest(static_cast<XXH3_state_t*>(state_));
+    out_size = size_;
+    return true;
+}
+
+void SegmentStore::Writer::abort() {
+    if (fp_) {
+        std::fclose(fp_);
+        fp_ = nullptr;
+        std::remove(path_.c_str());
+    }
+}
+
+// ---------------------------------------------------------------------------
+// SegmentStore
+// ---------------------------------------------------------------------------
+
+bool SegmentStore::initialize() {
+    std::string objects = root_ + "/objects";
+    std::string tmp = objects + "/tmp";
+    if (!make_dir(root_) || !make_dir(objects) || !make_dir(tmp)) {
+        KTV_SYSLOG(LOG_ERR, "[ktv][cache][init] root=%s reason=mkdir_failed", root_.c_str());
+        return false;
+    }
+
+    // 上次异常退出残留的临时文件
+    if (DIR* d = ::opendir(tmp.c_str())) {
+        while (struct dirent* ent = ::readdir(d)) {
+            if (ent->d_name[0] == '.') continue;
+            std::remove((tmp + "/" + ent->d_name).c_str());
+        }
+        ::closedir(d);
+    }
+    return true;
+}
+
+std::string SegmentStore::hashHex(uint64_t hash) {
+    char buf[17]{0};
+    std::snprintf(buf, sizeof(buf), "%016" PRIx64, hash);
+    return buf;
+}
+
+std::string SegmentStore::objectPath(uint64_t hash) const {
+    std::string hex = hashHex(hash);
+    return root_ + "/objects/" + hex.substr(0, 2) + "/" + hex + ".ts";
+}
+
+std::string SegmentStore::relativeObjectPath(uint64_t hash) {
+    std::string hex = hashHex(hash);
+    return "../objects/" + hex.substr(0, 2) + "/" + hex + ".ts";
+}
+
+std::string SegmentStore::tempPath() const {
+    char name[32]{0};
+    std::snprintf(name, sizeof(name), "/objects/tmp/%u.part", ++tmp_seq_);
+    return root_ + name;
+}
+
+bool SegmentStore::hashFile(const std::string& path, uint64_t& out_hash, uint64_t& out_size) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    XXH3_state_t* state = XXH3_createState();
+    if (!state) {
+        std::fclose(fp);
+        return false;
+    }
+    XXH3_64bits_reset(state);
+    std::vector<unsigned char> buf(kReadChunk);
+    uint64_t total = 0;
+    size_t n = 0;
+    while ((n = std::fread(buf.data(), 1, buf.size(), fp)) > 0) {
+        XXH3_64bits_update(state, buf.data(), n);
+        total += n;
+    }
+    bool ok = !std::ferror(fp);
+    std::fclose(fp);
+    out_hash = XXH3_64bits_digest(state);
+    out_size = total;
+    XXH3_freeState(state);
+    return ok;
+}
+
+bool SegmentStore::commit(const std::string& tmp_path, const Entry& entry, bool verify, bool& deduped) {
+    deduped = false;
+    if (!looks_like_segment(tmp_path)) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][cache][reject] reason=bad_format size=%" PRIu64, entry.size);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    if (verify) {
+        uint64_t hash = 0;
+        uint64_t size = 0;
+        if (!hashFile(tmp_path, hash, size) || hash != entry.hash || size != entry.size) {
+            KTV_SYSLOG(LOG_WARNING, "[ktv][cache][reject] reason=verify_failed hash=%s",
+                       hashHex(entry.hash).c_str());
+            std::remove(tmp_path.c_str());
+            return false;
+        }
+    }
+
+    std::string path = objectPath(entry.hash);
+    if (exists(entry)) {
+        std::remove(tmp_path.c_str());
+        deduped = true;
+        return true;
+    }
+    std::string hex = hashHex(entry.hash);
+    if (!make_dir(root_ + "/objects/" + hex.substr(0, 2)) || std::rename(tmp_path.c_str(), path.c_str()) != 0) {
+        KTV_SYSLOG(LOG_ERR, "[ktv][cache][error] action=commit path=%s errno=%d", path.c_str(), errno);
+        std::remove(tmp_path.c_str());
+        return false;
+    }
+    return true;
+}
+
+bool SegmentStore::exists(const Entry& entry) const {
+    struct stat st;
+    return ::stat(objectPath(entry.hash).c_str(), &st) == 0 &&
+           static_cast<uint64_t>(st.st_size) == entry.size;
+}
+
+bool SegmentStore::verify(const Entry& entry) const {
+    uint64_t hash = 0;
+    uint64_t size = 0;
+    return hashFile(objectPath(entry.hash), hash, size) && hash == entry.hash && size == entry.size;
+}
+
+void SegmentStore::remove(const Entry& entry) {
+    std::remove(objectPath(entry.hash).c_str());
+}
+
+bool SegmentStore::loadManifest(const std::string& song_dir, Manifest& out) {
+    out = Manifest{};
+    FILE* fp = std::fopen((song_dir + "/manifest").c_str(), "r");
+    if (!fp) return false;
+
+    char line[2048]{0};
+    bool ok = std::fgets(line, sizeof(line), fp) && std::strncmp(line, kManifestMagic, std::strlen(kManifestMagic)) == 0;
+    while (ok && std::fgets(line, sizeof(line), fp)) {
+        size_t len = std::strlen(line);
+        while (len > 0 && (line[len - 1] == '\n' || line[len - 1] == '\r')) line[--len] = '\0';
+        if (std::strncmp(line, "url=", 4) == 0) {
+            out.media_url = line + 4;
+            continue;
+        }
+        Entry e;
+        unsigned long long size = 0;
+        if (len < 18 || line[16] != ' ' || !parse_hex64(std::string(line, 16).c_str(), e.hash) ||
+            std::sscanf(line + 17, "%llu", &size) != 1) {
+            break;  // 清单只保留合法前缀
+        }
+        e.size = size;
+        out.entries.push_back(e);
+    }
+    std::fclose(fp);
+    return ok;
+}
+
+bool SegmentStore::saveManifest(const std::string& song_dir, const Manifest& manifest) {
+    std::string path = song_dir + "/manifest";
+    std::string tmp = path + ".part";
+    FILE* fp = std::fopen(tmp.c_str(), "w");
+    if (!fp) return false;
+    bool ok = std::fprintf(fp, "%s\nurl=%s\n", kManifestMagic, manifest.media_url.c_str()) > 0;
+    for (const auto& e : manifest.entries) {
+        if (!ok) break;
+        ok = std::fprintf(fp, "%s %" PRIu64 "\n", hashHex(e.hash).c_str(), e.size) > 0;
+    }
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+size_t SegmentStore::collectGarbage(uint64_t* freed_bytes) {
+    // 1. 汇总所有 manifest 引用的对象
+    std::unordered_set<uint64_t> live;
+    DIR* root = ::opendir(root_.c_str());
+    if (!root) return 0;
+    while (struct dirent* ent = ::readdir(root)) {
+        if (ent->d_name[0] == '.' || std::strcmp(ent->d_name, "objects") == 0) continue;
+        std::string dir = root_ + "/" + ent->d_name;
+        if (!is_dir(dir)) continue;
+        Manifest m;
+        if (!loadManifest(dir, m)) continue;
+        for (const auto& e : m.entries) live.insert(e.hash);
+    }
+    ::closedir(root);
+
+    // 2. 删除未引用对象
+    size_t removed = 0;
+    uint64_t freed = 0;
+    std::string objects = root_ + "/objects";
+    DIR* od = ::opendir(objects.c_str());
+    if (!od) return 0;
+    while (struct dirent* shard = ::readdir(od)) {
+        if (shard->d_name[0] == '.' || std::strcmp(shard->d_name, "tmp") == 0) continue;
+        std::string shard_dir = objects + "/" + shard->d_name;
+        DIR* sd = ::opendir(shard_dir.c_str());
+        if (!sd) continue;
+        while (struct dirent* obj = ::readdir(sd)) {
+            uint64_t hash = 0;
+            if (obj->d_name[0] == '.' || !parse_hex64(std::string(obj->d_name).substr(0, 16).c_str(), hash)) continue;
+            if (live.count(hash)) continue;
+            std::string path = shard_dir + "/" + obj->d_name;
+            struct stat st;
+            if (::stat(path.c_str(), &st) == 0) freed += static_cast<uint64_t>(st.st_size);
+            if (std::remove(path.c_str()) == 0) ++removed;
+        }
+        ::closedir(sd);
+    }
+    ::closedir(od);
+
+    if (freed_bytes) *freed_bytes = freed;
+    KTV_SYSLOG(LOG_INFO, "[ktv][cache][gc] live=%zu removed=%zu freed_bytes=%" PRIu64, live.size(), removed, freed);
+    return removed;
+}
+
+void SegmentStore::touchSong(const std::string& song_dir) {
+    ::utimes(song_dir.c_str(), nullptr);
+}
+
+// 删除歌曲目录下的文件（manifest / playlist / local.m3u8 / 标记文件等），再删目录本身
+static void remove_song_dir(const std::string& dir) {
+    if (DIR* d = ::opendir(dir.c_str())) {
+        while (struct dirent* ent = ::readdir(d)) {
+            if (std::strcmp(ent->d_name, ".") == 0 || std::strcmp(ent->d_name, "..") == 0) continue;
+            std::remove((dir + "/" + ent->d_name).c_str());
+        }
+        ::closedir(d);
+    }
+    ::rmdir(dir.c_str());
+}
+
+size_t SegmentStore::evictToBudget(uint64_t budget_bytes, const std::unordered_set<std::string>& keep,
+                                   uint64_t* freed_bytes) {
+    if (freed_bytes) *freed_bytes = 0;
+
+    struct Song {
+        std::string name;
+        time_t mtime = 0;
+        std::vector<Entry> entries;
+    };
+    std::vector<Song> songs;
+    std::unordered_map<uint64_t, uint32_t> refs;  // 对象 -> 引用它的歌曲数
+    uint64_t total = 0;
+
+    DIR* root = ::opendir(root_.c_str());
+    if (!root) return 0;
+    while (struct dirent* ent = ::readdir(root)) {
+        if (ent->d_name[0] == '.' || std::strcmp(ent->d_name, "objects") == 0) continue;
+        std::string dir = root_ + "/" + ent->d_name;
+        struct stat st;
+        if (::stat(dir.c_str(), &st) != 0 || !S_ISDIR(st.st_mode)) continue;
+        Manifest m;
+        if (!loadManifest(dir, m)) continue;
+        Song song;
+        song.name = ent->d_name;
+        song.mtime = st.st_mtime;
+        for (const auto& e : m.entries) {
+            // 同一首歌内重复的片段只算一次引用
+            if (std::find_if(song.entries.begin(), song.entries.end(),
+                             [&e](const Entry& x) { return x.hash == e.hash; }) != song.entries.end()) {
+                continue;
+            }
+            if (refs[e.hash]++ == 0) total += e.size;
+            song.entries.push_back(e);
+        }
+        songs.push_back(std::move(song));
+    }
+    ::closedir(root);
+    if (total <= budget_bytes) return 0;
+
+    std::sort(songs.begin(), songs.end(), [](const Song& a, const Song& b) { return a.mtime < b.mtime; });
+
+    size_t evicted = 0;
+    uint64_t freed = 0;
+    for (const auto& song : songs) {
+        if (total <= budget_bytes) break;
+        if (keep.count(song.name)) continue;
+        for (const auto& e : song.entries) {
+            if (--refs[e.hash] > 0) continue;
+            remove(e);
+            total -= e.size;
+            freed += e.size;
+        }
+        remove_song_dir(root_ + "/" + song.name);
+        ++evicted;
+        KTV_SYSLOG(LOG_INFO, "[ktv][cache][evict] dir=%s segments=%zu", song.name.c_str(), song.entries.size());
+    }
+
+    if (freed_bytes) *freed_bytes = freed;
+    KTV_SYSLOG(LOG_INFO, "[ktv][cache][budget] budget_bytes=%" PRIu64 " total_bytes=%" PRIu64
+               " evicted=%zu freed_bytes=%" PRIu64, budget_bytes, total, evicted, freed);
+    return evicted;
+}
+
+}  // namespace ktv::services
@@ -0,0 +1,122 @@
+
+#ifndef KTVLV_SERVICES_SEGMENT_STORE_H
+#define KTVLV_SERVICES_SEGMENT_STORE_H
+
+#include <cstdint>
+#include <cstdio>
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+namespace ktv::services {
+
+/**
+ * SegmentStore - 内容寻址的 ts 片段存储
+ *
+ * 目录结构：
+ *   <root>/objects/<hh>/<hash16>.ts   片段本体，文件名为内容哈希（XXH3-64）
+ *   <root>/objects/tmp/               下载中的临时文件
+ *   <root>/<song_dir>/manifest        每首歌的片段清单（顺序 = playlist 顺序）
+ *
+ * - 相同内容的片段只存一份（不同歌曲共用片头 / 同一首歌换 ID 重新发布）
+ * - 片段下载时边写边算哈希，提交前可回读校验，损坏的片段不会进入对象库
+ * - 对象没有引用计数，靠 collectGarbage() 扫描所有 manifest 回收
+ * - 容量上限由 evictToBudget() 维持：按歌曲目录 mtime 淘汰最久未用的歌曲（touchSong() 刷新）
+ *
+ * 调用线程：下载线程（非线程安全，由 M3u8DownloadService 串行调用）
+ */
+class SegmentStore {
+public:
+    struct Entry {
+        uint64_t hash = 0;
+        uint64_t size = 0;
+    };
+
+    struct Manifest {
+        std::string media_url;       // 媒体 playlist 地址（用于解析相对路径）
+        std::vector<Entry> entries;  // 已缓存的前缀片段
+    };
+
+    /**
+     * 片段写入器：边下载边写临时文件并累积哈希
+     * 用法：open() → write()* → finish() → SegmentStore::commit()
+     */
+    class Writer {
+    public:
+        Writer();
+        ~Writer();
+        Writer(const Writer&) = delete;
+        Writer& operator=(const Writer&) = delete;
+
+        bool open(const std::string& tmp_path);
+        bool write(const void* data, size_t len);
+        // 关闭文件并输出哈希/大小；失败时删除临时文件
+        bool finish(uint64_t& out_hash, uint64_t& out_size);
+        void abort();
+
+        const std::string& path() const { return path_; }
+        uint64_t size() const { return size_; }
+
+    private:
+        FILE* fp_{nullptr};
+        void* state_{nullptr};  // XXH3_state_t，避免在头文件暴露 xxhash
+        std::string path_;
+        uint64_t size_{0};
+    };
+
+    void setRoot(const std::string& root) { root_ = root; }
+    const std::string& root() const { return root_; }
+
+    // 创建 objects/ 与 objects/tmp/，清理上次异常退出残留的临时文件
+    bool initialize();
+
+    static std::string hashHex(uint64_t hash);
+    std::string objectPath(uint64_t hash) const;
+    // 相对歌曲目录的路径，写进 local.m3u8
+    static std::string relativeObjectPath(uint64_t hash);
+    std::string tempPath() const;
+
+    /**
+     * 将临时文件提交到对象库
+     * - 内容格式检查（TS 同步字节 / ID3 头），拦截错误页、截断响应
+     * - verify=true 时回读临时文件校验哈希（发现写入 flash 时的损坏）
+     * - 对象已存在则删除临时文件（去重），deduped 置 true
+     */
+    bool commit(const std::string& tmp_path, const Entry& entry, bool verify, bool& deduped);
+
+    // 重新读取对象并校验大小/哈希
+    bool verify(const Entry& entry) const;
+    bool exists(const Entry& entry) const;
+    void remove(const Entry& entry);
+
+    static bool hashFile(const std::string& path, uint64_t& out_hash, uint64_t& out_size);
+
+    static bool loadManifest(const std::string& song_dir, Manifest& out);
+    static bool saveManifest(const std::string& song_dir, const Manifest& manifest);
+
+    /**
+     * 回收未被任何 manifest 引用的对象
+     * @return 删除的对象个数
+     */
+    size_t collectGarbage(uint64_t* freed_bytes = nullptr);
+
+    // 刷新歌曲目录的 mtime（LRU 时间戳），开始下载/播放时调用
+    static void touchSong(const std::string& song_dir);
+
+    /**
+     * 对象库总大小超过 budget_bytes 时，按目录 mtime 从旧到新删除整首歌（目录 + 只被它引用的对象）
+     * - keep 中的目录名（<root> 下的一级目录名）不会被淘汰：正在下载/排队/播放的歌曲
+     * - 共享片段按引用计数处理，只有最后一个引用者被淘汰时才释放
+     * @return 淘汰的歌曲数
+     */
+    size_t evictToBudget(uint64_t budget_bytes, const std::unordered_set<std::string>& keep,
+                         uint64_t* freed_bytes = nullptr);
+
+private:
+    std::string root_ = "/data/ktv_cache";
+    mutable uint32_t tmp_seq_{0};
+};
+
+}  // namespace ktv::services
+
+#endif  // KTVLV_SERVICES_SEGMENT_STORE_H
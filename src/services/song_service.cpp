@@ -1,7 +1,10 @@
 #include "song_service.h"
 #include "http_service.h"
+#include "prefetch_service.h"
 #include "utils/json_helper.h"
-#include <syslog.h>
+#include "../utils/log_macros.h"
+#include <cstring>
+#include <string>
 
 namespace ktv::services {
 
@@ -10,6 +13,24 @@ static bool is_ok_or_truncated(int ret) {
     return (ret == 0 || ret == -5);
 }
 
+// 查询参数百分号编码（关键词可能含空格、中文、&）
+static std::string url_encode(const std::string& in) {
+    static const char kHex[] = "0123456789ABCDEF";
+    std::string out;
+    out.reserve(in.size() * 3);
+    for (unsigned char c : in) {
+        if ((c >= 'A' && c <= 'Z') || (c >= 'a' && c <= 'z') || (c >= '0' && c <= '9') ||
+            c == '-' || c == '_' || c == '.' || c == '~') {
+            out.push_back(static_cast<char>(c));
+        } else {
+            out.push_back('%');
+            out.push_back(kHex[c >> 4]);
+            out.push_back(kHex[c & 0x0F]);
+        }
+    }
+    return out;
+}
+
 static void parse_song_array(const char* json_str, std::vector<SongItem>& out) {
     if (!json_str) return;
 
@@ -29,16 +50,19 @@ static void parse_song_array(const char* json_str, std::vector<SongItem>& out) {
         char song_name[256]{0};
         char artist[256]{0};
         char m3u8_url[512]{0};
+        char cover[512]{0};
 
         int r_id = JsonHelper::GetRootArrayObjectString(root, i, "song_id", song_id, sizeof(song_id));
         int r_name = JsonHelper::GetRootArrayObjectString(root, i, "song_name", song_name, sizeof(song_name));
         int r_artist = JsonHelper::GetRootArrayObjectString(root, i, "artist", artist, sizeof(artist));
         int r_url = JsonHelper::GetRootArrayObjectString(root, i, "m3u8_url", m3u8_url, sizeof(m3u8_url));
+        int r_cover = JsonHelper::GetRootArrayObjectString(root, i, "cover", cover, sizeof(cover));
 
         if (is_ok_or_truncated(r_id)) s.id = song_id;
         if (is_ok_or_truncated(r_name)) s.title = song_name;
         if (is_ok_or_truncated(r_artist)) s.artist = artist;
         if (is_ok_or_truncated(r_url)) s.m3u8_url = m3u8_url;
+        if (r_cover == 0) s.cover_url = cover;   // 截断的 URL 不可用
 
         // fallback: if no song_id, use title as id
         if (s.id.empty()) s.id = s.title;
@@ -46,8 +70,9 @@ static void parse_song_array(const char* json_str, std::vector<SongItem>& out) {
     }
 }
 
-std::vector<SongItem> SongService::listSongs(int page, int size) {
+std::vector<SongItem> SongService::listSongs(int page, int size, bool* ok) {
     std::vector<SongItem> result;
+    if (ok) *ok = false;
     HttpResponse resp;
     char url[512]{0};
     std::snprintf(url, sizeof(url),
@@ -55,26 +80,31 @@ std::vector<SongItem> SongService::listSongs(int page, int size) {
                   token_.c_str(), page, size, net_cfg_.company.c_str(), net_cfg_.app_name.c_str(),
                   net_cfg_.platform.c_str(), net_cfg_.vn.c_str());
     if (!HttpService::getInstance().get(url, resp)) {
-        syslog(LOG_WARNING, "[ktv][service][error] component=song_service action=list_songs reason=http_failed");
+        KTV_SYSLOG(LOG_WARNING, "[ktv][service][error] component=song_service action=list_songs reason=http_failed");
         return result;
     }
+    if (ok) *ok = true;
     parse_song_array(resp.body.data(), result);
+    remember(result);
     return result;
 }
 
-std::vector<SongItem> SongService::search(const std::string& keyword, int page, int size) {
+std::vector<SongItem> SongService::search(const std::string& keyword, int page, int size,
+                                          const HttpService::CancelFn& cancelled) {
     std::vector<SongItem> result;
     HttpResponse resp;
     char url[512]{0};
     std::snprintf(url, sizeof(url),
                   "/apollo/search/actorsong?token=%s&page=%d&size=%d&key=%s&company=%s&app_name=%s",
-                  token_.c_str(), page, size, keyword.c_str(), net_cfg_.company.c_str(),
+                  token_.c_str(), page, size, url_encode(keyword).c_str(), net_cfg_.company.c_str(),
                   net_cfg_.app_name.c_str());
-    if (!HttpService::getInstance().get(url, resp)) {
-        syslog(LOG_WARNING, "[ktv][service][error] component=song_service action=search reason=http_failed");
+    if (!HttpService::getInstance().get(url, resp, cancelled)) {
+        if (cancelled && cancelled()) return result;
+        KTV_SYSLOG(LOG_WARNING, "[ktv][service][error] component=song_service action=search reason=http_failed");
         return result;
     }
     parse_song_array(resp.body.data(), result);
+    remember(result);
     return result;
 }
 
@@ -87,11 +117,65 @@ bool SongService::addToQueue(const std::string& song_id) {
     char body[256]{0};
     std::snprintf(body, sizeof(body), "{\"song_id\":\"%s\"}", song_id.c_str());
     if (!HttpService::getInstance().post(url, body, resp)) {
-        syslog(LOG_WARNING, "[ktv][service][error] component=song_service action=add_to_queue reason=http_failed");
+        KTV_SYSLOG(LOG_WARNING, "[ktv][service][error] component=song_service action=add_to_queue reason=http_failed");
         return false;
     }
+
+    // 点歌成功后预取开头部分，下一首起播无需等待网络
+    SongItem song;
+    if (!findSong(song_id, song)) {
+        song.id = song_id;
+    }
+    std::vector<SongItem> queue;
+    {
+        std::lock_guard<std::mutex> lock(queue_mtx_);
+        queue_.push_back(song);
+        queue = queue_;
+    }
+    PrefetchService::getInstance().onQueueChanged(queue);
     return true;
 }
 
+bool SongService::popQueue(SongItem& out) {
+    std::lock_guard<std::mutex> lock(queue_mtx_);
+    if (queue_.empty()) return false;
+    out = std::move(queue_.front());
+    queue_.erase(queue_.begin());
+    return true;
+}
+
+std::vector<SongItem> SongService::queueSnapshot() const {
+    std::lock_guard<std::mutex> lock(queue_mtx_);
+    return queue_;
+}
+
+bool SongService::findSong(const std::string& song_id, SongItem& out) const {
+    std::lock_guard<std::mutex> lock(catalog_mtx_);
+    auto it = catalog_.find(song_id);
+    if (it == catalog_.end()) return false;
+    out = it->second;
+    return true;
+}
+
+void SongService::remember(const std::vector<SongItem>& songs) {
+    std::lock_guard<std::mutex> lock(catalog_mtx_);
+    // 简单上限保护：超过上限整体清空（列表/搜索结果会很快重新填充）
+    if (catalog_.size() + songs.size() > kMaxCatalogSize) {
+        catalog_.clear();
+    }
+    for (const auto& s : songs) {
+        if (!s.id.empty()) catalog_[s.id] = s;
+    }
+    if (!songs.empty()) catalog_version_.fetch_add(1, std::memory_order_release);
+}
+
+std::vector<SongItem> SongService::catalogSnapshot() const {
+    std::lock_guard<std::mutex> lock(catalog_mtx_);
+    std::vector<SongItem> out;
+    out.reserve(catalog_.size());
+    for (const auto& kv : catalog_) out.push_back(kv.second);
+    return out;
+}
+
 }  // namespace ktv::services
 
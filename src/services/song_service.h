@@ -1,9 +1,14 @@
 #ifndef KTVLV_SERVICES_SONG_SERVICE_H
 #define KTVLV_SERVICES_SONG_SERVICE_H
 
+#include <atomic>
+#include <cstdint>
 #include <vector>
 #include <string>
+#include <mutex>
+#include <unordered_map>
 #include "../config/config.h"
+#include "http_service.h"
 
 namespace ktv::services {
 
@@ -12,6 +17,7 @@ struct SongItem {
     std::string title;
     std::string artist;
     std::string m3u8_url;
+    std::string cover_url;   // 封面图，可能为空
 };
 
 class SongService {
@@ -28,15 +34,39 @@ public:
     void setNetworkConfig(const ktv::config::NetworkConfig& cfg) { net_cfg_ = cfg; }
     const ktv::config::NetworkConfig& getNetworkConfig() const { return net_cfg_; }
 
-    std::vector<SongItem> listSongs(int page = 1, int size = 20);
-    std::vector<SongItem> search(const std::string& keyword, int page = 1, int size = 20);
+    // ok 非空时带回请求是否成功（区分"没有更多"与"网络失败"）
+    std::vector<SongItem> listSongs(int page = 1, int size = 20, bool* ok = nullptr);
+    // cancelled 返回 true 时中止请求并返回空结果（搜索输入已变化）
+    std::vector<SongItem> search(const std::string& keyword, int page = 1, int size = 20,
+                                 const HttpService::CancelFn& cancelled = nullptr);
+    // 点歌成功后追加到本地已点队列（服务端队列的镜像），并通知预取规划
     bool addToQueue(const std::string& song_id);
 
+    // 取出已点队列的下一首（开始播放时调用）；队列为空返回 false
+    bool popQueue(SongItem& out);
+    std::vector<SongItem> queueSnapshot() const;
+
+    // 按 song_id 查找最近一次列表/搜索结果中的歌曲（用于补全 m3u8_url）
+    bool findSong(const std::string& song_id, SongItem& out) const;
+
+    // 最近列表/搜索结果的快照（本地搜索索引使用）；版本号在内容变化时递增
+    std::vector<SongItem> catalogSnapshot() const;
+    uint64_t catalogVersion() const { return catalog_version_.load(std::memory_order_acquire); }
+
 private:
     SongService() = default;
     ~SongService() = default;
 
+    void remember(const std::vector<SongItem>& songs);
+
+    static constexpr size_t kMaxCatalogSize = 512;
+
     std::string token_;
+    std::unordered_map<std::string, SongItem> catalog_;
+    mutable std::mutex catalog_mtx_;
+    std::atomic<uint64_t> catalog_version_{0};
+    std::vector<SongItem> queue_;        // 已点队列（待唱，不含正在播放的一首）
+    mutable std::mutex queue_mtx_;
     ktv::config::NetworkConfig net_cfg_;
 };
 
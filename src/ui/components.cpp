@@ -1,8 +1,12 @@
 #include "components.h"
 #include "ui_scale.h"
+#include "style_registry.h"
+#include "../services/player_service.h"
 #include "../services/song_service.h"
+#include "../core/executor.h"
 #include "../events/event_bus.h"
-#include <syslog.h>
+#include "../events/ui_dispatcher.h"
+#include "../utils/log_macros.h"
 
 namespace ktv::ui::components {
 
@@ -10,6 +14,8 @@ static lv_style_t style_gradient_card;
 static lv_style_t style_action_btn;
 static lv_style_t style_action_btn_pressed;
 static lv_style_t style_action_btn_disabled;
+static lv_style_t style_song_item;
+static lv_style_t style_song_text;
 static bool styles_initialized = false;
 
 static void initStyles() {
@@ -46,6 +52,18 @@ static void initStyles() {
 
     lv_style_init(&style_action_btn_disabled);
     lv_style_set_text_opa(&style_action_btn_disabled, LV_OPA_50);
+
+    // 歌曲列表项
+    lv_style_init(&style_song_item);
+    lv_style_set_radius(&style_song_item, UIScale::s(12));
+    lv_style_set_bg_color(&style_song_item, lv_color_hex(0x67579E));
+    lv_style_set_bg_opa(&style_song_item, LV_OPA_50);
+    lv_style_set_pad_all(&style_song_item, UIScale::s(8));
+    lv_style_set_pad_column(&style_song_item, UIScale::s(6));
+
+    lv_style_init(&style_song_text);
+    lv_style_set_bg_opa(&style_song_text, LV_OPA_TRANSP);
+    lv_style_set_pad_row(&style_song_text, UIScale::s(4));
 }
 
 lv_obj_t* createGradientCard(lv_obj_t* parent, uint32_t color_start, uint32_t color_end,
@@ -54,32 +72,47 @@ lv_obj_t* createGradientCard(lv_obj_t* parent, uint32_t color_start, uint32_t co
     
     lv_obj_t* card = lv_obj_create(parent);
     lv_obj_add_style(card, &style_gradient_card, 0);
-    // 直接设置对象样式，而不是修改全局样式
-    lv_obj_set_style_radius(card, radius, 0);
-    lv_obj_set_style_bg_color(card, lv_color_hex(color_start), 0);
-    lv_obj_set_style_bg_grad_color(card, lv_color_hex(color_end), 0);
-    lv_obj_set_style_bg_grad_dir(card, LV_GRAD_DIR_VER, 0);
-    lv_obj_set_style_bg_opa(card, LV_OPA_100, 0);
-    lv_obj_set_style_pad_all(card, 0, 0);
+    // 相同配色/圆角的卡片共用一份渐变样式
+    lv_obj_add_style(card, StyleRegistry::getInstance().gradient(color_start, color_end, radius), 0);
     lv_obj_clear_flag(card, LV_OBJ_FLAG_SCROLLABLE);
     
     return card;
 }
 
+// UI 线程：点歌结果
+static void onQueueResult(const std::string& song_id, bool ok) {
+    if (!ok) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][action] action=add_to_queue song_id=%s status=failed", song_id.c_str());
+        return;
+    }
+    KTV_SYSLOG(LOG_INFO, "[ktv][ui][action] action=add_to_queue song_id=%s status=success", song_id.c_str());
+    ktv::events::Event ev;
+    ev.type = ktv::events::EventType::SongSelected;
+    ev.payload = song_id;
+    ktv::events::EventBus::getInstance().publish(ev);
+    ktv::services::PlayerService::getInstance().onSongQueued();
+}
+
+void queueSong(const std::string& song_id) {
+    auto job = [song_id] {
+        bool ok = ktv::services::SongService::getInstance().addToQueue(song_id);
+        ktv::events::UiDispatcher::getInstance().post([song_id, ok] { onQueueResult(song_id, ok); });
+    };
+    // Background Lane 满时可能挤掉排队中的点歌：按失败处理，不在 UI 线程上同步重试
+    auto dropped = [song_id] {
+        KTV_SYSLOG(LOG_INFO, "[ktv][ui][action] action=add_to_queue song_id=%s dropped", song_id.c_str());
+        ktv::events::UiDispatcher::getInstance().post([song_id] { onQueueResult(song_id, false); });
+    };
+    if (!ktv::core::Executor::instance().post(ktv::core::Lane::Background, job, dropped)) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][action] action=add_to_queue song_id=%s status=executor_rejected",
+                   song_id.c_str());
+    }
+}
+
 static void onSongClick(lv_event_t* e) {
     const char* song_id = static_cast<const char*>(lv_event_get_user_data(e));
     if (!song_id) return;
-    
-    bool ok = ktv::services::SongService::getInstance().addToQueue(song_id);
-    if (!ok) {
-        syslog(LOG_WARNING, "[ktv][ui][action] action=add_to_queue song_id=%s status=failed", song_id.c_str());
-    } else {
-        syslog(LOG_INFO, "[ktv][ui][action] action=add_to_queue song_id=%s status=success", song_id.c_str());
-        ktv::events::Event ev;
-        ev.type = ktv::events::EventType::SongSelected;
-        ev.payload = song_id;
-        ktv::events::EventBus::getInstance().publish(ev);
-    }
+    queueSong(song_id);
 }
 
 lv_obj_t* createActionButton(lv_obj_t* parent, const char* text, bool enabled) {
@@ -103,41 +136,38 @@ lv_obj_t* createActionButton(lv_obj_t* parent, const char* text, bool enabled) {
 
 lv_obj_t* createSongListItem(lv_obj_t* parent, const char* title, const char* subtitle,
                              const char* song_id) {
+    initStyles();
+
     lv_obj_t* item = lv_obj_create(parent);
+    lv_obj_add_style(item, &style_song_item, 0);
     lv_obj_set_width(item, LV_PCT(100));
     lv_obj_set_height(item, UIScale::s(72));
-    lv_obj_set_style_radius(item, UIScale::s(12), 0);
-    lv_obj_set_style_bg_color(item, lv_color_hex(0x67579E), 0);
-    lv_obj_set_style_bg_opa(item, LV_OPA_50, 0);
-    lv_obj_set_style_pad_all(item, UIScale::s(8), 0);
     lv_obj_clear_flag(item, LV_OBJ_FLAG_SCROLLABLE);
     
     // 使用 flex 布局
     lv_obj_set_flex_flow(item, LV_FLEX_FLOW_ROW);
-    lv_obj_set_style_pad_column(item, UIScale::s(6), 0);
     
     // 标题和副标题
     lv_obj_t* text_container = lv_obj_create(item);
+    lv_obj_add_style(text_container, &style_song_text, 0);
     lv_obj_set_flex_grow(text_container, 1);
-    lv_obj_set_style_bg_opa(text_container, LV_OPA_TRANSP, 0);
     lv_obj_clear_flag(text_container, LV_OBJ_FLAG_SCROLLABLE);
     lv_obj_set_flex_flow(text_container, LV_FLEX_FLOW_COLUMN);
-    lv_obj_set_style_pad_row(text_container, UIScale::s(4), 0);
     
     lv_obj_t* title_lbl = lv_label_create(text_container);
     lv_label_set_text(title_lbl, title);
-    lv_obj_set_style_text_color(title_lbl, lv_color_white(), 0);
+    lv_obj_add_style(title_lbl, StyleRegistry::getInstance().textColor(0xFFFFFF), 0);
     
     if (subtitle) {
         lv_obj_t* sub_lbl = lv_label_create(text_container);
         lv_label_set_text(sub_lbl, subtitle);
-        lv_obj_set_style_text_color(sub_lbl, lv_color_hex(0xC8C9D4), 0);
+        lv_obj_add_style(sub_lbl, StyleRegistry::getInstance().textColor(0xC8C9D4), 0);
     }
     
     // 点歌按钮
     if (song_id) {
         lv_obj_t* play_btn = lv_btn_create(item);
-        lv_obj_set_style_pad_all(play_btn, UIScale::s(10), 0);
+        lv_obj_add_style(play_btn, StyleRegistry::getInstance().padAll(10), 0);
         lv_obj_t* play_lbl = lv_label_create(play_btn);
         lv_label_set_text(play_lbl, LV_SYMBOL_PLAY " 点歌");
         lv_obj_center(play_lbl);
@@ -2,6 +2,7 @@
 #define KTVLV_UI_COMPONENTS_H
 
 #include <lvgl.h>
+#include <string>
 
 namespace ktv::ui::components {
 
@@ -10,7 +11,7 @@ namespace ktv::ui::components {
  * @param parent 父容器
  * @param color_start 起始颜色（hex）
  * @param color_end 结束颜色（hex）
- * @param radius 圆角半径（已缩放）
+ * @param radius 圆角半径（设计稿数值，按 UIScale 缩放）
  * @return 卡片对象
  */
 lv_obj_t* createGradientCard(lv_obj_t* parent, uint32_t color_start, uint32_t color_end,
@@ -36,6 +37,13 @@ lv_obj_t* createActionButton(lv_obj_t* parent, const char* text, bool enabled =
 lv_obj_t* createSongListItem(lv_obj_t* parent, const char* title, const char* subtitle,
                              const char* song_id = nullptr);
 
+/**
+ * 点歌：点歌接口是阻塞 HTTP 请求，投递到 Background Lane 执行，不占用 LVGL 线程
+ * 结果经 UiDispatcher 回到 UI 线程：成功时发布 SongSelected 并通知播放器，失败/被丢弃时记录日志
+ * @param song_id 歌曲ID
+ */
+void queueSong(const std::string& song_id);
+
 }  // namespace ktv::ui::components
 
 #endif  // KTVLV_UI_COMPONENTS_H
@@ -0,0 +1,105 @@
+#include "download_view.h"
+#include "style_registry.h"
+#include "ui_scale.h"
+#include "../utils/json_helper.h"
+#include "../utils/log_macros.h"
+
+namespace ktv::ui {
+
+namespace {
+
+struct Fields {
+    std::string kind;
+    std::string state;
+    double segments_done = 0.0;
+    double segments_total = 0.0;
+    double eta_ms = -1.0;
+};
+
+bool parse(const std::string& payload, Fields& out) {
+    ktv::utils::JsonDocument doc;
+    if (JsonHelper::Parse(payload.c_str(), payload.size(), &doc) != 0) return false;
+    const cJSON* root = doc.root();
+    char buf[32]{0};
+    if (JsonHelper::GetString(root, "kind", buf, sizeof(buf)) == 0) out.kind = buf;
+    if (JsonHelper::GetString(root, "state", buf, sizeof(buf)) == 0) out.state = buf;
+    ktv::utils::OutDouble d;
+    if (JsonHelper::GetDouble(root, "segments_done", &d) == 0) out.segments_done = d.value;
+    if (JsonHelper::GetDouble(root, "segments_total", &d) == 0) out.segments_total = d.value;
+    if (JsonHelper::GetDouble(root, "eta_ms", &d) == 0) out.eta_ms = d.value;
+    return true;
+}
+
+}  // namespace
+
+void DownloadView::ensureCreated() {
+    if (panel_) return;
+    auto& reg = StyleRegistry::getInstance();
+
+    panel_ = lv_obj_create(lv_layer_top());
+    lv_obj_add_style(panel_, reg.bg(0x000000, LV_OPA_50), 0);
+    lv_obj_add_style(panel_, reg.radius(12), 0);
+    lv_obj_add_style(panel_, reg.spacing(6, 12), 0);
+    lv_obj_add_style(panel_, reg.border(0), 0);
+    lv_obj_set_size(panel_, UIScale::s(280), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(panel_, LV_FLEX_FLOW_COLUMN);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_align(panel_, LV_ALIGN_BOTTOM_RIGHT, -UIScale::s(24), -UIScale::s(24));
+
+    label_ = lv_label_create(panel_);
+    lv_obj_add_style(label_, reg.textColor(0xFFFFFF), 0);
+    lv_obj_add_style(label_, reg.text(20), 0);
+    lv_label_set_text(label_, "");
+
+    bar_ = lv_bar_create(panel_);
+    lv_bar_set_range(bar_, 0, 100);
+    lv_obj_set_size(bar_, LV_PCT(100), UIScale::s(8));
+    lv_obj_add_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void DownloadView::onProgress(const std::string& payload) {
+    Fields f;
+    if (!parse(payload, f) || f.kind != "full") return;
+    ensureCreated();
+
+    int pct = f.segments_total > 0.0 ? static_cast<int>(f.segments_done * 100.0 / f.segments_total) : 0;
+    if (pct > 100) pct = 100;
+    lv_bar_set_value(bar_, pct, LV_ANIM_OFF);
+
+    const bool finished = f.state == "done" || f.state == "failed";
+    if (f.state == "failed") {
+        lv_label_set_text(label_, "缓存失败");
+    } else if (finished) {
+        lv_label_set_text(label_, "缓存完成");
+    } else if (f.eta_ms > 0.0) {
+        lv_label_set_text_fmt(label_, "缓存 %d%%  剩余 %ds", pct, static_cast<int>((f.eta_ms + 999.0) / 1000.0));
+    } else {
+        lv_label_set_text_fmt(label_, "缓存 %d%%", pct);
+    }
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+
+    if (!finished) {
+        // 新任务开始时取消上一个任务的延迟隐藏
+        if (hide_timer_) {
+            lv_timer_del(hide_timer_);
+            hide_timer_ = nullptr;
+        }
+        return;
+    }
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][download] action=finished state=%s", f.state.c_str());
+    if (hide_timer_) {
+        lv_timer_reset(hide_timer_);
+    } else {
+        hide_timer_ = lv_timer_create(onHideTimer, kHideDelayMs, this);
+        lv_timer_set_repeat_count(hide_timer_, 1);
+    }
+}
+
+void DownloadView::onHideTimer(lv_timer_t* timer) {
+    auto* self = static_cast<DownloadView*>(timer->user_data);
+    self->hide_timer_ = nullptr;   // 单次定时器，回调返回后 LVGL 自行删除
+    lv_obj_add_flag(self->panel_, LV_OBJ_FLAG_HIDDEN);
+}
+
+}  // namespace ktv::ui
@@ -0,0 +1,48 @@
+#ifndef KTVLV_UI_DOWNLOAD_VIEW_H
+#define KTVLV_UI_DOWNLOAD_VIEW_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <string>
+
+namespace ktv::ui {
+
+/**
+ * 歌曲缓存进度浮层（DownloadProgress 事件的 UI 消费方）
+ *
+ * - 右下角一条进度条 + "缓存 xx%  剩余 Ns"，只显示正常下载（kind=full），预取在后台静默进行
+ * - 任务结束（state=done/failed）后显示结果，kHideDelayMs 后隐藏；yielded 不会出现在 full 任务上
+ *
+ * 挂在 lv_layer_top() 上，首个事件到达时才创建。payload 为 M3u8DownloadService 发布的 JSON。
+ * 只能在 UI 线程调用（EventBus::dispatchOnUiThread）。
+ */
+class DownloadView {
+public:
+    static DownloadView& getInstance() {
+        static DownloadView instance;
+        return instance;
+    }
+
+    DownloadView(const DownloadView&) = delete;
+    DownloadView& operator=(const DownloadView&) = delete;
+
+    void onProgress(const std::string& payload);
+
+private:
+    static constexpr uint32_t kHideDelayMs = 2000;
+
+    DownloadView() = default;
+    ~DownloadView() = default;
+
+    void ensureCreated();
+    static void onHideTimer(lv_timer_t* timer);
+
+    lv_obj_t* panel_ = nullptr;
+    lv_obj_t* label_ = nullptr;
+    lv_obj_t* bar_ = nullptr;
+    lv_timer_t* hide_timer_ = nullptr;
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_DOWNLOAD_VIEW_H
@@ -0,0 +1,472 @@
+#include "image_cache.h"
+#include "../core/executor.h"
+#include "../events/ui_dispatcher.h"
+#include <curl/curl.h>
+#include "../utils/log_macros.h"
+#include <algorithm>
+#include <atomic>
+#include <cerrno>
+#include <chrono>
+#include <cinttypes>
+#include <cstdio>
+#include <cstring>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#include <utime.h>
+
+#define XXH_INLINE_ALL
+#include "xxhash.h"
+
+// 只编译 PNG/JPEG 解码；stb 使用 malloc，可以在后台线程调用（lodepng/sjpg 走 lv_mem，非线程安全）
+#define STB_IMAGE_IMPLEMENTATION
+#define STBI_ONLY_PNG
+#define STBI_ONLY_JPEG
+#define STBI_NO_STDIO
+#include "stb_image.h"
+
+namespace ktv::ui {
+
+namespace {
+
+constexpr size_t kMaxSourceBytes = 4 * 1024 * 1024;   // 原图下载上限
+constexpr long kFetchTimeoutSec = 10;
+constexpr int kPruneEveryWrites = 32;                  // 每写入若干缩略图检查一次目录大小
+
+// 缩略图文件头（像素按当前 LV_COLOR_DEPTH 原样存储）
+struct ThumbHeader {
+    char magic[4];
+    uint8_t version;
+    uint8_t color_depth;
+    uint8_t cf;
+    uint8_t reserved;
+    uint16_t w;
+    uint16_t h;
+    uint32_t size;
+};
+constexpr char kThumbMagic[4] = {'K', 'T', 'V', 'T'};
+constexpr uint8_t kThumbVersion = 1;
+
+std::atomic<int> g_thumb_writes{0};
+
+bool ensure_dir(const std::string& path) {
+    if (path.empty()) return false;
+    std::string cur;
+    for (size_t i = 0; i <= path.size(); ++i) {
+        if (i == path.size() || (path[i] == '/' && i > 0)) {
+            cur = path.substr(0, i);
+            if (::mkdir(cur.c_str(), 0755) != 0 && errno != EEXIST) return false;
+        }
+    }
+    return true;
+}
+
+std::string thumb_path(const ktv::config::ImageCacheConfig& cfg, const std::string& key) {
+    char name[32];
+    std::snprintf(name, sizeof(name), "%016" PRIx64 ".thumb", static_cast<uint64_t>(XXH3_64bits(key.data(), key.size())));
+    return cfg.thumb_dir + "/" + name;
+}
+
+size_t fetch_cb(void* data, size_t size, size_t nmemb, void* userp) {
+    auto* out = static_cast<std::vector<uint8_t>*>(userp);
+    size_t total = size * nmemb;
+    if (out->size() + total > kMaxSourceBytes) return 0;   // 超出上限中止
+    const uint8_t* p = static_cast<const uint8_t*>(data);
+    out->insert(out->end(), p, p + total);
+    return total;
+}
+
+bool fetch_http(const std::string& url, std::vector<uint8_t>& out) {
+    // 独立句柄：不占用 HttpService 的共享句柄（图片下载耗时较长）
+    CURL* curl = curl_easy_init();
+    if (!curl) return false;
+    curl_easy_setopt(curl, CURLOPT_URL, url.c_str());
+    curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, fetch_cb);
+    curl_easy_setopt(curl, CURLOPT_WRITEDATA, &out);
+    curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+    curl_easy_setopt(curl, CURLOPT_TIMEOUT, kFetchTimeoutSec);
+    curl_easy_setopt(curl, CURLOPT_NOSIGNAL, 1L);
+    CURLcode res = curl_easy_perform(curl);
+    long status = 0;
+    curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &status);
+    curl_easy_cleanup(curl);
+    return res == CURLE_OK && status == 200 && !out.empty();
+}
+
+bool read_file(const std::string& path, std::vector<uint8_t>& out, size_t limit) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    uint8_t buf[16 * 1024];
+    size_t n;
+    while ((n = std::fread(buf, 1, sizeof(buf), fp)) > 0) {
+        if (out.size() + n > limit) {
+            std::fclose(fp);
+            return false;
+        }
+        out.insert(out.end(), buf, buf + n);
+    }
+    std::fclose(fp);
+    return !out.empty();
+}
+
+bool fetch_source(const std::string& url, std::vector<uint8_t>& out) {
+    if (url.compare(0, 7, "http://") == 0 || url.compare(0, 8, "https://") == 0) return fetch_http(url, out);
+    if (url.compare(0, 7, "file://") == 0) return read_file(url.substr(7), out, kMaxSourceBytes);
+    return read_file(url, out, kMaxSourceBytes);
+}
+
+// RGBA8888 → 目标尺寸 RGBA8888：居中裁剪到目标宽高比，缩小时按区域平均，放大时取最近点
+void scale_cover(const uint8_t* src, int sw, int sh, uint8_t* dst, int dw, int dh) {
+    int cw = sw, ch = sh;
+    if (static_cast<int64_t>(sw) * dh > static_cast<int64_t>(sh) * dw) {
+        cw = static_cast<int>(static_cast<int64_t>(sh) * dw / dh);
+    } else {
+        ch = static_cast<int>(static_cast<int64_t>(sw) * dh / dw);
+    }
+    cw = std::max(cw, 1);
+    ch = std::max(ch, 1);
+    const int ox = (sw - cw) / 2;
+    const int oy = (sh - ch) / 2;
+
+    for (int y = 0; y < dh; ++y) {
+        int y0 = oy + y * ch / dh;
+        int y1 = std::max(y0 + 1, oy + (y + 1) * ch / dh);
+        for (int x = 0; x < dw; ++x) {
+            int x0 = ox + x * cw / dw;
+            int x1 = std::max(x0 + 1, ox + (x + 1) * cw / dw);
+            uint32_t acc[4] = {0, 0, 0, 0};
+            for (int yy = y0; yy < y1; ++yy) {
+                const uint8_t* row = src + (static_cast<size_t>(yy) * sw + x0) * 4;
+                for (int xx = x0; xx < x1; ++xx, row += 4) {
+                    acc[0] += row[0];
+                    acc[1] += row[1];
+                    acc[2] += row[2];
+                    acc[3] += row[3];
+                }
+            }
+            uint32_t n = static_cast<uint32_t>((y1 - y0) * (x1 - x0));
+            uint8_t* out = dst + (static_cast<size_t>(y) * dw + x) * 4;
+            for (int c = 0; c < 4; ++c) out[c] = static_cast<uint8_t>(acc[c] / n);
+        }
+    }
+}
+
+// RGBA8888 → LVGL 原生格式（LV_COLOR_DEPTH），不透明图片不保留 alpha 通道
+void to_native(const uint8_t* rgba, size_t count, lv_img_cf_t& cf, std::vector<uint8_t>& out) {
+    bool has_alpha = false;
+    for (size_t i = 0; i < count && !has_alpha; ++i) has_alpha = rgba[i * 4 + 3] != 0xFF;
+
+    cf = has_alpha ? LV_IMG_CF_TRUE_COLOR_ALPHA : LV_IMG_CF_TRUE_COLOR;
+    const size_t px = has_alpha ? LV_IMG_PX_SIZE_ALPHA_BYTE : sizeof(lv_color_t);
+    out.resize(count * px);
+    uint8_t* dst = out.data();
+    for (size_t i = 0; i < count; ++i, dst += px) {
+        const uint8_t* s = rgba + i * 4;
+        lv_color_t c = lv_color_make(s[0], s[1], s[2]);
+#if LV_COLOR_DEPTH == 32
+        c.ch.alpha = has_alpha ? s[3] : 0xFF;
+        std::memcpy(dst, &c, sizeof(c));
+#else
+        std::memcpy(dst, &c, sizeof(c));
+        if (has_alpha) dst[sizeof(c)] = s[3];
+#endif
+    }
+}
+
+bool read_thumb(const std::string& path, uint16_t w, uint16_t h, lv_img_cf_t& cf, std::vector<uint8_t>& out) {
+    FILE* fp = std::fopen(path.c_str(), "rb");
+    if (!fp) return false;
+    ThumbHeader hdr{};
+    bool ok = std::fread(&hdr, sizeof(hdr), 1, fp) == 1 &&
+              std::memcmp(hdr.magic, kThumbMagic, sizeof(kThumbMagic)) == 0 &&
+              hdr.version == kThumbVersion && hdr.color_depth == LV_COLOR_DEPTH &&
+              hdr.w == w && hdr.h == h &&
+              (hdr.cf == LV_IMG_CF_TRUE_COLOR || hdr.cf == LV_IMG_CF_TRUE_COLOR_ALPHA);
+    // 像素字节数必须与尺寸/格式完全一致：短了 LVGL 绘制时会越界读
+    const uint32_t px = hdr.cf == LV_IMG_CF_TRUE_COLOR ? sizeof(lv_color_t) : LV_IMG_PX_SIZE_ALPHA_BYTE;
+    ok = ok && hdr.size == static_cast<uint32_t>(w) * h * px;
+    if (ok) {
+        out.resize(hdr.size);
+        ok = std::fread(out.data(), 1, out.size(), fp) == out.size();
+        cf = static_cast<lv_img_cf_t>(hdr.cf);
+    }
+    std::fclose(fp);
+    if (ok) ::utime(path.c_str(), nullptr);   // 更新修改时间，作为磁盘 LRU 依据
+    return ok;
+}
+
+bool write_thumb(const std::string& path, uint16_t w, uint16_t h, lv_img_cf_t cf, const std::vector<uint8_t>& data) {
+    ThumbHeader hdr{};
+    std::memcpy(hdr.magic, kThumbMagic, sizeof(kThumbMagic));
+    hdr.version = kThumbVersion;
+    hdr.color_depth = LV_COLOR_DEPTH;
+    hdr.cf = static_cast<uint8_t>(cf);
+    hdr.w = w;
+    hdr.h = h;
+    hdr.size = static_cast<uint32_t>(data.size());
+
+    // 先写临时文件再 rename，断电不会留下半个缩略图
+    std::string tmp = path + ".tmp";
+    FILE* fp = std::fopen(tmp.c_str(), "wb");
+    if (!fp) return false;
+    bool ok = std::fwrite(&hdr, sizeof(hdr), 1, fp) == 1 &&
+              std::fwrite(data.data(), 1, data.size(), fp) == data.size();
+    ok = (std::fclose(fp) == 0) && ok;
+    if (!ok || std::rename(tmp.c_str(), path.c_str()) != 0) {
+        std::remove(tmp.c_str());
+        return false;
+    }
+    return true;
+}
+
+}  // namespace
+
+std::string ImageCache::makeKey(const std::string& url, lv_coord_t w, lv_coord_t h) {
+    return url + "@" + std::to_string(w) + "x" + std::to_string(h);
+}
+
+void ImageCache::setConfig(const ktv::config::ImageCacheConfig& cfg) {
+    cfg_ = cfg;
+    if (cfg_.thumb_dir.empty()) return;
+    if (!ensure_dir(cfg_.thumb_dir)) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][image] action=init dir=%s reason=mkdir_failed", cfg_.thumb_dir.c_str());
+        cfg_.thumb_dir.clear();
+        return;
+    }
+    auto snapshot = cfg_;
+    ktv::core::Executor::instance().post(ktv::core::Lane::Background, [snapshot] { pruneDisk(snapshot); });
+}
+
+void ImageCache::bind(lv_obj_t* img, const std::string& url, lv_coord_t w, lv_coord_t h) {
+    if (!img || w <= 0 || h <= 0) return;
+    std::string key = makeKey(url, w, h);
+
+    auto bit = bindings_.find(img);
+    if (bit != bindings_.end()) {
+        // 行复用时绑定了同一张图：已显示或仍在加载就不用动（加载被丢弃过的重新发起）
+        if (bit->second.key == key && (bit->second.applied || waiting_.count(key))) return;
+        detach(img);
+    } else {
+        lv_obj_add_event_cb(img, onImgDeleted, LV_EVENT_DELETE, nullptr);
+    }
+    Binding& binding = bindings_[img];
+    binding.key = key;
+    lv_obj_set_size(img, w, h);
+
+    if (auto it = entries_.find(key); it != entries_.end()) {
+        ++stats_.mem_hits;
+        lru_.splice(lru_.begin(), lru_, it->second.lru_pos);
+        apply(img, it->second);
+        binding.applied = true;
+        return;
+    }
+
+    lv_img_set_src(img, LV_SYMBOL_IMAGE);
+    if (url.empty()) return;
+
+    auto [wit, first] = waiting_.try_emplace(key);
+    wit->second.insert(img);
+    if (!first) return;   // 同一张图已在加载，完成后一起替换
+
+    auto cfg = cfg_;
+    auto job = [this, cfg, key, url, w, h] {
+        auto bitmap = std::make_shared<Bitmap>();
+        bool from_disk = false;
+        if (!load(cfg, key, url, static_cast<uint16_t>(w), static_cast<uint16_t>(h), *bitmap, from_disk)) {
+            bitmap.reset();
+        }
+        ktv::events::UiDispatcher::getInstance().post([this, key, bitmap, from_disk] {
+            onLoaded(key, bitmap, from_disk);
+        });
+    };
+    // 排队中被 DropOldest 挤掉：回到 UI 线程清掉 waiting_，否则同一张图以后永远不再加载
+    auto on_drop = [this, key] {
+        ktv::events::UiDispatcher::getInstance().post([this, key] { onDropped(key); });
+    };
+    if (!ktv::core::Executor::instance().post(ktv::core::Lane::Background, job, on_drop)) {
+        // 后台队列不可用：保持占位符，下次 bind 再试
+        waiting_.erase(key);
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][image] action=load reason=executor_rejected");
+    }
+}
+
+void ImageCache::unbind(lv_obj_t* img) {
+    if (!bindings_.count(img)) return;
+    detach(img);
+    lv_obj_remove_event_cb(img, onImgDeleted);
+    lv_img_set_src(img, nullptr);   // 不再持有引用，位图随时可能被淘汰
+}
+
+void ImageCache::onImgDeleted(lv_event_t* e) {
+    getInstance().detach(lv_event_get_target(e));
+}
+
+void ImageCache::detach(lv_obj_t* img) {
+    auto it = bindings_.find(img);
+    if (it == bindings_.end()) return;
+    if (it->second.applied) {
+        release(it->second.key);
+    } else if (auto wit = waiting_.find(it->second.key); wit != waiting_.end()) {
+        wit->second.erase(img);   // key 保留：加载仍在进行，结果照常入缓存
+    }
+    bindings_.erase(it);
+}
+
+ImageCache::Stats ImageCache::stats() const {
+    Stats s = stats_;
+    s.entries = entries_.size();
+    s.mem_bytes = mem_bytes_;
+    return s;
+}
+
+bool ImageCache::load(const ktv::config::ImageCacheConfig& cfg, const std::string& key, const std::string& url,
+                      uint16_t w, uint16_t h, Bitmap& out, bool& from_disk) {
+    auto begin = std::chrono::steady_clock::now();
+    out.w = w;
+    out.h = h;
+
+    const std::string path = cfg.thumb_dir.empty() ? std::string() : thumb_path(cfg, key);
+    if (!path.empty() && read_thumb(path, w, h, out.cf, out.pixels)) {
+        from_disk = true;
+        return true;
+    }
+
+    std::vector<uint8_t> source;
+    if (!fetch_source(url, source)) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][image] action=fetch url=%s reason=failed", url.c_str());
+        return false;
+    }
+    int sw = 0, sh = 0, channels = 0;
+    stbi_uc* rgba = stbi_load_from_memory(source.data(), static_cast<int>(source.size()), &sw, &sh, &channels, 4);
+    if (!rgba) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][image] action=decode url=%s reason=%s", url.c_str(), stbi_failure_reason());
+        return false;
+    }
+    source.clear();
+    source.shrink_to_fit();
+
+    std::vector<uint8_t> scaled(static_cast<size_t>(w) * h * 4);
+    scale_cover(rgba, sw, sh, scaled.data(), w, h);
+    stbi_image_free(rgba);
+    to_native(scaled.data(), static_cast<size_t>(w) * h, out.cf, out.pixels);
+
+    if (!path.empty() && write_thumb(path, w, h, out.cf, out.pixels) &&
+        ++g_thumb_writes % kPruneEveryWrites == 0) {
+        pruneDisk(cfg);
+    }
+
+    auto cost_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][image] action=decode src=%dx%d dst=%ux%u bytes=%zu cost_ms=%lld",
+               sw, sh, w, h, out.pixels.size(), static_cast<long long>(cost_ms));
+    return true;
+}
+
+void ImageCache::pruneDisk(const ktv::config::ImageCacheConfig& cfg) {
+    if (cfg.thumb_dir.empty() || cfg.disk_budget_mb <= 0) return;
+    DIR* dir = ::opendir(cfg.thumb_dir.c_str());
+    if (!dir) return;
+
+    struct File {
+        std::string path;
+        time_t mtime;
+        size_t size;
+    };
+    std::vector<File> files;
+    size_t total = 0;
+    while (dirent* ent = ::readdir(dir)) {
+        if (ent->d_name[0] == '.') continue;
+        std::string path = cfg.thumb_dir + "/" + ent->d_name;
+        struct stat st{};
+        if (::stat(path.c_str(), &st) != 0 || !S_ISREG(st.st_mode)) continue;
+        files.push_back({path, st.st_mtime, static_cast<size_t>(st.st_size)});
+        total += static_cast<size_t>(st.st_size);
+    }
+    ::closedir(dir);
+
+    const size_t budget = static_cast<size_t>(cfg.disk_budget_mb) * 1024 * 1024;
+    if (total <= budget) return;
+
+    // 删到预算的 80%，避免每次写入都触发清理
+    std::sort(files.begin(), files.end(), [](const File& a, const File& b) { return a.mtime < b.mtime; });
+    size_t removed = 0;
+    for (const auto& f : files) {
+        if (total <= budget * 4 / 5) break;
+        if (std::remove(f.path.c_str()) == 0) {
+            total -= f.size;
+            ++removed;
+        }
+    }
+    KTV_SYSLOG(LOG_INFO, "[ktv][ui][image] action=prune_disk removed=%zu remaining_bytes=%zu", removed, total);
+}
+
+void ImageCache::onLoaded(const std::string& key, std::shared_ptr<Bitmap> bitmap, bool from_disk) {
+    auto wit = waiting_.find(key);
+    std::unordered_set<lv_obj_t*> objs;
+    if (wit != waiting_.end()) {
+        objs = std::move(wit->second);
+        waiting_.erase(wit);
+    }
+    if (!bitmap) {
+        ++stats_.failures;   // 保持占位符
+        return;
+    }
+    ++(from_disk ? stats_.disk_hits : stats_.decodes);
+
+    lru_.push_front(key);
+    Entry& entry = entries_[key];
+    entry.bitmap = std::move(*bitmap);
+    entry.lru_pos = lru_.begin();
+    entry.dsc.header.always_zero = 0;
+    entry.dsc.header.cf = entry.bitmap.cf;
+    entry.dsc.header.w = entry.bitmap.w;
+    entry.dsc.header.h = entry.bitmap.h;
+    entry.dsc.data_size = static_cast<uint32_t>(entry.bitmap.pixels.size());
+    entry.dsc.data = entry.bitmap.pixels.data();
+    mem_bytes_ += entry.bitmap.pixels.size();
+
+    for (lv_obj_t* img : objs) {
+        auto bit = bindings_.find(img);
+        if (bit == bindings_.end() || bit->second.key != key || bit->second.applied) continue;
+        apply(img, entry);
+        bit->second.applied = true;
+    }
+    enforceBudget();
+}
+
+void ImageCache::onDropped(const std::string& key) {
+    // 对象保持占位符；下次 bind 同一张图时重新发起加载
+    if (waiting_.erase(key)) {
+        KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][image] action=load key=%s reason=dropped", key.c_str());
+    }
+}
+
+void ImageCache::apply(lv_obj_t* img, Entry& entry) {
+    lv_img_set_src(img, &entry.dsc);
+    ++entry.refs;
+}
+
+void ImageCache::release(const std::string& key) {
+    auto it = entries_.find(key);
+    if (it != entries_.end() && it->second.refs > 0) --it->second.refs;
+}
+
+void ImageCache::enforceBudget() {
+    const size_t budget = cfg_.mem_budget_kb > 0 ? static_cast<size_t>(cfg_.mem_budget_kb) * 1024 : 0;
+    if (budget == 0) return;
+
+    // 从最久未用开始淘汰，正在显示的图片跳过
+    auto it = lru_.end();
+    while (mem_bytes_ > budget && it != lru_.begin()) {
+        --it;
+        auto eit = entries_.find(*it);
+        if (eit == entries_.end() || eit->second.refs > 0) continue;
+        lv_img_cache_invalidate_src(&eit->second.dsc);
+        mem_bytes_ -= eit->second.bitmap.pixels.size();
+        entries_.erase(eit);
+        it = lru_.erase(it);
+        ++stats_.evictions;
+    }
+}
+
+}  // namespace ktv::ui
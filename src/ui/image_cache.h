@@ -0,0 +1,112 @@
+#ifndef KTVLV_UI_IMAGE_CACHE_H
+#define KTVLV_UI_IMAGE_CACHE_H
+
+#include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <string>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../config/config.h"
+
+namespace ktv::ui {
+
+/**
+ * 图片缓存（封面 / 歌手图 / 二维码等远程图片）
+ *
+ * - bind() 先显示占位符；内存命中时同步换上图片，否则在 Background Lane 加载
+ * - 加载顺序：磁盘缩略图 → 网络/本地文件解码（PNG/JPEG）→ 按目标尺寸居中裁剪缩放
+ *   → 转成显示器原生像素格式，绘制时 LVGL 直接拷贝，不再逐帧解码
+ * - 解码结果按 “URL + 尺寸” 做 LRU，总字节数受 mem_budget_kb 约束；正在显示的图片不会被淘汰
+ * - 缩略图以原生格式落盘，目录超出 disk_budget_mb 时按修改时间删除最旧的文件
+ * - 加载完成经 UiDispatcher 回到 UI 线程，替换所有仍在等待该图片的对象
+ *
+ * 使用方：歌曲列表行封面（layouts.cpp bind_song_row）
+ *
+ * 调用线程：bind()/unbind() 只在 UI 线程调用
+ */
+class ImageCache {
+public:
+    struct Stats {
+        uint64_t mem_hits = 0;
+        uint64_t disk_hits = 0;
+        uint64_t decodes = 0;
+        uint64_t failures = 0;
+        uint64_t evictions = 0;
+        size_t entries = 0;
+        size_t mem_bytes = 0;
+    };
+
+    static ImageCache& getInstance() {
+        static ImageCache instance;
+        return instance;
+    }
+
+    ImageCache(const ImageCache&) = delete;
+    ImageCache& operator=(const ImageCache&) = delete;
+
+    void setConfig(const ktv::config::ImageCacheConfig& cfg);
+
+    // img 必须是 lv_img 对象；w/h 为缩放后的显示尺寸（UIScale::s 之后）
+    void bind(lv_obj_t* img, const std::string& url, lv_coord_t w, lv_coord_t h);
+
+    // 解除绑定并清空图片源（对象删除时自动解除，无需调用）
+    void unbind(lv_obj_t* img);
+
+    Stats stats() const;
+
+private:
+    ImageCache() = default;
+    ~ImageCache() = default;
+
+    // 原生像素格式的位图（后台线程生成，UI 线程接管）
+    struct Bitmap {
+        lv_img_cf_t cf = LV_IMG_CF_TRUE_COLOR;
+        uint16_t w = 0;
+        uint16_t h = 0;
+        std::vector<uint8_t> pixels;
+    };
+
+    struct Entry {
+        Bitmap bitmap;
+        lv_img_dsc_t dsc{};
+        int refs = 0;                             // 正在显示该图片的对象数
+        std::list<std::string>::iterator lru_pos;
+    };
+
+    struct Binding {
+        std::string key;
+        bool applied = false;   // true：已显示并持有 Entry 引用；false：在 waiting_ 中等待
+    };
+
+    static std::string makeKey(const std::string& url, lv_coord_t w, lv_coord_t h);
+    static void onImgDeleted(lv_event_t* e);
+
+    // 后台线程
+    static bool load(const ktv::config::ImageCacheConfig& cfg, const std::string& key, const std::string& url,
+                     uint16_t w, uint16_t h, Bitmap& out, bool& from_disk);
+    static void pruneDisk(const ktv::config::ImageCacheConfig& cfg);
+
+    void detach(lv_obj_t* img);
+    void onLoaded(const std::string& key, std::shared_ptr<Bitmap> bitmap, bool from_disk);
+    void onDropped(const std::string& key);
+    void apply(lv_obj_t* img, Entry& entry);
+    void release(const std::string& key);
+    void enforceBudget();
+
+    ktv::config::ImageCacheConfig cfg_;
+
+    std::unordered_map<std::string, Entry> entries_;
+    std::list<std::string> lru_;                                        // 头部为最近使用
+    size_t mem_bytes_ = 0;
+    std::unordered_map<lv_obj_t*, Binding> bindings_;
+    std::unordered_map<std::string, std::unordered_set<lv_obj_t*>> waiting_;   // key → 等待加载的对象
+    Stats stats_;
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_IMAGE_CACHE_H
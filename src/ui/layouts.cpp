@@ -1,12 +1,24 @@
 #include "layouts.h"
 #include "page_manager.h"
 #include "ui_scale.h"
+#include "style_registry.h"
 #include "focus_manager.h"
+#include "virtual_list.h"
+#include "image_cache.h"
+#include "components.h"
 #include "../services/mock_data.h"
+#include "../services/player_service.h"
 #include "../services/song_service.h"
+#include "../services/prefetch_service.h"
+#include "../services/search_service.h"
 #include "../events/event_bus.h"
-#include <syslog.h>
+#include "../utils/log_macros.h"
+#include <algorithm>
+#include <chrono>
+#include <functional>
+#include <memory>
 #include <vector>
+#include <stdexcept>
 #include <string>
 
 // 兼容配置缺省时的心形符号
@@ -27,6 +39,7 @@ lv_style_t style_focus;
 lv_style_t style_shadow;
 lv_style_t style_vip;
 lv_style_t style_subtext;
+lv_style_t style_skeleton;
 
 lv_color_t color_hex(uint32_t hex) {
     return lv_color_hex(hex);
@@ -41,6 +54,9 @@ static inline lv_coord_t kPad() { return UIScale::s(12); }
 static inline lv_coord_t kGap() { return UIScale::s(10); }
 static inline lv_coord_t kRadius() { return UIScale::s(12); }
 
+// 搜索输入延迟目标（按键 → 结果列表重排完成）
+static constexpr std::chrono::milliseconds kSearchKeystrokeBudget{50};
+
 void init_ui_system(lv_coord_t screen_width, lv_coord_t screen_height) {
     // 初始化缩放系统
     UIScale::getInstance().initialize(screen_width, screen_height);
@@ -138,26 +154,30 @@ void init_ui_theme() {
     lv_style_set_bg_opa(&style_vip, LV_OPA_100);
     lv_style_set_pad_all(&style_vip, UIScale::s(12));
     lv_style_set_text_color(&style_vip, lv_color_white());
+
+    // 骨架占位条（列表数据加载中，叠加在 LV_STATE_USER_1 上）
+    lv_style_init(&style_skeleton);
+    lv_style_set_radius(&style_skeleton, UIScale::s(4));
+    lv_style_set_bg_color(&style_skeleton, lv_color_hex(0xC8C9D4));
+    lv_style_set_bg_opa(&style_skeleton, LV_OPA_20);
+    lv_style_set_height(&style_skeleton, UIScale::s(16));
+}
+
+// gap/pad 为设计稿数值（0 表示默认 8），间距样式由 StyleRegistry 共享
+static void apply_spacing(lv_obj_t* obj, lv_coord_t gap, lv_coord_t pad) {
+    lv_style_t* st = StyleRegistry::getInstance().spacing(gap ? gap : 8, pad ? pad : 8);
+    lv_obj_remove_style(obj, st, 0);   // 页面重复 setup 时不叠加同一样式
+    lv_obj_add_style(obj, st, 0);
 }
 
 static void setup_flex_row(lv_obj_t* obj, lv_coord_t gap = 0, lv_coord_t pad = 0) {
     lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_ROW);
-    // 如果未指定，使用默认缩放值
-    if (gap == 0) gap = UIScale::s(8);
-    if (pad == 0) pad = UIScale::s(8);
-    lv_obj_set_style_pad_all(obj, pad, 0);
-    lv_obj_set_style_pad_row(obj, gap, 0);
-    lv_obj_set_style_pad_column(obj, gap, 0);
+    apply_spacing(obj, gap, pad);
 }
 
 static void setup_flex_col(lv_obj_t* obj, lv_coord_t gap = 0, lv_coord_t pad = 0) {
     lv_obj_set_flex_flow(obj, LV_FLEX_FLOW_COLUMN);
-    // 如果未指定，使用默认缩放值
-    if (gap == 0) gap = UIScale::s(8);
-    if (pad == 0) pad = UIScale::s(8);
-    lv_obj_set_style_pad_all(obj, pad, 0);
-    lv_obj_set_style_pad_row(obj, gap, 0);
-    lv_obj_set_style_pad_column(obj, gap, 0);
+    apply_spacing(obj, gap, pad);
 }
 
 static void on_top_btn_event(lv_event_t* e) {
@@ -172,8 +192,8 @@ static void on_top_btn_event(lv_event_t* e) {
 static lv_obj_t* create_top_bar(lv_obj_t* parent) {
     lv_obj_t* bar = lv_obj_create(parent);
     lv_obj_set_size(bar, LV_PCT(100), UIScale::s(50));
-    setup_flex_row(bar, UIScale::s(12), UIScale::s(10));
-    lv_obj_set_style_bg_opa(bar, LV_OPA_60, 0);
+    setup_flex_row(bar, 12, 10);
+    lv_obj_add_style(bar, StyleRegistry::getInstance().bgOpa(LV_OPA_60), 0);
 
     auto add_btn = [&](const char* txt, int idx) {
         lv_obj_t* btn = lv_btn_create(bar);
@@ -195,7 +215,7 @@ static lv_obj_t* create_top_bar(lv_obj_t* parent) {
     // 占位弹性伸展，将 VIP 推到右侧
     lv_obj_t* spacer = lv_obj_create(bar);
     lv_obj_set_size(spacer, 1, 1);
-    lv_obj_set_style_bg_opa(spacer, LV_OPA_TRANSP, 0);
+    lv_obj_add_style(spacer, StyleRegistry::getInstance().bgOpa(LV_OPA_TRANSP), 0);
     lv_obj_set_flex_grow(spacer, 1);
 
     // VIP 按钮
@@ -212,16 +232,24 @@ static lv_obj_t* create_top_bar(lv_obj_t* parent) {
 static lv_obj_t* create_content_area(lv_obj_t* parent) {
     lv_obj_t* area = lv_obj_create(parent);
     lv_obj_set_size(area, LV_PCT(100), LV_PCT(100));
-    setup_flex_col(area, UIScale::s(6), UIScale::s(6));
+    setup_flex_col(area, 6, 6);
     lv_obj_set_scroll_dir(area, LV_DIR_VER);
     return area;
 }
 
+// 播放条按钮：user_data 为按钮序号（与 create_player_bar 的 labels 顺序一致）
+static void on_player_btn_event(lv_event_t* e) {
+    intptr_t id = reinterpret_cast<intptr_t>(lv_event_get_user_data(e));
+    auto& player = ktv::services::PlayerService::getInstance();
+    if (id == 1) player.playNext();
+    else if (id == 3) player.togglePause();
+}
+
 lv_obj_t* create_player_bar(lv_obj_t* parent) {
     lv_obj_t* bar = lv_obj_create(parent);
     lv_obj_set_size(bar, LV_PCT(100), UIScale::s(80));
-    setup_flex_row(bar, UIScale::s(10), UIScale::s(10));
-    lv_obj_set_style_bg_opa(bar, LV_OPA_70, 0);
+    setup_flex_row(bar, 10, 10);
+    lv_obj_add_style(bar, StyleRegistry::getInstance().bgOpa(LV_OPA_70), 0);
 
     const char* labels[] = {
         LV_SYMBOL_LIST " 已点",
@@ -233,11 +261,13 @@ lv_obj_t* create_player_bar(lv_obj_t* parent) {
         LV_SYMBOL_SETTINGS " 设置",
         LV_SYMBOL_CLOSE " 返回"
     };
+    intptr_t id = 0;
     for (const char* txt : labels) {
         lv_obj_t* btn = lv_btn_create(bar);
         lv_obj_add_style(btn, &style_btn, 0);
         lv_obj_add_style(btn, &style_btn_pressed, LV_STATE_PRESSED);
         lv_obj_add_style(btn, &style_focus, LV_STATE_FOCUSED);
+        lv_obj_add_event_cb(btn, on_player_btn_event, LV_EVENT_CLICKED, reinterpret_cast<void*>(id++));
         lv_obj_t* label = lv_label_create(btn);
         lv_label_set_text(label, txt);
         lv_obj_center(label);
@@ -246,53 +276,52 @@ lv_obj_t* create_player_bar(lv_obj_t* parent) {
 }
 
 static void on_song_click(lv_event_t* e) {
-    lv_obj_t* btn = lv_event_get_target(e);
-    const char* title = static_cast<const char*>(lv_event_get_user_data(e));
-    (void)btn;
-    // 直接调用点歌接口；若失败则记录日志
-    std::string song_id = title ? title : "";
-    bool ok = ktv::services::SongService::getInstance().addToQueue(song_id);
-    if (!ok) {
-        syslog(LOG_WARNING, "[ktv][ui][action] action=add_to_queue song_id=%s status=failed", song_id.c_str());
-    } else {
-        syslog(LOG_INFO, "[ktv][ui][action] action=add_to_queue song_id=%s status=success", song_id.c_str());
-        ktv::events::Event ev;
-        ev.type = ktv::events::EventType::SongSelected;
-        ev.payload = song_id;
-        ktv::events::EventBus::getInstance().publish(ev);
-    }
+    // 行对象会被虚拟列表复用，点击时再取当前绑定的歌曲
+    lv_obj_t* row = lv_obj_get_parent(lv_event_get_target(e));
+    VirtualList* list = VirtualList::fromRow(row);
+    const ktv::services::SongItem* s = list ? list->itemForRow(row) : nullptr;
+    if (!s || s->id.empty()) return;
+    components::queueSong(s->id);
 }
 
-static void create_song_list_item(lv_obj_t* list, const char* title, const char* subtitle) {
-    // Deprecated helper kept for fallback; prefer overload with SongItem
+// 行模板：只创建一次，内容由 bind_song_row 刷新
+static lv_obj_t* create_song_row(lv_obj_t* list) {
     lv_obj_t* item = lv_obj_create(list);
     lv_obj_add_style(item, &style_list_item, 0);
     lv_obj_add_style(item, &style_shadow, 0);
     lv_obj_set_width(item, LV_PCT(100));
     lv_obj_set_height(item, UIScale::s(72));
-    setup_flex_row(item, UIScale::s(6), UIScale::s(8));
+    setup_flex_row(item, 6, 8);
 
+    // 封面：色块打底，有封面 URL 时由 ImageCache 异步换上缩略图
     lv_obj_t* left = lv_obj_create(item);
     lv_obj_set_size(left, UIScale::s(60), UIScale::s(60));
-    lv_obj_set_style_bg_opa(left, LV_OPA_30, 0);
-    lv_obj_set_style_bg_color(left, lv_color_hex(0x8A7AC5), 0);
+    lv_obj_add_style(left, StyleRegistry::getInstance().bg(0x8A7AC5, LV_OPA_30), 0);
+    lv_obj_add_style(left, StyleRegistry::getInstance().padAll(0), 0);
+    lv_obj_clear_flag(left, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_t* cover = lv_img_create(left);
+    lv_obj_center(cover);
 
     lv_obj_t* center = lv_obj_create(item);
     lv_obj_set_flex_grow(center, 1);
-    setup_flex_col(center, UIScale::s(4), 0);
+    setup_flex_col(center, 4, 0);
 
-    lv_obj_t* title_lbl = lv_label_create(center);
-    lv_label_set_text(title_lbl, title);
+    lv_obj_t* title_lbl = lv_label_create(center);   // 标题
     lv_obj_t* sub_lbl = lv_label_create(center);
     lv_obj_add_style(sub_lbl, &style_subtext, 0);
-    lv_label_set_text(sub_lbl, subtitle);
+
+    // 数据未到时显示为灰色骨架条
+    lv_obj_add_style(title_lbl, &style_skeleton, LV_STATE_USER_1);
+    lv_obj_add_style(title_lbl, StyleRegistry::getInstance().widthPct(60), LV_STATE_USER_1);
+    lv_obj_add_style(sub_lbl, &style_skeleton, LV_STATE_USER_1);
+    lv_obj_add_style(sub_lbl, StyleRegistry::getInstance().widthPct(35), LV_STATE_USER_1);
 
     // 收藏心形（符号版）
     lv_obj_t* heart = lv_btn_create(item);
     lv_obj_add_style(heart, &style_btn, 0);
     lv_obj_add_style(heart, &style_btn_pressed, LV_STATE_PRESSED);
     lv_obj_add_style(heart, &style_focus, LV_STATE_FOCUSED);
-    lv_obj_set_style_pad_all(heart, UIScale::s(8), 0);
+    lv_obj_add_style(heart, StyleRegistry::getInstance().padAll(8), 0);
     lv_obj_t* heart_lbl = lv_label_create(heart);
     lv_obj_add_style(heart_lbl, &style_icon, 0);
     lv_label_set_text(heart_lbl, LV_SYMBOL_HEART);  // 默认空心/实心可后续切换
@@ -303,102 +332,127 @@ static void create_song_list_item(lv_obj_t* list, const char* title, const char*
     lv_obj_add_style(right, &style_btn, 0);
     lv_obj_add_style(right, &style_btn_pressed, LV_STATE_PRESSED);
     lv_obj_add_style(right, &style_focus, LV_STATE_FOCUSED);
-    lv_obj_set_style_pad_all(right, UIScale::s(10), 0);
+    lv_obj_add_style(right, StyleRegistry::getInstance().padAll(10), 0);
     lv_obj_t* label = lv_label_create(right);
     lv_label_set_text(label, LV_SYMBOL_PLAY " 点歌");
     lv_obj_center(label);
-    lv_obj_add_event_cb(right, on_song_click, LV_EVENT_CLICKED, (void*)title);
+    lv_obj_add_event_cb(right, on_song_click, LV_EVENT_CLICKED, nullptr);
+    return item;
 }
 
-static void create_song_list_item(lv_obj_t* list, const ktv::services::SongItem& s) {
-    const char* title = s.title.c_str();
-    const char* subtitle = s.artist.c_str();
-    lv_obj_t* item = lv_obj_create(list);
-    lv_obj_add_style(item, &style_list_item, 0);
-    lv_obj_add_style(item, &style_shadow, 0);
-    lv_obj_set_width(item, LV_PCT(100));
-    lv_obj_set_height(item, UIScale::s(72));
-    setup_flex_row(item, UIScale::s(6), UIScale::s(8));
+static void bind_song_row(lv_obj_t* row, const ktv::services::SongItem* s) {
+    lv_obj_t* cover = lv_obj_get_child(lv_obj_get_child(row, 0), 0);
+    if (s && !s->cover_url.empty()) {
+        ImageCache::getInstance().bind(cover, s->cover_url, UIScale::s(60), UIScale::s(60));
+    } else {
+        ImageCache::getInstance().unbind(cover);
+    }
 
-    lv_obj_t* left = lv_obj_create(item);
-    lv_obj_set_size(left, UIScale::s(60), UIScale::s(60));
-    lv_obj_set_style_bg_opa(left, LV_OPA_30, 0);
-    lv_obj_set_style_bg_color(left, lv_color_hex(0x8A7AC5), 0);
+    lv_obj_t* center = lv_obj_get_child(row, 1);
+    for (int i = 0; i < 2; ++i) {
+        lv_obj_t* lbl = lv_obj_get_child(center, i);
+        if (s) lv_obj_clear_state(lbl, LV_STATE_USER_1);
+        else lv_obj_add_state(lbl, LV_STATE_USER_1);
+    }
+    lv_label_set_text(lv_obj_get_child(center, 0), s ? s->title.c_str() : "");
+    lv_label_set_text(lv_obj_get_child(center, 1), s ? s->artist.c_str() : "");
+}
 
-    lv_obj_t* center = lv_obj_create(item);
-    lv_obj_set_flex_grow(center, 1);
-    setup_flex_col(center, UIScale::s(4), 0);
+static VirtualList* create_song_list(lv_obj_t* parent, std::unique_ptr<SongListDataSource> source,
+                                     const char* empty_text = nullptr) {
+    VirtualListConfig cfg;
+    cfg.row_height = UIScale::s(72);
+    cfg.row_gap = UIScale::s(6);
+    cfg.empty_text = empty_text;
+    VirtualList* vl = VirtualList::create(parent, std::move(source), cfg, create_song_row, bind_song_row);
 
-    lv_obj_t* title_lbl = lv_label_create(center);
-    lv_label_set_text(title_lbl, title);
-    lv_obj_t* sub_lbl = lv_label_create(center);
-    lv_obj_add_style(sub_lbl, &style_subtext, 0);
-    lv_label_set_text(sub_lbl, subtitle);
+    lv_obj_t* list = vl->obj();
+    lv_obj_set_flex_grow(list, 1);
+    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
+    lv_obj_add_style(list, StyleRegistry::getInstance().padAll(6), 0);
+    return vl;
+}
 
-    // 收藏心形（符号版）
-    lv_obj_t* heart = lv_btn_create(item);
-    lv_obj_add_style(heart, &style_btn, 0);
-    lv_obj_add_style(heart, &style_btn_pressed, LV_STATE_PRESSED);
-    lv_obj_add_style(heart, &style_focus, LV_STATE_FOCUSED);
-    lv_obj_set_style_pad_all(heart, UIScale::s(8), 0);
-    lv_obj_t* heart_lbl = lv_label_create(heart);
-    lv_obj_add_style(heart_lbl, &style_icon, 0);
-    lv_label_set_text(heart_lbl, LV_SYMBOL_HEART);
-    lv_obj_center(heart_lbl);
+// mock 数据没有 song_id，沿用旧逻辑以标题作为点歌 ID
+static std::vector<ktv::services::SongItem> from_mock(const std::vector<mock::SongItem>& songs) {
+    std::vector<ktv::services::SongItem> out;
+    out.reserve(songs.size());
+    for (const auto& m : songs) {
+        ktv::services::SongItem s;
+        s.id = m.title;
+        s.title = m.title;
+        s.artist = m.artist;
+        out.push_back(std::move(s));
+    }
+    return out;
+}
 
-    // 点歌按钮
-    lv_obj_t* right = lv_btn_create(item);
-    lv_obj_add_style(right, &style_btn, 0);
-    lv_obj_add_style(right, &style_btn_pressed, LV_STATE_PRESSED);
-    lv_obj_add_style(right, &style_focus, LV_STATE_FOCUSED);
-    lv_obj_set_style_pad_all(right, UIScale::s(10), 0);
-    lv_obj_t* label = lv_label_create(right);
-    lv_label_set_text(label, LV_SYMBOL_PLAY " 点歌");
-    lv_obj_center(label);
-    // 事件携带 song_id
-    lv_obj_add_event_cb(right, on_song_click, LV_EVENT_CLICKED,
-                        (void*)s.id.c_str());
+static std::vector<ktv::services::SongItem> slice_page(const std::vector<ktv::services::SongItem>& all,
+                                                       int page, int size) {
+    size_t begin = static_cast<size_t>(page) * static_cast<size_t>(size);
+    if (begin >= all.size()) return {};
+    size_t end = std::min(all.size(), begin + static_cast<size_t>(size));
+    return std::vector<ktv::services::SongItem>(all.begin() + begin, all.begin() + end);
 }
 
-void show_home_tab(lv_obj_t* content_area) {
-    lv_obj_clean(content_area);
-    setup_flex_row(content_area, UIScale::s(6), UIScale::s(6));
+static SongPageProvider g_song_page_provider;
 
-    lv_obj_t* list = lv_obj_create(content_area);
-    lv_obj_set_flex_grow(list, 1);
-    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
-    setup_flex_col(list, UIScale::s(6), UIScale::s(6));
-    lv_obj_set_scroll_dir(list, LV_DIR_VER);
-
-    // 安全地获取歌曲列表，失败时使用mock数据
-    std::vector<ktv::services::SongItem> songs;
-    try {
-        songs = ktv::services::SongService::getInstance().listSongs(1, 20);
-    } catch (const std::exception& e) {
-        syslog(LOG_WARNING, "[ktv][ui][error] component=song_list exception=%s action=using_mock_data", e.what());
-        songs.clear();
-    } catch (...) {
-        syslog(LOG_WARNING, "[ktv][ui][error] component=song_list exception=unknown action=using_mock_data");
-        songs.clear();
+void set_song_page_provider(SongPageProvider provider) {
+    g_song_page_provider = std::move(provider);
+}
+
+// 服务端分页（page 从 1 开始）；第一页为空或失败时退回 mock 数据，其余页失败时抛出（列表稍后重试）
+// 拉取在后台线程执行（fetch / fallback 不能触碰 LVGL），列表先显示骨架行
+static std::unique_ptr<SongListDataSource> make_song_source(
+        std::function<std::vector<ktv::services::SongItem>(int page, int size)> fetch,
+        std::function<std::vector<ktv::services::SongItem>()> fallback) {
+    if (g_song_page_provider) {
+        return std::make_unique<FunctionDataSource>(g_song_page_provider);
     }
-    
-    if (songs.empty()) {
-        // fallback to mock
-        for (const auto& s : ktv::mock::hotSongs()) {
-            create_song_list_item(list, s.title.c_str(), s.artist.c_str());
+    return std::make_unique<AsyncDataSource>([fetch, fallback](int page, int size) {
+        std::vector<ktv::services::SongItem> songs;
+        try {
+            songs = fetch(page + 1, size);
+        } catch (const std::exception& e) {
+            if (page > 0 || !fallback) throw;
+            KTV_SYSLOG(LOG_WARNING, "[ktv][ui][error] component=song_list exception=%s action=using_mock_data", e.what());
+            songs.clear();
+        } catch (...) {
+            if (page > 0 || !fallback) throw;
+            KTV_SYSLOG(LOG_WARNING, "[ktv][ui][error] component=song_list exception=unknown action=using_mock_data");
+            songs.clear();
         }
-    } else {
-        for (const auto& s : songs) {
-            create_song_list_item(list, s);
+        if (page == 0 && songs.empty() && fallback) {
+            return slice_page(fallback(), page, size);
         }
-    }
+        return songs;
+    });
+}
+
+void show_home_tab(lv_obj_t* content_area) {
+    lv_obj_clean(content_area);
+    setup_flex_row(content_area, 6, 6);
+
+    // 虚拟列表：按页拉取，只为可见行创建对象
+    create_song_list(content_area, make_song_source(
+        [](int page, int size) {
+            bool ok = false;
+            auto songs = ktv::services::SongService::getInstance().listSongs(page, size, &ok);
+            if (!ok) throw std::runtime_error("list_songs http_failed");
+            if (page == 1 && !songs.empty()) {
+                // 首页热门即预取候选（只取开头几秒，限速下载）
+                ktv::services::PrefetchService::getInstance().setTrending(songs);
+            }
+            return songs;
+        },
+        [] { return from_mock(ktv::mock::hotSongs()); }));
 
     // 翻页指示器（符号版）
     lv_obj_t* indicator = lv_obj_create(content_area);
     lv_obj_add_style(indicator, &style_card, 0);
-    lv_obj_set_style_bg_opa(indicator, LV_OPA_40, 0);
+    lv_obj_add_style(indicator, StyleRegistry::getInstance().bgOpa(LV_OPA_40), 0);
     lv_obj_set_size(indicator, UIScale::s(64), LV_PCT(80));
-    setup_flex_col(indicator, UIScale::s(8), UIScale::s(8));
+    setup_flex_col(indicator, 8, 8);
     lv_obj_t* up = lv_btn_create(indicator);
     lv_obj_add_style(up, &style_btn, 0);
     lv_obj_add_style(up, &style_btn_pressed, LV_STATE_PRESSED);
@@ -410,7 +464,7 @@ void show_home_tab(lv_obj_t* content_area) {
     lv_obj_t* page_lbl = lv_label_create(indicator);
     lv_obj_add_style(page_lbl, &style_icon, 0);
     lv_label_set_text(page_lbl, "1/10");
-    lv_obj_set_style_text_align(page_lbl, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_add_style(page_lbl, StyleRegistry::getInstance().textAlign(LV_TEXT_ALIGN_CENTER), 0);
 
     lv_obj_t* down = lv_btn_create(indicator);
     lv_obj_add_style(down, &style_btn, 0);
@@ -423,38 +477,22 @@ void show_home_tab(lv_obj_t* content_area) {
 
 void show_history_tab(lv_obj_t* content_area) {
     lv_obj_clean(content_area);
-    setup_flex_row(content_area, UIScale::s(6), UIScale::s(6));
+    setup_flex_row(content_area, 6, 6);
 
-    lv_obj_t* list = lv_obj_create(content_area);
-    lv_obj_set_flex_grow(list, 1);
-    lv_obj_set_size(list, LV_PCT(100), LV_PCT(100));
-    setup_flex_col(list, UIScale::s(6), UIScale::s(6));
-    lv_obj_set_scroll_dir(list, LV_DIR_VER);
-
-    // 安全地获取歌曲列表
-    std::vector<ktv::services::SongItem> songs;
-    try {
-        songs = ktv::services::SongService::getInstance().listSongs(1, 20);
-    } catch (...) {
-        syslog(LOG_WARNING, "[ktv][ui][error] component=history_list exception=unknown action=using_mock_data");
-        songs.clear();
-    }
-    
-    if (songs.empty()) {
-        for (const auto& s : ktv::mock::historySongs()) {
-            create_song_list_item(list, s.title.c_str(), s.artist.c_str());
-        }
-    } else {
-        for (const auto& s : songs) {
-            create_song_list_item(list, s);
-        }
-    }
+    create_song_list(content_area, make_song_source(
+        [](int page, int size) {
+            bool ok = false;
+            auto songs = ktv::services::SongService::getInstance().listSongs(page, size, &ok);
+            if (!ok) throw std::runtime_error("list_songs http_failed");
+            return songs;
+        },
+        [] { return from_mock(ktv::mock::historySongs()); }));
 
     lv_obj_t* indicator = lv_obj_create(content_area);
     lv_obj_add_style(indicator, &style_card, 0);
-    lv_obj_set_style_bg_opa(indicator, LV_OPA_40, 0);
+    lv_obj_add_style(indicator, StyleRegistry::getInstance().bgOpa(LV_OPA_40), 0);
     lv_obj_set_size(indicator, UIScale::s(64), LV_PCT(80));
-    setup_flex_col(indicator, UIScale::s(8), UIScale::s(8));
+    setup_flex_col(indicator, 8, 8);
     lv_obj_t* up = lv_btn_create(indicator);
     lv_obj_add_style(up, &style_btn, 0);
     lv_obj_add_style(up, &style_btn_pressed, LV_STATE_PRESSED);
@@ -466,7 +504,7 @@ void show_history_tab(lv_obj_t* content_area) {
     lv_obj_t* page_lbl = lv_label_create(indicator);
     lv_obj_add_style(page_lbl, &style_icon, 0);
     lv_label_set_text(page_lbl, "1/3");
-    lv_obj_set_style_text_align(page_lbl, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_add_style(page_lbl, StyleRegistry::getInstance().textAlign(LV_TEXT_ALIGN_CENTER), 0);
 
     lv_obj_t* down = lv_btn_create(indicator);
     lv_obj_add_style(down, &style_btn, 0);
@@ -479,13 +517,13 @@ void show_history_tab(lv_obj_t* content_area) {
 
 void show_search_page(lv_obj_t* content_area) {
     lv_obj_clean(content_area);
-    setup_flex_row(content_area, UIScale::s(6), UIScale::s(6));
+    setup_flex_row(content_area, 6, 6);
 
     // 左侧内容列
     lv_obj_t* left_col = lv_obj_create(content_area);
     lv_obj_set_flex_grow(left_col, 1);
     lv_obj_set_size(left_col, LV_PCT(100), LV_PCT(100));
-    setup_flex_col(left_col, UIScale::s(6), UIScale::s(6));
+    setup_flex_col(left_col, 6, 6);
 
     // 搜索框
     lv_obj_t* ta = lv_textarea_create(left_col);
@@ -496,62 +534,65 @@ void show_search_page(lv_obj_t* content_area) {
     // 虚拟键盘（示例 Grid）
     lv_obj_t* kb = lv_keyboard_create(left_col);
     lv_keyboard_set_textarea(kb, ta);
-    lv_obj_set_style_pad_all(kb, UIScale::s(6), 0);
-    lv_obj_set_style_bg_opa(kb, LV_OPA_40, 0);
-
-    // 结果列表
-    lv_obj_t* list = lv_obj_create(left_col);
-    lv_obj_set_size(list, LV_PCT(100), LV_PCT(50));
-    setup_flex_col(list, UIScale::s(6), UIScale::s(6));
-    lv_obj_set_scroll_dir(list, LV_DIR_VER);
-
-    auto refresh_results = [list](const char* kw) {
-        lv_obj_clean(list);
-        std::vector<mock::SongItem> results = mock::searchSongs(kw ? kw : "");
-        if (results.empty()) {
-            create_song_list_item(list, "未找到", "请换个关键词");
-            return;
-        }
-        for (auto& s : results) {
-            create_song_list_item(list, s.title.c_str(), s.artist.c_str());
-        }
-    };
-
-    // 初始显示
-    refresh_results("");
+    lv_obj_add_style(kb, StyleRegistry::getInstance().padAll(6), 0);
+    lv_obj_add_style(kb, StyleRegistry::getInstance().bgOpa(LV_OPA_40), 0);
+
+    // 结果列表（虚拟列表，初始显示本地推荐）
+    auto& search = ktv::services::SearchService::getInstance();
+    search.indexSongs(from_mock(mock::hotSongs()));
+    std::unique_ptr<SongListDataSource> initial;
+    if (g_song_page_provider) {
+        initial = make_song_source(nullptr, nullptr);
+    } else {
+        initial = std::make_unique<FunctionDataSource>([](int page, int size) {
+            return slice_page(from_mock(mock::searchSongs("")), page, size);
+        });
+    }
+    VirtualList* results = create_song_list(left_col, std::move(initial), "未找到，请换个关键词");
+    lv_obj_set_flex_grow(results->obj(), 0);
+    lv_obj_set_size(results->obj(), LV_PCT(100), LV_PCT(50));
 
-    // 输入事件：回车或失焦触发刷新
+    // 输入即搜：每次按键先查本地索引，停顿后合并服务端结果；回车跳过防抖
     lv_obj_add_event_cb(ta, [](lv_event_t* e) {
         lv_event_code_t code = lv_event_get_code(e);
-        if (code == LV_EVENT_READY || code == LV_EVENT_DEFOCUSED) {
-            lv_obj_t* ta = lv_event_get_target(e);
-            const char* txt = lv_textarea_get_text(ta);
-            lv_obj_t* list = (lv_obj_t*)lv_event_get_user_data(e);
-            lv_obj_clean(list);
-            auto results = ktv::services::SongService::getInstance().search(txt ? txt : "", 1, 20);
-            if (results.empty()) {
-                auto mockRes = ktv::mock::searchSongs(txt ? txt : "");
-                if (mockRes.empty()) {
-                    create_song_list_item(list, "未找到", "请换个关键词");
-                } else {
-                    for (auto& s : mockRes) {
-                        create_song_list_item(list, s.title.c_str(), s.artist.c_str());
-                    }
-                }
-                return;
-            }
-            for (auto& s : results) {
-                create_song_list_item(list, s);
-            }
+        if (code == LV_EVENT_DELETE) {
+            // 页面销毁：丢弃在途查询，回调不会再访问已删除的列表
+            ktv::services::SearchService::getInstance().cancel();
+            return;
         }
-    }, LV_EVENT_ALL, list);
+        if (code != LV_EVENT_VALUE_CHANGED && code != LV_EVENT_READY) return;
+
+        lv_obj_t* ta = lv_event_get_target(e);
+        const char* txt = lv_textarea_get_text(ta);
+        auto* list = static_cast<VirtualList*>(lv_event_get_user_data(e));
+        // 本地结果在 query() 内同步回调：按键 → 列表重排完成的耗时即输入延迟
+        // 防抖后的合并结果异步到达，只统计应用耗时
+        auto keystroke = std::chrono::steady_clock::now();
+        auto in_query = std::make_shared<bool>(true);
+        ktv::services::SearchService::getInstance().query(txt ? txt : "",
+            [list, keystroke, in_query](const ktv::services::SearchResult& r) {
+                auto begin = *in_query ? keystroke : std::chrono::steady_clock::now();
+                auto songs = std::make_shared<const std::vector<ktv::services::SongItem>>(r.songs);
+                list->reload(std::make_unique<FunctionDataSource>([songs](int page, int size) {
+                    return slice_page(*songs, page, size);
+                }));
+                lv_obj_update_layout(list->obj());
+                auto cost = std::chrono::steady_clock::now() - begin;
+                KTV_SYSLOG(cost > kSearchKeystrokeBudget ? LOG_WARNING : LOG_DEBUG,
+                           "[ktv][ui][search] stage=%s items=%zu cost_us=%lld",
+                           r.remote_done ? "merged" : "local", songs->size(),
+                           static_cast<long long>(std::chrono::duration_cast<std::chrono::microseconds>(cost).count()));
+            },
+            code == LV_EVENT_READY);
+        *in_query = false;
+    }, LV_EVENT_ALL, results);
 
     // 右侧翻页指示器
     lv_obj_t* indicator = lv_obj_create(content_area);
     lv_obj_add_style(indicator, &style_card, 0);
-    lv_obj_set_style_bg_opa(indicator, LV_OPA_40, 0);
+    lv_obj_add_style(indicator, StyleRegistry::getInstance().bgOpa(LV_OPA_40), 0);
     lv_obj_set_size(indicator, UIScale::s(64), LV_PCT(80));
-    setup_flex_col(indicator, UIScale::s(8), UIScale::s(8));
+    setup_flex_col(indicator, 8, 8);
     lv_obj_t* up = lv_btn_create(indicator);
     lv_obj_add_style(up, &style_btn, 0);
     lv_obj_add_style(up, &style_btn_pressed, LV_STATE_PRESSED);
@@ -563,7 +604,7 @@ void show_search_page(lv_obj_t* content_area) {
     lv_obj_t* page_lbl = lv_label_create(indicator);
     lv_obj_add_style(page_lbl, &style_icon, 0);
     lv_label_set_text(page_lbl, "1/5");
-    lv_obj_set_style_text_align(page_lbl, LV_TEXT_ALIGN_CENTER, 0);
+    lv_obj_add_style(page_lbl, StyleRegistry::getInstance().textAlign(LV_TEXT_ALIGN_CENTER), 0);
 
     lv_obj_t* down = lv_btn_create(indicator);
     lv_obj_add_style(down, &style_btn, 0);
@@ -577,7 +618,7 @@ void show_search_page(lv_obj_t* content_area) {
 lv_obj_t* create_licence_dialog(lv_obj_t* parent) {
     lv_obj_t* modal = lv_obj_create(parent);
     lv_obj_set_size(modal, LV_PCT(90), LV_PCT(60));
-    setup_flex_col(modal, UIScale::s(10), UIScale::s(12));
+    setup_flex_col(modal, 10, 12);
     lv_obj_center(modal);
 
     lv_obj_t* title = lv_label_create(modal);
@@ -588,7 +629,7 @@ lv_obj_t* create_licence_dialog(lv_obj_t* parent) {
     lv_textarea_set_placeholder_text(ta, "XXXX-XXXX-XXXX-XXXX");
 
     lv_obj_t* btn_row = lv_obj_create(modal);
-    setup_flex_row(btn_row, UIScale::s(10), 0);
+    setup_flex_row(btn_row, 10, 0);
     lv_obj_set_width(btn_row, LV_PCT(100));
 
     const char* btns[] = {"确认", "取消"};
@@ -607,9 +648,11 @@ lv_obj_t* create_main_screen() {
     lv_obj_t* scr = lv_scr_act();
     lv_obj_clean(scr);
     lv_obj_add_style(scr, &style_bg, 0);
+    // 正文字号按设计稿 22px 缩放后选最接近的字体（720p 下即默认 14px），子对象继承
+    lv_obj_add_style(scr, StyleRegistry::getInstance().text(22), 0);
     lv_obj_set_size(scr, LV_PCT(100), LV_PCT(100));
     lv_obj_clear_flag(scr, LV_OBJ_FLAG_SCROLLABLE);
-    setup_flex_col(scr, UIScale::s(6), UIScale::s(6));
+    setup_flex_col(scr, 6, 6);
 
     lv_obj_t* top = create_top_bar(scr);
     lv_obj_t* content = create_content_area(scr);
@@ -621,8 +664,8 @@ lv_obj_t* create_main_screen() {
     // 设置内容区域（必须在屏幕加载前完成）
     PageManager::getInstance().setContentArea(content);
     
-    // 初始页面
-    show_home_tab(content);
+    // 初始页面（由 PageManager 创建并缓存）
+    PageManager::getInstance().switchTo(Page::Home);
     
     // 布局与刷新交给主循环
     return scr;
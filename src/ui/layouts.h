@@ -2,9 +2,19 @@
 #define KTVLV_UI_LAYOUTS_H
 
 #include <lvgl.h>
+#include <functional>
+#include <vector>
+#include "../services/song_service.h"
 
 namespace ktv::ui {
 
+// 歌曲列表取页函数（page 从 0 开始，返回不足 size 条表示没有更多）
+using SongPageProvider = std::function<std::vector<ktv::services::SongItem>(int page, int size)>;
+
+// 覆盖首页/历史/搜索初始列表的数据来源（基准测试用合成数据），传空恢复默认
+// provider 在 UI 线程同步调用，只能是内存数据，不能访问网络/文件
+void set_song_page_provider(SongPageProvider provider);
+
 // 初始化UI系统（主题、缩放、焦点）
 void init_ui_system(lv_coord_t screen_width, lv_coord_t screen_height);
 
@@ -14,13 +24,13 @@ void init_ui_theme();
 // 创建主屏（含顶部菜单、内容区、底部播放条）
 lv_obj_t* create_main_screen();
 
-// 切换到首页内容
+// 在页面容器内构建首页内容（由 PageManager 调用并缓存）
 void show_home_tab(lv_obj_t* content_area);
 
-// 切换到历史记录内容
+// 在页面容器内构建历史记录内容
 void show_history_tab(lv_obj_t* content_area);
 
-// 显示搜索页
+// 在页面容器内构建搜索页
 void show_search_page(lv_obj_t* content_area);
 
 // 显示播放浮层/控制条
@@ -0,0 +1,260 @@
+#include "lyric_view.h"
+#include <algorithm>
+#include <cmath>
+#include <string>
+#include "style_registry.h"
+
+namespace ktv::ui {
+
+namespace {
+
+// 擦除点两侧各多失效 1 像素，覆盖字形边缘的抗锯齿
+constexpr lv_coord_t kWipeMargin = 1;
+
+void draw_clipped(lv_draw_ctx_t* ctx, const lv_area_t& img_area, lv_coord_t x1, lv_coord_t x2,
+                  const lv_img_dsc_t* img, lv_color_t color) {
+    if (x1 > x2) return;
+    lv_area_t part{x1, img_area.y1, x2, img_area.y2};
+    lv_area_t clip;
+    if (!_lv_area_intersect(&clip, &part, ctx->clip_area)) return;
+
+    lv_draw_img_dsc_t dsc;
+    lv_draw_img_dsc_init(&dsc);
+    // A8 位图的颜色取自 recolor
+    dsc.recolor = color;
+    dsc.recolor_opa = LV_OPA_COVER;
+
+    const lv_area_t* orig = ctx->clip_area;
+    ctx->clip_area = &clip;
+    lv_draw_img(ctx, &dsc, &img_area, img);
+    ctx->clip_area = orig;
+}
+
+}  // namespace
+
+LyricView* LyricView::create(lv_obj_t* parent, const LyricViewConfig& cfg) {
+    return new LyricView(parent, cfg);
+}
+
+LyricView::LyricView(lv_obj_t* parent, const LyricViewConfig& cfg) : cfg_(cfg) {
+    if (cfg_.tick_ms < 1) cfg_.tick_ms = 1;
+
+    font_ = StyleRegistry::getInstance().font(cfg_.font_px);
+    line_h_ = lv_font_get_line_height(font_);
+
+    obj_ = lv_obj_create(parent);
+    lv_obj_remove_style_all(obj_);
+    lv_obj_clear_flag(obj_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(obj_, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_set_size(obj_, LV_PCT(100), static_cast<lv_coord_t>(line_h_ * 2 + cfg_.row_gap));
+    lv_obj_set_user_data(obj_, this);
+    lv_obj_add_event_cb(obj_, onEvent, LV_EVENT_DRAW_MAIN, this);
+    lv_obj_add_event_cb(obj_, onEvent, LV_EVENT_SIZE_CHANGED, this);
+    lv_obj_add_event_cb(obj_, onEvent, LV_EVENT_DELETE, this);
+
+    canvas_ = lv_canvas_create(obj_);
+    lv_obj_add_flag(canvas_, LV_OBJ_FLAG_HIDDEN);
+
+    timer_ = lv_timer_create(onTick, cfg_.tick_ms, this);
+}
+
+LyricView::~LyricView() {
+    if (timer_) lv_timer_del(timer_);
+    for (auto& row : rows_) releaseRow(row);
+}
+
+void LyricView::onEvent(lv_event_t* e) {
+    auto* self = static_cast<LyricView*>(lv_event_get_user_data(e));
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_DRAW_MAIN:
+            self->draw(lv_event_get_draw_ctx(e));
+            break;
+        case LV_EVENT_SIZE_CHANGED:
+            // 可用宽度变了：位图宽度随之变化，下一次 update 重新光栅化
+            self->resetRows();
+            self->update(self->currentMs());
+            break;
+        case LV_EVENT_DELETE:
+            delete self;
+            break;
+        default:
+            break;
+    }
+}
+
+void LyricView::onTick(lv_timer_t* timer) {
+    auto* self = static_cast<LyricView*>(timer->user_data);
+    if (!self->lyrics_ || !self->playing_ || lv_obj_has_flag(self->obj_, LV_OBJ_FLAG_HIDDEN)) return;
+    self->update(self->currentMs());
+}
+
+void LyricView::setLyrics(std::shared_ptr<const ktv::audio::Lyrics> lyrics) {
+    lyrics_ = std::move(lyrics);
+    resetRows();
+    base_ms_ = 0;
+    base_tick_ = lv_tick_get();
+    playing_ = false;
+    update(0);
+}
+
+void LyricView::setPosition(uint32_t ms, bool playing) {
+    base_ms_ = ms;
+    base_tick_ = lv_tick_get();
+    playing_ = playing;
+    update(ms);
+}
+
+uint32_t LyricView::currentMs() const {
+    return playing_ ? base_ms_ + lv_tick_elaps(base_tick_) : base_ms_;
+}
+
+void LyricView::update(uint32_t ms) {
+    if (!lyrics_) return;
+    const ktv::audio::LyricPosition pos = lyrics_->locate(ms);
+
+    for (size_t r = 0; r < rows_.size(); ++r) {
+        Row& row = rows_[r];
+        const int want = lineForRow(r, pos.line);
+        if (row.line != want) {
+            rasterize(row, want);
+            row.wipe_x = wipeFor(row, pos);
+            // 新旧位图宽度、对齐位置不同：失效整个行位
+            lv_area_t area = rowArea(r);
+            lv_area_t content;
+            lv_obj_get_content_coords(obj_, &content);
+            area.x1 = content.x1;
+            area.x2 = content.x2;
+            lv_obj_invalidate_area(obj_, &area);
+            continue;
+        }
+        const lv_coord_t x = wipeFor(row, pos);
+        if (x == row.wipe_x) continue;
+
+        lv_area_t area = rowArea(r);
+        const lv_coord_t left = area.x1;
+        area.x1 = static_cast<lv_coord_t>(left + std::min(x, row.wipe_x) - kWipeMargin);
+        area.x2 = static_cast<lv_coord_t>(left + std::max(x, row.wipe_x) + kWipeMargin);
+        row.wipe_x = x;
+        lv_obj_invalidate_area(obj_, &area);
+    }
+}
+
+// 偶数行在上、奇数行在下；正在唱的行所在行位显示它，另一行位预告下一句
+int LyricView::lineForRow(size_t r, int active) const {
+    const int count = static_cast<int>(lyrics_->lines.size());
+    const int row = static_cast<int>(r);
+    int line;
+    if (active < 0) {
+        line = row;
+    } else if (active % 2 == row) {
+        line = active;
+    } else {
+        line = active + 1;
+    }
+    return line < count ? line : -1;
+}
+
+lv_coord_t LyricView::wipeFor(const Row& row, const ktv::audio::LyricPosition& pos) const {
+    if (row.line < 0 || row.word_end.empty()) return 0;
+    const lv_coord_t width = static_cast<lv_coord_t>(row.img.header.w);
+    if (row.line < pos.line) return width;
+    if (row.line > pos.line) return 0;
+
+    const size_t word = static_cast<size_t>(pos.word);
+    if (word >= row.word_end.size()) return width;
+    const lv_coord_t x0 = word == 0 ? 0 : row.word_end[word - 1];
+    const lv_coord_t x1 = row.word_end[word];
+    return static_cast<lv_coord_t>(x0 + std::lround(pos.progress * static_cast<float>(x1 - x0)));
+}
+
+void LyricView::rasterize(Row& row, int line) {
+    releaseRow(row);
+    row.line = line;
+    if (line < 0 || !lyrics_) return;
+
+    const ktv::audio::LyricLine& l = lyrics_->lines[static_cast<size_t>(line)];
+    const std::string text = lyrics_->lineText(static_cast<size_t>(line));
+    const lv_coord_t max_w = lv_obj_get_content_width(obj_);
+    lv_coord_t w = lv_txt_get_width(text.c_str(), static_cast<uint32_t>(text.size()), font_, 0,
+                                    LV_TEXT_FLAG_EXPAND);
+    if (max_w > 0) w = std::min(w, max_w);
+    if (w <= 0 || line_h_ <= 0) return;
+
+    // 每个字的右边界：量前缀宽度（含字距调整），截断到位图宽度
+    row.word_end.reserve(l.word_count);
+    for (uint32_t k = 0; k < l.word_count; ++k) {
+        const ktv::audio::LyricWord& word = lyrics_->words[l.first_word + k];
+        const uint32_t prefix = word.text_offset + word.text_len - l.text_offset;
+        lv_coord_t x = lv_txt_get_width(text.c_str(), prefix, font_, 0, LV_TEXT_FLAG_EXPAND);
+        row.word_end.push_back(std::min(x, w));
+    }
+
+    // 画布按 lv_color_t 像素绘制（A8 缓冲会被按 LV_COLOR_DEPTH 写越界）：
+    // 先在真彩色临时缓冲上黑底白字，再把亮度（即字形覆盖率）拷成 A8
+    const size_t px = static_cast<size_t>(w) * static_cast<size_t>(line_h_);
+    scratch_.resize(px);
+    lv_canvas_set_buffer(canvas_, scratch_.data(), w, line_h_, LV_IMG_CF_TRUE_COLOR);
+    lv_canvas_fill_bg(canvas_, lv_color_black(), LV_OPA_COVER);
+    lv_draw_label_dsc_t dsc;
+    lv_draw_label_dsc_init(&dsc);
+    dsc.font = font_;
+    dsc.color = lv_color_white();
+    dsc.flag = LV_TEXT_FLAG_EXPAND;
+    lv_canvas_draw_text(canvas_, 0, 0, w, &dsc, text.c_str());
+
+    row.buf.resize(px);
+    for (size_t i = 0; i < px; ++i) row.buf[i] = lv_color_brightness(scratch_[i]);
+
+    row.img.header.cf = LV_IMG_CF_ALPHA_8BIT;
+    row.img.header.always_zero = 0;
+    row.img.header.w = static_cast<uint32_t>(w);
+    row.img.header.h = static_cast<uint32_t>(line_h_);
+    row.img.data_size = static_cast<uint32_t>(row.buf.size());
+    row.img.data = row.buf.data();
+    ++raster_count_;
+}
+
+void LyricView::releaseRow(Row& row) {
+    // 图片缓存以 lv_img_dsc_t 地址为键，复用同一个描述符前必须先作废
+    if (row.img.data) lv_img_cache_invalidate_src(&row.img);
+    row.line = -1;
+    row.buf.clear();
+    row.buf.shrink_to_fit();
+    row.img = lv_img_dsc_t{};
+    row.word_end.clear();
+    row.wipe_x = 0;
+}
+
+void LyricView::resetRows() {
+    for (auto& row : rows_) releaseRow(row);
+    lv_obj_invalidate(obj_);
+}
+
+lv_area_t LyricView::rowArea(size_t r) const {
+    lv_area_t content;
+    lv_obj_get_content_coords(obj_, &content);
+    const Row& row = rows_[r];
+    const lv_coord_t w = static_cast<lv_coord_t>(row.img.header.w);
+
+    lv_area_t area;
+    area.y1 = static_cast<lv_coord_t>(content.y1 + static_cast<lv_coord_t>(r) * (line_h_ + cfg_.row_gap));
+    area.y2 = static_cast<lv_coord_t>(area.y1 + line_h_ - 1);
+    area.x1 = r == 0 ? content.x1 : static_cast<lv_coord_t>(std::max<int>(content.x1, content.x2 + 1 - w));
+    area.x2 = static_cast<lv_coord_t>(area.x1 + w - 1);
+    return area;
+}
+
+void LyricView::draw(lv_draw_ctx_t* ctx) {
+    const lv_color_t base = lv_color_hex(cfg_.color);
+    const lv_color_t highlight = lv_color_hex(cfg_.highlight_color);
+    for (size_t r = 0; r < rows_.size(); ++r) {
+        const Row& row = rows_[r];
+        if (!row.img.data) continue;
+        const lv_area_t area = rowArea(r);
+        const lv_coord_t split = static_cast<lv_coord_t>(area.x1 + row.wipe_x);
+        draw_clipped(ctx, area, area.x1, static_cast<lv_coord_t>(split - 1), &row.img, highlight);
+        draw_clipped(ctx, area, split, area.x2, &row.img, base);
+    }
+}
+
+}  // namespace ktv::ui
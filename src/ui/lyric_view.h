@@ -0,0 +1,91 @@
+#ifndef KTVLV_UI_LYRIC_VIEW_H
+#define KTVLV_UI_LYRIC_VIEW_H
+
+#include <lvgl.h>
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+#include "../audio/lyrics.h"
+
+namespace ktv::ui {
+
+struct LyricViewConfig {
+    lv_coord_t font_px = 48;           // 设计字号，经 StyleRegistry 映射到已编译字体
+    uint32_t color = 0xFFFFFF;         // 未唱部分
+    uint32_t highlight_color = 0x33CCFF;
+    lv_coord_t row_gap = 16;           // 已缩放
+    uint32_t tick_ms = 16;             // 擦除刷新周期
+};
+
+/**
+ * 卡拉 OK 歌词控件：两行交替显示（偶数行靠左、奇数行靠右），逐字擦除高亮
+ *
+ * - 每行文本只在换行时光栅化一次，存为 A8 位图（字形覆盖率），每帧不做文字排版
+ * - 绘制时同一张位图画两次：擦除点左侧用高亮色、右侧用原色，各自裁剪到对应区域
+ * - 每个 tick 只失效上一帧与本帧擦除点之间的窄条，换行时才失效整行
+ * - 进度由调用方用 setPosition() 上报（播放器进度回调），两次上报之间按 lv_tick 外推
+ * - 超出控件宽度的部分被截断；生命周期跟随 obj()，只能在 UI 线程调用
+ */
+class LyricView {
+public:
+    static LyricView* create(lv_obj_t* parent, const LyricViewConfig& cfg);
+
+    LyricView(const LyricView&) = delete;
+    LyricView& operator=(const LyricView&) = delete;
+
+    lv_obj_t* obj() const { return obj_; }
+
+    // 更换歌词（nullptr 清空）
+    void setLyrics(std::shared_ptr<const ktv::audio::Lyrics> lyrics);
+
+    // 当前歌曲时间；playing=false 时停在该位置不再外推
+    void setPosition(uint32_t ms, bool playing);
+
+    // 光栅化次数（调试用：正常播放时每句一次）
+    uint32_t rasterCount() const { return raster_count_; }
+
+private:
+    struct Row {
+        int line = -1;
+        std::vector<uint8_t> buf;           // A8 位图
+        lv_img_dsc_t img{};
+        std::vector<lv_coord_t> word_end;   // 每个字结束处的 x（相对位图左边）
+        lv_coord_t wipe_x = 0;              // 已绘制的擦除点
+    };
+
+    LyricView(lv_obj_t* parent, const LyricViewConfig& cfg);
+    ~LyricView();
+
+    static void onEvent(lv_event_t* e);
+    static void onTick(lv_timer_t* timer);
+
+    uint32_t currentMs() const;
+    void update(uint32_t ms);
+    int lineForRow(size_t r, int active) const;
+    lv_coord_t wipeFor(const Row& row, const ktv::audio::LyricPosition& pos) const;
+    void rasterize(Row& row, int line);
+    void releaseRow(Row& row);
+    lv_area_t rowArea(size_t r) const;
+    void draw(lv_draw_ctx_t* ctx);
+    void resetRows();
+
+    LyricViewConfig cfg_;
+    lv_obj_t* obj_ = nullptr;
+    lv_obj_t* canvas_ = nullptr;   // 隐藏，只用来往行位图里画字
+    std::vector<lv_color_t> scratch_;   // 光栅化用的真彩色临时缓冲（复用，最大一行）
+    lv_timer_t* timer_ = nullptr;
+    const lv_font_t* font_ = nullptr;
+    lv_coord_t line_h_ = 0;
+
+    std::shared_ptr<const ktv::audio::Lyrics> lyrics_;
+    std::array<Row, 2> rows_;
+    uint32_t base_ms_ = 0;
+    uint32_t base_tick_ = 0;
+    bool playing_ = false;
+    uint32_t raster_count_ = 0;
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_LYRIC_VIEW_H
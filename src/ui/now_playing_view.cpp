@@ -0,0 +1,96 @@
+#include "now_playing_view.h"
+#include "style_registry.h"
+#include "ui_scale.h"
+#include "../core/executor.h"
+#include "../events/ui_dispatcher.h"
+#include "../services/m3u8_download_service.h"
+#include "../services/player_service.h"
+#include "../utils/log_macros.h"
+
+namespace ktv::ui {
+
+void NowPlayingView::ensureCreated() {
+    if (panel_) return;
+    auto& reg = StyleRegistry::getInstance();
+
+    panel_ = lv_obj_create(lv_layer_top());
+    lv_obj_remove_style_all(panel_);
+    lv_obj_add_style(panel_, reg.bg(0x000000, LV_OPA_50), 0);
+    lv_obj_add_style(panel_, reg.radius(16), 0);
+    lv_obj_add_style(panel_, reg.padAll(UIScale::s(16)), 0);
+    lv_obj_set_size(panel_, LV_PCT(90), LV_SIZE_CONTENT);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_SCROLLABLE);
+    // 播放条高 s(80)，歌词贴在它上方
+    lv_obj_align(panel_, LV_ALIGN_BOTTOM_MID, 0, -UIScale::s(100));
+    lv_obj_add_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+
+    LyricViewConfig cfg;
+    cfg.row_gap = UIScale::s(16);
+    lyric_view_ = LyricView::create(panel_, cfg);
+
+    position_timer_ = lv_timer_create(onPositionTimer, kPositionPollMs, this);
+    lv_timer_pause(position_timer_);
+}
+
+void NowPlayingView::onPlayerState(const std::string& payload) {
+    if (payload == "stopped") {
+        ++generation_;
+        song_id_.clear();
+        hide();
+        return;
+    }
+    if (payload != "playing") return;
+    const std::string& song_id = ktv::services::PlayerService::getInstance().currentSong();
+    if (song_id.empty() || song_id == song_id_) return;
+    ensureCreated();
+    song_id_ = song_id;
+    // 上一首的歌词先撤下，新歌词解析完再显示
+    hide();
+    loadLyrics(song_id);
+}
+
+void NowPlayingView::loadLyrics(const std::string& song_id) {
+    const uint32_t generation = ++generation_;
+    std::string path = ktv::services::M3u8DownloadService::getInstance().songDir(song_id) + "/lyrics.txt";
+    bool posted = ktv::core::Executor::instance().post(ktv::core::Lane::Background, [generation, path, song_id] {
+        auto lyrics = std::make_shared<ktv::audio::Lyrics>();
+        std::string error;
+        if (!lyrics->load(path, error)) {
+            KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][lyrics] song_id=%s status=unavailable reason=%s", song_id.c_str(),
+                       error.c_str());
+            return;
+        }
+        KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][lyrics] song_id=%s lines=%zu words=%zu", song_id.c_str(),
+                   lyrics->lines.size(), lyrics->words.size());
+        ktv::events::UiDispatcher::getInstance().post([generation, lyrics] {
+            NowPlayingView::getInstance().applyLyrics(generation, lyrics);
+        });
+    });
+    if (!posted) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][lyrics] song_id=%s status=executor_rejected", song_id.c_str());
+    }
+}
+
+void NowPlayingView::applyLyrics(uint32_t generation, std::shared_ptr<const ktv::audio::Lyrics> lyrics) {
+    if (generation != generation_ || !panel_) return;
+    lyric_view_->setLyrics(std::move(lyrics));
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+    lv_timer_resume(position_timer_);
+    onPositionTimer(position_timer_);
+}
+
+void NowPlayingView::hide() {
+    if (!panel_) return;
+    lv_timer_pause(position_timer_);
+    lv_obj_add_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+    lyric_view_->setLyrics(nullptr);
+}
+
+void NowPlayingView::onPositionTimer(lv_timer_t* timer) {
+    auto* self = static_cast<NowPlayingView*>(timer->user_data);
+    const auto& player = ktv::services::PlayerService::getInstance();
+    self->lyric_view_->setPosition(player.positionMs(), player.state() == ktv::services::PlayerState::Playing);
+}
+
+}  // namespace ktv::ui
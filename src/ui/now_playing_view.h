@@ -0,0 +1,55 @@
+#ifndef KTVLV_UI_NOW_PLAYING_VIEW_H
+#define KTVLV_UI_NOW_PLAYING_VIEW_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include "lyric_view.h"
+
+namespace ktv::ui {
+
+/**
+ * 播放中浮层：底部播放条上方的卡拉 OK 歌词（PlayerStateChanged 事件的 UI 消费方）
+ *
+ * - 起播时在 Background Lane 读取 <song_dir>/lyrics.txt（LRC/增强 LRC/KRC），解析完回到 UI 线程换上
+ * - 每 kPositionPollMs 把 PlayerService 的播放进度报给 LyricView::setPosition，两次之间由控件外推
+ * - 歌曲没有歌词或播放停止时隐藏，进度定时器随之暂停
+ *
+ * 挂在 lv_layer_top() 上，首次起播时才创建。只能在 UI 线程调用（EventBus::dispatchOnUiThread）。
+ */
+class NowPlayingView {
+public:
+    static NowPlayingView& getInstance() {
+        static NowPlayingView instance;
+        return instance;
+    }
+
+    NowPlayingView(const NowPlayingView&) = delete;
+    NowPlayingView& operator=(const NowPlayingView&) = delete;
+
+    // payload："playing" / "stopped"（PlayerService 发布）
+    void onPlayerState(const std::string& payload);
+
+private:
+    static constexpr uint32_t kPositionPollMs = 250;
+
+    NowPlayingView() = default;
+    ~NowPlayingView() = default;
+
+    void ensureCreated();
+    void loadLyrics(const std::string& song_id);
+    void applyLyrics(uint32_t generation, std::shared_ptr<const ktv::audio::Lyrics> lyrics);
+    void hide();
+    static void onPositionTimer(lv_timer_t* timer);
+
+    lv_obj_t* panel_ = nullptr;
+    LyricView* lyric_view_ = nullptr;   // 生命周期跟随 panel_
+    lv_timer_t* position_timer_ = nullptr;
+    std::string song_id_;
+    uint32_t generation_ = 0;           // 每次换歌递增，丢弃上一首迟到的解析结果
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_NOW_PLAYING_VIEW_H
@@ -1,9 +1,61 @@
 #include "page_manager.h"
 #include "layouts.h"
 #include "focus_manager.h"
+#include "ui_scale.h"
+#include "style_registry.h"
+#include "core/lv_mem_pool.h"
+#include "../utils/log_macros.h"
+#include <chrono>
 
 namespace ktv::ui {
 
+// 页面在 LVGL 内存池中的记账标签（0 留给页面以外的对象）
+static uint16_t page_tag(Page page) {
+    return static_cast<uint16_t>(static_cast<int>(page) + 1);
+}
+
+static uint32_t count_objs(lv_obj_t* obj) {
+    uint32_t n = 1;
+    uint32_t cnt = lv_obj_get_child_cnt(obj);
+    for (uint32_t i = 0; i < cnt; ++i) {
+        n += count_objs(lv_obj_get_child(obj, static_cast<int32_t>(i)));
+    }
+    return n;
+}
+
+static lv_obj_t* build_page(Page page, lv_obj_t* parent) {
+    // 页面根容器：透明、无边距，页面内容自行布局
+    lv_obj_t* root = lv_obj_create(parent);
+    lv_obj_set_size(root, LV_PCT(100), LV_PCT(100));
+    lv_obj_add_style(root, StyleRegistry::getInstance().bgOpa(LV_OPA_TRANSP), 0);
+    lv_obj_add_style(root, StyleRegistry::getInstance().border(0), 0);
+    lv_obj_clear_flag(root, LV_OBJ_FLAG_SCROLLABLE);
+
+    switch (page) {
+        case Page::Home:
+            show_home_tab(root);
+            break;
+        case Page::History:
+            show_history_tab(root);
+            break;
+        case Page::Search:
+            show_search_page(root);
+            break;
+        default:
+            break;
+    }
+    return root;
+}
+
+const char* PageManager::pageName(Page page) {
+    switch (page) {
+        case Page::Home: return "home";
+        case Page::History: return "history";
+        case Page::Search: return "search";
+    }
+    return "unknown";
+}
+
 void PageManager::setContentArea(lv_obj_t* content_area) {
     content_area_ = content_area;
 }
@@ -14,13 +66,18 @@ void PageManager::registerUnmountCallback(Page page, UnmountCallback cb) {
 
 void PageManager::switchTo(Page page) {
     if (!content_area_) return;
-    if (page == current_) return;
+    if (has_current_ && page == current_) return;
 
-    // ✅ P0修复：调用旧页面的 unmount 回调，释放资源（定时器、事件监听等）
-    // 这是解决资源泄漏和 Ghost UI 的关键步骤
-    if (auto it = unmount_callbacks_.find(current_); it != unmount_callbacks_.end()) {
-        if (it->second) {
-            it->second();
+    auto begin = std::chrono::steady_clock::now();
+    Page from = current_;
+    bool had_from = has_current_;
+
+    // 旧页面只隐藏；不缓存时（page_cache_pages <= 1）按原逻辑销毁
+    if (had_from) {
+        if (cfg_.page_cache_pages <= 1) {
+            destroyPage(from);
+        } else if (auto it = pages_.find(from); it != pages_.end() && it->second.lifecycle) {
+            it->second.lifecycle->hide();
         }
     }
 
@@ -28,29 +85,89 @@ void PageManager::switchTo(Page page) {
     // 这是解决 lv_timer_handler 内部焦点处理冲突的关键步骤
     FocusManager::getInstance().resetActiveGroup();
 
-    // ✅ 核心修复：清理旧子树，避免 UI 叠加和对象悬空
-    // 这是解决刷新期崩溃的关键步骤
-    lv_obj_clean(content_area_);
+    // 之后的 LVGL 分配（构建页面、列表滚动重绑等）都记到该页面名下
+    ktv_lv_pool_set_tag(page_tag(page));
+
+    CachedPage& entry = pages_[page];
+    bool cached = entry.lifecycle && entry.lifecycle->getPage();
+    if (cached) {
+        entry.lifecycle->show();
+    } else {
+        entry.lifecycle.reset(new PageLifecycle(content_area_));
+        entry.lifecycle->setOnCreate([page](lv_obj_t* parent) { return build_page(page, parent); });
+        entry.lifecycle->setOnDestroy([this, page](lv_obj_t*) {
+            if (auto it = unmount_callbacks_.find(page); it != unmount_callbacks_.end() && it->second) {
+                it->second();
+            }
+        });
+        entry.lifecycle->show();
+
+        // ✅ 更新布局（但不立即刷新，让主循环处理）
+        lv_obj_update_layout(content_area_);
+
+        entry.obj_count = entry.lifecycle->getPage() ? count_objs(entry.lifecycle->getPage()) : 0;
+    }
 
     current_ = page;
-    switch (page) {
-        case Page::Home:
-            show_home_tab(content_area_);
-            break;
-        case Page::History:
-            show_history_tab(content_area_);
-            break;
-        case Page::Search:
-            show_search_page(content_area_);
-            break;
-        default:
-            break;
+    has_current_ = true;
+    lru_.remove(page);
+    lru_.push_front(page);
+    enforceBudget();
+
+    auto cost_us = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - begin).count();
+    KTV_SYSLOG(LOG_INFO,
+               "[ktv][ui][page_switch] from=%s to=%s mode=%s cost_us=%lld objs=%u page_bytes=%zu "
+               "cached_pages=%zu cached_bytes=%zu scale=%s",
+               had_from ? pageName(from) : "none", pageName(page), cached ? "cached" : "built",
+               static_cast<long long>(cost_us), entry.obj_count, pageBytes(page),
+               lru_.size(), cachedBytes(), UIScale::isFixed() ? "fixed" : "runtime");
+}
+
+void PageManager::invalidate(Page page) {
+    if (has_current_ && page == current_) {
+        // 当前页面：销毁后立即重建
+        has_current_ = false;
+        destroyPage(page);
+        switchTo(page);
+        return;
+    }
+    destroyPage(page);
+}
+
+void PageManager::destroyPage(Page page) {
+    auto it = pages_.find(page);
+    if (it == pages_.end()) return;
+    if (it->second.lifecycle) {
+        // 页面内的对象可能还在焦点组里
+        FocusManager::getInstance().resetActiveGroup();
+        it->second.lifecycle->destroy();
     }
+    pages_.erase(it);
+    lru_.remove(page);
+}
 
-    // ✅ 更新布局（但不立即刷新，让主循环处理）
-    // 这样可以避免在切换页面时触发过早的刷新
-    lv_obj_update_layout(content_area_);
+size_t PageManager::pageBytes(Page page) const {
+    return ktv_lv_pool_tag_bytes(page_tag(page));
 }
 
-}  // namespace ktv::ui
+size_t PageManager::cachedBytes() const {
+    size_t total = 0;
+    for (const auto& kv : pages_) total += pageBytes(kv.first);
+    return total;
+}
+
+void PageManager::enforceBudget() {
+    const size_t max_pages = cfg_.page_cache_pages > 1 ? static_cast<size_t>(cfg_.page_cache_pages) : 1;
+    const size_t budget = cfg_.page_cache_budget_kb > 0 ? static_cast<size_t>(cfg_.page_cache_budget_kb) * 1024 : 0;
+
+    // 当前页面永远保留（位于 LRU 头部）
+    while (lru_.size() > 1 && (lru_.size() > max_pages || (budget > 0 && cachedBytes() > budget))) {
+        Page victim = lru_.back();
+        KTV_SYSLOG(LOG_INFO, "[ktv][ui][page_cache] action=evict page=%s page_bytes=%zu cached_bytes=%zu",
+                   pageName(victim), pageBytes(victim), cachedBytes());
+        destroyPage(victim);
+    }
+}
 
+}  // namespace ktv::ui
@@ -2,8 +2,14 @@
 #define KTVLV_UI_PAGE_MANAGER_H
 
 #include <lvgl.h>
+#include <cstddef>
+#include <cstdint>
 #include <functional>
+#include <list>
+#include <memory>
 #include <unordered_map>
+#include "page_lifecycle.h"
+#include "../config/config.h"
 
 namespace ktv::ui {
 
@@ -13,7 +19,14 @@ enum class Page {
     Search,
 };
 
-// 轻量页面管理（单例，记录内容区域并切换展示）
+/**
+ * 轻量页面管理（单例，记录内容区域并切换展示）
+ *
+ * - 每个页面挂在内容区域下的独立容器里，由 PageLifecycle 管理
+ * - 切换时旧页面只隐藏不销毁；再次切回只是清除 HIDDEN 标志，不重建、不重新拉数据
+ * - 缓存页面数与 LVGL 内存占用（内存池按页面记账）受 UiConfig 约束，超出时按 LRU 销毁最久未用的页面
+ * - 每次切换输出 [ktv][ui][page_switch] 耗时（mode=built/cached），用于对比缓存前后
+ */
 class PageManager {
 public:
     using UnmountCallback = std::function<void()>;
@@ -29,25 +42,46 @@ public:
     // 设置内容区域容器
     void setContentArea(lv_obj_t* content_area);
 
-    // 注册页面的 unmount 回调（用于释放资源、清理定时器等）
+    void setCacheConfig(const ktv::config::UiConfig& cfg) { cfg_ = cfg; }
+
+    // 注册页面的 unmount 回调（页面被销毁时调用：LRU 淘汰或 invalidate）
     void registerUnmountCallback(Page page, UnmountCallback cb);
 
     // 切换页面
     void switchTo(Page page);
 
+    // 丢弃页面缓存，下次切换时重建（数据需要整体刷新时使用）
+    void invalidate(Page page);
+
     // 获取当前页面
     Page getCurrentPage() const { return current_; }
 
+    static const char* pageName(Page page);
+
 private:
     PageManager() = default;
     ~PageManager() = default;
 
+    struct CachedPage {
+        std::unique_ptr<PageLifecycle> lifecycle;
+        uint32_t obj_count = 0;
+    };
+
+    void destroyPage(Page page);
+    void enforceBudget();
+    // 页面当前占用的 LVGL 内存（内存池按页面标签记账，含创建后的增量）
+    size_t pageBytes(Page page) const;
+    size_t cachedBytes() const;
+
     lv_obj_t* content_area_ = nullptr;
     Page current_ = Page::Home;
+    bool has_current_ = false;
+    ktv::config::UiConfig cfg_;
+    std::unordered_map<Page, CachedPage> pages_;
+    std::list<Page> lru_;   // 头部为最近使用
     std::unordered_map<Page, UnmountCallback> unmount_callbacks_;
 };
 
 }  // namespace ktv::ui
 
 #endif  // KTVLV_UI_PAGE_MANAGER_H
-
@@ -0,0 +1,270 @@
+#include "perf_hud.h"
+#include "style_registry.h"
+#include "../events/event_bus.h"
+#include "../events/ui_dispatcher.h"
+#include "../utils/log_macros.h"
+#include <time.h>
+#include <algorithm>
+#include <cstdio>
+
+namespace ktv::ui {
+
+namespace {
+
+constexpr uint32_t kTickMs = 500;                 // HUD 刷新与秒统计检查周期
+constexpr uint64_t kMaxInputLatencyUs = 2000000;  // 超过视为该按键未引起重绘，丢弃
+constexpr uint64_t kComboWindowUs = 1500000;      // 组合键需在该时间内按完
+
+// linux/input-event-codes.h
+constexpr uint16_t kKeyLeft = 105;
+constexpr uint16_t kKeyRight = 106;
+constexpr uint16_t kKeyF12 = 88;
+constexpr std::array<uint16_t, 4> kComboKeys{kKeyLeft, kKeyRight, kKeyLeft, kKeyRight};
+
+uint64_t now_us() {
+    struct timespec ts;
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+    return static_cast<uint64_t>(ts.tv_sec) * 1000000ULL + static_cast<uint64_t>(ts.tv_nsec) / 1000ULL;
+}
+
+size_t fps_bucket(uint32_t fps) {
+    if (fps < 15) return 0;
+    if (fps < 30) return 1;
+    if (fps < 45) return 2;
+    if (fps < 55) return 3;
+    return 4;
+}
+
+}  // namespace
+
+void PerfHud::Window::add(uint32_t v) {
+    values_[head_] = v;
+    head_ = (head_ + 1) % kCapacity;
+    if (count_ < kCapacity) ++count_;
+}
+
+uint32_t PerfHud::Window::percentile(int p) const {
+    if (count_ == 0) return 0;
+    std::array<uint32_t, kCapacity> sorted;
+    std::copy(values_.begin(), values_.begin() + static_cast<std::ptrdiff_t>(count_), sorted.begin());
+    size_t idx = (count_ - 1) * static_cast<size_t>(p) / 100;
+    std::nth_element(sorted.begin(), sorted.begin() + static_cast<std::ptrdiff_t>(idx),
+                     sorted.begin() + static_cast<std::ptrdiff_t>(count_));
+    return sorted[idx];
+}
+
+uint32_t PerfHud::Window::max() const {
+    if (count_ == 0) return 0;
+    return *std::max_element(values_.begin(), values_.begin() + static_cast<std::ptrdiff_t>(count_));
+}
+
+void PerfHud::setConfig(const ktv::config::PerfConfig& cfg) {
+    cfg_ = cfg;
+    if (disp_) setVisible(cfg_.hud);
+}
+
+void PerfHud::attach(lv_disp_t* disp) {
+    if (!disp || disp_) return;
+    disp_ = disp;
+    lv_disp_drv_t* drv = disp->driver;
+    orig_flush_ = drv->flush_cb;
+    orig_render_start_ = drv->render_start_cb;
+    orig_monitor_ = drv->monitor_cb;
+    drv->flush_cb = onFlush;
+    drv->render_start_cb = onRenderStart;
+    drv->monitor_cb = onMonitor;
+
+    second_start_us_ = last_log_us_ = now_us();
+    timer_ = lv_timer_create(onTick, kTickMs, this);
+    setVisible(cfg_.hud);
+    KTV_SYSLOG(LOG_INFO, "[ktv][perf][init] hud=%d hotkey=%d log_interval_s=%d", cfg_.hud ? 1 : 0,
+               cfg_.hud_hotkey ? 1 : 0, cfg_.log_interval_s);
+}
+
+void PerfHud::recordTimerHandler(uint64_t us) {
+    timer_us_.add(static_cast<uint32_t>(std::min<uint64_t>(us, UINT32_MAX)));
+
+    max_bus_depth_ = std::max(max_bus_depth_,
+                              static_cast<uint32_t>(ktv::events::EventBus::getInstance().pending()));
+    max_ui_depth_ = std::max(max_ui_depth_,
+                             static_cast<uint32_t>(ktv::events::UiDispatcher::getInstance().pending()));
+}
+
+void PerfHud::onKeyPress(uint16_t code, uint64_t ts_us) {
+    // 按键已在上一次 lv_timer_handler 中被读取，之后完成的第一帧即反映该按键
+    if (ts_us != 0 && !input_pending_) {
+        input_ts_us_ = ts_us;
+        input_pending_ = true;
+    }
+
+    if (!cfg_.hud_hotkey) return;
+    if (code == kKeyF12) {
+        setVisible(!visible_);
+        return;
+    }
+    combo_[combo_pos_ % combo_.size()] = code;
+    combo_ts_[combo_pos_ % combo_.size()] = ts_us ? ts_us : now_us();
+    ++combo_pos_;
+    if (combo_pos_ < combo_.size()) return;
+
+    // 最近 4 次按键依次匹配且总时长在窗口内
+    size_t first = combo_pos_ % combo_.size();
+    for (size_t i = 0; i < combo_.size(); ++i) {
+        if (combo_[(first + i) % combo_.size()] != kComboKeys[i]) return;
+    }
+    size_t last = (combo_pos_ - 1) % combo_.size();
+    if (combo_ts_[last] - combo_ts_[first] > kComboWindowUs) return;
+    combo_pos_ = 0;
+    setVisible(!visible_);
+}
+
+void PerfHud::setVisible(bool visible) {
+    visible_ = visible;
+    if (visible && !label_) createLabel();
+    if (!label_) return;
+    if (visible) {
+        lv_obj_clear_flag(label_, LV_OBJ_FLAG_HIDDEN);
+        updateLabel();
+    } else {
+        lv_obj_add_flag(label_, LV_OBJ_FLAG_HIDDEN);
+    }
+    KTV_SYSLOG(LOG_INFO, "[ktv][perf][hud] visible=%d", visible ? 1 : 0);
+}
+
+void PerfHud::createLabel() {
+    auto& reg = StyleRegistry::getInstance();
+    label_ = lv_label_create(lv_layer_sys());
+    lv_obj_add_style(label_, reg.bg(0x000000, LV_OPA_60), 0);
+    lv_obj_add_style(label_, reg.textColor(0x7CFC00), 0);
+    lv_obj_add_style(label_, reg.padAll(8), 0);
+    lv_obj_add_style(label_, reg.text(18), 0);
+    lv_obj_clear_flag(label_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_align(label_, LV_ALIGN_TOP_RIGHT, 0, 0);
+}
+
+void PerfHud::onRenderStart(lv_disp_drv_t* drv) {
+    PerfHud& self = getInstance();
+    self.render_start_us_ = now_us();
+    self.frame_flush_us_ = 0;
+    self.frame_flush_px_ = 0;
+    if (self.orig_render_start_) self.orig_render_start_(drv);
+}
+
+void PerfHud::onFlush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color) {
+    PerfHud& self = getInstance();
+    uint64_t begin = now_us();
+    self.orig_flush_(drv, area, color);
+    // 异步 flush（DMA）时这里只统计提交耗时
+    self.frame_flush_us_ += now_us() - begin;
+    self.frame_flush_px_ += static_cast<uint64_t>(lv_area_get_width(area)) *
+                            static_cast<uint64_t>(lv_area_get_height(area));
+}
+
+void PerfHud::onMonitor(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px) {
+    PerfHud& self = getInstance();
+    self.frameDone(px);
+    if (self.orig_monitor_) self.orig_monitor_(drv, time_ms, px);
+}
+
+void PerfHud::frameDone(uint32_t px) {
+    (void)px;
+    uint64_t now = now_us();
+    if (render_start_us_ != 0) {
+        uint64_t total = now - render_start_us_;
+        uint64_t render = total > frame_flush_us_ ? total - frame_flush_us_ : 0;
+        render_us_.add(static_cast<uint32_t>(std::min<uint64_t>(render, UINT32_MAX)));
+        flush_us_.add(static_cast<uint32_t>(std::min<uint64_t>(frame_flush_us_, UINT32_MAX)));
+    }
+    flush_bytes_ += frame_flush_px_ * sizeof(lv_color_t);
+    ++frames_this_second_;
+
+    if (input_pending_) {
+        if (now > input_ts_us_ && now - input_ts_us_ < kMaxInputLatencyUs) {
+            input_ms_.add(static_cast<uint32_t>((now - input_ts_us_) / 1000));
+        }
+        input_pending_ = false;
+    }
+}
+
+void PerfHud::secondElapsed(uint64_t now_us_val) {
+    uint64_t elapsed = now_us_val - second_start_us_;
+    if (elapsed < 1000000) return;
+    // 空闲（没有任何刷新）的时段不计入直方图，只统计实际在绘制的秒
+    if (frames_this_second_ > 0) {
+        last_fps_ = static_cast<uint32_t>(frames_this_second_ * 1000000ULL / elapsed);
+        ++fps_hist_[fps_bucket(last_fps_)];
+    } else {
+        last_fps_ = 0;
+    }
+    frames_this_second_ = 0;
+    second_start_us_ = now_us_val;
+}
+
+void PerfHud::onTick(lv_timer_t* timer) {
+    PerfHud& self = *static_cast<PerfHud*>(timer->user_data);
+    uint64_t now = now_us();
+    self.secondElapsed(now);
+    // 按键还没等到重绘时不刷新 HUD：HUD 自己的重绘会被当成该按键的响应帧；
+    // 超时仍未重绘的按键视为没有引起重绘，放弃统计
+    if (self.input_pending_ && now > self.input_ts_us_ && now - self.input_ts_us_ >= kMaxInputLatencyUs) {
+        self.input_pending_ = false;
+    }
+    if (self.visible_ && !self.input_pending_) self.updateLabel();
+    if (self.cfg_.log_interval_s > 0 &&
+        now - self.last_log_us_ >= static_cast<uint64_t>(self.cfg_.log_interval_s) * 1000000ULL) {
+        self.dumpToLog();
+        self.last_log_us_ = now;
+    }
+}
+
+void PerfHud::updateLabel() {
+    if (!label_) return;
+    char buf[320];
+    std::snprintf(buf, sizeof(buf),
+                  "FPS %u\n"
+                  "timer p50 %.1f p95 %.1f ms\n"
+                  "render p50 %.1f p95 %.1f ms\n"
+                  "flush p50 %.1f p95 %.1f ms\n"
+                  "input p50 %u p95 %u ms\n"
+                  "queue bus %u ui %u\n"
+                  "fps <15:%u <30:%u <45:%u <55:%u 55+:%u",
+                  last_fps_,
+                  timer_us_.percentile(50) / 1000.0, timer_us_.percentile(95) / 1000.0,
+                  render_us_.percentile(50) / 1000.0, render_us_.percentile(95) / 1000.0,
+                  flush_us_.percentile(50) / 1000.0, flush_us_.percentile(95) / 1000.0,
+                  input_ms_.percentile(50), input_ms_.percentile(95),
+                  max_bus_depth_, max_ui_depth_,
+                  fps_hist_[0], fps_hist_[1], fps_hist_[2], fps_hist_[3], fps_hist_[4]);
+    lv_label_set_text(label_, buf);
+}
+
+void PerfHud::dumpToLog() {
+    // 日志环单条记录最多 kMaxArgs（12）个参数：帧耗时与刷屏分两条，UI 线程不直接调用 syslog()
+    KTV_SYSLOG(LOG_INFO,
+               "[ktv][perf][frame] timer_us p50=%u p95=%u p99=%u max=%u render_us p50=%u p95=%u p99=%u max=%u "
+               "samples=%zu",
+               timer_us_.percentile(50), timer_us_.percentile(95), timer_us_.percentile(99), timer_us_.max(),
+               render_us_.percentile(50), render_us_.percentile(95), render_us_.percentile(99), render_us_.max(),
+               render_us_.size());
+    KTV_SYSLOG(LOG_INFO,
+               "[ktv][perf][flush] flush_us p50=%u p95=%u max=%u flush_kb=%llu samples=%zu",
+               flush_us_.percentile(50), flush_us_.percentile(95), flush_us_.max(),
+               static_cast<unsigned long long>(flush_bytes_ / 1024), flush_us_.size());
+    KTV_SYSLOG(LOG_INFO,
+               "[ktv][perf][input] latency_ms p50=%u p95=%u p99=%u max=%u samples=%zu",
+               input_ms_.percentile(50), input_ms_.percentile(95), input_ms_.percentile(99), input_ms_.max(),
+               input_ms_.size());
+    KTV_SYSLOG(LOG_INFO,
+               "[ktv][perf][fps] hist_lt15=%u hist_lt30=%u hist_lt45=%u hist_lt55=%u hist_ge55=%u "
+               "bus_depth_max=%u ui_depth_max=%u",
+               fps_hist_[0], fps_hist_[1], fps_hist_[2], fps_hist_[3], fps_hist_[4],
+               max_bus_depth_, max_ui_depth_);
+
+    // 直方图与队列峰值按日志周期清零，分位数窗口持续滚动
+    fps_hist_.fill(0);
+    flush_bytes_ = 0;
+    max_bus_depth_ = 0;
+    max_ui_depth_ = 0;
+}
+
+}  // namespace ktv::ui
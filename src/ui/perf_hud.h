@@ -0,0 +1,129 @@
+#ifndef KTVLV_UI_PERF_HUD_H
+#define KTVLV_UI_PERF_HUD_H
+
+#include <lvgl.h>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include "../config/config.h"
+
+namespace ktv::ui {
+
+/**
+ * 性能统计与 HUD
+ *
+ * - lv_timer_handler 耗时（主循环上报）
+ * - 每帧渲染/flush 拆分：包装显示驱动的 render_start_cb / flush_cb / monitor_cb
+ * - FPS 直方图（按秒统计帧数）
+ * - 输入延迟：evdev 内核时间戳 → 第一帧反映该按键的刷新完成
+ * - EventBus / UiDispatcher 队列深度
+ *
+ * 最近若干样本的分位数周期写 syslog；HUD 挂在 lv_layer_sys() 上，由配置切换；
+ * [perf] hud_hotkey 打开时另可用组合键（遥控器 左右左右，键盘 F12）切换。
+ * 输入延迟等待期间 HUD 不刷新文字，避免把 HUD 自身的重绘算成按键响应。只能在 UI 线程调用。
+ */
+class PerfHud {
+public:
+    static PerfHud& getInstance() {
+        static PerfHud instance;
+        return instance;
+    }
+
+    PerfHud(const PerfHud&) = delete;
+    PerfHud& operator=(const PerfHud&) = delete;
+
+    void setConfig(const ktv::config::PerfConfig& cfg);
+
+    /**
+     * 接管显示驱动回调（原 flush_cb 仍会被调用），并创建统计定时器
+     */
+    void attach(lv_disp_t* disp);
+
+    // 主循环：一次 lv_timer_handler 的耗时
+    void recordTimerHandler(uint64_t us);
+
+    /**
+     * 主循环：已被 LVGL 读取的按键按下（Linux 键码 + CLOCK_MONOTONIC 微秒内核时间戳）
+     * 用于输入延迟统计与 HUD 组合键
+     */
+    void onKeyPress(uint16_t code, uint64_t ts_us);
+
+    void setVisible(bool visible);
+    bool visible() const { return visible_; }
+
+    // 立即把当前分位数写入 syslog
+    void dumpToLog();
+
+private:
+    // 固定容量的滚动窗口，分位数按需排序计算
+    class Window {
+    public:
+        void add(uint32_t v);
+        uint32_t percentile(int p) const;
+        uint32_t max() const;
+        size_t size() const { return count_; }
+
+    private:
+        static constexpr size_t kCapacity = 512;
+        std::array<uint32_t, kCapacity> values_{};
+        size_t head_{0};
+        size_t count_{0};
+    };
+
+    // FPS 直方图分档：<15, 15-29, 30-44, 45-54, >=55
+    static constexpr size_t kFpsBuckets = 5;
+
+    PerfHud() = default;
+    ~PerfHud() = default;
+
+    static void onRenderStart(lv_disp_drv_t* drv);
+    static void onFlush(lv_disp_drv_t* drv, const lv_area_t* area, lv_color_t* color);
+    static void onMonitor(lv_disp_drv_t* drv, uint32_t time_ms, uint32_t px);
+    static void onTick(lv_timer_t* timer);
+
+    void frameDone(uint32_t px);
+    void secondElapsed(uint64_t now_us);
+    void updateLabel();
+    void createLabel();
+
+    ktv::config::PerfConfig cfg_;
+    bool visible_{false};
+    lv_disp_t* disp_{nullptr};
+    lv_obj_t* label_{nullptr};
+    lv_timer_t* timer_{nullptr};
+
+    void (*orig_flush_)(lv_disp_drv_t*, const lv_area_t*, lv_color_t*){nullptr};
+    void (*orig_render_start_)(lv_disp_drv_t*){nullptr};
+    void (*orig_monitor_)(lv_disp_drv_t*, uint32_t, uint32_t){nullptr};
+
+    // 当前帧
+    uint64_t render_start_us_{0};
+    uint64_t frame_flush_us_{0};
+    uint64_t frame_flush_px_{0};
+
+    // 输入延迟：内核时间戳 → LVGL 读取后的下一次刷新完成
+    bool input_pending_{false};
+    uint64_t input_ts_us_{0};
+
+    // 组合键
+    std::array<uint16_t, 4> combo_{};
+    std::array<uint64_t, 4> combo_ts_{};
+    size_t combo_pos_{0};
+
+    Window timer_us_;
+    Window render_us_;
+    Window flush_us_;
+    Window input_ms_;
+    std::array<uint32_t, kFpsBuckets> fps_hist_{};
+    uint32_t frames_this_second_{0};
+    uint32_t last_fps_{0};
+    uint64_t second_start_us_{0};
+    uint64_t last_log_us_{0};
+    uint64_t flush_bytes_{0};
+    uint32_t max_bus_depth_{0};
+    uint32_t max_ui_depth_{0};
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_PERF_HUD_H
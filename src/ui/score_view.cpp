@@ -0,0 +1,169 @@
+#include "score_view.h"
+#include "style_registry.h"
+#include "ui_scale.h"
+#include "../utils/json_helper.h"
+#include "../utils/log_macros.h"
+#include <algorithm>
+
+namespace ktv::ui {
+
+namespace {
+
+struct Fields {
+    std::string song_id;
+    double score = 0.0;
+    double cents = 0.0;
+    double sung_midi = 0.0;
+    double ref_midi = 0.0;
+};
+
+bool parse(const std::string& payload, Fields& out) {
+    ktv::utils::JsonDocument doc;
+    if (JsonHelper::Parse(payload.c_str(), payload.size(), &doc) != 0) return false;
+    const cJSON* root = doc.root();
+    char song_id[128]{0};
+    if (JsonHelper::GetString(root, "song_id", song_id, sizeof(song_id)) == 0) out.song_id = song_id;
+    ktv::utils::OutDouble d;
+    if (JsonHelper::GetDouble(root, "score", &d) == 0) out.score = d.value;
+    if (JsonHelper::GetDouble(root, "cents", &d) == 0) out.cents = d.value;
+    if (JsonHelper::GetDouble(root, "sung_midi", &d) == 0) out.sung_midi = d.value;
+    if (JsonHelper::GetDouble(root, "ref_midi", &d) == 0) out.ref_midi = d.value;
+    return true;
+}
+
+const char* rating_text(double score) {
+    if (score >= 90.0) return "PERFECT";
+    if (score >= 75.0) return "GREAT";
+    if (score >= 60.0) return "GOOD";
+    return "MISS";
+}
+
+uint32_t rating_color(double score) {
+    if (score >= 90.0) return 0xFFD700;
+    if (score >= 75.0) return 0x7CFC00;
+    if (score >= 60.0) return 0x87CEFA;
+    return 0xB0B0B0;
+}
+
+}  // namespace
+
+void ScoreView::ensureCreated() {
+    if (panel_) return;
+    auto& reg = StyleRegistry::getInstance();
+
+    panel_ = lv_obj_create(lv_layer_top());
+    lv_obj_add_style(panel_, reg.bg(0x000000, LV_OPA_50), 0);
+    lv_obj_add_style(panel_, reg.radius(12), 0);
+    lv_obj_add_style(panel_, reg.spacing(6, 12), 0);
+    lv_obj_add_style(panel_, reg.border(0), 0);
+    lv_obj_set_size(panel_, UIScale::s(320), LV_SIZE_CONTENT);
+    lv_obj_set_flex_flow(panel_, LV_FLEX_FLOW_COLUMN);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_SCROLLABLE);
+    lv_obj_align(panel_, LV_ALIGN_TOP_LEFT, UIScale::s(24), UIScale::s(24));
+
+    score_label_ = lv_label_create(panel_);
+    lv_obj_add_style(score_label_, reg.textColor(0xFFFFFF), 0);
+    lv_obj_add_style(score_label_, reg.text(28), 0);
+    lv_label_set_text(score_label_, "SCORE 0.0");
+
+    // 音准条：中点为唱准，左偏低右偏高
+    pitch_bar_ = lv_bar_create(panel_);
+    lv_bar_set_mode(pitch_bar_, LV_BAR_MODE_SYMMETRICAL);
+    lv_bar_set_range(pitch_bar_, -kCentsRange, kCentsRange);
+    lv_obj_set_size(pitch_bar_, LV_PCT(100), UIScale::s(12));
+
+    rating_label_ = lv_label_create(panel_);
+    lv_obj_add_style(rating_label_, reg.text(24), 0);
+    lv_label_set_text(rating_label_, "");
+
+    final_label_ = lv_label_create(lv_layer_top());
+    lv_obj_add_style(final_label_, reg.bg(0x000000, LV_OPA_70), 0);
+    lv_obj_add_style(final_label_, reg.radius(16), 0);
+    lv_obj_add_style(final_label_, reg.padAll(32), 0);
+    lv_obj_add_style(final_label_, reg.textColor(0xFFD700), 0);
+    lv_obj_add_style(final_label_, reg.text(48), 0);
+    lv_obj_add_style(final_label_, reg.textAlign(LV_TEXT_ALIGN_CENTER), 0);
+    lv_obj_clear_flag(final_label_, LV_OBJ_FLAG_CLICKABLE);
+    lv_obj_center(final_label_);
+    lv_obj_add_flag(final_label_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void ScoreView::show() {
+    ensureCreated();
+    lv_obj_clear_flag(panel_, LV_OBJ_FLAG_HIDDEN);
+}
+
+void ScoreView::onLive(const std::string& payload) {
+    Fields f;
+    if (!parse(payload, f)) return;
+    show();
+    if (f.song_id != song_id_) {
+        // 新的一首：上一首的结算还在显示时收起
+        song_id_ = f.song_id;
+        lv_obj_add_flag(final_label_, LV_OBJ_FLAG_HIDDEN);
+    }
+    lv_label_set_text_fmt(score_label_, "SCORE %.1f", f.score);
+
+    // 无声或当前没有参考音符时音准条回到中点
+    int cents = 0;
+    if (f.sung_midi > 0.0 && f.ref_midi > 0.0) {
+        cents = std::max(-kCentsRange, std::min(kCentsRange, static_cast<int>(f.cents)));
+    }
+    lv_bar_set_value(pitch_bar_, cents, LV_ANIM_OFF);
+}
+
+void ScoreView::onLine(const std::string& payload) {
+    Fields f;
+    if (!parse(payload, f)) return;
+    show();
+    lv_style_t* color = StyleRegistry::getInstance().textColor(rating_color(f.score));
+    if (color != rating_color_) {
+        if (rating_color_) lv_obj_remove_style(rating_label_, rating_color_, 0);
+        lv_obj_add_style(rating_label_, color, 0);
+        rating_color_ = color;
+    }
+    lv_label_set_text_fmt(rating_label_, "%s  %.0f", rating_text(f.score), f.score);
+
+    if (rating_timer_) {
+        lv_timer_reset(rating_timer_);
+    } else {
+        rating_timer_ = lv_timer_create(onRatingTimer, kRatingShowMs, this);
+        lv_timer_set_repeat_count(rating_timer_, 1);
+    }
+}
+
+void ScoreView::onFinal(const std::string& payload) {
+    Fields f;
+    if (!parse(payload, f)) return;
+    show();
+    lv_label_set_text_fmt(score_label_, "SCORE %.1f", f.score);
+    lv_bar_set_value(pitch_bar_, 0, LV_ANIM_OFF);
+    lv_label_set_text_fmt(final_label_, "FINAL\n%.1f", f.score);
+    lv_obj_center(final_label_);
+    lv_obj_clear_flag(final_label_, LV_OBJ_FLAG_HIDDEN);
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][score] action=final score=%.1f", f.score);
+
+    if (final_timer_) {
+        lv_timer_reset(final_timer_);
+    } else {
+        final_timer_ = lv_timer_create(onFinalTimer, kFinalShowMs, this);
+        lv_timer_set_repeat_count(final_timer_, 1);
+    }
+}
+
+void ScoreView::onRatingTimer(lv_timer_t* timer) {
+    auto* self = static_cast<ScoreView*>(timer->user_data);
+    self->rating_timer_ = nullptr;   // 单次定时器，回调返回后 LVGL 自行删除
+    lv_label_set_text(self->rating_label_, "");
+}
+
+void ScoreView::onFinalTimer(lv_timer_t* timer) {
+    auto* self = static_cast<ScoreView*>(timer->user_data);
+    self->final_timer_ = nullptr;
+    lv_obj_add_flag(self->final_label_, LV_OBJ_FLAG_HIDDEN);
+    lv_obj_add_flag(self->panel_, LV_OBJ_FLAG_HIDDEN);
+    self->song_id_.clear();
+}
+
+}  // namespace ktv::ui
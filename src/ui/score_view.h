@@ -0,0 +1,60 @@
+#ifndef KTVLV_UI_SCORE_VIEW_H
+#define KTVLV_UI_SCORE_VIEW_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <string>
+
+namespace ktv::ui {
+
+/**
+ * 演唱打分浮层（ScoreService 事件的 UI 消费方）
+ *
+ * - ScoreLive：左上角累计分 + 音准条（演唱相对参考音的偏差，±kCentsRange 音分）
+ * - ScoreLine：在音准条下方短暂显示一句的评价（PERFECT/GREAT/GOOD/MISS）
+ * - ScoreFinal：屏幕中央显示全曲得分，kFinalShowMs 后连同浮层一起隐藏
+ *
+ * 挂在 lv_layer_top() 上，首个事件到达时才创建。payload 为 ScoreService 发布的 JSON。
+ * 只能在 UI 线程调用（EventBus::dispatchOnUiThread）。
+ */
+class ScoreView {
+public:
+    static ScoreView& getInstance() {
+        static ScoreView instance;
+        return instance;
+    }
+
+    ScoreView(const ScoreView&) = delete;
+    ScoreView& operator=(const ScoreView&) = delete;
+
+    void onLive(const std::string& payload);
+    void onLine(const std::string& payload);
+    void onFinal(const std::string& payload);
+
+private:
+    static constexpr int kCentsRange = 200;
+    static constexpr uint32_t kRatingShowMs = 1500;
+    static constexpr uint32_t kFinalShowMs = 5000;
+
+    ScoreView() = default;
+    ~ScoreView() = default;
+
+    void ensureCreated();
+    void show();
+    static void onRatingTimer(lv_timer_t* timer);
+    static void onFinalTimer(lv_timer_t* timer);
+
+    lv_obj_t* panel_ = nullptr;
+    lv_obj_t* score_label_ = nullptr;
+    lv_obj_t* pitch_bar_ = nullptr;
+    lv_obj_t* rating_label_ = nullptr;
+    lv_obj_t* final_label_ = nullptr;
+    lv_style_t* rating_color_ = nullptr;   // 评价文字当前使用的颜色样式（共享样式，按分档切换）
+    lv_timer_t* rating_timer_ = nullptr;
+    lv_timer_t* final_timer_ = nullptr;
+    std::string song_id_;   // 当前显示的歌曲，换歌时清空上一首的结算
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_SCORE_VIEW_H
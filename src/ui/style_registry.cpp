@@ -0,0 +1,200 @@
+#include "style_registry.h"
+#include "ui_scale.h"
+#include "../utils/log_macros.h"
+#include <cstdlib>
+
+namespace ktv::ui {
+
+namespace {
+
+struct FontEntry {
+    lv_coord_t px;
+    const lv_font_t* font;
+};
+
+// lv_conf.h 中启用的字号，按从小到大排列
+const FontEntry kFonts[] = {
+#if LV_FONT_MONTSERRAT_12
+    {12, &lv_font_montserrat_12},
+#endif
+#if LV_FONT_MONTSERRAT_14
+    {14, &lv_font_montserrat_14},
+#endif
+#if LV_FONT_MONTSERRAT_16
+    {16, &lv_font_montserrat_16},
+#endif
+#if LV_FONT_MONTSERRAT_20
+    {20, &lv_font_montserrat_20},
+#endif
+#if LV_FONT_MONTSERRAT_24
+    {24, &lv_font_montserrat_24},
+#endif
+#if LV_FONT_MONTSERRAT_28
+    {28, &lv_font_montserrat_28},
+#endif
+#if LV_FONT_MONTSERRAT_32
+    {32, &lv_font_montserrat_32},
+#endif
+    {0, nullptr},
+};
+
+}  // namespace
+
+lv_style_t* StyleRegistry::spacing(lv_coord_t gap, lv_coord_t pad) {
+    return get(Kind::Spacing, static_cast<uint32_t>(gap), static_cast<uint32_t>(pad));
+}
+
+lv_style_t* StyleRegistry::padAll(lv_coord_t pad) {
+    return get(Kind::PadAll, static_cast<uint32_t>(pad));
+}
+
+lv_style_t* StyleRegistry::bgOpa(lv_opa_t opa) {
+    return get(Kind::BgOpa, opa);
+}
+
+lv_style_t* StyleRegistry::bg(uint32_t color, lv_opa_t opa) {
+    return get(Kind::Bg, color, opa);
+}
+
+lv_style_t* StyleRegistry::radius(lv_coord_t radius) {
+    return get(Kind::Radius, static_cast<uint32_t>(radius));
+}
+
+lv_style_t* StyleRegistry::border(lv_coord_t width) {
+    return get(Kind::Border, static_cast<uint32_t>(width));
+}
+
+lv_style_t* StyleRegistry::gradient(uint32_t color_start, uint32_t color_end, lv_coord_t radius) {
+    return get(Kind::Gradient, color_start, color_end, radius);
+}
+
+lv_style_t* StyleRegistry::textColor(uint32_t color) {
+    return get(Kind::TextColor, color);
+}
+
+lv_style_t* StyleRegistry::textAlign(lv_text_align_t align) {
+    return get(Kind::TextAlign, align);
+}
+
+lv_style_t* StyleRegistry::widthPct(lv_coord_t pct) {
+    return get(Kind::WidthPct, static_cast<uint32_t>(pct));
+}
+
+lv_style_t* StyleRegistry::text(lv_coord_t design_px) {
+    return get(Kind::Text, static_cast<uint32_t>(design_px));
+}
+
+const lv_font_t* StyleRegistry::font(lv_coord_t design_px) {
+    syncScale();
+    auto it = fonts_.find(design_px);
+    if (it != fonts_.end()) return it->second;
+
+    // 取缩放后最接近的字号，距离相同时取小号（避免撑破按缩放计算的容器）
+    const lv_coord_t want = UIScale::s(design_px);
+    const lv_font_t* best = LV_FONT_DEFAULT;
+    int best_diff = -1;
+    for (const FontEntry* f = kFonts; f->font; ++f) {
+        int diff = std::abs(f->px - want);
+        if (best_diff < 0 || diff < best_diff) {
+            best = f->font;
+            best_diff = diff;
+        }
+    }
+    fonts_[design_px] = best;
+    return best;
+}
+
+lv_coord_t StyleRegistry::fontSize(const lv_font_t* font) {
+    for (const FontEntry* f = kFonts; f->font; ++f) {
+        if (f->font == font) return f->px;
+    }
+    return 0;
+}
+
+lv_style_t* StyleRegistry::get(Kind kind, uint32_t a, uint32_t b, int32_t c) {
+    syncScale();
+    Key key{kind, a, b, c};
+    auto it = styles_.find(key);
+    if (it != styles_.end()) return &it->second->style;
+
+    auto entry = std::make_unique<Entry>();
+    entry->key = key;
+    lv_style_init(&entry->style);
+    build(*entry);
+    lv_style_t* style = &entry->style;
+    styles_.emplace(key, std::move(entry));
+    return style;
+}
+
+void StyleRegistry::build(Entry& e) {
+    const Kind kind = std::get<0>(e.key);
+    const uint32_t a = std::get<1>(e.key);
+    const uint32_t b = std::get<2>(e.key);
+    const int32_t c = std::get<3>(e.key);
+    lv_style_t* st = &e.style;
+    auto s = [](uint32_t v) { return UIScale::s(static_cast<lv_coord_t>(v)); };
+
+    switch (kind) {
+        case Kind::Spacing:
+            lv_style_set_pad_all(st, s(b));
+            lv_style_set_pad_row(st, s(a));
+            lv_style_set_pad_column(st, s(a));
+            break;
+        case Kind::PadAll:
+            lv_style_set_pad_all(st, s(a));
+            break;
+        case Kind::BgOpa:
+            lv_style_set_bg_opa(st, static_cast<lv_opa_t>(a));
+            break;
+        case Kind::Bg:
+            lv_style_set_bg_color(st, lv_color_hex(a));
+            lv_style_set_bg_opa(st, static_cast<lv_opa_t>(b));
+            break;
+        case Kind::Radius:
+            lv_style_set_radius(st, s(a));
+            break;
+        case Kind::Border:
+            lv_style_set_border_width(st, s(a));
+            break;
+        case Kind::Gradient:
+            lv_style_set_radius(st, s(static_cast<uint32_t>(c)));
+            lv_style_set_bg_color(st, lv_color_hex(a));
+            lv_style_set_bg_grad_color(st, lv_color_hex(b));
+            lv_style_set_bg_grad_dir(st, LV_GRAD_DIR_VER);
+            lv_style_set_bg_opa(st, LV_OPA_100);
+            break;
+        case Kind::TextColor:
+            lv_style_set_text_color(st, lv_color_hex(a));
+            break;
+        case Kind::TextAlign:
+            lv_style_set_text_align(st, static_cast<lv_text_align_t>(a));
+            break;
+        case Kind::WidthPct:
+            lv_style_set_width(st, LV_PCT(static_cast<lv_coord_t>(a)));
+            break;
+        case Kind::Text:
+            lv_style_set_text_font(st, font(static_cast<lv_coord_t>(a)));
+            break;
+    }
+}
+
+void StyleRegistry::syncScale() {
+    const float scale = UIScale::getInstance().getScale();
+    if (scale == scale_) return;
+    const bool had_styles = !styles_.empty();
+    scale_ = scale;
+    fonts_.clear();
+    if (!had_styles) return;
+
+    // 样式对象地址不变，只重写属性；对象引用的是指针，刷新后即生效
+    for (auto& kv : styles_) {
+        lv_style_reset(&kv.second->style);
+        lv_style_init(&kv.second->style);
+        build(*kv.second);
+    }
+    lv_obj_report_style_change(nullptr);
+    KTV_SYSLOG(LOG_INFO, "[ktv][ui][style] action=rescale scale=%.2f styles=%zu",
+               static_cast<double>(scale), styles_.size());
+}
+
+}  // namespace ktv::ui
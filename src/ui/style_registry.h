@@ -0,0 +1,96 @@
+#ifndef KTVLV_UI_STYLE_REGISTRY_H
+#define KTVLV_UI_STYLE_REGISTRY_H
+
+#include <lvgl.h>
+#include <cstdint>
+#include <map>
+#include <memory>
+#include <tuple>
+
+namespace ktv::ui {
+
+/**
+ * 共享样式/字体注册表
+ *
+ * 参数均为设计稿数值（1920x1080），按 UIScale 当前比例缩放后生成 lv_style_t，
+ * 相同参数的对象共用同一份样式，避免每个对象各自携带 local style。
+ * 缩放比例变化时原地重算所有样式并通知 LVGL 刷新，已添加样式的对象无需重建。
+ *
+ * 返回的指针在进程生命周期内有效；只能在 UI 线程调用。
+ */
+class StyleRegistry {
+public:
+    static StyleRegistry& getInstance() {
+        static StyleRegistry instance;
+        return instance;
+    }
+
+    StyleRegistry(const StyleRegistry&) = delete;
+    StyleRegistry& operator=(const StyleRegistry&) = delete;
+
+    // flex 容器间距：pad_all = pad，pad_row/pad_column = gap
+    lv_style_t* spacing(lv_coord_t gap, lv_coord_t pad);
+    lv_style_t* padAll(lv_coord_t pad);
+    lv_style_t* bgOpa(lv_opa_t opa);
+    lv_style_t* bg(uint32_t color, lv_opa_t opa);
+    lv_style_t* radius(lv_coord_t radius);
+    // 边框宽度，border(0) 用于去掉默认主题的容器边框
+    lv_style_t* border(lv_coord_t width);
+    // 竖直渐变背景（不透明）+ 圆角
+    lv_style_t* gradient(uint32_t color_start, uint32_t color_end, lv_coord_t radius);
+    lv_style_t* textColor(uint32_t color);
+    lv_style_t* textAlign(lv_text_align_t align);
+    // 百分比宽度，不参与缩放
+    lv_style_t* widthPct(lv_coord_t pct);
+    // text_font = font(design_px)
+    lv_style_t* text(lv_coord_t design_px);
+
+    /**
+     * 设计稿字号映射到最接近的已编译字体（lv_conf.h 中启用的 Montserrat 字号）
+     */
+    const lv_font_t* font(lv_coord_t design_px);
+
+    /**
+     * 已编译字体对应的设计字号，非内置字体返回 0
+     */
+    static lv_coord_t fontSize(const lv_font_t* font);
+
+    // 创建过的样式数量（调试用）
+    size_t size() const { return styles_.size(); }
+
+private:
+    enum class Kind : uint8_t {
+        Spacing,
+        PadAll,
+        BgOpa,
+        Bg,
+        Radius,
+        Border,
+        Gradient,
+        TextColor,
+        TextAlign,
+        WidthPct,
+        Text,
+    };
+    using Key = std::tuple<Kind, uint32_t, uint32_t, int32_t>;
+
+    struct Entry {
+        Key key;
+        lv_style_t style;
+    };
+
+    StyleRegistry() = default;
+    ~StyleRegistry() = default;
+
+    lv_style_t* get(Kind kind, uint32_t a, uint32_t b = 0, int32_t c = 0);
+    void build(Entry& e);
+    void syncScale();
+
+    float scale_{0.0f};
+    std::map<Key, std::unique_ptr<Entry>> styles_;
+    std::map<lv_coord_t, const lv_font_t*> fonts_;
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_STYLE_REGISTRY_H
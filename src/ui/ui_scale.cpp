@@ -1,4 +1,6 @@
 #include "ui_scale.h"
+#include "style_registry.h"
+#include "../utils/log_macros.h"
 #include <algorithm>
 #include <cmath>
 
@@ -11,6 +13,17 @@ void UIScale::initialize(lv_coord_t screen_width, lv_coord_t screen_height,
     design_width_ = design_width;
     design_height_ = design_height;
 
+#if KTV_UI_FIXED_SCALE
+    // 比例已在编译期确定，这里只同步 getScale() 并提示面板与构建不一致
+    (void)design_width;
+    (void)design_height;
+    scale_ = static_cast<float>(scale_detail::kFixedRatio.num) / scale_detail::kFixedRatio.den;
+    if (screen_width != KTV_UI_FIXED_WIDTH || screen_height != KTV_UI_FIXED_HEIGHT) {
+        KTV_SYSLOG(LOG_WARNING, "[ktv][ui][scale] fixed=%dx%d actual=%dx%d scale=%.3f",
+                   KTV_UI_FIXED_WIDTH, KTV_UI_FIXED_HEIGHT, static_cast<int>(screen_width),
+                   static_cast<int>(screen_height), static_cast<double>(scale_));
+    }
+#else
     // 计算缩放比例：取宽高比例的最小值，保证内容不溢出
     float scale_w = static_cast<float>(screen_width) / design_width;
     float scale_h = static_cast<float>(screen_height) / design_height;
@@ -18,18 +31,22 @@ void UIScale::initialize(lv_coord_t screen_width, lv_coord_t screen_height,
 
     // 限制缩放范围：0.5x ~ 2.0x，避免极端情况
     scale_ = std::max(0.5f, std::min(2.0f, scale_));
+#endif
 }
 
 lv_coord_t UIScale::scale(lv_coord_t value) const {
+#if KTV_UI_FIXED_SCALE
+    return s(value);
+#else
     return static_cast<lv_coord_t>(std::round(value * scale_));
+#endif
 }
 
 const lv_font_t* UIScale::scaleFont(const lv_font_t* base_font) const {
-    // LVGL 字体系统较复杂，这里简化处理
-    // 实际项目中可以维护字体映射表
-    // 暂时返回原字体，后续可扩展
-    (void)scale_;  // 避免未使用警告
-    return base_font;
+    // 只有内置 Montserrat 字号能换算，其余字体（如外部中文字库）原样返回
+    lv_coord_t design_px = StyleRegistry::fontSize(base_font);
+    if (design_px == 0) return base_font;
+    return StyleRegistry::getInstance().font(design_px);
 }
 
 }  // namespace ktv::ui
@@ -2,9 +2,56 @@
 #define KTVLV_UI_UI_SCALE_H
 
 #include <lvgl.h>
+#include <cstdint>
+
+/*
+ * 固定分辨率构建：CMake 传入 KTV_UI_FIXED_WIDTH/HEIGHT 后缩放比例在编译期确定，
+ * UIScale::s(N) 为 constexpr，字面量参数直接折叠为常量；未定义时走运行时缩放。
+ */
+#if defined(KTV_UI_FIXED_WIDTH) && defined(KTV_UI_FIXED_HEIGHT)
+#define KTV_UI_FIXED_SCALE 1
+#else
+#define KTV_UI_FIXED_SCALE 0
+#endif
 
 namespace ktv::ui {
 
+namespace scale_detail {
+
+constexpr int32_t kDesignWidth = 1920;
+constexpr int32_t kDesignHeight = 1080;
+
+// 缩放比例用分数表示，编译期计算不引入浮点误差
+struct Ratio {
+    int32_t num;
+    int32_t den;
+};
+
+// 与 UIScale::initialize 规则一致：取宽高比例较小者，限制在 0.5x ~ 2.0x
+constexpr Ratio fitRatio(int32_t width, int32_t height) {
+    Ratio r = (int64_t{width} * kDesignHeight <= int64_t{height} * kDesignWidth)
+                  ? Ratio{width, kDesignWidth}
+                  : Ratio{height, kDesignHeight};
+    if (int64_t{r.num} * 2 < r.den) return Ratio{1, 2};
+    if (r.num > int64_t{r.den} * 2) return Ratio{2, 1};
+    return r;
+}
+
+// 四舍五入（远离零），与 std::round 一致
+constexpr lv_coord_t scaleBy(Ratio r, lv_coord_t value) {
+    int64_t prod = int64_t{value} * r.num;
+    int64_t half = r.den / 2;
+    return static_cast<lv_coord_t>(prod >= 0 ? (prod + half) / r.den : (prod - half) / r.den);
+}
+
+#if KTV_UI_FIXED_SCALE
+constexpr Ratio kFixedRatio = fitRatio(KTV_UI_FIXED_WIDTH, KTV_UI_FIXED_HEIGHT);
+static_assert(KTV_UI_FIXED_WIDTH > 0 && KTV_UI_FIXED_HEIGHT > 0, "KTV_UI_FIXED_WIDTH/HEIGHT must be positive");
+static_assert(scaleBy(fitRatio(1280, 720), 72) == 48, "fixed scale rounding");
+#endif
+
+}  // namespace scale_detail
+
 /**
  * 全局UI缩放系统
  * 基于设计稿 1920x1080，自动适配不同分辨率
@@ -44,13 +91,24 @@ public:
      */
     const lv_font_t* scaleFont(const lv_font_t* base_font) const;
 
+    /**
+     * 是否为编译期固定缩放构建
+     */
+    static constexpr bool isFixed() { return KTV_UI_FIXED_SCALE != 0; }
+
     /**
      * 快速缩放函数（内联优化）
-     * 注意：必须在 initialize() 之后调用
+     * 注意：运行时缩放必须在 initialize() 之后调用；固定缩放构建为编译期常量
      */
+#if KTV_UI_FIXED_SCALE
+    static constexpr lv_coord_t s(lv_coord_t value) {
+        return scale_detail::scaleBy(scale_detail::kFixedRatio, value);
+    }
+#else
     static inline lv_coord_t s(lv_coord_t value) {
         return getInstance().scale(value);
     }
+#endif
 
 private:
     UIScale() = default;
@@ -0,0 +1,313 @@
+#include "virtual_list.h"
+#include "style_registry.h"
+#include "../core/executor.h"
+#include "../events/ui_dispatcher.h"
+#include "../utils/log_macros.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <exception>
+
+namespace ktv::ui {
+
+static constexpr int kFallbackVisibleRows = 8;   // 首次布局前视口高度未知时的估计
+
+AsyncDataSource::AsyncDataSource(Fetch fetch)
+    : fetch_(std::make_shared<const Fetch>(std::move(fetch)))
+    , cancelled_(std::make_shared<std::atomic<bool>>(false))
+{
+}
+
+AsyncDataSource::~AsyncDataSource() {
+    cancelled_->store(true, std::memory_order_relaxed);
+}
+
+void AsyncDataSource::requestPage(int page, int page_size, PageCallback done) {
+    auto fetch = fetch_;
+    auto cancelled = cancelled_;
+    auto job = [fetch, cancelled, page, page_size, done]() {
+        if (cancelled->load(std::memory_order_relaxed)) return;   // 排队期间已切换关键词/页面
+        auto begin = std::chrono::steady_clock::now();
+        std::vector<ktv::services::SongItem> items;
+        int total = -1;
+        try {
+            if (*fetch) items = (*fetch)(page, page_size);
+        } catch (const std::exception& e) {
+            KTV_SYSLOG(LOG_WARNING, "[ktv][ui][page_load] page=%d error=%s", page, e.what());
+            total = kPageFailed;
+        } catch (...) {
+            KTV_SYSLOG(LOG_WARNING, "[ktv][ui][page_load] page=%d error=unknown", page);
+            total = kPageFailed;
+        }
+        if (cancelled->load(std::memory_order_relaxed)) return;
+        auto cost_ms = std::chrono::duration_cast<std::chrono::milliseconds>(
+            std::chrono::steady_clock::now() - begin).count();
+        KTV_SYSLOG(LOG_DEBUG, "[ktv][ui][page_load] page=%d items=%zu cost_ms=%lld",
+                   page, items.size(), static_cast<long long>(cost_ms));
+
+        // std::function 要求可拷贝，结果放进 shared_ptr 避免二次拷贝
+        auto result = std::make_shared<std::vector<ktv::services::SongItem>>(std::move(items));
+        ktv::events::UiDispatcher::getInstance().post([cancelled, done, page, result, total] {
+            // 析构只发生在 UI 线程，这里的判断与 reload/删除没有竞争
+            if (cancelled->load(std::memory_order_relaxed)) return;
+            done(page, std::move(*result), total);
+        });
+    };
+
+    // 投递被拒或排队中被 DropOldest 挤掉：本页按失败回调（列表稍后重试），不在调用线程（UI）上同步拉取；
+    // 被挤掉时 post 也可能返回 false，reported 保证只回调一次
+    auto reported = std::make_shared<std::atomic<bool>>(false);
+    auto fail = [cancelled, done, page, reported]() {
+        if (reported->exchange(true)) return;
+        KTV_SYSLOG(LOG_INFO, "[ktv][ui][page_load] page=%d dropped", page);
+        ktv::events::UiDispatcher::getInstance().post([cancelled, done, page] {
+            if (cancelled->load(std::memory_order_relaxed)) return;
+            done(page, {}, kPageFailed);
+        });
+    };
+    if (!ktv::core::Executor::instance().post(ktv::core::Lane::Background, job, fail)) fail();
+}
+
+VirtualList* VirtualList::create(lv_obj_t* parent, std::unique_ptr<SongListDataSource> source,
+                                 const VirtualListConfig& cfg, CreateRow create_row, BindRow bind_row) {
+    return new VirtualList(parent, std::move(source), cfg, std::move(create_row), std::move(bind_row));
+}
+
+VirtualList::VirtualList(lv_obj_t* parent, std::unique_ptr<SongListDataSource> source,
+                         const VirtualListConfig& cfg, CreateRow create_row, BindRow bind_row)
+    : cfg_(cfg)
+    , create_row_(std::move(create_row))
+    , bind_row_(std::move(bind_row))
+    , source_(std::move(source))
+    , alive_(std::make_shared<bool>(true))
+{
+    if (cfg_.row_height < 1) cfg_.row_height = 1;
+    if (cfg_.page_size < 1) cfg_.page_size = 1;
+    if (cfg_.max_cached_pages < 2) cfg_.max_cached_pages = 2;
+
+    // 不使用 flex：行对象按下标绝对定位
+    scroll_ = lv_obj_create(parent);
+    lv_obj_set_scroll_dir(scroll_, LV_DIR_VER);
+    lv_obj_set_user_data(scroll_, this);
+    lv_obj_add_event_cb(scroll_, onEvent, LV_EVENT_SCROLL, this);
+    lv_obj_add_event_cb(scroll_, onEvent, LV_EVENT_SIZE_CHANGED, this);
+    lv_obj_add_event_cb(scroll_, onEvent, LV_EVENT_DELETE, this);
+
+    sizer_ = lv_obj_create(scroll_);
+    lv_obj_set_size(sizer_, 1, 1);
+    lv_obj_add_style(sizer_, StyleRegistry::getInstance().bgOpa(LV_OPA_TRANSP), 0);
+    lv_obj_add_style(sizer_, StyleRegistry::getInstance().border(0), 0);
+    lv_obj_clear_flag(sizer_, LV_OBJ_FLAG_CLICKABLE);
+
+    if (cfg_.empty_text) {
+        empty_label_ = lv_label_create(scroll_);
+        lv_label_set_text(empty_label_, cfg_.empty_text);
+        lv_obj_add_flag(empty_label_, LV_OBJ_FLAG_HIDDEN);
+    }
+
+    requestPage(0);
+    layoutRows();
+}
+
+VirtualList::~VirtualList() {
+    if (retry_timer_) lv_timer_del(retry_timer_);
+}
+
+void VirtualList::onEvent(lv_event_t* e) {
+    auto* self = static_cast<VirtualList*>(lv_event_get_user_data(e));
+    switch (lv_event_get_code(e)) {
+        case LV_EVENT_SCROLL:
+            self->layoutRows();
+            break;
+        case LV_EVENT_SIZE_CHANGED:
+            self->ensurePool();
+            self->layoutRows();
+            break;
+        case LV_EVENT_DELETE:
+            delete self;
+            break;
+        default:
+            break;
+    }
+}
+
+void VirtualList::onRetry(lv_timer_t* timer) {
+    auto* self = static_cast<VirtualList*>(timer->user_data);
+    self->retry_timer_ = nullptr;   // 单次定时器，回调返回后 LVGL 自行删除
+    self->failed_.clear();
+    self->layoutRows();             // 仍在可见区的失败页重新请求
+}
+
+VirtualList* VirtualList::fromRow(lv_obj_t* row) {
+    lv_obj_t* parent = row ? lv_obj_get_parent(row) : nullptr;
+    return parent ? static_cast<VirtualList*>(lv_obj_get_user_data(parent)) : nullptr;
+}
+
+const ktv::services::SongItem* VirtualList::itemForRow(lv_obj_t* row) const {
+    for (const auto& r : rows_) {
+        if (r.obj == row) return itemAt(r.index);
+    }
+    return nullptr;
+}
+
+const ktv::services::SongItem* VirtualList::itemAt(int index) const {
+    if (index < 0) return nullptr;
+    auto it = pages_.find(index / cfg_.page_size);
+    if (it == pages_.end()) return nullptr;
+    size_t offset = static_cast<size_t>(index % cfg_.page_size);
+    return offset < it->second.size() ? &it->second[offset] : nullptr;
+}
+
+void VirtualList::reload(std::unique_ptr<SongListDataSource> source) {
+    ++generation_;
+    source_ = std::move(source);
+    pages_.clear();
+    pending_.clear();
+    failed_.clear();
+    count_ = 0;
+    has_more_ = true;
+    loaded_once_ = false;
+    for (auto& r : rows_) r.index = -1;
+    lv_obj_scroll_to_y(scroll_, 0, LV_ANIM_OFF);
+    updateExtent();
+    requestPage(0);
+    layoutRows();
+}
+
+void VirtualList::ensurePool() {
+    lv_coord_t view_h = lv_obj_get_content_height(scroll_);
+    int visible = view_h > 0 ? (view_h + pitch() - 1) / pitch() : kFallbackVisibleRows;
+    size_t want = static_cast<size_t>(visible + 2 * cfg_.overscan_rows);
+    if (rows_.size() >= want) return;
+
+    // 行池只增不减：槽位 = 下标 % 池大小，扩容后全部重新绑定
+    while (rows_.size() < want) {
+        Row r;
+        r.obj = create_row_(scroll_);
+        lv_obj_set_width(r.obj, LV_PCT(100));
+        lv_obj_set_height(r.obj, cfg_.row_height);
+        lv_obj_add_flag(r.obj, LV_OBJ_FLAG_HIDDEN);
+        rows_.push_back(r);
+    }
+    for (auto& r : rows_) r.index = -1;
+}
+
+void VirtualList::layoutRows() {
+    // 同步数据源会在布局过程中回调 onPage()，嵌套调用改为循环重排
+    if (in_layout_) {
+        relayout_ = true;
+        return;
+    }
+    in_layout_ = true;
+    do {
+        relayout_ = false;
+        layoutOnce();
+    } while (relayout_);
+    in_layout_ = false;
+}
+
+void VirtualList::layoutOnce() {
+    if (rows_.empty()) ensurePool();
+
+    const int total = displayCount();
+    const int pool = static_cast<int>(rows_.size());
+    int first = std::max(0, lv_obj_get_scroll_y(scroll_) / pitch() - cfg_.overscan_rows);
+    if (total > pool) first = std::min(first, total - pool);
+    else first = 0;
+
+    std::vector<bool> used(rows_.size(), false);
+    for (int idx = first; idx < std::min(total, first + pool); ++idx) {
+        Row& r = rows_[static_cast<size_t>(idx % pool)];
+        used[static_cast<size_t>(idx % pool)] = true;
+        const ktv::services::SongItem* item = itemAt(idx);
+        if (r.index != idx || !item) {
+            bind_row_(r.obj, item);
+            lv_obj_set_y(r.obj, static_cast<lv_coord_t>(idx) * pitch());
+            lv_obj_clear_flag(r.obj, LV_OBJ_FLAG_HIDDEN);
+            r.index = item ? idx : -1;   // 占位行数据到达后需要重新绑定
+        }
+        if (!item && idx < total) requestPage(idx / cfg_.page_size);
+    }
+    for (size_t i = 0; i < rows_.size(); ++i) {
+        if (!used[i] && !lv_obj_has_flag(rows_[i].obj, LV_OBJ_FLAG_HIDDEN)) {
+            lv_obj_add_flag(rows_[i].obj, LV_OBJ_FLAG_HIDDEN);
+            rows_[i].index = -1;
+        }
+    }
+
+    evictPages(first / cfg_.page_size, (first + pool) / cfg_.page_size);
+}
+
+void VirtualList::updateExtent() {
+    int total = displayCount();
+    lv_coord_t height = total > 0 ? static_cast<lv_coord_t>(total) * pitch() - cfg_.row_gap : 0;
+    lv_obj_set_pos(sizer_, 0, height > 0 ? height - 1 : 0);
+
+    if (empty_label_) {
+        if (loaded_once_ && count_ == 0 && !has_more_) {
+            lv_obj_clear_flag(empty_label_, LV_OBJ_FLAG_HIDDEN);
+        } else {
+            lv_obj_add_flag(empty_label_, LV_OBJ_FLAG_HIDDEN);
+        }
+    }
+}
+
+void VirtualList::requestPage(int page) {
+    if (!source_ || page < 0 || pages_.count(page) || pending_.count(page) || failed_.count(page)) return;
+    pending_.insert(page);
+    std::weak_ptr<bool> alive = alive_;
+    uint64_t gen = generation_;
+    source_->requestPage(page, cfg_.page_size,
+                         [this, alive, gen](int p, std::vector<ktv::services::SongItem> items, int total) {
+                             if (alive.expired()) return;
+                             onPage(gen, p, std::move(items), total);
+                         });
+}
+
+void VirtualList::onPage(uint64_t generation, int page, std::vector<ktv::services::SongItem> items, int total) {
+    if (generation != generation_) return;   // reload 之前发出的请求
+    pending_.erase(page);
+    if (total == SongListDataSource::kPageFailed) {
+        // 失败页不缓存（否则被当成空页，之后的行永远是骨架），定时后重新请求
+        failed_.insert(page);
+        if (!retry_timer_) {
+            retry_timer_ = lv_timer_create(onRetry, cfg_.retry_ms, this);
+            lv_timer_set_repeat_count(retry_timer_, 1);
+        }
+        KTV_SYSLOG(LOG_INFO, "[ktv][ui][page_load] page=%d failed retry_ms=%u", page, cfg_.retry_ms);
+        return;
+    }
+    loaded_once_ = true;
+
+    const int end = page * cfg_.page_size + static_cast<int>(items.size());
+    const bool full = static_cast<int>(items.size()) >= cfg_.page_size;
+    if (total >= 0) {
+        count_ = total;
+        has_more_ = false;
+    } else {
+        count_ = std::max(count_, end);
+        // 只有最后一页决定是否还有更多
+        if (end >= count_) has_more_ = full;
+    }
+    pages_[page] = std::move(items);   // 空页也记录，避免重复请求
+
+    updateExtent();
+    if (!rows_.empty()) layoutRows();
+}
+
+void VirtualList::evictPages(int first_page, int last_page) {
+    if (static_cast<int>(pages_.size()) <= cfg_.max_cached_pages) return;
+    std::vector<std::pair<int, int>> by_distance;   // (距离, 页号)
+    for (const auto& kv : pages_) {
+        int p = kv.first;
+        int d = p < first_page ? first_page - p : (p > last_page ? p - last_page : 0);
+        if (d > 0) by_distance.emplace_back(d, p);
+    }
+    std::sort(by_distance.rbegin(), by_distance.rend());
+    for (const auto& dp : by_distance) {
+        if (static_cast<int>(pages_.size()) <= cfg_.max_cached_pages) break;
+        pages_.erase(dp.second);
+    }
+}
+
+}  // namespace ktv::ui
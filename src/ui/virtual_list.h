@@ -0,0 +1,165 @@
+#ifndef KTVLV_UI_VIRTUAL_LIST_H
+#define KTVLV_UI_VIRTUAL_LIST_H
+
+#include <lvgl.h>
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <memory>
+#include <unordered_map>
+#include <unordered_set>
+#include <vector>
+#include "../services/song_service.h"
+
+namespace ktv::ui {
+
+/**
+ * 歌曲列表数据源（按页拉取）
+ * - page 从 0 开始
+ * - done 必须在 UI 线程回调（同步数据源直接在 requestPage 内回调即可）
+ * - total < 0 表示总数未知：返回满页时列表认为还有下一页
+ * - total == kPageFailed 表示本页拉取失败：列表不缓存该页，稍后重试
+ */
+class SongListDataSource {
+public:
+    using PageCallback = std::function<void(int page, std::vector<ktv::services::SongItem> items, int total)>;
+
+    static constexpr int kPageFailed = -2;
+
+    virtual ~SongListDataSource() = default;
+    virtual void requestPage(int page, int page_size, PageCallback done) = 0;
+};
+
+// 同步拉取函数包装成数据源（SongService::listSongs / search 等）
+class FunctionDataSource : public SongListDataSource {
+public:
+    using Fetch = std::function<std::vector<ktv::services::SongItem>(int page, int page_size)>;
+
+    explicit FunctionDataSource(Fetch fetch) : fetch_(std::move(fetch)) {}
+
+    void requestPage(int page, int page_size, PageCallback done) override {
+        done(page, fetch_ ? fetch_(page, page_size) : std::vector<ktv::services::SongItem>{}, -1);
+    }
+
+private:
+    Fetch fetch_;
+};
+
+/**
+ * 异步数据源：fetch 在 Executor 后台 Lane 执行，结果经 UiDispatcher 回到 UI 线程
+ *
+ * - fetch 运行在工作线程，不能调用任何 LVGL 接口；抛异常表示本页失败（回调 kPageFailed）
+ * - 一页结果对应一次 UI 回调（列表在回调里一次性重排）
+ * - 数据源被替换或列表被删除时（析构）标记取消：排队中的请求不再发起网络访问，
+ *   已在途的结果到达后直接丢弃
+ */
+class AsyncDataSource : public SongListDataSource {
+public:
+    using Fetch = FunctionDataSource::Fetch;
+
+    explicit AsyncDataSource(Fetch fetch);
+    ~AsyncDataSource() override;
+
+    void requestPage(int page, int page_size, PageCallback done) override;
+
+private:
+    std::shared_ptr<const Fetch> fetch_;
+    std::shared_ptr<std::atomic<bool>> cancelled_;
+};
+
+struct VirtualListConfig {
+    lv_coord_t row_height = 72;      // 已缩放
+    lv_coord_t row_gap = 6;          // 已缩放
+    int page_size = 20;
+    int overscan_rows = 2;           // 可见区上下各多保留的行数
+    int max_cached_pages = 6;        // 超出后淘汰离可见区最远的页
+    uint32_t retry_ms = 2000;        // 拉取失败的页过多久重新请求
+    int placeholder_rows = 8;        // 首页数据到达前显示的骨架行数
+    const char* empty_text = nullptr;
+};
+
+/**
+ * 虚拟列表：只为可见行（+ overscan）创建 LVGL 对象，滚动时复用行对象重新绑定数据
+ *
+ * - 行对象数量只和视口高度有关，与数据条数无关（1000 条搜索结果也只有十几行对象）
+ * - 数据按页向数据源请求，只缓存可见区附近的若干页
+ * - 行外观由调用方提供：create_row 创建一次，bind_row 每次复用时刷新内容
+ *   （item == nullptr 表示该行数据还在加载）
+ * - 生命周期跟随 obj()：对象删除时 VirtualList 自动释放
+ */
+class VirtualList {
+public:
+    using CreateRow = std::function<lv_obj_t*(lv_obj_t* parent)>;
+    using BindRow = std::function<void(lv_obj_t* row, const ktv::services::SongItem* item)>;
+
+    static VirtualList* create(lv_obj_t* parent, std::unique_ptr<SongListDataSource> source,
+                               const VirtualListConfig& cfg, CreateRow create_row, BindRow bind_row);
+
+    VirtualList(const VirtualList&) = delete;
+    VirtualList& operator=(const VirtualList&) = delete;
+
+    lv_obj_t* obj() const { return scroll_; }
+
+    // 更换数据源（如搜索关键词变化）并回到顶部；旧数据源未完成的回调被丢弃
+    void reload(std::unique_ptr<SongListDataSource> source);
+
+    // 行对象 → 列表 / 当前绑定的数据（用于行内按钮的事件回调）
+    static VirtualList* fromRow(lv_obj_t* row);
+    const ktv::services::SongItem* itemForRow(lv_obj_t* row) const;
+    const ktv::services::SongItem* itemAt(int index) const;
+
+    int count() const { return count_; }
+    size_t rowPoolSize() const { return rows_.size(); }
+
+private:
+    struct Row {
+        lv_obj_t* obj = nullptr;
+        int index = -1;   // 当前绑定的数据下标，-1 表示需要重新绑定
+    };
+
+    VirtualList(lv_obj_t* parent, std::unique_ptr<SongListDataSource> source, const VirtualListConfig& cfg,
+                CreateRow create_row, BindRow bind_row);
+    ~VirtualList();
+
+    static void onEvent(lv_event_t* e);
+    static void onRetry(lv_timer_t* timer);
+
+    lv_coord_t pitch() const { return cfg_.row_height + cfg_.row_gap; }
+    int displayCount() const {
+        int n = count_ + (has_more_ ? 1 : 0);
+        return loaded_once_ ? n : std::max(n, cfg_.placeholder_rows);
+    }
+    void ensurePool();
+    void layoutRows();
+    void layoutOnce();
+    void updateExtent();
+    void requestPage(int page);
+    void onPage(uint64_t generation, int page, std::vector<ktv::services::SongItem> items, int total);
+    void evictPages(int first_page, int last_page);
+
+    VirtualListConfig cfg_;
+    CreateRow create_row_;
+    BindRow bind_row_;
+    std::unique_ptr<SongListDataSource> source_;
+
+    lv_obj_t* scroll_ = nullptr;
+    lv_obj_t* sizer_ = nullptr;        // 撑开滚动范围的占位对象
+    lv_obj_t* empty_label_ = nullptr;
+    std::vector<Row> rows_;
+
+    std::unordered_map<int, std::vector<ktv::services::SongItem>> pages_;
+    std::unordered_set<int> pending_;
+    std::unordered_set<int> failed_;   // 拉取失败、等待重试的页（不进 pages_）
+    lv_timer_t* retry_timer_ = nullptr;
+    int count_ = 0;
+    bool has_more_ = true;
+    bool loaded_once_ = false;
+    bool in_layout_ = false;
+    bool relayout_ = false;
+    uint64_t generation_ = 0;
+    std::shared_ptr<bool> alive_;      // 数据源回调晚于列表销毁时用于判活
+};
+
+}  // namespace ktv::ui
+
+#endif  // KTVLV_UI_VIRTUAL_LIST_H
@@ -0,0 +1,24 @@
+// json_escape.h
+// 手写 JSON 字符串字段时的转义（事件 payload 用 snprintf 拼接，不经过 cJSON）。
+#pragma once
+
+#include <string>
+
+namespace ktv::utils {
+
+// 转义引号与反斜杠，丢弃控制字符（song_id 等来自服务端，不保证干净）
+inline std::string json_escape(const std::string& s) {
+  std::string out;
+  out.reserve(s.size());
+  for (unsigned char c : s) {
+    if (c == '"' || c == '\\') {
+      out += '\\';
+      out += static_cast<char>(c);
+    } else if (c >= 0x20) {
+      out += static_cast<char>(c);
+    }
+  }
+  return out;
+}
+
+}  // namespace ktv::utils
@@ -3,12 +3,23 @@
 #pragma once
 
 #include <syslog.h>
+#include "../core/log_filter.h"
+#include "../core/log_ring.h"
 
 /**
  * 日志宏 - 统一格式
  *
  * 格式：[ktv][component][level] message
  *
+ * 写入进程内日志环（ktv::core::LogRing），由 Background Lane 异步写 syslog，
+ * 调用方不做格式化、不碰 syslog socket。fmt 必须是字符串常量。
+ *
+ * 三层过滤（由便宜到贵）：
+ * - 编译期：级别低于 KTV_LOG_MIN_LEVEL 的调用整段被编译器删掉（参数也不求值）
+ * - 运行时：按组件（格式串 "[ktv][<component>]"）查级别表，config.ini [log] 段配置；
+ *   未启用时参数同样不求值
+ * - 限频：每个调用点一个令牌桶，超出的丢弃，并以 "[ktv][log][ratelimit] suppressed=N" 汇总
+ *
  * 用法：
  *   KTV_LOG_INFO("db", "action=init path=%s", path);
  *   KTV_LOG_ERR("http", "action=get reason=timeout url=%s", url);
@@ -20,25 +31,39 @@
  *   [ktv][http][error] action=get reason=timeout url=/api/songs
  */
 
+// 编译期最低级别（syslog 优先级，数值越大越详细）：发布版用 -DKTV_LOG_MIN_LEVEL=6 去掉 debug
+#ifndef KTV_LOG_MIN_LEVEL
+#define KTV_LOG_MIN_LEVEL LOG_DEBUG
+#endif
+
+// 与 syslog(priority, fmt, ...) 同参数的替换：文本不变，只是改走日志环（经过上面三层过滤）
+#define KTV_SYSLOG(priority, fmt, ...)                                                        \
+    do {                                                                                      \
+        if ((priority) <= KTV_LOG_MIN_LEVEL) {                                                \
+            static ::ktv::core::LogSite ktv_log_site_(fmt, __FILE__, __LINE__);               \
+            if (ktv_log_site_.enabled(priority)) ktv_log_site_.log((priority), fmt, ##__VA_ARGS__); \
+        }                                                                                     \
+    } while (0)
+
 // 基础日志宏
 #define KTV_LOG_DEBUG(component, fmt, ...) \
-    syslog(LOG_DEBUG, "[ktv][" component "][debug] " fmt, ##__VA_ARGS__)
+    KTV_SYSLOG(LOG_DEBUG, "[ktv][" component "][debug] " fmt, ##__VA_ARGS__)
 
 #define KTV_LOG_INFO(component, fmt, ...) \
-    syslog(LOG_INFO, "[ktv][" component "][info] " fmt, ##__VA_ARGS__)
+    KTV_SYSLOG(LOG_INFO, "[ktv][" component "][info] " fmt, ##__VA_ARGS__)
 
 #define KTV_LOG_WARN(component, fmt, ...) \
-    syslog(LOG_WARNING, "[ktv][" component "][warn] " fmt, ##__VA_ARGS__)
+    KTV_SYSLOG(LOG_WARNING, "[ktv][" component "][warn] " fmt, ##__VA_ARGS__)
 
 #define KTV_LOG_ERR(component, fmt, ...) \
-    syslog(LOG_ERR, "[ktv][" component "][error] " fmt, ##__VA_ARGS__)
+    KTV_SYSLOG(LOG_ERR, "[ktv][" component "][error] " fmt, ##__VA_ARGS__)
 
 // 带 action 的快捷宏（最常用场景）
 #define KTV_LOG_ACTION(component, action, fmt, ...) \
-    syslog(LOG_INFO, "[ktv][" component "][action] action=" action " " fmt, ##__VA_ARGS__)
+    KTV_SYSLOG(LOG_INFO, "[ktv][" component "][action] action=" action " " fmt, ##__VA_ARGS__)
 
 #define KTV_LOG_ACTION_ERR(component, action, reason) \
-    syslog(LOG_ERR, "[ktv][" component "][error] action=" action " reason=" reason)
+    KTV_SYSLOG(LOG_ERR, "[ktv][" component "][error] action=" action " reason=" reason)
 
 /**
  * 组件名约定（建议统一使用）：